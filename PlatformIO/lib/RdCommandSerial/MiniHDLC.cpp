@@ -3,6 +3,7 @@
 // Very loosely based on https://github.com/mengguang/minihdlc
 
 #include "MiniHDLC.h"
+#include "MemRegions.h"
 
 // CRC Lookup table
 const uint16_t MiniHDLC::_CRCTable[256] = { 
@@ -44,6 +45,12 @@ MiniHDLC::MiniHDLC(MiniHDLCPutChFnType putChFn, MiniHDLCFrameRxFnType frameRxFn,
     _bitwiseByte = 0;
     _bitwiseBitCount = 0;
     _bitwiseSendOnesCount = 0;
+    _rxBuffer = NULL;
+}
+
+MiniHDLC::~MiniHDLC()
+{
+    MemRegions::free(MemRegions::SUBSYS_HDLC_RX, _rxBuffer, MINIHDLC_MAX_FRAME_LENGTH + 1);
 }
 
 // Function to handle a single bit received
@@ -145,6 +152,12 @@ void MiniHDLC::handleChar(uint8_t ch)
     }
 
     // Store in buffer
+    if (!_rxBuffer)
+    {
+        _rxBuffer = (uint8_t*)MemRegions::alloc(MemRegions::SUBSYS_HDLC_RX, MINIHDLC_MAX_FRAME_LENGTH + 1);
+        if (!_rxBuffer)
+            return;
+    }
     _rxBuffer[_framePos] = ch;
 
     // Update checksum if needed
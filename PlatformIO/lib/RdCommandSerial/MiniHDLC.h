@@ -50,6 +50,7 @@ public:
     // If bitwise HDLC then the first parameter will receive bits not bytes 
     MiniHDLC(MiniHDLCPutChFnType putChFn, MiniHDLCFrameRxFnType frameRxFn,
 				bool bigEndianCRC = true, bool bitwiseHDLC = false);
+    ~MiniHDLC();
 
     // Called by external function that has byte-wise data to process
     void handleChar(uint8_t ch);
@@ -117,8 +118,8 @@ private:
     int _bitwiseBitCount;
     int _bitwiseSendOnesCount;
 
-    // Receive buffer
-    uint8_t _rxBuffer[MINIHDLC_MAX_FRAME_LENGTH + 1];
+    // Receive buffer (allocated from MemRegions when the first frame arrives)
+    uint8_t* _rxBuffer;
 
     // Stats
     MiniHDLCStats _stats;
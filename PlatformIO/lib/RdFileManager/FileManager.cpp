@@ -4,9 +4,9 @@
 #include "RdJson.h"
 #include "FileManager.h"
 #include "Utils.h"
+#include "MemRegions.h"
 #include <sys/stat.h>
 #include "vfs_api.h"
-#include "esp_spiffs.h"
 #include "ConfigPinMap.h"
 #include "esp_err.h"
 #include "esp_log.h"
@@ -36,41 +36,24 @@ void FileManager::setup(ConfigBase& config, const char* pConfigPath)
     // See if SPIFFS enabled
     _enableSPIFFS = fsConfig.getLong("spiffsEnabled", 0) != 0;
 
-    // Init SPIFFS if required
-    if (_enableSPIFFS)
+    // Mount the internal flash file system if required - the backend is set by flashFs (SPIFFS by
+    // default) and changing it needs spiffsFormatIfCorrupt as the partition is then reformatted
+    if (_enableSPIFFS && !_pFlashFs)
     {
-        // Begin SPIFFS using arduino functions as web server relies on that file system
         bool spiffsFormatIfCorrupt = fsConfig.getLong("spiffsFormatIfCorrupt", 0) != 0;
-
-        // Using ESP32 native SPIFFS support rather than arduino as potential bugs encountered in some
-        // arduino functions
-        esp_vfs_spiffs_conf_t conf = {
-        .base_path = "/spiffs",
-        .partition_label = NULL,
-        .max_files = 5,
-        .format_if_mount_failed = spiffsFormatIfCorrupt
-        };        
-        // Use settings defined above to initialize and mount SPIFFS filesystem.
-        // Note: esp_vfs_spiffs_register is an all-in-one convenience function.
-        esp_err_t ret = esp_vfs_spiffs_register(&conf);
-        if (ret != ESP_OK)
-        {
-            if (ret == ESP_FAIL)
-                Log.warning("%ssetup failed mount/format SPIFFS\n", MODULE_PREFIX);
-            else if (ret == ESP_ERR_NOT_FOUND)
-                Log.warning("%ssetup failed to find SPIFFS partition\n", MODULE_PREFIX);
-            else
-                Log.warning("%ssetup failed to init SPIFFS (error %s)\n", MODULE_PREFIX, esp_err_to_name(ret));
+        _pFlashFs = FileSysBackend::create(fsConfig);
+        if (_pFlashFs && !_pFlashFs->mount(FLASH_FS_BASE_PATH, spiffsFormatIfCorrupt))
+        {
+            delete _pFlashFs;
+            _pFlashFs = NULL;
         }
-        else
+        if (_pFlashFs)
         {
-            // Get SPIFFS info
+            // Get flash file system info
             size_t total = 0, used = 0;
-            esp_err_t ret = esp_spiffs_info(NULL, &total, &used);
-            if (ret != ESP_OK)
-                Log.warning("%ssetup failed to get SPIFFS info (error %s)\n", MODULE_PREFIX, esp_err_to_name(ret));
-            else
-                Log.notice("%ssetup SPIFFS partition size total %d, used %d\n", MODULE_PREFIX, total, used);
+            if (_pFlashFs->getInfo(total, used))
+                Log.notice("%ssetup %s partition size total %d, used %d\n", MODULE_PREFIX,
+                            _pFlashFs->getTypeName(), total, used);
 
             // Default to SPIFFS
             _defaultToSPIFFS = true;
@@ -112,7 +95,8 @@ void FileManager::setup(ConfigBase& config, const char* pConfigPath)
             // in case when mounting fails.
             esp_vfs_fat_sdmmc_mount_config_t mount_config = {
                 .format_if_mount_failed = false,
-                .max_files = 5
+                .max_files = 5,
+                .allocation_unit_size = 0
             };
 
             sdmmc_card_t* pCard;
@@ -136,6 +120,146 @@ void FileManager::setup(ConfigBase& config, const char* pConfigPath)
             // sdmmc_card_print_info(stdout, pCard);
         }
     }
+
+    // Start the worker task
+    if (!_fsTaskHandle)
+    {
+        if (xTaskCreatePinnedToCore(fsTaskFn, "FileSys", FS_TASK_STACK_SIZE, this,
+                        FS_TASK_PRIORITY, &_fsTaskHandle, FS_TASK_CORE) != pdPASS)
+        {
+            _fsTaskHandle = NULL;
+            Log.warning("%ssetup failed to start task - file system accessed directly\n", MODULE_PREFIX);
+        }
+    }
+}
+
+void FileManager::fsTaskFn(void* pParam)
+{
+    FileManager* pThis = (FileManager*)pParam;
+    while (true)
+    {
+        // Wait for a step to do - while the background job has work the wait times out so it
+        // gets a step after an interval without other work
+        bool backgroundWork = pThis->_backgroundJobSet.load(std::memory_order_acquire) &&
+                    (pThis->_backgroundMoreWork || (pThis->_backgroundWakeCount.load() != pThis->_backgroundStepWakeCount));
+        if (xSemaphoreTake(pThis->_fsWorkSem, backgroundWork ?
+                        pdMS_TO_TICKS(BACKGROUND_STEP_INTERVAL_MS) : portMAX_DELAY) != pdTRUE)
+        {
+            pThis->_backgroundStepWakeCount = pThis->_backgroundWakeCount.load();
+            pThis->_backgroundMoreWork = pThis->_backgroundStepFn();
+            continue;
+        }
+
+        // Highest priority request gets the step
+        bool stepDone = false;
+        for (int reqClass = 0; reqClass < FS_REQ_NUM_CLASSES; reqClass++)
+        {
+            FsReqSlot& reqSlot = pThis->_fsReqSlots[reqClass];
+            if (!reqSlot._pending.load(std::memory_order_acquire))
+                continue;
+            if ((*reqSlot._pStepFn)())
+            {
+                reqSlot._pending.store(false, std::memory_order_relaxed);
+                xSemaphoreGive(reqSlot._doneSem);
+            }
+            else
+            {
+                // More steps needed
+                xSemaphoreGive(pThis->_fsWorkSem);
+            }
+            stepDone = true;
+            break;
+        }
+
+        // Prefetch for playback when there are no requests, then background listings and the
+        // benchmark only when there is nothing else to do
+        bool benchmarkRunning = pThis->_benchmarkPhase.load(std::memory_order_acquire) != BENCHMARK_IDLE;
+        bool asyncListRunning = pThis->_asyncFileListRunning.load(std::memory_order_acquire);
+        if (!stepDone && (pThis->_prefetchFillIdx >= 0))
+        {
+            if (!pThis->prefetchStep() || asyncListRunning || benchmarkRunning)
+                xSemaphoreGive(pThis->_fsWorkSem);
+        }
+        else if (!stepDone && asyncListRunning)
+        {
+            if (pThis->asyncFileListStep() || benchmarkRunning)
+                xSemaphoreGive(pThis->_fsWorkSem);
+        }
+        else if (!stepDone && benchmarkRunning)
+        {
+            if (pThis->benchmarkStep())
+                xSemaphoreGive(pThis->_fsWorkSem);
+        }
+    }
+}
+
+void FileManager::setBackgroundJob(const FsBackgroundStepFnType& stepFn)
+{
+    if (_backgroundJobSet.load())
+    {
+        Log.warning("%ssetBackgroundJob already set\n", MODULE_PREFIX);
+        return;
+    }
+    _backgroundStepFn = stepFn;
+    _backgroundJobSet.store(true, std::memory_order_release);
+    backgroundJobWake();
+}
+
+void FileManager::backgroundJobWake()
+{
+    // The worker steps the job when it next times out waiting for work
+    _backgroundWakeCount++;
+    xSemaphoreGive(_fsWorkSem);
+}
+
+bool FileManager::backgroundFileListStart(const String& fileSystemStr, const String& folderStr, const FileListEntryFnType& entryFn)
+{
+    // Check file system supported
+    String nameOfFS;
+    if (!checkFileSystem(fileSystemStr, nameOfFS))
+        return false;
+    // Any listing in progress is abandoned
+    if (_backgroundFileList._pIndexFile)
+        fclose(_backgroundFileList._pIndexFile);
+    if (_backgroundFileList._dir)
+        closedir(_backgroundFileList._dir);
+    fileListJobInit(_backgroundFileList, nameOfFS, folderStr, 0);
+    _backgroundFileList._entryFn = entryFn;
+    return true;
+}
+
+bool FileManager::backgroundFileListStep(bool& rslt)
+{
+    rslt = false;
+    if (!_backgroundFileList._entryFn)
+        return true;
+    if (!fileListJobStep(_backgroundFileList))
+        return false;
+    rslt = _backgroundFileList._rslt;
+    fileListJobEnd(_backgroundFileList);
+    _backgroundFileList._entryFn = nullptr;
+    return true;
+}
+
+void FileManager::runOnFsTask(FsReqClass reqClass, const FsReqStepFnType& stepFn)
+{
+    // Run directly if there is no worker (or this is the worker)
+    if (!_fsTaskHandle || (xTaskGetCurrentTaskHandle() == _fsTaskHandle))
+    {
+        while (!stepFn())
+            ;
+        return;
+    }
+
+    // Pass to the worker and wait
+    FsReqSlot& reqSlot = _fsReqSlots[reqClass];
+    xSemaphoreTake(reqSlot._callerMutex, portMAX_DELAY);
+    reqSlot._pStepFn = &stepFn;
+    reqSlot._pending.store(true, std::memory_order_release);
+    xSemaphoreGive(_fsWorkSem);
+    xSemaphoreTake(reqSlot._doneSem, portMAX_DELAY);
+    reqSlot._pStepFn = NULL;
+    xSemaphoreGive(reqSlot._callerMutex);
 }
     
 void FileManager::reformat(const String& fileSystemStr, String& respStr)
@@ -151,12 +275,235 @@ void FileManager::reformat(const String& fileSystemStr, String& respStr)
     // Reformat - need to disable Watchdog timer while formatting
     // Watchdog is not enabled on core 1 in Arduino according to this
     // https://www.bountysource.com/issues/44690700-watchdog-with-system-reset
-    _cachedFileListValid = false;
-    disableCore0WDT();
-    esp_err_t ret = esp_spiffs_format(NULL);
-    enableCore0WDT();
-    Utils::setJsonBoolResult(respStr, ret == ESP_OK);
-    Log.warning("%sReformat SPIFFS result %s\n", MODULE_PREFIX, (ret == ESP_OK ? "OK" : "FAIL"));
+    fileListChanged();
+    bool rslt = false;
+    runOnFsTask(FS_REQ_UPLOAD, [this, &rslt]() {
+        prefetchDiscard(NULL);
+        disableCore0WDT();
+        rslt = _pFlashFs && _pFlashFs->format();
+        enableCore0WDT();
+        return true;
+    });
+    Utils::setJsonBoolResult(respStr, rslt);
+    Log.warning("%sReformat %s result %s\n", MODULE_PREFIX, (_pFlashFs ? _pFlashFs->getTypeName() : "SPIFFS"), 
+                (rslt ? "OK" : "FAIL"));
+}
+
+void FileManager::runBenchmark(const String& fileSystemStr, int numFiles, String& respStr)
+{
+    if (numFiles < 1)
+        numFiles = BENCHMARK_FILES_DEFAULT;
+    if (numFiles > BENCHMARK_FILES_MAX)
+        numFiles = BENCHMARK_FILES_MAX;
+
+    // Check file system supported
+    String nameOfFS;
+    if (!checkFileSystem(fileSystemStr, nameOfFS))
+    {
+        respStr = "{\"rslt\":\"fail\",\"error\":\"invalidfs\"}";
+        return;
+    }
+
+    // Start the job if one isn't running
+    xSemaphoreTake(_benchmarkMutex, portMAX_DELAY);
+    if (_benchmarkPhase.load() != BENCHMARK_IDLE)
+    {
+        xSemaphoreGive(_benchmarkMutex);
+        respStr = "{\"rslt\":\"busy\"}";
+        return;
+    }
+    _pBenchmarkBuf = (uint8_t*)MemRegions::alloc(MemRegions::SUBSYS_FILE_CHUNK, BENCHMARK_BLOCK_LEN);
+    if (!_pBenchmarkBuf)
+    {
+        xSemaphoreGive(_benchmarkMutex);
+        respStr = "{\"rslt\":\"fail\",\"error\":\"nomem\"}";
+        return;
+    }
+    _benchmarkFsName = nameOfFS;
+    _benchmarkNumFiles = numFiles;
+    _benchmarkFileIdx = 0;
+    _benchmarkBlockPos = 0;
+    _pBenchmarkError = NULL;
+    _benchmarkWriteUs = _benchmarkListUs = _benchmarkStatUs = _benchmarkReadUs = 0;
+    _benchmarkBytesRead = 0;
+    _benchmarkResult = "";
+    _benchmarkPhase.store(BENCHMARK_WRITE, std::memory_order_release);
+    xSemaphoreGive(_benchmarkMutex);
+    Log.notice("%sbenchmark started %s numFiles %d\n", MODULE_PREFIX, nameOfFS.c_str(), numFiles);
+
+    // Run directly if there is no worker
+    if (!_fsTaskHandle)
+        while (benchmarkStep())
+            ;
+    else
+        xSemaphoreGive(_fsWorkSem);
+    Utils::setJsonBoolResult(respStr, true);
+}
+
+void FileManager::getBenchmarkResult(String& respStr)
+{
+    xSemaphoreTake(_benchmarkMutex, portMAX_DELAY);
+    if (_benchmarkPhase.load() != BENCHMARK_IDLE)
+        respStr = "{\"rslt\":\"busy\"}";
+    else if (_benchmarkResult.length() == 0)
+        respStr = "{\"rslt\":\"fail\",\"error\":\"notrun\"}";
+    else
+        respStr = _benchmarkResult;
+    xSemaphoreGive(_benchmarkMutex);
+}
+
+void FileManager::benchmarkFilePath(int fileIdx, String& rootFilename)
+{
+    char filename[30];
+    snprintf(filename, sizeof(filename), "__fsbench_%d.txt", fileIdx);
+    rootFilename = getFilePath(_benchmarkFsName, filename);
+}
+
+// Do a step of the benchmark job (on the worker task) - returns true if there is more to do
+bool FileManager::benchmarkStep()
+{
+    String rootFilename;
+    int phase = _benchmarkPhase.load(std::memory_order_acquire);
+    switch (phase)
+    {
+        case BENCHMARK_WRITE:
+        {
+            // Upload write - a block at a time to a temporary file which is renamed when complete
+            if (_benchmarkBlockPos == 0)
+            {
+                for (int byteIdx = 0; byteIdx < BENCHMARK_BLOCK_LEN; byteIdx++)
+                    _pBenchmarkBuf[byteIdx] = (byteIdx % 64 == 63) ? '\n' : ('0' + (byteIdx + _benchmarkFileIdx) % 10);
+            }
+            String tmpRootFilename = getFilePath(_benchmarkFsName, "__fsbench__.tmp");
+            uint32_t startUs = micros();
+            FILE* pFile = fopen(tmpRootFilename.c_str(), (_benchmarkBlockPos == 0) ? "wb" : "ab");
+            bool writeOk = pFile && (fwrite(_pBenchmarkBuf, 1, BENCHMARK_BLOCK_LEN, pFile) == BENCHMARK_BLOCK_LEN);
+            if (pFile)
+                fclose(pFile);
+            _benchmarkBlockPos += BENCHMARK_BLOCK_LEN;
+            if (writeOk && (_benchmarkBlockPos >= BENCHMARK_FILE_LEN))
+            {
+                benchmarkFilePath(_benchmarkFileIdx, rootFilename);
+                unlink(rootFilename.c_str());
+                writeOk = rename(tmpRootFilename.c_str(), rootFilename.c_str()) == 0;
+                _benchmarkBlockPos = 0;
+                _benchmarkFileIdx++;
+            }
+            _benchmarkWriteUs += micros() - startUs;
+            if (!writeOk)
+            {
+                unlink(tmpRootFilename.c_str());
+                _pBenchmarkError = "writefail";
+                _benchmarkNumFiles = _benchmarkFileIdx + 1;
+                _benchmarkFileIdx = 0;
+                _benchmarkPhase.store(BENCHMARK_TIDY);
+            }
+            else if (_benchmarkFileIdx >= _benchmarkNumFiles)
+            {
+                _benchmarkFileIdx = 0;
+                _benchmarkPhase.store(BENCHMARK_LIST);
+            }
+            return true;
+        }
+        case BENCHMARK_LIST:
+        {
+            // Listing of the root folder which holds the benchmark files (not from the cache)
+            String listJson;
+            fileListInvalidate();
+            uint32_t startUs = micros();
+            getFilesJSON(_benchmarkFsName, "/", listJson);
+            _benchmarkListUs += micros() - startUs;
+            if (++_benchmarkFileIdx >= BENCHMARK_REPEATS)
+            {
+                fileListInvalidate();
+                _benchmarkFileIdx = 0;
+                _benchmarkPhase.store(BENCHMARK_STAT);
+            }
+            return true;
+        }
+        case BENCHMARK_STAT:
+        {
+            // Stat of every file (as done for each file work item)
+            uint32_t startUs = micros();
+            for (int fileIdx = 0; fileIdx < _benchmarkNumFiles; fileIdx++)
+            {
+                char filename[30];
+                int fileLen = 0;
+                snprintf(filename, sizeof(filename), "__fsbench_%d.txt", fileIdx);
+                getFileInfo(_benchmarkFsName, filename, fileLen);
+            }
+            _benchmarkStatUs += micros() - startUs;
+            if (++_benchmarkFileIdx >= BENCHMARK_REPEATS)
+            {
+                _benchmarkFileIdx = 0;
+                _benchmarkPhase.store(BENCHMARK_READ);
+            }
+            return true;
+        }
+        case BENCHMARK_READ:
+        {
+            // Sequential read of a file in chunks
+            benchmarkFilePath(_benchmarkFileIdx, rootFilename);
+            uint32_t startUs = micros();
+            FILE* pFile = fopen(rootFilename.c_str(), "rb");
+            if (pFile)
+            {
+                size_t readLen = 0;
+                while ((readLen = fread(_pBenchmarkBuf, 1, BENCHMARK_BLOCK_LEN, pFile)) > 0)
+                    _benchmarkBytesRead += readLen;
+                fclose(pFile);
+            }
+            _benchmarkReadUs += micros() - startUs;
+            if (++_benchmarkFileIdx >= _benchmarkNumFiles)
+            {
+                _benchmarkFileIdx = 0;
+                _benchmarkPhase.store(BENCHMARK_TIDY);
+            }
+            return true;
+        }
+        case BENCHMARK_TIDY:
+        {
+            // Remove a file
+            benchmarkFilePath(_benchmarkFileIdx, rootFilename);
+            unlink(rootFilename.c_str());
+            if (++_benchmarkFileIdx < _benchmarkNumFiles)
+                return true;
+            break;
+        }
+        default:
+            return false;
+    }
+
+    // Complete
+    fileListChanged();
+    MemRegions::free(MemRegions::SUBSYS_FILE_CHUNK, _pBenchmarkBuf, BENCHMARK_BLOCK_LEN);
+    _pBenchmarkBuf = NULL;
+    String resultStr;
+    if (_pBenchmarkError)
+    {
+        resultStr = "{\"rslt\":\"fail\",\"error\":\"" + String(_pBenchmarkError) + "\"}";
+    }
+    else
+    {
+        char jsonStr[300];
+        uint32_t bytesWritten = _benchmarkNumFiles * BENCHMARK_FILE_LEN;
+        snprintf(jsonStr, sizeof(jsonStr), "{\"rslt\":\"ok\",\"fsName\":\"%s\",\"backend\":\"%s\",\"numFiles\":%d,\"fileLen\":%d,"
+                    "\"writeKBPerSec\":%0.1f,\"listMs\":%0.2f,\"statUs\":%0.1f,\"readKBPerSec\":%0.1f,\"bytesRead\":%u}",
+                    _benchmarkFsName.c_str(), (_benchmarkFsName == "spiffs") ? _pFlashFs->getTypeName() : "fat",
+                    _benchmarkNumFiles, BENCHMARK_FILE_LEN,
+                    _benchmarkWriteUs ? bytesWritten * 1000000.0 / 1024 / _benchmarkWriteUs : 0,
+                    _benchmarkListUs / 1000.0 / BENCHMARK_REPEATS,
+                    float(_benchmarkStatUs) / BENCHMARK_REPEATS / _benchmarkNumFiles,
+                    _benchmarkReadUs ? _benchmarkBytesRead * 1000000.0 / 1024 / _benchmarkReadUs : 0,
+                    (unsigned)_benchmarkBytesRead);
+        resultStr = jsonStr;
+    }
+    Log.notice("%sbenchmark %s\n", MODULE_PREFIX, resultStr.c_str());
+    xSemaphoreTake(_benchmarkMutex, portMAX_DELAY);
+    _benchmarkResult = resultStr;
+    _benchmarkPhase.store(BENCHMARK_IDLE, std::memory_order_release);
+    xSemaphoreGive(_benchmarkMutex);
+    return false;
 }
 
 bool FileManager::getFileInfo(const String& fileSystemStr, const String& filename, int& fileLength)
@@ -167,26 +514,24 @@ bool FileManager::getFileInfo(const String& fileSystemStr, const String& filenam
         return false;
     }
 
-    // Take mutex
-    xSemaphoreTake(_fileSysMutex, portMAX_DELAY);
-
     // Check file exists
     struct stat st;
     String rootFilename = getFilePath(nameOfFS, filename);
-
-    if (stat(rootFilename.c_str(), &st) != 0)
+    int statRslt = 0;
+    runOnFsTask(FS_REQ_PLAYBACK, [&]() {
+        statRslt = stat(rootFilename.c_str(), &st);
+        return true;
+    });
+    if (statRslt != 0)
     {
-        xSemaphoreGive(_fileSysMutex);
         Log.trace("%sgetFileInfo %s cannot stat\n", MODULE_PREFIX, rootFilename.c_str());
         return false;
     }
     if (!S_ISREG(st.st_mode))
     {
-        xSemaphoreGive(_fileSysMutex);
         Log.trace("%sgetFileInfo %s is a folder\n", MODULE_PREFIX, rootFilename.c_str());
         return false;
     }
-    xSemaphoreGive(_fileSysMutex);
     fileLength = st.st_size;
     return true;
 }
@@ -201,31 +546,271 @@ bool FileManager::getFilesJSON(const String& fileSystemStr, const String& folder
         return false;
     }
 
-    // Check if cached version can be used
-    if ((_cachedFileListValid) && (_cachedFileListResponse.length() != 0))
+    // Check if cached version can be used (and note the generation so a list made while files
+    // change isn't cached)
+    String cacheKey = nameOfFS + ":" + folderStr;
+    xSemaphoreTake(_cachedFileListMutex, portMAX_DELAY);
+    bool cacheHit = _cachedFileListValid && (_pCachedFileList != NULL) && (_cachedFileListKey == cacheKey);
+    if (cacheHit)
+        respStr = _pCachedFileList;
+    uint32_t listGen = _fileListGen;
+    xSemaphoreGive(_cachedFileListMutex);
+    if (cacheHit)
+        return true;
+
+    // Listed a few entries per step on the worker task
+    FileListJob job;
+    fileListJobInit(job, nameOfFS, folderStr, listGen);
+    runOnFsTask(FS_REQ_LISTING, [this, &job]() {
+        return fileListJobStep(job);
+    });
+    fileListJobEnd(job);
+    respStr = job._respStr;
+    return job._rslt;
+}
+
+void FileManager::getFilesJSONAsync(const String& fileSystemStr, const String& folderStr, const FileListDoneFnType& doneFn)
+{
+    // Check file system supported
+    String nameOfFS;
+    if (!checkFileSystem(fileSystemStr, nameOfFS))
+    {
+        doneFn(false, "{\"rslt\":\"fail\",\"error\":\"unknownfs\",\"files\":[]}");
+        return;
+    }
+
+    // List directly if there is no worker
+    if (!_fsTaskHandle)
+    {
+        String respStr;
+        bool rslt = getFilesJSON(fileSystemStr, folderStr, respStr);
+        doneFn(rslt, respStr);
+        return;
+    }
+
+    // Use the cached version if possible - otherwise wait for the background listing (starting
+    // it if one isn't already running)
+    String cacheKey = nameOfFS + ":" + folderStr;
+    xSemaphoreTake(_cachedFileListMutex, portMAX_DELAY);
+    if (_cachedFileListValid && (_pCachedFileList != NULL) && (_cachedFileListKey == cacheKey))
+    {
+        String respStr = _pCachedFileList;
+        xSemaphoreGive(_cachedFileListMutex);
+        doneFn(true, respStr);
+        return;
+    }
+    FileListWaiter waiter;
+    waiter._nameOfFS = nameOfFS;
+    waiter._folder = folderStr;
+    waiter._cacheKey = cacheKey;
+    waiter._doneFn = doneFn;
+    _asyncFileListWaiters.push_back(waiter);
+    bool startJob = !_asyncFileListRunning.load(std::memory_order_acquire);
+    if (startJob)
     {
-        respStr = _cachedFileListResponse;
+        fileListJobInit(_asyncFileList, nameOfFS, folderStr, _fileListGen);
+        _asyncFileListRunning.store(true, std::memory_order_release);
+    }
+    xSemaphoreGive(_cachedFileListMutex);
+    if (startJob)
+        xSemaphoreGive(_fsWorkSem);
+}
+
+// Step of the background listing on the worker task - when done the callers waiting for the
+// folder are completed and the listing for the next caller (if any) started - returns true
+// while there is more to do
+bool FileManager::asyncFileListStep()
+{
+    if (!fileListJobStep(_asyncFileList))
         return true;
-        
+    fileListJobEnd(_asyncFileList);
+    bool rslt = _asyncFileList._rslt;
+    String respStr = _asyncFileList._respStr;
+    _asyncFileList._respStr = "";
+
+    // Callers for this folder are done
+    std::vector<FileListWaiter> doneWaiters;
+    xSemaphoreTake(_cachedFileListMutex, portMAX_DELAY);
+    for (auto it = _asyncFileListWaiters.begin(); it != _asyncFileListWaiters.end(); )
+    {
+        if (it->_cacheKey == _asyncFileList._cacheKey)
+        {
+            doneWaiters.push_back(*it);
+            it = _asyncFileListWaiters.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    bool moreToDo = !_asyncFileListWaiters.empty();
+    if (moreToDo)
+        fileListJobInit(_asyncFileList, _asyncFileListWaiters.front()._nameOfFS,
+                    _asyncFileListWaiters.front()._folder, _fileListGen);
+    else
+        _asyncFileListRunning.store(false, std::memory_order_release);
+    xSemaphoreGive(_cachedFileListMutex);
+    for (FileListWaiter& waiter : doneWaiters)
+        waiter._doneFn(rslt, respStr);
+    return moreToDo;
+}
+
+// Set up a listing
+void FileManager::fileListJobInit(FileListJob& job, const String& nameOfFS, const String& folderStr, uint32_t listGen)
+{
+    job._nameOfFS = nameOfFS;
+    job._folder = folderStr;
+    job._cacheKey = nameOfFS + ":" + folderStr;
+    job._listGen = listGen;
+    job._rootFolder = "";
+    job._baseFolder = getFsBaseFolder(nameOfFS);
+    job._pIndexFile = NULL;
+    job._indexRead = false;
+    job._indexPrefix = "";
+    job._fileIndex.clear();
+    job._entryFn = nullptr;
+    job._dir = NULL;
+    job._firstFile = true;
+    job._rslt = true;
+    job._respStr = "";
+}
+
+// Step of a listing on the worker task (with metadata from the file system's index) - returns
+// true when complete
+bool FileManager::fileListJobStep(FileListJob& job)
+{
+    if (!job._dir)
+    {
+        job._rslt = getFilesJSONStart(job._nameOfFS, job._folder, job._respStr, job._rootFolder, job._dir);
+        if (!job._rslt)
+            return true;
+
+        // Index keys of files in the folder start with its path in the file system
+        String folderPath = job._rootFolder.endsWith("/") ? job._rootFolder : job._rootFolder + "/";
+        job._indexPrefix = folderPath.substring(job._baseFolder.length() + 1);
+        fileIndexOpen(job._baseFolder, job._pIndexFile);
+        return false;
     }
-    // Take mutex
-    if (xSemaphoreTake(_fileSysMutex, 0) != pdTRUE)
+
+    // Read the index entries for the folder
+    if (job._pIndexFile && !job._indexRead)
     {
-        respStr = "{\"rslt\":\"fail\",\"error\":\"fsbusy\",\"files\":[]}";
+        job._indexRead = fileIndexReadStep(job);
         return false;
     }
 
+    // Read directory entries
+    for (int entryIdx = 0; entryIdx < LISTING_ENTRIES_PER_STEP; entryIdx++)
+    {
+        struct dirent* ent = readdir(job._dir);
+        if (!ent)
+        {
+            // Finished with file list
+            closedir(job._dir);
+            job._dir = NULL;
+            job._respStr += "]}";
+            return true;
+        }
+
+        // Check for unwanted files
+        String fName = ent->d_name;
+        if ((fName == ".") || (fName == ".."))
+            continue;
+        if (fName.equalsIgnoreCase("System Volume Information"))
+            continue;
+        if (fName.equalsIgnoreCase("thumbs.db"))
+            continue;
+        if (fName.equals(FILE_INDEX_NAME) || fName.equals(FILE_INDEX_TMP_NAME))
+            continue;
+
+        // Get file info including size
+        size_t fileSize = 0;
+        struct stat st;
+        String filePath = (job._rootFolder.endsWith("/") ? job._rootFolder + fName : job._rootFolder + "/" + fName);
+        if (stat(filePath.c_str(), &st) == 0) 
+        {
+            fileSize = st.st_size;
+        }
+
+        // Metadata is only valid for the file length it was made from
+        String metaJson;
+        auto indexIt = job._fileIndex.find(fName);
+        if ((indexIt != job._fileIndex.end()) && (indexIt->second._fileLength == (int)fileSize))
+        {
+            char lineBuf[FILE_INDEX_LINE_MAXLEN];
+            if ((fseek(job._pIndexFile, indexIt->second._metaPos, SEEK_SET) == 0) &&
+                        fileIndexReadLine(job._pIndexFile, lineBuf, sizeof(lineBuf)))
+                metaJson = lineBuf;
+        }
+        if (job._entryFn)
+        {
+            job._entryFn(fName, fileSize, metaJson);
+            continue;
+        }
+
+        // Form the JSON list
+        if (!job._firstFile)
+            job._respStr += ",";
+        job._firstFile = false;
+        job._respStr += "{\"name\":\"";
+        job._respStr += ent->d_name;
+        job._respStr += "\",\"size\":";
+        job._respStr += String(fileSize);
+        if (metaJson.length() > 0)
+        {
+            job._respStr += ",\"meta\":";
+            job._respStr += metaJson;
+        }
+        job._respStr += "}";
+    }
+    return false;
+}
+
+// Replenish the cache from a completed listing (unless files changed while it was made or the
+// entries went to an entry function)
+void FileManager::fileListJobEnd(FileListJob& job)
+{
+    if (job._pIndexFile)
+        fclose(job._pIndexFile);
+    job._pIndexFile = NULL;
+    job._fileIndex.clear();
+    if (!job._rslt || job._entryFn)
+        return;
+    xSemaphoreTake(_cachedFileListMutex, portMAX_DELAY);
+    if (job._listGen != _fileListGen)
+    {
+        xSemaphoreGive(_cachedFileListMutex);
+        return;
+    }
+    if (_cachedFileListSize < job._respStr.length() + 1)
+    {
+        MemRegions::free(MemRegions::SUBSYS_FILE_LIST, _pCachedFileList, _cachedFileListSize);
+        _cachedFileListSize = job._respStr.length() + 1;
+        _pCachedFileList = (char*)MemRegions::alloc(MemRegions::SUBSYS_FILE_LIST, _cachedFileListSize);
+        if (!_pCachedFileList)
+            _cachedFileListSize = 0;
+    }
+    if (_pCachedFileList)
+    {
+        memcpy(_pCachedFileList, job._respStr.c_str(), job._respStr.length() + 1);
+        _cachedFileListKey = job._cacheKey;
+        _cachedFileListValid = true;
+    }
+    xSemaphoreGive(_cachedFileListMutex);
+}
+
+// Start of a file listing (on the worker task) - gets the file system size and opens the folder
+bool FileManager::getFilesJSONStart(String& nameOfFS, const String& folderStr, String& respStr, String& rootFolder, DIR*& dir)
+{
     // Get size of file systems
     String baseFolderForFS;
     double fsSizeBytes = 0, fsUsedBytes = 0;
     if (nameOfFS == "spiffs")
     {
-        uint32_t sizeBytes = 0, usedBytes = 0;
-        esp_err_t ret = esp_spiffs_info(NULL, &sizeBytes, &usedBytes);
-        if (ret != ESP_OK)
+        size_t sizeBytes = 0, usedBytes = 0;
+        if (!_pFlashFs || !_pFlashFs->getInfo(sizeBytes, usedBytes))
         {
-            xSemaphoreGive(_fileSysMutex);
-            Log.warning("%sgetFilesJSON Failed to get SPIFFS info (error %s)\n", MODULE_PREFIX, esp_err_to_name(ret));
+            Log.warning("%sgetFilesJSON Failed to get SPIFFS info\n", MODULE_PREFIX);
             respStr = "{\"rslt\":\"fail\",\"error\":\"SPIFFSINFO\",\"files\":[]}";
             return false;
         }
@@ -233,7 +818,7 @@ bool FileManager::getFilesJSON(const String& fileSystemStr, const String& folder
         fsSizeBytes = sizeBytes;
         fsUsedBytes = usedBytes;
         nameOfFS = "spiffs";
-        baseFolderForFS = "/spiffs";
+        baseFolderForFS = getFsBaseFolder(nameOfFS);
     }
     else if (nameOfFS == "sd")
     {
@@ -256,7 +841,7 @@ bool FileManager::getFilesJSON(const String& fileSystemStr, const String& folder
         }
         // Set FS info
         nameOfFS = "sd";
-        baseFolderForFS = "/sd";
+        baseFolderForFS = getFsBaseFolder(nameOfFS);
     }
 
     // Check file system is valid
@@ -268,11 +853,10 @@ bool FileManager::getFilesJSON(const String& fileSystemStr, const String& folder
     }
 
     // Open directory
-    String rootFolder = (folderStr.startsWith("/") ? baseFolderForFS + folderStr : (baseFolderForFS + "/" + folderStr));
-    DIR* dir = opendir(rootFolder.c_str());
+    rootFolder = (folderStr.startsWith("/") ? baseFolderForFS + folderStr : (baseFolderForFS + "/" + folderStr));
+    dir = opendir(rootFolder.c_str());
     if (!dir)
     {
-        xSemaphoreGive(_fileSysMutex);
         Log.warning("%sgetFilesJSON Failed to open base folder %s\n", MODULE_PREFIX, rootFolder.c_str());
         respStr = "{\"rslt\":\"fail\",\"error\":\"nofolder\",\"files\":[]}";
         return false;
@@ -282,47 +866,6 @@ bool FileManager::getFilesJSON(const String& fileSystemStr, const String& folder
     respStr = "{\"rslt\":\"ok\",\"fsName\":\"" + nameOfFS + "\",\"fsBase\":\"" + baseFolderForFS + 
                 "\",\"diskSize\":" + String(fsSizeBytes) + ",\"diskUsed\":" + fsUsedBytes +
                 ",\"folder\":\"" + String(rootFolder) + "\",\"files\":[";
-    bool firstFile = true;
-
-    // Read directory entries
-    struct dirent* ent = NULL;
-    while ((ent = readdir(dir)) != NULL) 
-    {
-        // Check for unwanted files
-        String fName = ent->d_name;
-        if (fName.equalsIgnoreCase("System Volume Information"))
-            continue;
-        if (fName.equalsIgnoreCase("thumbs.db"))
-            continue;
-
-        // Get file info including size
-        size_t fileSize = 0;
-        struct stat st;
-        String filePath = (rootFolder.endsWith("/") ? rootFolder + fName : rootFolder + "/" + fName);
-        if (stat(filePath.c_str(), &st) == 0) 
-        {
-            fileSize = st.st_size;
-        }
-
-        // Form the JSON list
-        if (!firstFile)
-            respStr += ",";
-        firstFile = false;
-        respStr += "{\"name\":\"";
-        respStr += ent->d_name;
-        respStr += "\",\"size\":";
-        respStr += String(fileSize);
-        respStr += "}";
-    }
-
-    // Finished with file list
-    closedir(dir);
-    xSemaphoreGive(_fileSysMutex);
-
-    // Complete string and replenish cache
-    respStr += "]}";
-    _cachedFileListResponse = respStr;
-    _cachedFileListValid = true;
     return true;
 }
 
@@ -336,64 +879,60 @@ String FileManager::getFileContents(const String& fileSystemStr, const String& f
         return "";
     }
 
-    // Take mutex
-    xSemaphoreTake(_fileSysMutex, portMAX_DELAY);
-
-    // Get file info - to check length
+    // Read on the worker task
     String rootFilename = getFilePath(nameOfFS, filename);
-    struct stat st;
-    if (stat(rootFilename.c_str(), &st) != 0)
-    {
-        xSemaphoreGive(_fileSysMutex);
-        Log.trace("%sgetContents %s cannot stat\n", MODULE_PREFIX, rootFilename.c_str());
-        return "";
-    }
-    if (!S_ISREG(st.st_mode))
-    {
-        xSemaphoreGive(_fileSysMutex);
-        Log.trace("%sgetContents %s is a folder\n", MODULE_PREFIX, rootFilename.c_str());
-        return "";
-    }
-
-    // Check valid
-    if (maxLen <= 0)
-    {
-        maxLen = ESP.getFreeHeap() / 3;
-    }
-    if (st.st_size >= maxLen-1)
-    {
-        xSemaphoreGive(_fileSysMutex);
-        Log.trace("%sgetContents %s free heap %d size %d too big to read\n", MODULE_PREFIX, rootFilename.c_str(), maxLen, st.st_size);
-        return "";
-    }
-    int fileSize = st.st_size;
+    String readData;
+    runOnFsTask(FS_REQ_PLAYBACK, [&]() {
+        // Get file info - to check length
+        struct stat st;
+        if (stat(rootFilename.c_str(), &st) != 0)
+        {
+            Log.trace("%sgetContents %s cannot stat\n", MODULE_PREFIX, rootFilename.c_str());
+            return true;
+        }
+        if (!S_ISREG(st.st_mode))
+        {
+            Log.trace("%sgetContents %s is a folder\n", MODULE_PREFIX, rootFilename.c_str());
+            return true;
+        }
 
-    // Open file
-    FILE* pFile = fopen(rootFilename.c_str(), "rb");
-    if (!pFile)
-    {
-        xSemaphoreGive(_fileSysMutex);
-        Log.trace("%sgetContents failed to open file to read %s\n", MODULE_PREFIX, rootFilename.c_str());
-        return "";
-    }
+        // Check valid
+        if (maxLen <= 0)
+        {
+            maxLen = ESP.getFreeHeap() / 3;
+        }
+        if (st.st_size >= maxLen-1)
+        {
+            Log.trace("%sgetContents %s free heap %d size %d too big to read\n", MODULE_PREFIX, rootFilename.c_str(), maxLen, st.st_size);
+            return true;
+        }
+        int fileSize = st.st_size;
 
-    // Buffer
-    uint8_t* pBuf = new uint8_t[fileSize+1];
-    if (!pBuf)
-    {
-        fclose(pFile);
-        xSemaphoreGive(_fileSysMutex);
-        Log.trace("%sgetContents failed to allocate %d\n", MODULE_PREFIX, fileSize);
-        return "";
-    }
+        // Open file
+        FILE* pFile = fopen(rootFilename.c_str(), "rb");
+        if (!pFile)
+        {
+            Log.trace("%sgetContents failed to open file to read %s\n", MODULE_PREFIX, rootFilename.c_str());
+            return true;
+        }
 
-    // Read
-    size_t bytesRead = fread((char*)pBuf, 1, fileSize, pFile);
-    fclose(pFile);
-    xSemaphoreGive(_fileSysMutex);
-    pBuf[bytesRead] = 0;
-    String readData = (char*)pBuf;
-    delete [] pBuf;
+        // Buffer
+        uint8_t* pBuf = new uint8_t[fileSize+1];
+        if (!pBuf)
+        {
+            fclose(pFile);
+            Log.trace("%sgetContents failed to allocate %d\n", MODULE_PREFIX, fileSize);
+            return true;
+        }
+
+        // Read
+        size_t bytesRead = fread((char*)pBuf, 1, fileSize, pFile);
+        fclose(pFile);
+        pBuf[bytesRead] = 0;
+        readData = (char*)pBuf;
+        delete [] pBuf;
+        return true;
+    });
     return readData;
 }
 
@@ -406,36 +945,41 @@ bool FileManager::setFileContents(const String& fileSystemStr, const String& fil
         return false;
     }
 
-    // Take mutex
-    xSemaphoreTake(_fileSysMutex, portMAX_DELAY);
-
-    // Open file for writing
+    // Write on the worker task
     String rootFilename = getFilePath(nameOfFS, filename);
-    FILE* pFile = fopen(rootFilename.c_str(), "wb");
-    if (!pFile)
-    {
-        xSemaphoreGive(_fileSysMutex);
-        Log.trace("%ssetContents failed to open file to write %s\n", MODULE_PREFIX, rootFilename.c_str());
-        return "";
-    }
+    bool rslt = false;
+    runOnFsTask(FS_REQ_UPLOAD, [&]() {
+        // Prefetched data is stale
+        prefetchDiscard(&rootFilename);
+
+        // Open file for writing
+        FILE* pFile = fopen(rootFilename.c_str(), "wb");
+        if (!pFile)
+        {
+            Log.trace("%ssetContents failed to open file to write %s\n", MODULE_PREFIX, rootFilename.c_str());
+            return true;
+        }
 
-    // Write
-    size_t bytesWritten = fwrite((uint8_t*)(fileContents.c_str()), 1, fileContents.length(), pFile);
-    fclose(pFile);
+        // Write
+        size_t bytesWritten = fwrite((uint8_t*)(fileContents.c_str()), 1, fileContents.length(), pFile);
+        fclose(pFile);
+        rslt = bytesWritten == fileContents.length();
+        fileIndexRemove(rootFilename);
+        return true;
+    });
 
     // Clean up
-    _cachedFileListValid = false;
-    xSemaphoreGive(_fileSysMutex);
-    return bytesWritten == fileContents.length();
+    fileListChanged();
+    return rslt;
 }
 
 void FileManager::uploadAPIBlocksComplete()
 {
     // Cached file list now invalid
-    _cachedFileListValid = false;
+    fileListChanged();
 }
 
-void FileManager::uploadAPIBlockHandler(const char* fileSystem, const String& req, const String& filename, 
+void FileManager::uploadAPIBlockHandler(const char* fileSystem, const String& /* req */, const String& filename, 
                     int fileLength, size_t index, uint8_t *data, size_t len, bool finalBlock)
 {
     Log.trace("%suploadAPIBlockHandler fileSys %s, filename %s, total %d, idx %d, len %d, final %d\n", MODULE_PREFIX, 
@@ -446,53 +990,52 @@ void FileManager::uploadAPIBlockHandler(const char* fileSystem, const String& re
     if (!checkFileSystem(String(fileSystem), nameOfFS))
         return;
 
-    // Take mutex
-    xSemaphoreTake(_fileSysMutex, portMAX_DELAY);
+    // Write on the worker task
     String tempFileName = "/__tmp__";
     String tmpRootFilename = getFilePath(nameOfFS, tempFileName);
-    FILE* pFile = NULL;
-
-    // Check if we should overwrite or append
-    if (index > 0)
-        pFile = fopen(tmpRootFilename.c_str(), "ab");
-    else
-        pFile = fopen(tmpRootFilename.c_str(), "wb");
-    if (!pFile)
-    {
-        xSemaphoreGive(_fileSysMutex);
-        Log.trace("%suploadBlock failed to open file to write %s\n", MODULE_PREFIX, tmpRootFilename.c_str());
-        return;
-    }
-
-    // Write file block to temporary file
-    size_t bytesWritten = fwrite(data, 1, len, pFile);
-    fclose(pFile);
-    if (bytesWritten != len)
-    {
-        Log.trace("%suploadBlock write failed %s (written %d != len %d)\n", MODULE_PREFIX, tmpRootFilename.c_str(), bytesWritten, len);
-    }
-
-    // Rename if last block
-    if (finalBlock)
-    {
-        // Check if destination file exists before renaming
-        struct stat st;
-        String rootFilename = getFilePath(nameOfFS, filename);
-        if (stat(rootFilename.c_str(), &st) == 0) 
+    runOnFsTask(FS_REQ_UPLOAD, [&]() {
+        // Check if we should overwrite or append
+        FILE* pFile = NULL;
+        if (index > 0)
+            pFile = fopen(tmpRootFilename.c_str(), "ab");
+        else
+            pFile = fopen(tmpRootFilename.c_str(), "wb");
+        if (!pFile)
         {
-            // Remove in case filename already exists
-            unlink(rootFilename.c_str());
+            Log.trace("%suploadBlock failed to open file to write %s\n", MODULE_PREFIX, tmpRootFilename.c_str());
+            return true;
         }
 
-        // Rename
-        if (rename(tmpRootFilename.c_str(), rootFilename.c_str()) != 0)
+        // Write file block to temporary file
+        size_t bytesWritten = fwrite(data, 1, len, pFile);
+        fclose(pFile);
+        if (bytesWritten != len)
         {
-            Log.trace("%sfailed rename %s to %s\n", MODULE_PREFIX, tmpRootFilename.c_str(), rootFilename.c_str());
+            Log.trace("%suploadBlock write failed %s (written %d != len %d)\n", MODULE_PREFIX, tmpRootFilename.c_str(), bytesWritten, len);
         }
-    }
 
-    // Restore semaphore
-    xSemaphoreGive(_fileSysMutex);
+        // Rename if last block
+        if (finalBlock)
+        {
+            // Check if destination file exists before renaming
+            struct stat st;
+            String rootFilename = getFilePath(nameOfFS, filename);
+            if (stat(rootFilename.c_str(), &st) == 0) 
+            {
+                // Remove in case filename already exists
+                unlink(rootFilename.c_str());
+            }
+            prefetchDiscard(&rootFilename);
+            fileIndexRemove(rootFilename);
+
+            // Rename
+            if (rename(tmpRootFilename.c_str(), rootFilename.c_str()) != 0)
+            {
+                Log.trace("%sfailed rename %s to %s\n", MODULE_PREFIX, tmpRootFilename.c_str(), rootFilename.c_str());
+            }
+        }
+        return true;
+    });
 }
 
 bool FileManager::deleteFile(const String& fileSystemStr, const String& filename)
@@ -504,19 +1047,20 @@ bool FileManager::deleteFile(const String& fileSystemStr, const String& filename
         return false;
     }
     
-    // Take mutex
-    xSemaphoreTake(_fileSysMutex, portMAX_DELAY);
-
-    // Remove file
-    struct stat st;
+    // Remove file on the worker task
     String rootFilename = getFilePath(nameOfFS, filename);
-    if (stat(rootFilename.c_str(), &st) == 0) 
-    {
-        unlink(rootFilename.c_str());
-    }
+    runOnFsTask(FS_REQ_UPLOAD, [this, &rootFilename]() {
+        prefetchDiscard(&rootFilename);
+        struct stat st;
+        if (stat(rootFilename.c_str(), &st) == 0) 
+        {
+            unlink(rootFilename.c_str());
+        }
+        fileIndexRemove(rootFilename);
+        return true;
+    });
 
-    _cachedFileListValid = false;
-    xSemaphoreGive(_fileSysMutex);   
+    fileListChanged();
     return true;
 }
 
@@ -529,28 +1073,59 @@ bool FileManager::chunkedFileStart(const String& fileSystemStr, const String& fi
         return false;
     }
 
-    // Take mutex
-    xSemaphoreTake(_fileSysMutex, portMAX_DELAY);
+    // Buffer for chunks
+    if (!_pChunkedFileBuffer)
+    {
+        _pChunkedFileBuffer = (uint8_t*)MemRegions::alloc(MemRegions::SUBSYS_FILE_CHUNK, CHUNKED_BUF_MAXLEN);
+        if (!_pChunkedFileBuffer)
+            return false;
+    }
 
-    // Check file exists
-    struct stat st;
+    // Check file exists (length already known if it has been prefetched)
     String rootFilename = getFilePath(nameOfFS, filename);
-    if ((stat(rootFilename.c_str(), &st) != 0) || !S_ISREG(st.st_mode))
+    int fileLen = -1;
+    runOnFsTask(FS_REQ_PLAYBACK, [&]() {
+        int bufIdx = prefetchFind(rootFilename);
+        if ((bufIdx >= 0) && (_prefetchBufs[bufIdx]._fileLen >= 0))
+        {
+            fileLen = _prefetchBufs[bufIdx]._fileLen;
+            return true;
+        }
+        struct stat st;
+        if ((stat(rootFilename.c_str(), &st) == 0) && S_ISREG(st.st_mode))
+            fileLen = st.st_size;
+        return true;
+    });
+    if (fileLen < 0)
     {
         Log.trace("%schunked file doesn't exist %s\n", MODULE_PREFIX, rootFilename.c_str());
-        xSemaphoreGive(_fileSysMutex);
         return false;
     }
-    _chunkedFileLen = st.st_size;
-    xSemaphoreGive(_fileSysMutex);  
-    
+    _chunkedFileLen = fileLen;
+
+    // Compressed files are decoded when read by line (otherwise the compressed data is read)
+    String filenameStr = filename;
+    _chunkedFileCompressed = readByLine && isCompressedFile(filenameStr);
+    if (_chunkedFileCompressed)
+    {
+        if (!_pDecodeBuf)
+        {
+            _pDecodeBuf = (uint8_t*)MemRegions::alloc(MemRegions::SUBSYS_FILE_CHUNK, DECODE_IN_BUF_LEN + DECODE_OUT_BUF_LEN);
+            if (!_pDecodeBuf)
+                return false;
+        }
+        _chunkDecoder.reset();
+        _decodeInPos = _decodeInLen = 0;
+        _decodeOutPos = _decodeOutLen = 0;
+    }
+
     // Setup access
     _chunkedFilename = rootFilename;
     _chunkedFileInProgress = true;
     _chunkedFilePos = 0;
     _chunkOnLineEndings = readByLine;
-    Log.trace("%schunkedFileStart filename %s size %d byLine %s\n", MODULE_PREFIX, 
-            rootFilename.c_str(), _chunkedFileLen, (readByLine ? "Y" : "N"));
+    Log.trace("%schunkedFileStart filename %s size %d byLine %s compressed %s\n", MODULE_PREFIX, 
+            rootFilename.c_str(), _chunkedFileLen, (readByLine ? "Y" : "N"), (_chunkedFileCompressed ? "Y" : "N"));
     return true; 
 }
 
@@ -594,8 +1169,48 @@ uint8_t* FileManager::chunkFileNext(String& filename, int& fileLen, int& chunkPo
     fileLen = _chunkedFileLen;
     chunkPos = _chunkedFilePos;
 
-    // Take mutex
-    xSemaphoreTake(_fileSysMutex, portMAX_DELAY);
+    // Read on the worker task (only this and one reference captured so the request doesn't
+    // need an allocation)
+    struct {
+        int chunkLen;
+        bool finalChunk;
+        bool readOk;
+    } chunkRslt = { 0, finalChunk, false };
+    runOnFsTask(FS_REQ_PLAYBACK, [this, &chunkRslt]() {
+        chunkRslt.readOk = chunkFileNextFs(chunkRslt.chunkLen, chunkRslt.finalChunk);
+        return true;
+    });
+    chunkLen = chunkRslt.chunkLen;
+    finalChunk = chunkRslt.finalChunk;
+    return chunkRslt.readOk ? _pChunkedFileBuffer : NULL;
+}
+
+bool FileManager::chunkFileNextFs(int& chunkLen, bool& finalChunk)
+{
+    // Compressed file
+    if (_chunkedFileCompressed)
+        return chunkFileNextCompressed(chunkLen, finalChunk);
+
+    // Lines in the prefetched start of the file don't need the file system
+    int prefetchIdx = _chunkOnLineEndings ? prefetchFind(_chunkedFilename) : -1;
+    if (prefetchIdx >= 0)
+    {
+        bool endOfFile = false;
+        if (prefetchReadLine(_prefetchBufs[prefetchIdx], (char*)_pChunkedFileBuffer, CHUNKED_BUF_MAXLEN-1, 
+                        _chunkedFilePos, endOfFile))
+        {
+            if (endOfFile)
+            {
+                finalChunk = true;
+                _chunkedFileInProgress = false;
+            }
+            else
+            {
+                chunkLen = strlen((char*)_pChunkedFileBuffer);
+            }
+            return true;
+        }
+    }
 
     // Open file and seek
     FILE* pFile = NULL;
@@ -605,24 +1220,22 @@ uint8_t* FileManager::chunkFileNext(String& filename, int& fileLen, int& chunkPo
         pFile = fopen(_chunkedFilename.c_str(), "rb");
     if (!pFile)
     {
-            xSemaphoreGive(_fileSysMutex);  
-            Log.trace("%schunkNext failed open %s\n", MODULE_PREFIX, _chunkedFilename.c_str());
-            return NULL;
-    }    
+        Log.trace("%schunkNext failed open %s\n", MODULE_PREFIX, _chunkedFilename.c_str());
+        return false;
+    }
     if ((_chunkedFilePos != 0) && (fseek(pFile, _chunkedFilePos, SEEK_SET) != 0))
     {
-        xSemaphoreGive(_fileSysMutex);  
         Log.trace("%schunkNext failed seek in filename %s to %d\n", MODULE_PREFIX, 
                         _chunkedFilename.c_str(), _chunkedFilePos);
         fclose(pFile);
-        return NULL;
+        return false;
     }
 
     // Handle data type
     if (_chunkOnLineEndings)
     {
         // Read a line
-        char* pReadLine = readLineFromFile((char*)_chunkedFileBuffer, CHUNKED_BUF_MAXLEN-1, pFile);
+        char* pReadLine = readLineFromFile((char*)_pChunkedFileBuffer, CHUNKED_BUF_MAXLEN-1, pFile);
         // Ensure line is terminated
         if (!pReadLine)
         {
@@ -632,7 +1245,7 @@ uint8_t* FileManager::chunkFileNext(String& filename, int& fileLen, int& chunkPo
         }
         else
         {
-            chunkLen = strlen((char*)_chunkedFileBuffer);
+            chunkLen = strlen((char*)_pChunkedFileBuffer);
         }
         // Record position
         _chunkedFilePos = ftell(pFile);
@@ -640,7 +1253,7 @@ uint8_t* FileManager::chunkFileNext(String& filename, int& fileLen, int& chunkPo
     else
     {
         // Fill the buffer with file data
-        chunkLen = fread((char*)_chunkedFileBuffer, 1, CHUNKED_BUF_MAXLEN, pFile);
+        chunkLen = fread((char*)_pChunkedFileBuffer, 1, CHUNKED_BUF_MAXLEN, pFile);
 
         // Record position and check if this was the final block
         _chunkedFilePos = ftell(pFile);
@@ -658,8 +1271,244 @@ uint8_t* FileManager::chunkFileNext(String& filename, int& fileLen, int& chunkPo
 
     // Close
     fclose(pFile);
-    xSemaphoreGive(_fileSysMutex);  
-    return _chunkedFileBuffer;
+    return true;
+}
+
+// Read a line from a compressed file in the same way as readLineFromFile (on the worker task)
+bool FileManager::chunkFileNextCompressed(int& chunkLen, bool& finalChunk)
+{
+    char* pLine = (char*)_pChunkedFileBuffer;
+    int maxLen = CHUNKED_BUF_MAXLEN-1;
+    pLine[0] = 0;
+    int curLen = 0;
+    while (true)
+    {
+        if (curLen >= maxLen-1)
+            break;
+        int ch = decodeGetByte();
+        if (ch == DECODE_READ_FAILED)
+            return false;
+        if (ch == DECODE_END)
+        {
+            if (curLen != 0)
+                break;
+            finalChunk = true;
+            _chunkedFileInProgress = false;
+            break;
+        }
+        if (ch == '\n')
+            break;
+        if (ch == '\r')
+            continue;
+        pLine[curLen++] = ch;
+        pLine[curLen] = 0;
+    }
+    chunkLen = curLen;
+    Log.verbose("%schunkNext compressed filename %s chunklen %d filePos %d fileLen %d final %d\n", MODULE_PREFIX, 
+                    _chunkedFilename.c_str(), chunkLen, _chunkedFilePos, _chunkedFileLen, finalChunk);
+    return true;
+}
+
+// Next decoded byte of a compressed file - compressed data comes from the prefetch buffer
+// if it is there, otherwise from the file
+int FileManager::decodeGetByte()
+{
+    uint8_t* pDecodeIn = _pDecodeBuf;
+    uint8_t* pDecodeOut = _pDecodeBuf + DECODE_IN_BUF_LEN;
+    while (_decodeOutPos >= _decodeOutLen)
+    {
+        // Decode what has been read (a back-reference can continue without more input)
+        size_t inUsed = 0;
+        _decodeOutLen = _chunkDecoder.decode(pDecodeIn + _decodeInPos, _decodeInLen - _decodeInPos, inUsed,
+                        pDecodeOut, DECODE_OUT_BUF_LEN);
+        _decodeInPos += inUsed;
+        _decodeOutPos = 0;
+        if (_decodeOutLen > 0)
+            break;
+
+        // Read the next block of compressed data
+        if (_chunkedFilePos >= _chunkedFileLen)
+            return DECODE_END;
+        int toRead = _chunkedFileLen - _chunkedFilePos;
+        if (toRead > DECODE_IN_BUF_LEN)
+            toRead = DECODE_IN_BUF_LEN;
+        int prefetchIdx = prefetchFind(_chunkedFilename);
+        if ((prefetchIdx >= 0) && (_chunkedFilePos + toRead <= _prefetchBufs[prefetchIdx]._len))
+        {
+            memcpy(pDecodeIn, _prefetchBufs[prefetchIdx]._pBuf + _chunkedFilePos, toRead);
+        }
+        else
+        {
+            FILE* pFile = fopen(_chunkedFilename.c_str(), "rb");
+            if (!pFile)
+            {
+                Log.trace("%schunkNext failed open %s\n", MODULE_PREFIX, _chunkedFilename.c_str());
+                return DECODE_READ_FAILED;
+            }
+            if ((_chunkedFilePos != 0) && (fseek(pFile, _chunkedFilePos, SEEK_SET) != 0))
+            {
+                Log.trace("%schunkNext failed seek in filename %s to %d\n", MODULE_PREFIX, 
+                                _chunkedFilename.c_str(), _chunkedFilePos);
+                fclose(pFile);
+                return DECODE_READ_FAILED;
+            }
+            toRead = fread((char*)pDecodeIn, 1, toRead, pFile);
+            fclose(pFile);
+            if (toRead <= 0)
+                return DECODE_END;
+        }
+        _chunkedFilePos += toRead;
+        _decodeInPos = 0;
+        _decodeInLen = toRead;
+    }
+    return pDecodeOut[_decodeOutPos++];
+}
+
+void FileManager::chunkedFilePrefetch(const String& fileSystemStr, const String& filename)
+{
+    // Only done in the background
+    if (!_fsTaskHandle)
+        return;
+    String nameOfFS;
+    if (!checkFileSystem(fileSystemStr, nameOfFS))
+        return;
+
+    // Record the file - the worker reads it when it has no requests
+    String rootFilename = getFilePath(nameOfFS, filename);
+    runOnFsTask(FS_REQ_PLAYBACK, [&]() {
+        int foundIdx = prefetchFind(rootFilename);
+        if (foundIdx >= 0)
+        {
+            _prefetchLastIdx = foundIdx;
+            return true;
+        }
+
+        // Only one file is read at a time
+        bool wasFilling = _prefetchFillIdx >= 0;
+        prefetchEndFill();
+
+        // Buffers are used in turn so the previously announced file (which is about to be
+        // played or is playing) is kept
+        int bufIdx = (_prefetchLastIdx + 1) % PREFETCH_NUM_BUFS;
+        _prefetchLastIdx = bufIdx;
+        PrefetchBuf& prefetchBuf = _prefetchBufs[bufIdx];
+        prefetchBuf._filename = rootFilename;
+        prefetchBuf._fileLen = -1;
+        prefetchBuf._len = 0;
+        _prefetchFillIdx = bufIdx;
+        if (!wasFilling)
+            xSemaphoreGive(_fsWorkSem);
+        return true;
+    });
+}
+
+// Step of reading the start of a file into a prefetch buffer (on the worker task) - returns true
+// when done
+bool FileManager::prefetchStep()
+{
+    PrefetchBuf& prefetchBuf = _prefetchBufs[_prefetchFillIdx];
+
+    // Check the file and open on the first step
+    if (!_pPrefetchFile)
+    {
+        if (!prefetchBuf._pBuf)
+            prefetchBuf._pBuf = (uint8_t*)MemRegions::alloc(MemRegions::SUBSYS_FILE_PREFETCH, PREFETCH_BUF_MAXLEN);
+        struct stat st;
+        if (prefetchBuf._pBuf && (stat(prefetchBuf._filename.c_str(), &st) == 0) && S_ISREG(st.st_mode))
+            _pPrefetchFile = fopen(prefetchBuf._filename.c_str(), "rb");
+        if (!_pPrefetchFile)
+        {
+            Log.verbose("%sprefetch %s not readable\n", MODULE_PREFIX, prefetchBuf._filename.c_str());
+            prefetchBuf._filename = "";
+            _prefetchFillIdx = -1;
+            return true;
+        }
+        prefetchBuf._fileLen = st.st_size;
+        return false;
+    }
+
+    // Read the next part
+    int toRead = PREFETCH_BUF_MAXLEN - prefetchBuf._len;
+    if (toRead > PREFETCH_BYTES_PER_STEP)
+        toRead = PREFETCH_BYTES_PER_STEP;
+    int bytesRead = fread((char*)prefetchBuf._pBuf + prefetchBuf._len, 1, toRead, _pPrefetchFile);
+    prefetchBuf._len += bytesRead;
+    if ((bytesRead == toRead) && (prefetchBuf._len < PREFETCH_BUF_MAXLEN) && (prefetchBuf._len < prefetchBuf._fileLen))
+        return false;
+
+    // Done (if the read was short the rest of the file is read as normal)
+    Log.trace("%sprefetch %s read %d of %d\n", MODULE_PREFIX, prefetchBuf._filename.c_str(), 
+                    prefetchBuf._len, prefetchBuf._fileLen);
+    prefetchEndFill();
+    return true;
+}
+
+// Stop filling a prefetch buffer - what has been read so far is kept
+void FileManager::prefetchEndFill()
+{
+    if (_pPrefetchFile)
+        fclose(_pPrefetchFile);
+    _pPrefetchFile = NULL;
+    _prefetchFillIdx = -1;
+}
+
+// Discard prefetched data for a file (or for all files if NULL)
+void FileManager::prefetchDiscard(const String* pRootFilename)
+{
+    for (int bufIdx = 0; bufIdx < PREFETCH_NUM_BUFS; bufIdx++)
+    {
+        PrefetchBuf& prefetchBuf = _prefetchBufs[bufIdx];
+        if (pRootFilename && (prefetchBuf._filename != *pRootFilename))
+            continue;
+        if (bufIdx == _prefetchFillIdx)
+            prefetchEndFill();
+        prefetchBuf._filename = "";
+        prefetchBuf._fileLen = -1;
+        prefetchBuf._len = 0;
+    }
+}
+
+int FileManager::prefetchFind(const String& rootFilename)
+{
+    if (rootFilename.length() == 0)
+        return -1;
+    for (int bufIdx = 0; bufIdx < PREFETCH_NUM_BUFS; bufIdx++)
+        if (_prefetchBufs[bufIdx]._filename == rootFilename)
+            return bufIdx;
+    return -1;
+}
+
+// Read a line from a prefetch buffer in the same way as readLineFromFile - returns false if the
+// line isn't all in the buffer
+bool FileManager::prefetchReadLine(PrefetchBuf& prefetchBuf, char* pBuf, int maxLen, int& filePos, bool& endOfFile)
+{
+    if (prefetchBuf._fileLen < 0)
+        return false;
+    bool bufHasEnd = prefetchBuf._len >= prefetchBuf._fileLen;
+    pBuf[0] = 0;
+    int curLen = 0;
+    int bufPos = filePos;
+    while (true)
+    {
+        if (curLen >= maxLen-1)
+            break;
+        if (bufPos >= prefetchBuf._len)
+        {
+            if (!bufHasEnd)
+                return false;
+            endOfFile = (curLen == 0);
+            break;
+        }
+        char ch = prefetchBuf._pBuf[bufPos++];
+        if (ch == '\n')
+            break;
+        if (ch == '\r')
+            continue;
+        pBuf[curLen++] = ch;
+        pBuf[curLen] = 0;
+    }
+    filePos = bufPos;
+    return true;
 }
 
 // Get file name extension
@@ -674,6 +1523,18 @@ String FileManager::getFileExtension(String& fileName)
     return fileName.substring(dotPos+1);
 }
 
+bool FileManager::isCompressedFile(String& filename)
+{
+    return getFileExtension(filename).equalsIgnoreCase("hs");
+}
+
+String FileManager::getUncompressedName(String& filename)
+{
+    if (!isCompressedFile(filename))
+        return filename;
+    return filename.substring(0, filename.lastIndexOf('.'));
+}
+
 // Get file system and check ok
 bool FileManager::checkFileSystem(const String& fileSystemStr, String& fsName)
 {
@@ -711,7 +1572,273 @@ bool FileManager::checkFileSystem(const String& fileSystemStr, String& fsName)
 String FileManager::getFilePath(const String& nameOfFS, const String& filename)
 {
     // Check if filename already contains file system
+    String rootFilename;
     if ((filename.indexOf("spiffs/") >= 0) || (filename.indexOf("sd/") >= 0))
-        return (filename.startsWith("/") ? filename : ("/" + filename));
-    return (filename.startsWith("/") ? "/" + nameOfFS + filename : ("/" + nameOfFS + "/" + filename));
+        rootFilename = (filename.startsWith("/") ? filename : ("/" + filename));
+    else
+        rootFilename = (filename.startsWith("/") ? "/" + nameOfFS + filename : ("/" + nameOfFS + "/" + filename));
+
+    // Flash file system backends on the host are mounted elsewhere
+    String flashFsPrefix = String(FLASH_FS_BASE_PATH) + "/";
+    if (_pFlashFs && rootFilename.startsWith(flashFsPrefix) && (_pFlashFs->getMountPath() != FLASH_FS_BASE_PATH))
+        rootFilename = _pFlashFs->getMountPath() + rootFilename.substring(flashFsPrefix.length() - 1);
+    return rootFilename;
+}
+
+String FileManager::getFsBaseFolder(const String& nameOfFS)
+{
+    if (nameOfFS == "sd")
+        return "/sd";
+    return _pFlashFs ? _pFlashFs->getMountPath() : String(FLASH_FS_BASE_PATH);
+}
+
+bool FileManager::getFileIndexKey(const String& rootFilename, String& baseFolder, String& key)
+{
+    // Path within the file system that holds the file
+    const char* fsNames[] = { "spiffs", "sd" };
+    for (const char* pFsName : fsNames)
+    {
+        baseFolder = getFsBaseFolder(pFsName);
+        if (rootFilename.startsWith(baseFolder + "/"))
+        {
+            key = rootFilename.substring(baseFolder.length() + 1);
+            return key.length() > 0;
+        }
+    }
+    return false;
+}
+
+bool FileManager::setFileMeta(const String& fileSystemStr, const String& filename, int fileLength, const String& metaJson)
+{
+    // Check file system supported
+    String nameOfFS;
+    if (!checkFileSystem(fileSystemStr, nameOfFS))
+        return false;
+    String baseFolder, key;
+    if (!getFileIndexKey(getFilePath(nameOfFS, filename), baseFolder, key))
+        return false;
+
+    // Replace the file's line in the index
+    String indexLine = key + "\t" + String(fileLength) + "\t" + metaJson + "\n";
+    if ((int)indexLine.length() >= FILE_INDEX_LINE_MAXLEN)
+        return false;
+    bool rslt = false;
+    runOnFsTask(FS_REQ_UPLOAD, [&]() {
+        rslt = fileIndexUpdate(baseFolder, key, &indexLine);
+        return true;
+    });
+    if (rslt)
+        fileListInvalidate();
+    return rslt;
+}
+
+bool FileManager::readFileBlock(const String& fileSystemStr, const String& filename, int filePos, 
+                uint8_t* pBuf, int maxLen, int& readLen)
+{
+    // Check file system supported
+    readLen = 0;
+    String nameOfFS;
+    if (!checkFileSystem(fileSystemStr, nameOfFS))
+        return false;
+
+    // Read at the lowest priority
+    String rootFilename = getFilePath(nameOfFS, filename);
+    bool rslt = false;
+    runOnFsTask(FS_REQ_LISTING, [&]() {
+        FILE* pFile = fopen(rootFilename.c_str(), "rb");
+        if (!pFile)
+            return true;
+        if (fseek(pFile, filePos, SEEK_SET) == 0)
+        {
+            readLen = fread(pBuf, 1, maxLen, pFile);
+            rslt = true;
+        }
+        fclose(pFile);
+        return true;
+    });
+    return rslt;
+}
+
+// Open the index for reading (pFile is NULL if there is no index) - returns false if it exists
+// but can't be read
+bool FileManager::fileIndexOpen(const String& baseFolder, FILE*& pFile)
+{
+    pFile = NULL;
+    String indexFilename = baseFolder + "/" + FILE_INDEX_NAME;
+    String tmpFilename = baseFolder + "/" + FILE_INDEX_TMP_NAME;
+    struct stat st;
+    if (stat(indexFilename.c_str(), &st) != 0)
+    {
+        // An update stopped between removing the index and renaming the temporary file
+        if (stat(tmpFilename.c_str(), &st) != 0)
+            return true;
+        if (rename(tmpFilename.c_str(), indexFilename.c_str()) != 0)
+        {
+            Log.warning("%sfileIndexOpen can't restore %s\n", MODULE_PREFIX, indexFilename.c_str());
+            return false;
+        }
+    }
+    pFile = fopen(indexFilename.c_str(), "rb");
+    if (!pFile)
+    {
+        Log.warning("%sfileIndexOpen can't read %s\n", MODULE_PREFIX, indexFilename.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Read a line of the index without the line ending - lines that don't fit in the buffer (which
+// setFileMeta doesn't write) are skipped - returns false at the end of the file or on error
+bool FileManager::fileIndexReadLine(FILE* pFile, char* pBuf, int bufLen)
+{
+    while (fgets(pBuf, bufLen, pFile))
+    {
+        int lineLen = strlen(pBuf);
+        if ((lineLen > 0) && (pBuf[lineLen - 1] == '\n'))
+        {
+            pBuf[lineLen - 1] = 0;
+            return true;
+        }
+        if (feof(pFile))
+            return true;
+        int ch = 0;
+        while ((ch = fgetc(pFile)) != EOF)
+            if (ch == '\n')
+                break;
+    }
+    return false;
+}
+
+// Split a line of the index in place - lines are key<tab>fileLength<tab>metaJson
+bool FileManager::fileIndexParseLine(char* pLine, const char*& pKey, int& fileLength, const char*& pMetaJson)
+{
+    char* pLenStr = strchr(pLine, '\t');
+    if (!pLenStr)
+        return false;
+    *pLenStr++ = 0;
+    char* pMetaStr = strchr(pLenStr, '\t');
+    if (!pMetaStr)
+        return false;
+    *pMetaStr++ = 0;
+    pKey = pLine;
+    fileLength = atoi(pLenStr);
+    pMetaJson = pMetaStr;
+    return true;
+}
+
+// Read a few lines of the index keeping the entries for files in the folder being listed -
+// returns true when the whole index has been read
+bool FileManager::fileIndexReadStep(FileListJob& job)
+{
+    char lineBuf[FILE_INDEX_LINE_MAXLEN];
+    for (int lineIdx = 0; lineIdx < FILE_INDEX_LINES_PER_STEP; lineIdx++)
+    {
+        long linePos = ftell(job._pIndexFile);
+        if (!fileIndexReadLine(job._pIndexFile, lineBuf, sizeof(lineBuf)))
+        {
+            if (ferror(job._pIndexFile))
+                Log.warning("%sfileIndexReadStep failed to read index in %s\n", MODULE_PREFIX, job._baseFolder.c_str());
+            return true;
+        }
+        const char* pKey = NULL;
+        const char* pMetaJson = NULL;
+        int fileLength = 0;
+        if (!fileIndexParseLine(lineBuf, pKey, fileLength, pMetaJson))
+            continue;
+        if (strncmp(pKey, job._indexPrefix.c_str(), job._indexPrefix.length()) != 0)
+            continue;
+        const char* pName = pKey + job._indexPrefix.length();
+        if (strchr(pName, '/'))
+            continue;
+        FileIndexEntry& entry = job._fileIndex[pName];
+        entry._fileLength = fileLength;
+        entry._metaPos = linePos + (pMetaJson - lineBuf);
+    }
+    return false;
+}
+
+bool FileManager::fileIndexUpdate(const String& baseFolder, const String& key, const String* pNewLine)
+{
+    // The index is left as it is if it can't be read
+    FILE* pIndexFile = NULL;
+    if (!fileIndexOpen(baseFolder, pIndexFile))
+        return false;
+    if (!pIndexFile && !pNewLine)
+        return true;
+
+    // Copy to the temporary file without the file's line (and with the new line)
+    String indexFilename = baseFolder + "/" + FILE_INDEX_NAME;
+    String tmpFilename = baseFolder + "/" + FILE_INDEX_TMP_NAME;
+    FILE* pTmpFile = fopen(tmpFilename.c_str(), "wb");
+    if (!pTmpFile)
+    {
+        if (pIndexFile)
+            fclose(pIndexFile);
+        Log.trace("%sfileIndexUpdate can't write %s\n", MODULE_PREFIX, tmpFilename.c_str());
+        return false;
+    }
+    bool rslt = true;
+    bool changed = pNewLine != NULL;
+    char lineBuf[FILE_INDEX_LINE_MAXLEN];
+    while (rslt && pIndexFile && fileIndexReadLine(pIndexFile, lineBuf, sizeof(lineBuf)))
+    {
+        if ((strncmp(lineBuf, key.c_str(), key.length()) == 0) && (lineBuf[key.length()] == '\t'))
+        {
+            changed = true;
+            continue;
+        }
+        rslt = (fputs(lineBuf, pTmpFile) >= 0) && (fputc('\n', pTmpFile) != EOF);
+    }
+    if (pIndexFile)
+    {
+        if (ferror(pIndexFile))
+            rslt = false;
+        fclose(pIndexFile);
+    }
+    if (rslt && pNewLine)
+        rslt = fwrite(pNewLine->c_str(), 1, pNewLine->length(), pTmpFile) == pNewLine->length();
+    if (fclose(pTmpFile) != 0)
+        rslt = false;
+    if (!rslt || !changed)
+    {
+        unlink(tmpFilename.c_str());
+        if (!rslt)
+            Log.trace("%sfileIndexUpdate failed to write %s\n", MODULE_PREFIX, tmpFilename.c_str());
+        return rslt;
+    }
+
+    // Replace the index (file systems that can't rename over a file need it removed first - the
+    // temporary file is used if that is as far as it gets)
+    if (rename(tmpFilename.c_str(), indexFilename.c_str()) != 0)
+    {
+        unlink(indexFilename.c_str());
+        if (rename(tmpFilename.c_str(), indexFilename.c_str()) != 0)
+        {
+            Log.trace("%sfileIndexUpdate failed to replace %s\n", MODULE_PREFIX, indexFilename.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+void FileManager::fileIndexRemove(const String& rootFilename)
+{
+    String baseFolder, key;
+    if (getFileIndexKey(rootFilename, baseFolder, key))
+        fileIndexUpdate(baseFolder, key, NULL);
+}
+
+void FileManager::fileListInvalidate()
+{
+    xSemaphoreTake(_cachedFileListMutex, portMAX_DELAY);
+    _cachedFileListValid = false;
+    _fileListGen++;
+    xSemaphoreGive(_cachedFileListMutex);
+}
+
+void FileManager::fileListChanged()
+{
+    fileListInvalidate();
+    _fileListChangeCount++;
+    backgroundJobWake();
 }
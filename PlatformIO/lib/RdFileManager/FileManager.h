@@ -4,10 +4,50 @@
 #pragma once
 
 #include <Arduino.h>
+#include <functional>
+#include <atomic>
+#include <vector>
+#include <map>
+#include <dirent.h>
 #include "ConfigBase.h"
+#include "HeatshrinkDecoder.h"
+#include "FileSysBackend.h"
 
+// All file system access is done by a worker task which services requests in priority order -
+// playback reads, then uploads/writes, then listings. Each class of request has one slot so
+// callers of the same class take turns and wait for their request to complete. Listings are
+// done a few folder entries at a time so playback reads don't wait behind them (and made in the
+// background with a completion function for callers that can't wait, e.g. the web server). When
+// there are no requests the worker reads the start of the file expected to be played next into
+// RAM and when it has been idle for a while it does a step of the background job (e.g. indexing
+// files).
+// The internal flash file system is called spiffs in file system names and paths whichever
+// backend (SPIFFS or LittleFS - see FileSysBackend) is used
 class FileManager
 {
+public:
+    // Request classes in priority order
+    enum FsReqClass
+    {
+        FS_REQ_PLAYBACK,
+        FS_REQ_UPLOAD,
+        FS_REQ_LISTING,
+        FS_REQ_NUM_CLASSES
+    };
+
+    // Does a step of a request on the worker task - returns true when the request is complete
+    typedef std::function<bool()> FsReqStepFnType;
+
+    // Does a step of the background job on the worker task - returns true if there is more to do
+    typedef std::function<bool()> FsBackgroundStepFnType;
+
+    // Called with the result of a file list made in the background (on the worker task unless
+    // the list was cached)
+    typedef std::function<void(bool rslt, const String& respStr)> FileListDoneFnType;
+
+    // Called for each entry of a stepped listing (metaJson is empty if the file has no metadata)
+    typedef std::function<void(const String& name, int fileSize, const String& metaJson)> FileListEntryFnType;
+
 private:
     // File system controls
     bool _enableSPIFFS;
@@ -17,23 +57,186 @@ private:
     bool _sdIsOk;
     bool _cachedFileListValid;
 
+    // Internal flash file system backend
+    static constexpr const char* FLASH_FS_BASE_PATH = "/spiffs";
+    FileSysBackend* _pFlashFs;
+
     // SD card
     void* _pSDCard;
 
-    // Chunked file access
+    // Chunked file access (buffer allocated from MemRegions on first use)
     static const int CHUNKED_BUF_MAXLEN = 1000;
-    uint8_t _chunkedFileBuffer[CHUNKED_BUF_MAXLEN];
+    uint8_t* _pChunkedFileBuffer;
     int _chunkedFileInProgress;
     int _chunkedFilePos;
     String _chunkedFilename;
     int _chunkedFileLen;
     bool _chunkOnLineEndings;
 
-    // Cached file list response
-    String _cachedFileListResponse;
+    // Compressed (heatshrink) files read by line - the compressed data is read a block at a time
+    // and decoded as lines are needed (buffer allocated from MemRegions on first use)
+    static const int DECODE_IN_BUF_LEN = 512;
+    static const int DECODE_OUT_BUF_LEN = 512;
+    static const int DECODE_END = -1;
+    static const int DECODE_READ_FAILED = -2;
+    bool _chunkedFileCompressed;
+    HeatshrinkDecoder _chunkDecoder;
+    uint8_t* _pDecodeBuf;
+    int _decodeInPos;
+    int _decodeInLen;
+    int _decodeOutPos;
+    int _decodeOutLen;
+
+    // Prefetch of the start of files about to be played - only used by the worker task. There are
+    // two buffers so the next file can be read while the start of the current one is played
+    // (buffers allocated from MemRegions on first use)
+    static const int PREFETCH_NUM_BUFS = 2;
+    static const int PREFETCH_BUF_MAXLEN = 4096;
+    static const int PREFETCH_BYTES_PER_STEP = 1024;
+    struct PrefetchBuf
+    {
+        uint8_t* _pBuf;
+        String _filename;
+        int _fileLen;
+        int _len;
+    };
+    PrefetchBuf _prefetchBufs[PREFETCH_NUM_BUFS];
+    FILE* _pPrefetchFile;
+    int _prefetchFillIdx;
+    int _prefetchLastIdx;
+
+    // Cached file list response (allocated from MemRegions) for a file system and folder - the
+    // mutex is held while the cache is read or replaced (listings are done by different tasks)
+    char* _pCachedFileList;
+    size_t _cachedFileListSize;
+    String _cachedFileListKey;
+    SemaphoreHandle_t _cachedFileListMutex;
+    uint32_t _fileListGen;
+    std::atomic<uint32_t> _fileListChangeCount;
+
+    // File metadata index - a line per file (path in file system, length and metadata JSON) in
+    // the root folder of each file system. It is updated by copying to the temporary file which
+    // replaces the index once written (so if only the temporary file exists it is complete)
+    static constexpr const char* FILE_INDEX_NAME = "__fileindex__.txt";
+    static constexpr const char* FILE_INDEX_TMP_NAME = "__fileindex__.tmp";
+    static const int FILE_INDEX_LINE_MAXLEN = 512;
+    static const int FILE_INDEX_LINES_PER_STEP = 8;
+
+    // Worker task
+    static const int FS_TASK_STACK_SIZE = 8000;
+    static const int FS_TASK_PRIORITY = 2;
+    static const int FS_TASK_CORE = 0;
+    TaskHandle_t _fsTaskHandle;
+
+    // Requests - the work semaphore counts steps waiting to be done (including the prefetch and
+    // background listing)
+    struct FsReqSlot
+    {
+        SemaphoreHandle_t _callerMutex;
+        SemaphoreHandle_t _doneSem;
+        const FsReqStepFnType* _pStepFn;
+        // Set (release) by the caller after _pStepFn so the worker sees the function
+        std::atomic<bool> _pending;
+    };
+    FsReqSlot _fsReqSlots[FS_REQ_NUM_CLASSES];
+    SemaphoreHandle_t _fsWorkSem;
+
+    // Background job - stepped when the worker has had nothing else to do for the interval and
+    // while it has more to do or has been woken since its last step (set once - the function is
+    // published by the atomic flag)
+    static const int BACKGROUND_STEP_INTERVAL_MS = 20;
+    FsBackgroundStepFnType _backgroundStepFn;
+    std::atomic<bool> _backgroundJobSet;
+    std::atomic<uint32_t> _backgroundWakeCount;
+    uint32_t _backgroundStepWakeCount;
+    bool _backgroundMoreWork;
+
+    // Folder entries listed per step
+    static const int LISTING_ENTRIES_PER_STEP = 4;
+
+    // Index entry for a file in the folder being listed - the metadata is read from the index
+    // when the file is listed
+    struct FileIndexEntry
+    {
+        int _fileLength;
+        long _metaPos;
+    };
+
+    // State of a folder listing - done a few entries per step on the worker task. The index
+    // entries for the folder are read first (a few lines per step) into a map by file name and
+    // the index is kept open for their metadata. Entries are added to the JSON response or passed
+    // to the entry function if one is set
+    struct FileListJob
+    {
+        String _nameOfFS;
+        String _folder;
+        String _cacheKey;
+        uint32_t _listGen;
+        String _rootFolder;
+        String _baseFolder;
+        FILE* _pIndexFile;
+        bool _indexRead;
+        String _indexPrefix;
+        std::map<String, FileIndexEntry> _fileIndex;
+        FileListEntryFnType _entryFn;
+        DIR* _dir;
+        bool _firstFile;
+        bool _rslt;
+        String _respStr;
+    };
+
+    // Listings for callers that don't wait (e.g. the web server) - stepped by the worker when it
+    // has no requests or prefetch to do and put in the cached file list when done. Each caller's
+    // completion function is called when the listing of its folder is done and then the listing
+    // for the next caller is started (the job is started with the cache mutex held and only
+    // changed by the worker while the flag is set - the callers are under the cache mutex)
+    struct FileListWaiter
+    {
+        String _nameOfFS;
+        String _folder;
+        String _cacheKey;
+        FileListDoneFnType _doneFn;
+    };
+    FileListJob _asyncFileList;
+    std::atomic<bool> _asyncFileListRunning;
+    std::vector<FileListWaiter> _asyncFileListWaiters;
+
+    // Listing for the background job (only used on the worker task)
+    FileListJob _backgroundFileList;
+
+    // Benchmark files are written in upload sized blocks
+    static const int BENCHMARK_FILES_DEFAULT = 20;
+    static const int BENCHMARK_FILES_MAX = 100;
+    static const int BENCHMARK_FILE_LEN = 8192;
+    static const int BENCHMARK_BLOCK_LEN = 1024;
+    static const int BENCHMARK_REPEATS = 5;
 
-    // Mutex controlling access to file system
-    SemaphoreHandle_t _fileSysMutex;
+    // Benchmark job - started by runBenchmark and stepped by the worker task when it has no
+    // requests or prefetch to do (a block, listing or file per step) using its own file handles.
+    // The mutex is held while the job is started or the result is read or replaced
+    enum BenchmarkPhase
+    {
+        BENCHMARK_IDLE,
+        BENCHMARK_WRITE,
+        BENCHMARK_LIST,
+        BENCHMARK_STAT,
+        BENCHMARK_READ,
+        BENCHMARK_TIDY
+    };
+    std::atomic<int> _benchmarkPhase;
+    SemaphoreHandle_t _benchmarkMutex;
+    String _benchmarkFsName;
+    int _benchmarkNumFiles;
+    int _benchmarkFileIdx;
+    int _benchmarkBlockPos;
+    uint8_t* _pBenchmarkBuf;
+    const char* _pBenchmarkError;
+    uint32_t _benchmarkWriteUs;
+    uint32_t _benchmarkListUs;
+    uint32_t _benchmarkStatUs;
+    uint32_t _benchmarkReadUs;
+    uint32_t _benchmarkBytesRead;
+    String _benchmarkResult;
 
 public:
     FileManager()
@@ -48,7 +251,53 @@ public:
         _chunkedFilePos = 0;
         _chunkedFileInProgress = false;
         _pSDCard = NULL;
-        _fileSysMutex = xSemaphoreCreateMutex();
+        _pFlashFs = NULL;
+        _pChunkedFileBuffer = NULL;
+        _chunkedFileCompressed = false;
+        _pDecodeBuf = NULL;
+        _decodeInPos = _decodeInLen = 0;
+        _decodeOutPos = _decodeOutLen = 0;
+        _pCachedFileList = NULL;
+        _cachedFileListSize = 0;
+        _cachedFileListMutex = xSemaphoreCreateMutex();
+        _fileListGen = 0;
+        _fileListChangeCount.store(0);
+        _asyncFileList._dir = NULL;
+        _asyncFileList._pIndexFile = NULL;
+        _backgroundFileList._dir = NULL;
+        _backgroundFileList._pIndexFile = NULL;
+        _asyncFileListRunning.store(false);
+        for (int bufIdx = 0; bufIdx < PREFETCH_NUM_BUFS; bufIdx++)
+        {
+            _prefetchBufs[bufIdx]._pBuf = NULL;
+            _prefetchBufs[bufIdx]._fileLen = -1;
+            _prefetchBufs[bufIdx]._len = 0;
+        }
+        _pPrefetchFile = NULL;
+        _prefetchFillIdx = -1;
+        _prefetchLastIdx = 0;
+        _fsTaskHandle = NULL;
+        for (int reqClass = 0; reqClass < FS_REQ_NUM_CLASSES; reqClass++)
+        {
+            _fsReqSlots[reqClass]._callerMutex = xSemaphoreCreateMutex();
+            _fsReqSlots[reqClass]._doneSem = xSemaphoreCreateBinary();
+            _fsReqSlots[reqClass]._pStepFn = NULL;
+            _fsReqSlots[reqClass]._pending.store(false);
+        }
+        _fsWorkSem = xSemaphoreCreateCounting(FS_REQ_NUM_CLASSES + 2, 0);
+        _backgroundJobSet.store(false);
+        _backgroundWakeCount.store(0);
+        _backgroundStepWakeCount = 0;
+        _backgroundMoreWork = false;
+        _benchmarkPhase.store(BENCHMARK_IDLE);
+        _benchmarkMutex = xSemaphoreCreateMutex();
+        _benchmarkNumFiles = 0;
+        _benchmarkFileIdx = 0;
+        _benchmarkBlockPos = 0;
+        _pBenchmarkBuf = NULL;
+        _pBenchmarkError = NULL;
+        _benchmarkWriteUs = _benchmarkListUs = _benchmarkStatUs = _benchmarkReadUs = 0;
+        _benchmarkBytesRead = 0;
     }
 
     // Configure
@@ -57,10 +306,37 @@ public:
     // Reformat
     void reformat(const String& fileSystemStr, String& respStr);
 
+    // Start a benchmark of upload write, listing, stat and sequential read on a file system - it
+    // runs on the worker task at lower priority than other file access
+    void runBenchmark(const String& fileSystemStr, int numFiles, String& respStr);
+
+    // Result of the last benchmark - JSON with throughput and times per operation (busy while
+    // a benchmark is running)
+    void getBenchmarkResult(String& respStr);
+
     // Get a list of files on the file system as a JSON format string
     // {"rslt":"ok","diskSize":123456,"diskUsed":1234,"folder":"/","files":[{"name":"file1.txt","size":223},{"name":"file2.txt","size":234}]}
     bool getFilesJSON(const String& fileSystemStr, const String& folderStr, String& respStr);
 
+    // Get the list of files without waiting - doneFn is called with the list (straight away if it
+    // is cached, otherwise on the worker task when the listing made in the background is done)
+    void getFilesJSONAsync(const String& fileSystemStr, const String& folderStr, const FileListDoneFnType& doneFn);
+
+    // Metadata for a file (a JSON object, e.g. pattern statistics) - included in getFilesJSON as
+    // "meta" while the file has the same length and removed when the file is written or deleted
+    // (setting metadata doesn't count as a change to the files)
+    bool setFileMeta(const String& fileSystemStr, const String& filename, int fileLength, const String& metaJson);
+
+    // Count of changes to the files on any file system (e.g. uploads and deletes)
+    uint32_t getFileListChangeCount()
+    {
+        return _fileListChangeCount.load();
+    }
+
+    // Read part of a file (e.g. from the background job)
+    bool readFileBlock(const String& fileSystemStr, const String& filename, int filePos,
+                uint8_t* pBuf, int maxLen, int& readLen);
+
     // Get/Set file contents as a string
     String getFileContents(const String& fileSystemStr, const String& filename, int maxLen=0);
     bool setFileContents(const String& fileSystemStr, const String& filename, String& fileContents);
@@ -81,14 +357,67 @@ public:
     // Get next chunk of file
     uint8_t* chunkFileNext(String& filename, int& fileLen, int& chunkPos, int& chunkLen, bool& finalChunk);
 
+    // Announce the file expected to be started next with chunkedFileStart (read by line) - the start
+    // of it is read into RAM in the background so its first lines don't wait for the file system
+    void chunkedFilePrefetch(const String& fileSystemStr, const String& filename);
+
     // Get file name extension
     static String getFileExtension(String& filename);
 
+    // Compressed files (read by line as the uncompressed contents) are named with the extension
+    // of the uncompressed file followed by .hs - e.g. pattern.thr.hs
+    static bool isCompressedFile(String& filename);
+
+    // Name without the compressed file extension
+    static String getUncompressedName(String& filename);
+
     // Read line from file
     char* readLineFromFile(char* pBuf, int maxLen, FILE* pFile);
 
+    // Run a request on the worker task and wait for it to complete (runs directly if the
+    // worker isn't running)
+    void runOnFsTask(FsReqClass reqClass, const FsReqStepFnType& stepFn);
+
+    // Background job (only one can be set) - steps run on the worker task so they can use the
+    // file functions above without waiting. Steps are only run by the worker task (not if it
+    // couldn't be started). Wake when there may be more to do (also done when files change)
+    void setBackgroundJob(const FsBackgroundStepFnType& stepFn);
+    void backgroundJobWake();
+
+    // Stepped listing for the background job - start and then step (a few entries per step with
+    // entryFn called for each) until the step returns true - rslt is false if the folder can't
+    // be listed. Only one can be in progress
+    bool backgroundFileListStart(const String& fileSystemStr, const String& folderStr, const FileListEntryFnType& entryFn);
+    bool backgroundFileListStep(bool& rslt);
+
 private:
+    static void fsTaskFn(void* pParam);
+    bool getFilesJSONStart(String& nameOfFS, const String& folderStr, String& respStr, String& rootFolder, DIR*& dir);
+    void fileListJobInit(FileListJob& job, const String& nameOfFS, const String& folderStr, uint32_t listGen);
+    bool fileListJobStep(FileListJob& job);
+    void fileListJobEnd(FileListJob& job);
+    bool asyncFileListStep();
+    bool chunkFileNextFs(int& chunkLen, bool& finalChunk);
+    bool chunkFileNextCompressed(int& chunkLen, bool& finalChunk);
+    int decodeGetByte();
+    bool prefetchStep();
+    bool benchmarkStep();
+    void benchmarkFilePath(int fileIdx, String& rootFilename);
+    void prefetchEndFill();
+    void prefetchDiscard(const String* pRootFilename);
+    int prefetchFind(const String& rootFilename);
+    bool prefetchReadLine(PrefetchBuf& prefetchBuf, char* pBuf, int maxLen, int& filePos, bool& endOfFile);
     bool checkFileSystem(const String& fileSystemStr, String& fsName);
     String getFilePath(const String& nameOfFS, const String& filename);
+    String getFsBaseFolder(const String& nameOfFS);
+    bool getFileIndexKey(const String& rootFilename, String& baseFolder, String& key);
+    bool fileIndexOpen(const String& baseFolder, FILE*& pFile);
+    static bool fileIndexReadLine(FILE* pFile, char* pBuf, int bufLen);
+    static bool fileIndexParseLine(char* pLine, const char*& pKey, int& fileLength, const char*& pMetaJson);
+    bool fileIndexReadStep(FileListJob& job);
+    bool fileIndexUpdate(const String& baseFolder, const String& key, const String* pNewLine);
+    void fileIndexRemove(const String& rootFilename);
+    void fileListInvalidate();
+    void fileListChanged();
 
 };
@@ -0,0 +1,241 @@
+// FileSysBackend
+// Rob Dobson 2018-2019
+
+#include "FileSysBackend.h"
+#include <ArduinoLog.h>
+
+static const char* MODULE_PREFIX = "FileSysBackend: ";
+
+#ifdef ESP_PLATFORM
+
+#include "esp_spiffs.h"
+#ifdef FILE_SYS_LITTLEFS_ENABLE
+#include "esp_littlefs.h"
+#endif
+#include "esp_err.h"
+
+// Both backends use the partition labelled spiffs in partitions.csv
+static const char* FLASH_FS_PARTITION_LABEL = "spiffs";
+
+// SPIFFS - flat namespace so listing and opening files scan the whole partition
+class FileSysSPIFFS : public FileSysBackend
+{
+public:
+    const char* getTypeName()
+    {
+        return "spiffs";
+    }
+
+    bool mount(const char* basePath, bool formatIfCorrupt)
+    {
+        // Using ESP32 native SPIFFS support rather than arduino as potential bugs encountered in some
+        // arduino functions
+        esp_vfs_spiffs_conf_t conf = {
+        .base_path = basePath,
+        .partition_label = NULL,
+        .max_files = 5,
+        .format_if_mount_failed = formatIfCorrupt
+        };
+        // Use settings defined above to initialize and mount SPIFFS filesystem.
+        // Note: esp_vfs_spiffs_register is an all-in-one convenience function.
+        esp_err_t ret = esp_vfs_spiffs_register(&conf);
+        if (ret != ESP_OK)
+        {
+            if (ret == ESP_FAIL)
+                Log.warning("%smount failed mount/format SPIFFS\n", MODULE_PREFIX);
+            else if (ret == ESP_ERR_NOT_FOUND)
+                Log.warning("%smount failed to find SPIFFS partition\n", MODULE_PREFIX);
+            else
+                Log.warning("%smount failed to init SPIFFS (error %s)\n", MODULE_PREFIX, esp_err_to_name(ret));
+            return false;
+        }
+        _mountPath = basePath;
+        return true;
+    }
+
+    bool getInfo(size_t& totalBytes, size_t& usedBytes)
+    {
+        esp_err_t ret = esp_spiffs_info(NULL, &totalBytes, &usedBytes);
+        if (ret != ESP_OK)
+        {
+            Log.warning("%sgetInfo failed to get SPIFFS info (error %s)\n", MODULE_PREFIX, esp_err_to_name(ret));
+            return false;
+        }
+        return true;
+    }
+
+    bool format()
+    {
+        return esp_spiffs_format(NULL) == ESP_OK;
+    }
+};
+
+#ifdef FILE_SYS_LITTLEFS_ENABLE
+
+// LittleFS - has directories and metadata pairs so listing, stat and opening don't depend on
+// how many files there are elsewhere and writes don't slow down as the partition fills
+class FileSysLittleFS : public FileSysBackend
+{
+public:
+    const char* getTypeName()
+    {
+        return "littlefs";
+    }
+
+    bool mount(const char* basePath, bool formatIfCorrupt)
+    {
+        esp_vfs_littlefs_conf_t conf = {};
+        conf.base_path = basePath;
+        conf.partition_label = FLASH_FS_PARTITION_LABEL;
+        conf.format_if_mount_failed = formatIfCorrupt;
+        esp_err_t ret = esp_vfs_littlefs_register(&conf);
+        if (ret != ESP_OK)
+        {
+            if (ret == ESP_FAIL)
+                Log.warning("%smount failed mount/format LittleFS\n", MODULE_PREFIX);
+            else if (ret == ESP_ERR_NOT_FOUND)
+                Log.warning("%smount failed to find LittleFS partition\n", MODULE_PREFIX);
+            else
+                Log.warning("%smount failed to init LittleFS (error %s)\n", MODULE_PREFIX, esp_err_to_name(ret));
+            return false;
+        }
+        _mountPath = basePath;
+        return true;
+    }
+
+    bool getInfo(size_t& totalBytes, size_t& usedBytes)
+    {
+        esp_err_t ret = esp_littlefs_info(FLASH_FS_PARTITION_LABEL, &totalBytes, &usedBytes);
+        if (ret != ESP_OK)
+        {
+            Log.warning("%sgetInfo failed to get LittleFS info (error %s)\n", MODULE_PREFIX, esp_err_to_name(ret));
+            return false;
+        }
+        return true;
+    }
+
+    bool format()
+    {
+        return esp_littlefs_format(FLASH_FS_PARTITION_LABEL) == ESP_OK;
+    }
+};
+
+#endif
+
+FileSysBackend* FileSysBackend::create(ConfigBase& fsConfig)
+{
+    String typeName = fsConfig.getString("flashFs", "spiffs");
+    if (typeName.equalsIgnoreCase("spiffs"))
+        return new FileSysSPIFFS();
+#ifdef FILE_SYS_LITTLEFS_ENABLE
+    if (typeName.equalsIgnoreCase("littlefs"))
+        return new FileSysLittleFS();
+#endif
+    Log.warning("%screate flashFs %s not supported\n", MODULE_PREFIX, typeName.c_str());
+    return NULL;
+}
+
+#else
+
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
+
+// RAM-backed file system for host builds - files are kept under a folder on a RAM disk with the
+// base path appended (e.g. /dev/shm/rbotfs/spiffs) and the size is fixed by config
+class FileSysRAM : public FileSysBackend
+{
+public:
+    FileSysRAM(const String& ramRoot, size_t sizeBytes)
+    {
+        _ramRoot = ramRoot;
+        _sizeBytes = sizeBytes;
+    }
+
+    const char* getTypeName()
+    {
+        return "ram";
+    }
+
+    bool mount(const char* basePath, bool /* formatIfCorrupt */)
+    {
+        // Create the folders (each level of the path)
+        String mountPath = _ramRoot + basePath;
+        for (int sepPos = mountPath.indexOf('/', 1); ; sepPos = mountPath.indexOf('/', sepPos + 1))
+        {
+            String folder = (sepPos < 0) ? mountPath : mountPath.substring(0, sepPos);
+            mkdir(folder.c_str(), 0755);
+            if (sepPos < 0)
+                break;
+        }
+        struct stat st;
+        if ((stat(mountPath.c_str(), &st) != 0) || !S_ISDIR(st.st_mode))
+        {
+            Log.warning("%smount failed to create RAM folder %s\n", MODULE_PREFIX, mountPath.c_str());
+            return false;
+        }
+        _mountPath = mountPath;
+        return true;
+    }
+
+    bool getInfo(size_t& totalBytes, size_t& usedBytes)
+    {
+        totalBytes = _sizeBytes;
+        usedBytes = 0;
+        return walkFolder(_mountPath, false, usedBytes);
+    }
+
+    bool format()
+    {
+        size_t usedBytes = 0;
+        return walkFolder(_mountPath, true, usedBytes);
+    }
+
+private:
+    String _ramRoot;
+    size_t _sizeBytes;
+
+    // Totals file sizes in a folder and its sub-folders - optionally removing them
+    bool walkFolder(const String& folder, bool remove, size_t& usedBytes)
+    {
+        DIR* dir = opendir(folder.c_str());
+        if (!dir)
+            return false;
+        bool rslt = true;
+        struct dirent* ent = NULL;
+        while ((ent = readdir(dir)) != NULL)
+        {
+            String name = ent->d_name;
+            if ((name == ".") || (name == ".."))
+                continue;
+            String path = folder + "/" + name;
+            struct stat st;
+            if (stat(path.c_str(), &st) != 0)
+                continue;
+            if (S_ISDIR(st.st_mode))
+            {
+                rslt = walkFolder(path, remove, usedBytes) && rslt;
+                if (remove)
+                    rmdir(path.c_str());
+                continue;
+            }
+            usedBytes += st.st_size;
+            if (remove && (unlink(path.c_str()) != 0))
+                rslt = false;
+        }
+        closedir(dir);
+        return rslt;
+    }
+};
+
+FileSysBackend* FileSysBackend::create(ConfigBase& fsConfig)
+{
+    String typeName = fsConfig.getString("flashFs", "ram");
+    if (typeName.equalsIgnoreCase("ram"))
+        return new FileSysRAM(fsConfig.getString("ramFsRoot", "/dev/shm/rbotfs"),
+                        fsConfig.getLong("ramFsSize", 0x10F000));
+    Log.warning("%screate flashFs %s not supported on host\n", MODULE_PREFIX, typeName.c_str());
+    return NULL;
+}
+
+#endif
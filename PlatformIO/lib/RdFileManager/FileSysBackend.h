@@ -0,0 +1,48 @@
+// FileSysBackend
+// Rob Dobson 2018-2019
+
+// Backends for the internal flash file system. A backend mounts the file system on the VFS so
+// FileManager accesses it with the standard C file functions whichever backend is used - the
+// backend only handles mounting, size info and formatting. On the ESP32 the backend is SPIFFS
+// or LittleFS (both on the partition labelled spiffs - LittleFS only in builds which define
+// FILE_SYS_LITTLEFS_ENABLE and have the LittleFS_esp32 library). Host builds have a RAM-backed
+// backend which keeps the files in a folder on a RAM disk (e.g. tmpfs)
+
+#pragma once
+
+#include <Arduino.h>
+#include "ConfigBase.h"
+
+class FileSysBackend
+{
+public:
+    virtual ~FileSysBackend()
+    {
+    }
+
+    // Type name as used in the fileManager config (flashFs)
+    virtual const char* getTypeName() = 0;
+
+    // Mount at the base path (e.g. /spiffs) - formats if the file system can't be mounted and
+    // formatIfCorrupt is set (the case when changing between SPIFFS and LittleFS)
+    virtual bool mount(const char* basePath, bool formatIfCorrupt) = 0;
+
+    // Size info
+    virtual bool getInfo(size_t& totalBytes, size_t& usedBytes) = 0;
+
+    // Format (erases all files)
+    virtual bool format() = 0;
+
+    // Path files are accessed at when mounted - the base path for SPIFFS and LittleFS
+    const String& getMountPath()
+    {
+        return _mountPath;
+    }
+
+    // Create the backend set in the fileManager config - flashFs is spiffs (default) or littlefs
+    // on the ESP32 and ram on the host - returns NULL if not supported
+    static FileSysBackend* create(ConfigBase& fsConfig);
+
+protected:
+    String _mountPath;
+};
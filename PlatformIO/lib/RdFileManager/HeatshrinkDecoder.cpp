@@ -0,0 +1,67 @@
+// HeatshrinkDecoder
+// Rob Dobson 2018-2019
+
+#include "HeatshrinkDecoder.h"
+#include <string.h>
+
+void HeatshrinkDecoder::reset()
+{
+    // Back-references before the start of the stream are to zeros (as the reference decoder)
+    memset(_window, 0, sizeof(_window));
+    _windowPos = 0;
+    _bitBuf = 0;
+    _bitCount = 0;
+    _backrefOffset = 0;
+    _backrefRemaining = 0;
+}
+
+size_t HeatshrinkDecoder::decode(const uint8_t* pIn, size_t inLen, size_t& inUsed, uint8_t* pOut, size_t outMax)
+{
+    static const int BACKREF_BITS = 1 + WINDOW_BITS + LOOKAHEAD_BITS;
+    static const uint32_t WINDOW_MASK = WINDOW_SIZE - 1;
+    inUsed = 0;
+    size_t outLen = 0;
+    while (outLen < outMax)
+    {
+        // Rest of a back-reference
+        if (_backrefRemaining > 0)
+        {
+            uint8_t ch = _window[(_windowPos - _backrefOffset) & WINDOW_MASK];
+            _window[_windowPos++ & WINDOW_MASK] = ch;
+            pOut[outLen++] = ch;
+            _backrefRemaining--;
+            continue;
+        }
+
+        // Top up the bits - a whole tag is needed (ones left over at the end of the
+        // stream are padding)
+        while ((_bitCount <= 24) && (inUsed < inLen))
+        {
+            _bitBuf = (_bitBuf << 8) | pIn[inUsed++];
+            _bitCount += 8;
+        }
+        if (_bitCount < 1)
+            break;
+        bool isLiteral = (_bitBuf >> (_bitCount - 1)) & 1;
+        if (isLiteral)
+        {
+            if (_bitCount < 9)
+                break;
+            uint8_t ch = (_bitBuf >> (_bitCount - 9)) & 0xff;
+            _bitCount -= 9;
+            _window[_windowPos++ & WINDOW_MASK] = ch;
+            pOut[outLen++] = ch;
+        }
+        else
+        {
+            if (_bitCount < BACKREF_BITS)
+                break;
+            _bitCount -= BACKREF_BITS;
+            uint32_t backref = _bitBuf >> _bitCount;
+            _backrefOffset = ((backref >> LOOKAHEAD_BITS) & WINDOW_MASK) + 1;
+            _backrefRemaining = (backref & ((1 << LOOKAHEAD_BITS) - 1)) + 1;
+        }
+        _bitBuf &= (1ul << _bitCount) - 1;
+    }
+    return outLen;
+}
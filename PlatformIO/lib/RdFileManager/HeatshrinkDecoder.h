@@ -0,0 +1,46 @@
+// HeatshrinkDecoder
+// Rob Dobson 2018-2019
+
+// Streaming decoder for the heatshrink LZSS format (https://github.com/atomicobject/heatshrink)
+// with a window of 2^11 bytes and lookahead of 2^4 bytes - the defaults of the heatshrink
+// command line tool, so files compressed with "heatshrink -e -w 11 -l 4" (or with
+// Tests/CompressPatterns) can be decoded. Input and output can be split anywhere between calls
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+class HeatshrinkDecoder
+{
+public:
+    static const int WINDOW_BITS = 11;
+    static const int LOOKAHEAD_BITS = 4;
+    static const int WINDOW_SIZE = 1 << WINDOW_BITS;
+
+    HeatshrinkDecoder()
+    {
+        reset();
+    }
+
+    // Start a new stream
+    void reset();
+
+    // Decode from the input into the output until the input is used up or the output is full
+    // - inUsed is the number of input bytes consumed (the rest must be passed to the next call)
+    // - returns the number of bytes written to the output
+    size_t decode(const uint8_t* pIn, size_t inLen, size_t& inUsed, uint8_t* pOut, size_t outMax);
+
+private:
+    // Window of previous output
+    uint8_t _window[WINDOW_SIZE];
+    uint32_t _windowPos;
+
+    // Input bits not yet used (MSB first)
+    uint32_t _bitBuf;
+    int _bitCount;
+
+    // Back-reference being output
+    uint32_t _backrefOffset;
+    uint32_t _backrefRemaining;
+};
@@ -200,20 +200,217 @@ jsmnrtok_t* RdJson::parseJson(const char* jsonStr, int& numTokens,
     return pTokens;
 }
 
+// Short form escapes - other control chars are escaped as \u00XX
+static char RdJson_shortEscape(char ch)
+{
+    switch (ch)
+    {
+        case '"': return '"';
+        case '\\': return '\\';
+        case '\b': return 'b';
+        case '\f': return 'f';
+        case '\n': return 'n';
+        case '\r': return 'r';
+        case '\t': return 't';
+    }
+    return 0;
+}
+
+static int RdJson_hexDigit(char ch)
+{
+    if ((ch >= '0') && (ch <= '9'))
+        return ch - '0';
+    if ((ch >= 'a') && (ch <= 'f'))
+        return ch - 'a' + 10;
+    if ((ch >= 'A') && (ch <= 'F'))
+        return ch - 'A' + 10;
+    return -1;
+}
+
+// Parse the 4 hex digits of a \uXXXX escape - returns -1 if invalid
+static long RdJson_parseHex4(const char* pStr, const char* pEnd)
+{
+    if (pEnd - pStr < 4)
+        return -1;
+    long val = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        int digit = RdJson_hexDigit(pStr[i]);
+        if (digit < 0)
+            return -1;
+        val = (val << 4) | digit;
+    }
+    return val;
+}
+
+size_t RdJson::escapedLen(const char* pSrc, size_t srcLen)
+{
+    size_t escLen = srcLen;
+    for (size_t i = 0; i < srcLen; i++)
+    {
+        uint8_t ch = pSrc[i];
+        if (RdJson_shortEscape(ch))
+            escLen += 1;
+        else if (ch < 0x20)
+            escLen += 5;
+    }
+    return escLen;
+}
+
+size_t RdJson::escapeString(char* pDest, size_t destSize, const char* pSrc, size_t srcLen)
+{
+    static const char hexChars[] = "0123456789abcdef";
+    size_t escLen = 0;
+    size_t destPos = 0;
+    bool truncated = false;
+    for (size_t i = 0; i < srcLen; i++)
+    {
+        uint8_t ch = pSrc[i];
+        char escCh = RdJson_shortEscape(ch);
+        size_t seqLen = escCh ? 2 : ((ch < 0x20) ? 6 : 1);
+        escLen += seqLen;
+        if (truncated || (destPos + seqLen >= destSize))
+        {
+            truncated = true;
+            continue;
+        }
+        if (escCh)
+        {
+            pDest[destPos++] = '\\';
+            pDest[destPos++] = escCh;
+        }
+        else if (ch < 0x20)
+        {
+            memcpy(pDest + destPos, "\\u00", 4);
+            pDest[destPos + 4] = hexChars[ch >> 4];
+            pDest[destPos + 5] = hexChars[ch & 0x0f];
+            destPos += 6;
+        }
+        else
+        {
+            pDest[destPos++] = ch;
+        }
+    }
+    if (destSize > 0)
+        pDest[destPos] = 0;
+    return escLen;
+}
+
+size_t RdJson::unescapeInPlace(char* pStr, size_t strLen)
+{
+    // Nothing to do until the first backslash
+    char* pRead = (char*)memchr(pStr, '\\', strLen);
+    if (!pRead)
+        return strLen;
+    const char* pEnd = pStr + strLen;
+    char* pWrite = pRead;
+    while (pRead < pEnd)
+    {
+        char ch = *pRead++;
+        if ((ch != '\\') || (pRead >= pEnd))
+        {
+            *pWrite++ = ch;
+            continue;
+        }
+        char escCh = *pRead++;
+        switch (escCh)
+        {
+            case '"': *pWrite++ = '"'; break;
+            case '\\': *pWrite++ = '\\'; break;
+            case '/': *pWrite++ = '/'; break;
+            case 'b': *pWrite++ = '\b'; break;
+            case 'f': *pWrite++ = '\f'; break;
+            case 'n': *pWrite++ = '\n'; break;
+            case 'r': *pWrite++ = '\r'; break;
+            case 't': *pWrite++ = '\t'; break;
+            case 'u':
+            {
+                // Code point (combining a surrogate pair) written as UTF-8 - invalid
+                // sequences and \u0000 (which would terminate the string) are left as they are
+                long codePoint = RdJson_parseHex4(pRead, pEnd);
+                int escSeqLen = 4;
+                if ((codePoint >= 0xd800) && (codePoint < 0xdc00))
+                {
+                    long lowSurrogate = -1;
+                    if ((pEnd - pRead >= 10) && (pRead[4] == '\\') && (pRead[5] == 'u'))
+                        lowSurrogate = RdJson_parseHex4(pRead + 6, pEnd);
+                    if ((lowSurrogate >= 0xdc00) && (lowSurrogate < 0xe000))
+                    {
+                        codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (lowSurrogate - 0xdc00);
+                        escSeqLen = 10;
+                    }
+                    else
+                    {
+                        codePoint = -1;
+                    }
+                }
+                else if ((codePoint >= 0xdc00) && (codePoint < 0xe000))
+                {
+                    codePoint = -1;
+                }
+                if (codePoint <= 0)
+                {
+                    *pWrite++ = '\\';
+                    *pWrite++ = 'u';
+                    break;
+                }
+                if (codePoint < 0x80)
+                {
+                    *pWrite++ = codePoint;
+                }
+                else if (codePoint < 0x800)
+                {
+                    *pWrite++ = 0xc0 | (codePoint >> 6);
+                    *pWrite++ = 0x80 | (codePoint & 0x3f);
+                }
+                else if (codePoint < 0x10000)
+                {
+                    *pWrite++ = 0xe0 | (codePoint >> 12);
+                    *pWrite++ = 0x80 | ((codePoint >> 6) & 0x3f);
+                    *pWrite++ = 0x80 | (codePoint & 0x3f);
+                }
+                else
+                {
+                    *pWrite++ = 0xf0 | (codePoint >> 18);
+                    *pWrite++ = 0x80 | ((codePoint >> 12) & 0x3f);
+                    *pWrite++ = 0x80 | ((codePoint >> 6) & 0x3f);
+                    *pWrite++ = 0x80 | (codePoint & 0x3f);
+                }
+                pRead += escSeqLen;
+                break;
+            }
+            default:
+                // Not a valid escape so keep as it is
+                *pWrite++ = '\\';
+                *pWrite++ = escCh;
+                break;
+        }
+    }
+    *pWrite = 0;
+    return pWrite - pStr;
+}
+
 void RdJson::escapeString(String& strToEsc)
 {
-    // Replace characters which are invalid in JSON
-    strToEsc.replace("\\", "\\\\");
-    strToEsc.replace("\"", "\\\"");
-    strToEsc.replace("\n", "\\n");
+    // Length is known up front so there is at most one allocation
+    size_t srcLen = strToEsc.length();
+    size_t escLen = escapedLen(strToEsc.c_str(), srcLen);
+    if (escLen == srcLen)
+        return;
+    char* pEscaped = new char[escLen + 1];
+    escapeString(pEscaped, escLen + 1, strToEsc.c_str(), srcLen);
+    strToEsc = pEscaped;
+    delete [] pEscaped;
 }
 
 void RdJson::unescapeString(String& strToUnEsc)
 {
-    // Replace characters which are invalid in JSON
-    strToUnEsc.replace("\\\"", "\"");
-    strToUnEsc.replace("\\\\", "\\");
-    strToUnEsc.replace("\\n", "\n");
+    // Unescaping only shortens the string so it is done in the string's own buffer
+    size_t srcLen = strToUnEsc.length();
+    if ((srcLen == 0) || (strToUnEsc.indexOf('\\') < 0))
+        return;
+    size_t newLen = unescapeInPlace(&strToUnEsc[0], srcLen);
+    strToUnEsc.remove(newLen);
 }
 
 bool RdJson::getTokenByDataPath(const char* jsonStr, const char* dataPath,
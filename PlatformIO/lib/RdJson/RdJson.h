@@ -56,10 +56,22 @@ public:
     static jsmnrtok_t* parseJson(const char* jsonStr, int& numTokens,
                                  int maxTokens = 10000);
 
+    // Escape/unescape the contents of a JSON string (quote, backslash, control chars and \uXXXX)
+    // in a single pass
     static void escapeString(String& strToEsc);
 
     static void unescapeString(String& strToUnEsc);
 
+    // Length of srcLen chars from pSrc once escaped
+    static size_t escapedLen(const char* pSrc, size_t srcLen);
+
+    // Escape into a caller buffer (destSize includes the terminator) - returns the escaped length,
+    // if this isn't less than destSize the output is truncated at a whole escape sequence
+    static size_t escapeString(char* pDest, size_t destSize, const char* pSrc, size_t srcLen);
+
+    // Unescape in place (the result is never longer than the source) - returns the new length
+    static size_t unescapeInPlace(char* pStr, size_t strLen);
+
     static bool getTokenByDataPath(const char* jsonStr, const char* dataPath,
                                    jsmnrtok_t* pTokens, int numTokens,
                                    int& startTokenIdx, int& endTokenIdx);
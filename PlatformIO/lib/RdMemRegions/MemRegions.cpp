@@ -0,0 +1,201 @@
+// MemRegions
+// Rob Dobson 2019
+
+#include "MemRegions.h"
+#include "ArduinoLog.h"
+#include "ConfigBase.h"
+#include <stdlib.h>
+#ifdef ESP32
+#include "esp_heap_caps.h"
+#include "soc/soc_memory_layout.h"
+#endif
+
+static const char* MODULE_PREFIX = "MemRegions: ";
+
+// Tables indexed by region or subsystem - sized by their initializers so that a missing
+// entry fails to compile rather than defaulting to 0 (REGION_INTERNAL or a NULL name)
+static const char* MemRegions_regionNames[] = {
+    "internal", "dma", "psram"
+};
+static_assert(sizeof(MemRegions_regionNames) / sizeof(MemRegions_regionNames[0]) == MemRegions::NUM_REGIONS,
+            "MemRegions_regionNames must have an entry for each region");
+static const char* MemRegions_subsysNames[] = {
+    "motionPipeline", "hdlcRx", "fileChunk", "netLogPause", "fileList", "filePrefetch"
+};
+static_assert(sizeof(MemRegions_subsysNames) / sizeof(MemRegions_subsysNames[0]) == MemRegions::NUM_SUBSYSTEMS,
+            "MemRegions_subsysNames must have an entry for each subsystem");
+
+// Defaults - all of these are large and not used from ISRs so PSRAM is used if present
+// (the length is checked in setup() as the member is private)
+MemRegions::Region MemRegions::_regionPolicy[] = {
+    REGION_PSRAM, REGION_PSRAM, REGION_PSRAM, REGION_PSRAM, REGION_PSRAM, REGION_PSRAM
+};
+std::atomic<uint32_t> MemRegions::_allocBytes[MemRegions::NUM_SUBSYSTEMS];
+std::atomic<uint32_t> MemRegions::_allocPSRAMBytes[MemRegions::NUM_SUBSYSTEMS];
+std::atomic<uint32_t> MemRegions::_allocFailCount[MemRegions::NUM_SUBSYSTEMS];
+
+#ifdef ESP32
+static uint32_t MemRegions_regionCaps(int region)
+{
+    switch(region)
+    {
+        case MemRegions::REGION_DMA: return MALLOC_CAP_DMA | MALLOC_CAP_8BIT;
+        case MemRegions::REGION_PSRAM: return MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+        default: return MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+    }
+}
+#endif
+
+void MemRegions::setup(ConfigBase& config, const char* pConfigPath)
+{
+    static_assert(sizeof(_regionPolicy) / sizeof(_regionPolicy[0]) == NUM_SUBSYSTEMS,
+                "MemRegions::_regionPolicy must have an entry for each subsystem");
+
+    // Get config
+    String pathStr = "memRegions";
+    if (pConfigPath)
+        pathStr = pConfigPath;
+    ConfigBase regionsConfig(config.getString(pathStr.c_str(), "").c_str());
+
+    // Region for each subsystem (unchanged if not specified)
+    for (int subsysIdx = 0; subsysIdx < NUM_SUBSYSTEMS; subsysIdx++)
+    {
+        String regionStr = regionsConfig.getString(MemRegions_subsysNames[subsysIdx], "");
+        if (regionStr.length() == 0)
+            continue;
+        int regionIdx = 0;
+        for (; regionIdx < NUM_REGIONS; regionIdx++)
+            if (regionStr.equalsIgnoreCase(MemRegions_regionNames[regionIdx]))
+                break;
+        if (regionIdx < NUM_REGIONS)
+            _regionPolicy[subsysIdx] = (Region)regionIdx;
+        else
+            Log.warning("%ssetup %s unknown region %s\n", MODULE_PREFIX, MemRegions_subsysNames[subsysIdx], regionStr.c_str());
+    }
+    String jsonStr;
+    getJSON(jsonStr);
+    Log.notice("%ssetup %s\n", MODULE_PREFIX, jsonStr.c_str());
+}
+
+void* MemRegions::alloc(Subsystem subsys, size_t size)
+{
+    if ((subsys < 0) || (subsys >= NUM_SUBSYSTEMS) || (size == 0))
+        return NULL;
+#ifdef ESP32
+    void* ptr = heap_caps_malloc(size, MemRegions_regionCaps(_regionPolicy[subsys]));
+    if (!ptr && (_regionPolicy[subsys] == REGION_PSRAM))
+        ptr = heap_caps_malloc(size, MemRegions_regionCaps(REGION_INTERNAL));
+#else
+    void* ptr = malloc(size);
+#endif
+    if (!ptr)
+    {
+        _allocFailCount[subsys].fetch_add(1, std::memory_order_relaxed);
+        Log.warning("%salloc %s failed %d bytes\n", MODULE_PREFIX, MemRegions_subsysNames[subsys], (int)size);
+        return NULL;
+    }
+    _allocBytes[subsys].fetch_add(size, std::memory_order_relaxed);
+    if (isPSRAM(ptr))
+        _allocPSRAMBytes[subsys].fetch_add(size, std::memory_order_relaxed);
+    return ptr;
+}
+
+void* MemRegions::allocOrAbort(Subsystem subsys, size_t size)
+{
+    void* ptr = alloc(subsys, size);
+    if (!ptr && (size != 0))
+    {
+        Log.error("%sallocOrAbort %s out of memory for %d bytes\n", MODULE_PREFIX, getSubsystemName(subsys), (int)size);
+        abort();
+    }
+    return ptr;
+}
+
+void MemRegions::free(Subsystem subsys, void* ptr, size_t size)
+{
+    if (!ptr || (subsys < 0) || (subsys >= NUM_SUBSYSTEMS))
+        return;
+    _allocBytes[subsys].fetch_sub(size, std::memory_order_relaxed);
+    if (isPSRAM(ptr))
+        _allocPSRAMBytes[subsys].fetch_sub(size, std::memory_order_relaxed);
+#ifdef ESP32
+    heap_caps_free(ptr);
+#else
+    ::free(ptr);
+#endif
+}
+
+MemRegions::Region MemRegions::getRegion(Subsystem subsys)
+{
+    if ((subsys < 0) || (subsys >= NUM_SUBSYSTEMS))
+        return REGION_INTERNAL;
+    return _regionPolicy[subsys];
+}
+
+void MemRegions::setRegion(Subsystem subsys, Region region)
+{
+    if ((subsys < 0) || (subsys >= NUM_SUBSYSTEMS) || (region < 0) || (region >= NUM_REGIONS))
+        return;
+    _regionPolicy[subsys] = region;
+}
+
+const char* MemRegions::getRegionName(int region)
+{
+    if ((region < 0) || (region >= NUM_REGIONS))
+        return "";
+    return MemRegions_regionNames[region];
+}
+
+const char* MemRegions::getSubsystemName(int subsys)
+{
+    if ((subsys < 0) || (subsys >= NUM_SUBSYSTEMS))
+        return "";
+    return MemRegions_subsysNames[subsys];
+}
+
+bool MemRegions::isPSRAM(void* ptr)
+{
+#ifdef ESP32
+    return esp_ptr_external_ram(ptr);
+#else
+    return false;
+#endif
+}
+
+void MemRegions::getJSON(String& jsonStr)
+{
+    char tmpStr[200];
+#ifdef ESP32
+    bool psramPresent = heap_caps_get_free_size(MALLOC_CAP_SPIRAM) > 0;
+#else
+    bool psramPresent = false;
+#endif
+    snprintf(tmpStr, sizeof(tmpStr), "{\"psram\":%d,\"regions\":{", psramPresent ? 1 : 0);
+    jsonStr = tmpStr;
+    for (int regionIdx = 0; regionIdx < NUM_REGIONS; regionIdx++)
+    {
+        uint32_t freeBytes = 0, usedBytes = 0, minFreeBytes = 0, largestBlock = 0;
+#ifdef ESP32
+        multi_heap_info_t heapInfo;
+        heap_caps_get_info(&heapInfo, MemRegions_regionCaps(regionIdx));
+        freeBytes = heapInfo.total_free_bytes;
+        usedBytes = heapInfo.total_allocated_bytes;
+        minFreeBytes = heapInfo.minimum_free_bytes;
+        largestBlock = heapInfo.largest_free_block;
+#endif
+        snprintf(tmpStr, sizeof(tmpStr), "%s\"%s\":{\"size\":%u,\"free\":%u,\"minFree\":%u,\"largest\":%u}",
+                    (regionIdx == 0) ? "" : ",", MemRegions_regionNames[regionIdx],
+                    freeBytes + usedBytes, freeBytes, minFreeBytes, largestBlock);
+        jsonStr += tmpStr;
+    }
+    jsonStr += "},\"subsystems\":{";
+    for (int subsysIdx = 0; subsysIdx < NUM_SUBSYSTEMS; subsysIdx++)
+    {
+        snprintf(tmpStr, sizeof(tmpStr), "%s\"%s\":{\"region\":\"%s\",\"bytes\":%u,\"psramBytes\":%u,\"fails\":%u}",
+                    (subsysIdx == 0) ? "" : ",", MemRegions_subsysNames[subsysIdx],
+                    MemRegions_regionNames[_regionPolicy[subsysIdx]], _allocBytes[subsysIdx].load(),
+                    _allocPSRAMBytes[subsysIdx].load(), _allocFailCount[subsysIdx].load());
+        jsonStr += tmpStr;
+    }
+    jsonStr += "}}";
+}
@@ -0,0 +1,108 @@
+// MemRegions
+// Rob Dobson 2019
+
+#pragma once
+
+#include <Arduino.h>
+#include <stddef.h>
+#include <atomic>
+
+class ConfigBase;
+
+// Placement of large buffers in memory regions (internal RAM, DMA-capable RAM or PSRAM)
+// The region for each subsystem is set in config, e.g. {"motionPipeline":"psram","hdlcRx":"internal"}
+// If a PSRAM allocation fails (e.g. no PSRAM fitted) then internal RAM is used instead
+class MemRegions
+{
+public:
+    enum Region
+    {
+        REGION_INTERNAL,
+        REGION_DMA,
+        REGION_PSRAM,
+        NUM_REGIONS
+    };
+
+    enum Subsystem
+    {
+        SUBSYS_MOTION_PIPELINE,
+        SUBSYS_HDLC_RX,
+        SUBSYS_FILE_CHUNK,
+        SUBSYS_NETLOG_PAUSE,
+        SUBSYS_FILE_LIST,
+        SUBSYS_FILE_PREFETCH,
+        NUM_SUBSYSTEMS
+    };
+
+    // Setup - only affects allocations made afterwards
+    static void setup(ConfigBase& config, const char* pConfigPath = NULL);
+
+    // Allocate and free for a subsystem (size is needed to keep usage stats)
+    static void* alloc(Subsystem subsys, size_t size);
+    // As alloc but failure is fatal (logged then abort) - for callers which can't handle NULL
+    static void* allocOrAbort(Subsystem subsys, size_t size);
+    static void free(Subsystem subsys, void* ptr, size_t size);
+
+    // Region policy
+    static Region getRegion(Subsystem subsys);
+    static void setRegion(Subsystem subsys, Region region);
+
+    // Usage report
+    // {"psram":1,"regions":{"internal":{"size":..,"free":..,"minFree":..,"largest":..},...},
+    //  "subsystems":{"motionPipeline":{"region":"psram","bytes":..,"psramBytes":..},...}}
+    static void getJSON(String& jsonStr);
+
+    static const char* getRegionName(int region);
+    static const char* getSubsystemName(int subsys);
+
+private:
+    // Size is set by the initializer (checked against NUM_SUBSYSTEMS) in MemRegions.cpp
+    static Region _regionPolicy[];
+    // Usage stats - updated by allocations from several tasks
+    static std::atomic<uint32_t> _allocBytes[NUM_SUBSYSTEMS];
+    static std::atomic<uint32_t> _allocPSRAMBytes[NUM_SUBSYSTEMS];
+    static std::atomic<uint32_t> _allocFailCount[NUM_SUBSYSTEMS];
+    static bool isPSRAM(void* ptr);
+};
+
+// Allocator so std containers can be placed according to the policy for a subsystem
+template <class T, MemRegions::Subsystem SUBSYS>
+class MemRegionAllocator
+{
+public:
+    typedef T value_type;
+    template <class U>
+    struct rebind
+    {
+        typedef MemRegionAllocator<U, SUBSYS> other;
+    };
+
+    MemRegionAllocator()
+    {
+    }
+    template <class U>
+    MemRegionAllocator(const MemRegionAllocator<U, SUBSYS>&)
+    {
+    }
+
+    // Containers don't check for NULL so running out of memory is fatal
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(MemRegions::allocOrAbort(SUBSYS, n * sizeof(T)));
+    }
+    void deallocate(T* ptr, size_t n)
+    {
+        MemRegions::free(SUBSYS, ptr, n * sizeof(T));
+    }
+};
+
+template <class T, class U, MemRegions::Subsystem SUBSYS>
+bool operator==(const MemRegionAllocator<T, SUBSYS>&, const MemRegionAllocator<U, SUBSYS>&)
+{
+    return true;
+}
+template <class T, class U, MemRegions::Subsystem SUBSYS>
+bool operator!=(const MemRegionAllocator<T, SUBSYS>&, const MemRegionAllocator<U, SUBSYS>&)
+{
+    return false;
+}
@@ -160,6 +160,8 @@ void NetLog::setup(ConfigBase *pConfig, const char* systemName)
 {
     _systemName = systemName;
     _pConfigBase = pConfig;
+    if (!_pChBuffer)
+        _pChBuffer = (uint8_t*)MemRegions::alloc(MemRegions::SUBSYS_NETLOG_PAUSE, _pauseBufferMaxChars);
     if (!pConfig)
         return;
     if (_logToSerial && _serialPort == 0)
@@ -10,6 +10,7 @@
 #include "MQTTManager.h"
 #include "CommandSerial.h"
 #include "RingBufferPosn.h"
+#include "MemRegions.h"
 
 class NetLog : public Print
 {
@@ -66,7 +67,9 @@ private:
     bool _isPaused;
     uint32_t _pauseTimeMs;
     uint32_t _pauseStartedMs;
+    // Pause buffer is allocated from MemRegions in setup()
     uint8_t *_pChBuffer;
+    int _pauseBufferMaxChars;
     RingBufferPosn _chBufferPosn;
 
 public:
@@ -92,7 +95,8 @@ public:
         _pauseStartedMs = 0;
         _pauseTimeMs = pauseTimeMs;
         _isPaused = false;
-        _pChBuffer = new uint8_t[pauseBufferMaxChars];
+        _pChBuffer = NULL;
+        _pauseBufferMaxChars = pauseBufferMaxChars;
     }
 
     void setLogLevel(const char* logLevelStr);
@@ -27,8 +27,15 @@ RdOTAUpdate::RdOTAUpdate()
     _directUpdateRestartPending = false;
     _directUpdateRestartPendingStartMs = 0;
     // Direct update status
-    _otaDirectUpdateHandle = -1;
     _otaDirectInProgress = false;
+    _otaDirectFinalBlockRxd = false;
+    _otaDirectFailed = false;
+    _otaDirectRingBuf = NULL;
+    // Task and flash writing
+    _otaTaskHandle = NULL;
+    _flashWriteOkFn = NULL;
+    _lastFlashWriteMs = 0;
+    _flashWritesDeferred = 0;
 }
 
 void RdOTAUpdate::setup(ConfigBase &config, const char *projectName, const char *currentVers)
@@ -45,6 +52,27 @@ void RdOTAUpdate::setup(ConfigBase &config, const char *projectName, const char
     _updateServerPort = otaConfig.getLong("port", 80);
     // Init timer
     _updateStateEntryMs = millis();
+
+    // Task to do the work so it doesn't hold up the main loop
+    if (_otaEnabled && !_otaTaskHandle)
+    {
+        if (xTaskCreatePinnedToCore(otaTaskFn, "OTA", OTA_TASK_STACK_SIZE, this, 
+                        OTA_TASK_PRIORITY, &_otaTaskHandle, OTA_TASK_CORE) != pdPASS)
+        {
+            _otaTaskHandle = NULL;
+            Log.warning("%ssetup failed to start task - using main loop\n", MODULE_PREFIX);
+        }
+    }
+}
+
+void RdOTAUpdate::otaTaskFn(void* pParam)
+{
+    RdOTAUpdate* pThis = (RdOTAUpdate*)pParam;
+    while (true)
+    {
+        pThis->serviceTask();
+        vTaskDelay(pdMS_TO_TICKS(OTA_TASK_PERIOD_MS));
+    }
 }
 
 void RdOTAUpdate::requestUpdateCheck()
@@ -59,10 +87,39 @@ bool RdOTAUpdate::isInProgress()
 
 void RdOTAUpdate::service()
 {
-    // Check if enabled
-    if (!_otaEnabled)
+    // Check if enabled - if the task is running it does everything
+    if (!_otaEnabled || _otaTaskHandle)
         return;
+    serviceTask();
+}
 
+bool RdOTAUpdate::flashWriteOk()
+{
+    bool directBacklog = _otaDirectInProgress && _otaDirectRingBuf &&
+                (xRingbufferGetCurFreeSize(_otaDirectRingBuf) < DIRECT_RING_BUF_SIZE / 2);
+    if (!directBacklog && !Utils::isTimeout(millis(), _lastFlashWriteMs, MIN_MS_BETWEEN_FLASH_WRITES))
+        return false;
+    if (_flashWriteOkFn && !_flashWriteOkFn())
+    {
+        _flashWritesDeferred++;
+        return false;
+    }
+    return true;
+}
+
+int RdOTAUpdate::maxBytesToWrite()
+{
+    int bytesToSectorEnd = FLASH_SECTOR_SIZE - (_updateBytesWritten % FLASH_SECTOR_SIZE);
+    if (bytesToSectorEnd > MAX_RX_BUFFER_SIZE)
+        return MAX_RX_BUFFER_SIZE;
+    // Writing up to the sector end would write flash
+    if (!flashWriteOk())
+        return bytesToSectorEnd - 1;
+    return bytesToSectorEnd;
+}
+
+void RdOTAUpdate::serviceTask()
+{
     // Check if OTA direct restart is pending
     if (_directUpdateRestartPending && 
             Utils::isTimeout(millis(), _directUpdateRestartPendingStartMs, TIME_TO_WAIT_BEFORE_RESTART_MS))
@@ -80,15 +137,20 @@ void RdOTAUpdate::service()
         _firmwareCheckRequired = false;
     }
 
+    // Data from direct update
+    serviceDirect();
+
     // Handle connected - pump any data
     if (_wifiClient.connected())
     {
-        // Check for data available
+        // Check for data available - when downloading the amount read is limited to what can
+        // be written to flash now (data not read is held back by TCP flow control)
         int numAvail = _wifiClient.available();
         int numToRead = numAvail;
-        if (numAvail > MAX_RX_BUFFER_SIZE)
+        int maxToRead = (_otaUpdateState == OTA_UPDATE_STATE_DOWNLOADING) ? maxBytesToWrite() : MAX_RX_BUFFER_SIZE;
+        if (numAvail > maxToRead)
         {
-            numToRead = MAX_RX_BUFFER_SIZE;
+            numToRead = maxToRead;
         }
         if (numToRead > 0)
         {
@@ -145,7 +207,7 @@ void RdOTAUpdate::service()
             setState(OTA_UPDATE_STATE_IDLE);
 
             // Restart CPU to complete process
-            Log.notice("%sRestarting now .....\n", MODULE_PREFIX);
+            Log.notice("%sRestarting now (flash writes deferred %d) .....\n", MODULE_PREFIX, _flashWritesDeferred);
             ESP.restart();
         }
         break;
@@ -296,16 +358,14 @@ bool RdOTAUpdate::updateStart(unsigned int updateFileLen)
 
 void RdOTAUpdate::updateChunk(uint8_t *pData, int dataReceivedLen)
 {
-    bool bytesWritten = Update.write(pData, dataReceivedLen);
+    size_t bytesWritten = Update.write(pData, dataReceivedLen);
     if (bytesWritten > 0)
     {
-        // Note the write method always seems to return 1 but it works ok so I guess it must
-        // be writing the remaining data ok
-        // if (bytesWritten != dataReceivedLen)
-        // {
-        //     Log.verbose("Flash write returned %d != %d\n", bytesWritten, dataReceivedLen);
-        // }
-        _updateBytesWritten += bytesWritten;
+        // Check if a flash sector was written
+        int newBytesWritten = _updateBytesWritten + bytesWritten;
+        if ((_updateBytesWritten / FLASH_SECTOR_SIZE) != (newBytesWritten / FLASH_SECTOR_SIZE))
+            _lastFlashWriteMs = millis();
+        _updateBytesWritten = newBytesWritten;
         // Log.verbose("Progress %d\n", (100 * _updateBytesWritten) / _targetFileLength);
     }
     else
@@ -496,7 +556,6 @@ void RdOTAUpdate::directFirmwareUpdatePart(String &filename, size_t contentLen,
         return;
     }
     // Log.trace("%sapiESPFirmwarePart %d, %d, %d, %d\n", MODULE_PREFIX, contentLen, index, len, finalBlock);
-    const esp_partition_t* update_partition = esp_ota_get_next_update_partition(NULL);
     // Check if first part
     if (index == 0)
     {
@@ -516,61 +575,119 @@ void RdOTAUpdate::directFirmwareUpdatePart(String &filename, size_t contentLen,
         Log.warning("%sapiESPFirmwarePart running partition type %d subtype %d (offset 0x%x)\n",
                     MODULE_PREFIX, running->type, running->subtype, running->address);
 
-        Log.warning("%swriting to partition subtype %d at offset 0x%x\n",
-                MODULE_PREFIX, update_partition->subtype, update_partition->address);
+        // Can't do both kinds of update at once
+        if (_otaDirectInProgress || isInProgress())
+        {
+            Log.warning("%sapiESPFirmwarePart update already in progress\n", MODULE_PREFIX);
+            return;
+        }
+
+        // Ring buffer to pass data to the OTA task
+        if (!_otaDirectRingBuf)
+            _otaDirectRingBuf = xRingbufferCreate(DIRECT_RING_BUF_SIZE, RINGBUF_TYPE_BYTEBUF);
 
-        esp_err_t err = esp_ota_begin(update_partition, OTA_SIZE_UNKNOWN, &_otaDirectUpdateHandle);
-        if (err != ESP_OK) 
+        // The Update library erases flash a sector at a time as it writes (the content length
+        // includes the multipart form data so the image size isn't known)
+        _updateBytesWritten = 0;
+        _otaDirectFinalBlockRxd = false;
+        _otaDirectFailed = false;
+        if (!_otaDirectRingBuf || !Update.begin(UPDATE_SIZE_UNKNOWN, U_FLASH))
         {
-            Log.warning("%sesp_ota_begin failed, error=%d\n", MODULE_PREFIX, err);
+            Log.warning("%sapiESPFirmwarePart begin failed\n", MODULE_PREFIX);
         }
         else
         {
             _otaDirectInProgress = true;
-            Log.warning("%sesp_ota_begin succeeded\n", MODULE_PREFIX);
+            Log.warning("%sapiESPFirmwarePart begin succeeded\n", MODULE_PREFIX);
         }
     }
 
     // Check if in progress
-    if (_otaDirectInProgress)
+    if (_otaDirectInProgress && !_otaDirectFailed)
     {
-        esp_err_t err = esp_ota_write(_otaDirectUpdateHandle, (const void *)data, len);
-        if (err != ESP_OK) 
+        // Pass to the OTA task - this is the web server task so it only waits briefly for space
+        // and the update fails if flash writing is held off for longer (e.g. by motion)
+        size_t dataPos = 0;
+        unsigned long sendStartMs = millis();
+        while (dataPos < len)
         {
-            Log.warning("%sesp_ota_write failed! err=0x%x\n", MODULE_PREFIX, err);
-        }
-    }
-
-    // Check if final block
-    if (finalBlock && _otaDirectInProgress)
-    {
-        _otaDirectInProgress = false;
-        if (esp_ota_end(_otaDirectUpdateHandle) != ESP_OK) 
-        {
-            Log.warning("%sesp_ota_end failed!\n", MODULE_PREFIX);
-        }
-        else
-        {
-            esp_err_t err = esp_ota_set_boot_partition(update_partition);
-            if (err != ESP_OK) 
-            {
-                Log.warning("%sesp_ota_set_boot_partition failed! err=0x%x\n", MODULE_PREFIX, err);
-            }
-            else
+            size_t bytesToSend = len - dataPos;
+            if (bytesToSend > DIRECT_RING_BUF_SIZE / 2)
+                bytesToSend = DIRECT_RING_BUF_SIZE / 2;
+            unsigned long waitedMs = millis() - sendStartMs;
+            TickType_t waitTicks = (waitedMs < DIRECT_RING_BUF_WAIT_MS) ? pdMS_TO_TICKS(DIRECT_RING_BUF_WAIT_MS - waitedMs) : 0;
+            if (xRingbufferSend(_otaDirectRingBuf, data + dataPos, bytesToSend, waitTicks) != pdTRUE)
             {
-                Log.notice("%sesp_ota_set_boot_partition ok ... reboot pending\n", MODULE_PREFIX, err);
-                _directUpdateRestartPendingStartMs = millis();
-                _directUpdateRestartPending = true;
+                Log.warning("%sapiESPFirmwarePart flash writes not keeping up - update abandoned\n", MODULE_PREFIX);
+                _otaDirectFailed = true;
+                break;
             }
+            dataPos += bytesToSend;
         }
     }
+
+    // Check if final block - the OTA task completes the update when it has written everything
+    if (finalBlock && _otaDirectInProgress)
+        _otaDirectFinalBlockRxd = true;
 }
 
 void RdOTAUpdate::directFirmwareUpdateDone()
 {
     if (_otaDirectInProgress)
     {
-        esp_ota_end(_otaDirectUpdateHandle);
+        _otaDirectFinalBlockRxd = true;
     }
     Log.trace("%sapiESPFirmwareUpdate DONE\n", MODULE_PREFIX);
 }
+
+// Called from the OTA task to write data received by direct update
+void RdOTAUpdate::serviceDirect()
+{
+    if (!_otaDirectInProgress)
+        return;
+
+    // Must check for the final block before checking for data to avoid a race with the receiver
+    bool finalBlockRxd = _otaDirectFinalBlockRxd;
+    if (!_otaDirectFailed)
+    {
+        // Write what we can
+        int maxBytes = maxBytesToWrite();
+        if (maxBytes <= 0)
+            return;
+        size_t rxLen = 0;
+        uint8_t* pData = (uint8_t*)xRingbufferReceiveUpTo(_otaDirectRingBuf, &rxLen, 0, maxBytes);
+        if (pData)
+        {
+            updateChunk(pData, rxLen);
+            vRingbufferReturnItem(_otaDirectRingBuf, pData);
+            return;
+        }
+        if (!finalBlockRxd)
+            return;
+    }
+
+    // Complete (or abandon) the update
+    _otaDirectInProgress = false;
+    if (_otaDirectFailed)
+    {
+        Update.abort();
+        Log.warning("%sdirect update failed after %d bytes\n", MODULE_PREFIX, _updateBytesWritten);
+    }
+    else if (!Update.end(true))
+    {
+        Log.warning("%sdirect update end failed err %d\n", MODULE_PREFIX, Update.getError());
+    }
+    else
+    {
+        Log.notice("%sdirect update %d bytes written ok (flash writes deferred %d) ... reboot pending\n", MODULE_PREFIX,
+                    _updateBytesWritten, _flashWritesDeferred);
+        _directUpdateRestartPendingStartMs = millis();
+        _directUpdateRestartPending = true;
+    }
+
+    // Empty the ring buffer of anything left
+    size_t rxLen = 0;
+    uint8_t* pData = NULL;
+    while ((pData = (uint8_t*)xRingbufferReceiveUpTo(_otaDirectRingBuf, &rxLen, 0, DIRECT_RING_BUF_SIZE)) != NULL)
+        vRingbufferReturnItem(_otaDirectRingBuf, pData);
+}
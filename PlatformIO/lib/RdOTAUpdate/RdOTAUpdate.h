@@ -9,7 +9,15 @@
 #include "Utils.h"
 #include "ConfigBase.h"
 #include "esp_ota_ops.h"
+#include "freertos/ringbuf.h"
+#include <functional>
 
+// Callback to check if it is ok to write to flash now (e.g. motion isn't about to run out of blocks)
+typedef std::function<bool()> RdOTAUpdateFlashWriteOkFnType;
+
+// Downloads and flash writes are done in a low priority task (not the main loop) and flash
+// is written at most one sector at a time with a gap between writes - writes are deferred
+// while the flash write ok callback returns false
 class RdOTAUpdate
 {
 private:
@@ -44,7 +52,21 @@ private:
     const int OTA_FILEINFO_MAXLEN = 1000;
 
     // Max number of bytes in one chunk
-    const int MAX_RX_BUFFER_SIZE = 100;
+    static const int MAX_RX_BUFFER_SIZE = 1024;
+
+    // Task which does the work
+    static const int OTA_TASK_STACK_SIZE = 6000;
+    static const int OTA_TASK_PRIORITY = 1;
+    static const int OTA_TASK_CORE = 0;
+    static const int OTA_TASK_PERIOD_MS = 2;
+    TaskHandle_t _otaTaskHandle;
+
+    // Flash writes - the Update library writes (and erases) a sector when its buffer is full
+    static const int FLASH_SECTOR_SIZE = 4096;
+    static const int MIN_MS_BETWEEN_FLASH_WRITES = 50;
+    RdOTAUpdateFlashWriteOkFnType _flashWriteOkFn;
+    unsigned long _lastFlashWriteMs;
+    uint32_t _flashWritesDeferred;
 
     // Master flag indicating update check is needed
     bool _firmwareCheckRequired;
@@ -86,9 +108,15 @@ private:
     bool _directUpdateRestartPending;
     int _directUpdateRestartPendingStartMs;
 
-    // Direct update vars
-    bool _otaDirectInProgress;
-    esp_ota_handle_t _otaDirectUpdateHandle;
+    // Direct update vars - data is passed to the OTA task through a ring buffer (the web server
+    // task only waits briefly for space - the gap between flash writes is skipped when the
+    // buffer is half full so the OTA task keeps up)
+    static const int DIRECT_RING_BUF_SIZE = 8192;
+    static const int DIRECT_RING_BUF_WAIT_MS = 200;
+    volatile bool _otaDirectInProgress;
+    volatile bool _otaDirectFinalBlockRxd;
+    volatile bool _otaDirectFailed;
+    RingbufHandle_t _otaDirectRingBuf;
 
 public:
     RdOTAUpdate();
@@ -105,12 +133,30 @@ public:
     // Call this frequently
     void service();
 
+    // Set callback used to check if flash can be written now
+    void setFlashWriteOkCallback(RdOTAUpdateFlashWriteOkFnType flashWriteOkFn)
+    {
+        _flashWriteOkFn = flashWriteOkFn;
+    }
+
     // Direct firmware update
     void directFirmwareUpdatePart(String& filename, size_t contentLen, size_t index, 
                 uint8_t *data, size_t len, bool finalBlock);
     void directFirmwareUpdateDone();
 
 private:
+    // Task and work done in it
+    static void otaTaskFn(void* pParam);
+    void serviceTask();
+    void serviceDirect();
+
+    // Check flash write can be done now
+    bool flashWriteOk();
+
+    // Max bytes which can be written now - stops at the end of the current flash sector
+    // unless a flash write is ok
+    int maxBytesToWrite();
+
     // Start an update process
     void startUpdateProcess();
 
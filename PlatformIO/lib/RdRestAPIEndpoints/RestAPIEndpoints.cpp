@@ -41,7 +41,8 @@ void RestAPIEndpoints::addEndpoint(const char *pEndpointStr, RestAPIEndpointDef:
                     bool pNoCache,
                     const char *pExtraHeaders,
                     RestAPIFnBody callbackBody,
-                    RestAPIFnUpload callbackUpload)
+                    RestAPIFnUpload callbackUpload,
+                    RestAPIFnAsync callbackAsync)
 {
     // Check for overflow
     if (_numEndpoints >= MAX_WEB_SERVER_ENDPOINTS)
@@ -56,7 +57,7 @@ void RestAPIEndpoints::addEndpoint(const char *pEndpointStr, RestAPIEndpointDef:
                                 pDescription,
                                 pContentType, pContentEncoding,
                                 pNoCache, pExtraHeaders,
-                                callbackBody, callbackUpload);
+                                callbackBody, callbackUpload, callbackAsync);
     _pEndpoints[_numEndpoints] = pNewEndpointDef;
     _numEndpoints++;
 }
@@ -81,8 +82,11 @@ void RestAPIEndpoints::handleApiRequest(const char *requestStr, String &retStr)
 {
     // Get the command
     static char *emptyStr = (char *)"";
-    String requestEndpoint = getNthArgStr(requestStr, 0);
-    requestEndpoint.toUpperCase();
+    RestAPIArgs args;
+    splitArgs(requestStr, args);
+    StrView requestEndpoint = args.getField(0);
+    char endpointName[MAX_ENDPOINT_NAME_LEN];
+    requestEndpoint.copyTo(endpointName, sizeof(endpointName));
     char *argStart = strstr(requestStr, "/");
     retStr = "";
 
@@ -98,7 +102,7 @@ void RestAPIEndpoints::handleApiRequest(const char *requestStr, String &retStr)
     bool endpointMatched = false;
     int numEndpoints = getNumEndpoints();
     Log.verbose("%sreqStr %s requestEndpoint %s, num endpoints %d\n", MODULE_PREFIX, 
-                requestStr, requestEndpoint.c_str(), numEndpoints);
+                requestStr, endpointName, numEndpoints);
     for (int i = 0; i < numEndpoints; i++)
     {
         RestAPIEndpointDef* pEndpoint = getNthEndpoint(i);
@@ -110,7 +114,7 @@ void RestAPIEndpoints::handleApiRequest(const char *requestStr, String &retStr)
         {
             continue;
         }
-        if (requestEndpoint.equalsIgnoreCase(pEndpoint->_endpointStr))
+        if (requestEndpoint.equalsIgnoreCase(pEndpoint->_endpointStr.c_str()))
         {
             String reqStr(requestStr);
             pEndpoint->callback(reqStr, retStr);
@@ -119,7 +123,7 @@ void RestAPIEndpoints::handleApiRequest(const char *requestStr, String &retStr)
     }
     if (!endpointMatched)
     {
-        Log.notice("%sendpoint %s not found\n", MODULE_PREFIX, requestEndpoint.c_str());
+        Log.notice("%sendpoint %s not found\n", MODULE_PREFIX, endpointName);
     }
 }
 
@@ -162,6 +166,22 @@ String RestAPIEndpoints::getNthArgStr(const char *argStr, int argIdx)
     return oStr;
 }
 
+// Split a request into the endpoint and its args in a single pass
+void RestAPIEndpoints::splitArgs(const char *argStr, RestAPIArgs &args)
+{
+    if (*argStr == '/')
+        argStr++;
+    args.split(argStr, "/?");
+}
+
+// Get an arg from a split request
+String RestAPIEndpoints::getArgStr(const RestAPIArgs &args, int argIdx)
+{
+    String oStr;
+    args.getField(argIdx).toString(oStr);
+    return unencodeHTTPChars(oStr);
+}
+
 // Get position and length of nth arg
 const char* RestAPIEndpoints::getArgPtrAndLen(const char *argStr, int argIdx, int &argLen)
 {
@@ -5,12 +5,52 @@
 #include <Arduino.h>
 #include <ArduinoLog.h>
 #include <functional>
+#include <memory>
+#include <atomic>
+#include "FieldSplitter.h"
 
 // Callback function for any endpoint
 typedef std::function<void(String &reqStr, String &respStr)> RestAPIFunction;
 typedef std::function<void(String &reqStr, uint8_t *pData, size_t len, size_t index, size_t total)> RestAPIFnBody;
 typedef std::function<void(String &reqStr, String& filename, size_t contentLen, size_t index, uint8_t *data, size_t len, bool finalBlock)> RestAPIFnUpload;
 
+// Response to a request which is completed later (e.g. by another task) - the web server sends
+// it when complete() has been called
+class RestAPIAsyncResp
+{
+public:
+    RestAPIAsyncResp()
+    {
+        _isComplete.store(false);
+    }
+    void complete(const String& respStr)
+    {
+        _respStr = respStr;
+        _isComplete.store(true, std::memory_order_release);
+    }
+    bool isComplete()
+    {
+        return _isComplete.load(std::memory_order_acquire);
+    }
+    const String& getRespStr()
+    {
+        return _respStr;
+    }
+
+private:
+    std::atomic<bool> _isComplete;
+    String _respStr;
+};
+typedef std::shared_ptr<RestAPIAsyncResp> RestAPIAsyncRespPtr;
+
+// Callback for an endpoint whose response is completed later (used by the web server in place
+// of the normal callback if set)
+typedef std::function<void(String &reqStr, RestAPIAsyncRespPtr pResp)> RestAPIFnAsync;
+
+// Request split into the endpoint (arg 0) and its args - any args beyond the max are left in the last
+static const int RESTAPI_MAX_ARGS = 10;
+typedef FieldSplitter<RESTAPI_MAX_ARGS> RestAPIArgs;
+
 // Definition of an endpoint
 class RestAPIEndpointDef
 {
@@ -38,7 +78,8 @@ public:
                        bool noCache,
                        const char *pExtraHeaders,
                        RestAPIFnBody callbackBody,
-                       RestAPIFnUpload callbackUpload
+                       RestAPIFnUpload callbackUpload,
+                       RestAPIFnAsync callbackAsync
                        )
     {
         _endpointStr = pStr;
@@ -47,6 +88,7 @@ public:
         _callback = callback;
         _callbackBody = callbackBody;
         _callbackUpload = callbackUpload;
+        _callbackAsync = callbackAsync;
         _description = pDescription;
         if (pContentType)
             _contentType = pContentType;
@@ -66,6 +108,7 @@ public:
     RestAPIFunction _callback;
     RestAPIFnBody _callbackBody;
     RestAPIFnUpload _callbackUpload;
+    RestAPIFnAsync _callbackAsync;
     bool _noCache;
     String _extraHeaders;
 
@@ -88,6 +131,17 @@ public:
             _callbackUpload(req, filename, contentLen, index, data, len, finalBlock);
     }
 
+    bool hasCallbackAsync()
+    {
+        return (bool)_callbackAsync;
+    }
+
+    void callbackAsync(String &req, RestAPIAsyncRespPtr pResp)
+    {
+        if (_callbackAsync)
+            _callbackAsync(req, pResp);
+    }
+
 };
 
 // Collection of endpoints
@@ -97,6 +151,9 @@ public:
     // Max endpoints we can accommodate
     static const int MAX_WEB_SERVER_ENDPOINTS = 50;
 
+    // Max length of an endpoint name (only used for logging)
+    static const int MAX_ENDPOINT_NAME_LEN = 40;
+
     RestAPIEndpoints()
     {
         _numEndpoints = 0;
@@ -120,7 +177,8 @@ public:
                      bool pNoCache = true,
                      const char *pExtraHeaders = NULL,
                      RestAPIFnBody callbackBody = NULL,
-                     RestAPIFnUpload callbackUpload = NULL);
+                     RestAPIFnUpload callbackUpload = NULL,
+                     RestAPIFnAsync callbackAsync = NULL);
 
     // Get the endpoint definition corresponding to a requested endpoint
     RestAPIEndpointDef *getEndpoint(const char *pEndpointStr);
@@ -137,6 +195,12 @@ public:
     // Get Nth argument from a string
     static String getNthArgStr(const char *argStr, int argIdx);
 
+    // Split a request into the endpoint and its args in a single pass
+    static void splitArgs(const char *argStr, RestAPIArgs &args);
+
+    // Get an arg from a split request
+    static String getArgStr(const RestAPIArgs &args, int argIdx);
+
     // Get position and length of nth arg
     static const char *getArgPtrAndLen(const char *argStr, int argIdx, int &argLen);
 
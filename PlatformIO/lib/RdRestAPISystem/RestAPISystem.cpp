@@ -3,6 +3,7 @@
 
 #include "RestAPISystem.h"
 #include "RestAPIEndpoints.h"
+#include "MemRegions.h"
 
 static const char* MODULE_PREFIX = "RestAPISystem: ";
 
@@ -52,6 +53,9 @@ void RestAPISystem::setup(RestAPIEndpoints &endpoints)
     endpoints.addEndpoint("v", RestAPIEndpointDef::ENDPOINT_CALLBACK, RestAPIEndpointDef::ENDPOINT_GET, 
                     std::bind(&RestAPISystem::apiGetVersion, this, std::placeholders::_1, std::placeholders::_2), 
                     "Get version info");
+    endpoints.addEndpoint("memregions", RestAPIEndpointDef::ENDPOINT_CALLBACK, RestAPIEndpointDef::ENDPOINT_GET, 
+                    std::bind(&RestAPISystem::apiMemRegions, this, std::placeholders::_1, std::placeholders::_2), 
+                    "Get memory region (internal/dma/psram) usage and placement of large buffers");
     endpoints.addEndpoint("loglevel", RestAPIEndpointDef::ENDPOINT_CALLBACK, RestAPIEndpointDef::ENDPOINT_GET, 
                     std::bind(&RestAPISystem::apiNetLogLevel, this, std::placeholders::_1, std::placeholders::_2), 
                     "Set log level");
@@ -82,9 +86,17 @@ void RestAPISystem::setup(RestAPIEndpoints &endpoints)
     endpoints.addEndpoint("reformatfs", RestAPIEndpointDef::ENDPOINT_CALLBACK, RestAPIEndpointDef::ENDPOINT_GET, 
                     std::bind(&RestAPISystem::apiReformatFS, this, std::placeholders::_1, std::placeholders::_2), 
                     "Reformat file system e.g. /spiffs");
+    endpoints.addEndpoint("fsbench", RestAPIEndpointDef::ENDPOINT_CALLBACK, RestAPIEndpointDef::ENDPOINT_GET, 
+                    std::bind(&RestAPISystem::apiFileSysBenchmark, this, std::placeholders::_1, std::placeholders::_2), 
+                    "Start file system benchmark e.g. /spiffs/20 ... number of files");
+    endpoints.addEndpoint("fsbenchresult", RestAPIEndpointDef::ENDPOINT_CALLBACK, RestAPIEndpointDef::ENDPOINT_GET, 
+                    std::bind(&RestAPISystem::apiFileSysBenchmarkResult, this, std::placeholders::_1, std::placeholders::_2), 
+                    "Result of last file system benchmark");
     endpoints.addEndpoint("filelist", RestAPIEndpointDef::ENDPOINT_CALLBACK, RestAPIEndpointDef::ENDPOINT_GET, 
                     std::bind(&RestAPISystem::apiFileList, this, std::placeholders::_1, std::placeholders::_2), 
-                    "List files in folder e.g. /spiffs/folder ... ~ for / in folder");
+                    "List files in folder e.g. /spiffs/folder ... ~ for / in folder",
+                    NULL, NULL, true, NULL, NULL, NULL,
+                    std::bind(&RestAPISystem::apiFileListAsync, this, std::placeholders::_1, std::placeholders::_2));
     endpoints.addEndpoint("fileread", RestAPIEndpointDef::ENDPOINT_CALLBACK, RestAPIEndpointDef::ENDPOINT_GET, 
                     std::bind(&RestAPISystem::apiFileRead, this, std::placeholders::_1, std::placeholders::_2), 
                     "Read file ... name", "text/plain");
@@ -205,15 +217,17 @@ void RestAPISystem::service()
 
 void RestAPISystem::apiWifiSet(String &reqStr, String &respStr)
 {
+    RestAPIArgs args;
+    RestAPIEndpoints::splitArgs(reqStr.c_str(), args);
     bool rslt = false;
     // Get SSID
-    String ssid = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 1);
+    String ssid = RestAPIEndpoints::getArgStr(args, 1);
     Log.trace("%sWiFi SSID %s\n", MODULE_PREFIX, ssid.c_str());
     // Get pw
-    String pw = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 2);
+    String pw = RestAPIEndpoints::getArgStr(args, 2);
     Log.trace("%sWiFi PW %s\n", MODULE_PREFIX, pw.c_str());
     // Get hostname
-    String hostname = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 3);
+    String hostname = RestAPIEndpoints::getArgStr(args, 3);
     Log.trace("%sHostname %s\n", MODULE_PREFIX, hostname.c_str());
     // Check if both SSID and pw have now been set
     if (ssid.length() != 0 && pw.length() != 0)
@@ -247,20 +261,22 @@ void RestAPISystem::apiWifiIntAntenna(String &reqStr, String &respStr)
 
 void RestAPISystem::apiMQTTSet(String &reqStr, String &respStr)
 {
+    RestAPIArgs args;
+    RestAPIEndpoints::splitArgs(reqStr.c_str(), args);
     // Get Server
-    String server = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 1);
+    String server = RestAPIEndpoints::getArgStr(args, 1);
     Log.trace("%sMQTTServer %s\n", MODULE_PREFIX, server.c_str());
     // Get mqtt in topic
-    String inTopic = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 2);
+    String inTopic = RestAPIEndpoints::getArgStr(args, 2);
     inTopic.replace("~", "/");
     Log.trace("%sMQTTInTopic %s\n", MODULE_PREFIX, inTopic.c_str());
     // Get mqtt out topic
-    String outTopic = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 3);
+    String outTopic = RestAPIEndpoints::getArgStr(args, 3);
     outTopic.replace("~", "/");
     Log.trace("%sMQTTOutTopic %s\n", MODULE_PREFIX, outTopic.c_str());
     // Get port
     int portNum = MQTTManager::DEFAULT_MQTT_PORT;
-    String port = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 4);
+    String port = RestAPIEndpoints::getArgStr(args, 4);
     if (port.length() == 0)
         portNum = port.toInt();
     Log.trace("%sMQTTPort %d\n", MODULE_PREFIX, portNum);
@@ -290,9 +306,11 @@ void RestAPISystem::apiNetLogLevel(String &reqStr, String &respStr)
 
 void RestAPISystem::apiNetLogMQTT(String &reqStr, String &respStr)
 {
+    RestAPIArgs args;
+    RestAPIEndpoints::splitArgs(reqStr.c_str(), args);
     // Set MQTT as a destination for logging
-    String onOffFlag = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 1);
-    String topicStr = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 2);
+    String onOffFlag = RestAPIEndpoints::getArgStr(args, 1);
+    String topicStr = RestAPIEndpoints::getArgStr(args, 2);
     Log.trace("%sNetLogMQTT %s, topic %s\n", MODULE_PREFIX, onOffFlag.c_str(), topicStr.c_str());
     _netLog.setMQTT(onOffFlag != "0", topicStr.c_str());
     Utils::setJsonBoolResult(respStr, true);
@@ -300,9 +318,11 @@ void RestAPISystem::apiNetLogMQTT(String &reqStr, String &respStr)
 
 void RestAPISystem::apiNetLogSerial(String &reqStr, String &respStr)
 {
+    RestAPIArgs args;
+    RestAPIEndpoints::splitArgs(reqStr.c_str(), args);
     // Set Serial as a destination for logging
-    String onOffFlag = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 1);
-    String portStr = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 2);
+    String onOffFlag = RestAPIEndpoints::getArgStr(args, 1);
+    String portStr = RestAPIEndpoints::getArgStr(args, 2);
     Log.trace("%sNetLogSerial enabled %s, port %s\n", MODULE_PREFIX, onOffFlag.c_str(), portStr.c_str());
     _netLog.setSerial(onOffFlag != "0", portStr.c_str());
     Utils::setJsonBoolResult(respStr, true);
@@ -319,11 +339,13 @@ void RestAPISystem::apiNetLogCmdSerial(String &reqStr, String &respStr)
 
 void RestAPISystem::apiNetLogHTTP(String &reqStr, String &respStr)
 {
+    RestAPIArgs args;
+    RestAPIEndpoints::splitArgs(reqStr.c_str(), args);
     // Set HTTP as a destination for logging
-    String onOffFlag = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 1);
-    String ipAddrOrHostname = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 2);
-    String httpPortStr = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 3);
-    String urlStr = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 4);
+    String onOffFlag = RestAPIEndpoints::getArgStr(args, 1);
+    String ipAddrOrHostname = RestAPIEndpoints::getArgStr(args, 2);
+    String httpPortStr = RestAPIEndpoints::getArgStr(args, 3);
+    String urlStr = RestAPIEndpoints::getArgStr(args, 4);
     Log.trace("%sNetLogHTTP %s, ipHost %s, port %s, url %s\n", MODULE_PREFIX, 
                         onOffFlag.c_str(), ipAddrOrHostname.c_str(), httpPortStr.c_str(), urlStr.c_str());
     _netLog.setHTTP(onOffFlag != "0", ipAddrOrHostname.c_str(), httpPortStr.c_str(), urlStr.c_str());
@@ -332,10 +354,12 @@ void RestAPISystem::apiNetLogHTTP(String &reqStr, String &respStr)
 
 void RestAPISystem::apiNetLogPT(String &reqStr, String &respStr)
 {
+    RestAPIArgs args;
+    RestAPIEndpoints::splitArgs(reqStr.c_str(), args);
     // Set PaperTrail as a destination for logging
-    String onOffFlag = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 1);
-    String hostName = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 2);
-    String portStr = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 3);
+    String onOffFlag = RestAPIEndpoints::getArgStr(args, 1);
+    String hostName = RestAPIEndpoints::getArgStr(args, 2);
+    String portStr = RestAPIEndpoints::getArgStr(args, 3);
     Log.trace("%sNetLogPT %s, host %s, port %s\n", MODULE_PREFIX, 
                         onOffFlag.c_str(), hostName.c_str(), portStr.c_str());
     _netLog.setPapertrail(onOffFlag != "0", hostName.c_str(), portStr.c_str());
@@ -382,12 +406,14 @@ void RestAPISystem::apiNTPGetConfig(String &reqStr, String &respStr)
 
 void RestAPISystem::apiNTPSetConfig(String &reqStr, String &respStr)
 {
+    RestAPIArgs args;
+    RestAPIEndpoints::splitArgs(reqStr.c_str(), args);
     // Set NTP
-    String gmtOffsetSecsStr = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 1);
-    String dstOffsetSecsStr = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 2);
-    String server1Str = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 3);
-    String server2Str = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 4);
-    String server3Str = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 5);
+    String gmtOffsetSecsStr = RestAPIEndpoints::getArgStr(args, 1);
+    String dstOffsetSecsStr = RestAPIEndpoints::getArgStr(args, 2);
+    String server1Str = RestAPIEndpoints::getArgStr(args, 3);
+    String server2Str = RestAPIEndpoints::getArgStr(args, 4);
+    String server3Str = RestAPIEndpoints::getArgStr(args, 5);
     int gmtOffsetSecs = atoi(gmtOffsetSecsStr.c_str());
     int dstOffsetSecs = atoi(dstOffsetSecsStr.c_str());
     Log.trace("%sNNTPSetup GMT %d DST %d S1 %s S2 %s S3 %s\n", MODULE_PREFIX, 
@@ -414,6 +440,14 @@ void RestAPISystem::apiGetVersion(String &reqStr, String& respStr)
     respStr = "{\"sysType\":\""+ _systemType + "\", \"version\":\"" + _systemVersion + "\"}";
 }
 
+// Get memory region usage
+void RestAPISystem::apiMemRegions(String &reqStr, String& respStr)
+{
+    String regionsJson;
+    MemRegions::getJSON(regionsJson);
+    respStr = "{\"rslt\":\"ok\",\"memRegions\":" + regionsJson + "}";
+}
+
 // Format file system
 void RestAPISystem::apiReformatFS(String &reqStr, String& respStr)
 {
@@ -422,20 +456,57 @@ void RestAPISystem::apiReformatFS(String &reqStr, String& respStr)
     _fileManager.reformat(fileSystemStr, respStr);
 }
 
+// Start a file system benchmark (runs on the file system task - result from fsbenchresult)
+void RestAPISystem::apiFileSysBenchmark(String &reqStr, String& respStr)
+{
+    RestAPIArgs args;
+    RestAPIEndpoints::splitArgs(reqStr.c_str(), args);
+    // File system
+    String fileSystemStr = RestAPIEndpoints::getArgStr(args, 1);
+    // Number of files
+    String numFilesStr = RestAPIEndpoints::getArgStr(args, 2);
+    _fileManager.runBenchmark(fileSystemStr, numFilesStr.toInt(), respStr);
+}
+
+// Result of the last file system benchmark
+void RestAPISystem::apiFileSysBenchmarkResult(String &reqStr, String& respStr)
+{
+    _fileManager.getBenchmarkResult(respStr);
+}
+
 // List files on a file system
 // Uses FileManager.h
 // In the reqStr the first part of the path is the file system name (e.g. sd or spiffs, can be blank to default)
 // The second part of the path is the folder - note that / must be replaced with ~ in folder
 void RestAPISystem::apiFileList(String &reqStr, String& respStr)
 {
+    String fileSystemStr, folderStr;
+    getFileListArgs(reqStr, fileSystemStr, folderStr);
+    _fileManager.getFilesJSON(fileSystemStr, folderStr, respStr);
+}
+
+// List files for the web server - its task doesn't wait for the file system so the response is
+// completed when the listing (made by the file system task) is done
+void RestAPISystem::apiFileListAsync(String &reqStr, RestAPIAsyncRespPtr pResp)
+{
+    String fileSystemStr, folderStr;
+    getFileListArgs(reqStr, fileSystemStr, folderStr);
+    _fileManager.getFilesJSONAsync(fileSystemStr, folderStr, [pResp](bool /* rslt */, const String& respStr) {
+        pResp->complete(respStr);
+    });
+}
+
+void RestAPISystem::getFileListArgs(String &reqStr, String& fileSystemStr, String& folderStr)
+{
+    RestAPIArgs args;
+    RestAPIEndpoints::splitArgs(reqStr.c_str(), args);
     // File system
-    String fileSystemStr = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 1);
+    fileSystemStr = RestAPIEndpoints::getArgStr(args, 1);
     // Folder
-    String folderStr = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 2);
+    folderStr = RestAPIEndpoints::getArgStr(args, 2);
     folderStr.replace("~", "/");
     if (folderStr.length() == 0)
         folderStr = "/";
-    _fileManager.getFilesJSON(fileSystemStr, folderStr, respStr);
 }
 
 // Read file contents
@@ -444,10 +515,12 @@ void RestAPISystem::apiFileList(String &reqStr, String& respStr)
 // The second part of the path is the folder and filename - note that / must be replaced with ~ in folder
 void RestAPISystem::apiFileRead(String &reqStr, String& respStr)
 {
+    RestAPIArgs args;
+    RestAPIEndpoints::splitArgs(reqStr.c_str(), args);
     // File system
-    String fileSystemStr = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 1);
+    String fileSystemStr = RestAPIEndpoints::getArgStr(args, 1);
     // Filename
-    String fileNameStr = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 2);
+    String fileNameStr = RestAPIEndpoints::getArgStr(args, 2);
     fileNameStr.replace("~", "/");
     respStr = _fileManager.getFileContents(fileSystemStr, fileNameStr);
 }
@@ -458,10 +531,12 @@ void RestAPISystem::apiFileRead(String &reqStr, String& respStr)
 // The second part of the path is the filename - note that / must be replaced with ~ in filename
 void RestAPISystem::apiDeleteFile(String &reqStr, String& respStr)
 {
+    RestAPIArgs args;
+    RestAPIEndpoints::splitArgs(reqStr.c_str(), args);
     // File system
-    String fileSystemStr = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 1);
+    String fileSystemStr = RestAPIEndpoints::getArgStr(args, 1);
     // Filename
-    String filenameStr = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 2);
+    String filenameStr = RestAPIEndpoints::getArgStr(args, 2);
     bool rslt = false;
     filenameStr.replace("~", "/");
     if (filenameStr.length() != 0)
@@ -86,14 +86,24 @@ public:
     // Get system version
     void apiGetVersion(String &reqStr, String& respStr);
 
+    // Get memory region usage
+    void apiMemRegions(String &reqStr, String& respStr);
+
     // Format file system
     void apiReformatFS(String &reqStr, String& respStr);
 
+    // Benchmark listing, stat, read and write on a file system (e.g. sd or spiffs, can be blank
+    // to default) - the second part of the path is the number of files to write
+    void apiFileSysBenchmark(String &reqStr, String& respStr);
+    void apiFileSysBenchmarkResult(String &reqStr, String& respStr);
+
     // List files on a file system
     // Uses FileManager.h
     // In the reqStr the first part of the path is the file system name (e.g. sd or spiffs, can be blank to default)
     // The second part of the path is the folder - note that / must be replaced with ~ in folder
     void apiFileList(String &reqStr, String& respStr);
+    void apiFileListAsync(String &reqStr, RestAPIAsyncRespPtr pResp);
+    void getFileListArgs(String &reqStr, String& fileSystemStr, String& folderStr);
 
     // Read file contents
     // Uses FileManager.h
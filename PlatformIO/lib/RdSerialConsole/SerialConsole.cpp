@@ -44,90 +44,194 @@ SerialConsole::CommandRxState SerialConsole::getXonXoff()
 
 void SerialConsole::service()
 {
-    // Check for char
-    int ch = getChar();
-    if (ch == -1)
-        return;
+    // Retry a line which couldn't be accepted - nothing more is read until it is
+    if (!_linePending || dispatchLine())
+    {
+        // Read all available chars (up to the batch size) in one go and handle them - stopping
+        // if a line can't be accepted
+        if ((_rxBatchPos < _rxBatchLen) || (readBatch() > 0))
+        {
+            while (_rxBatchPos < _rxBatchLen)
+            {
+                if (!handleChar(_rxBatch[_rxBatchPos++]))
+                    break;
+            }
+        }
+    }
+    echoFlush();
+    updateFlowControl();
+}
+
+int SerialConsole::readBatch()
+{
+    _rxBatchPos = 0;
+    _rxBatchLen = 0;
+    if (_serialPortNum != 0)
+        return 0;
+    int numToRead = Serial.available();
+    if (numToRead <= 0)
+        return 0;
+    if (numToRead > RX_BATCH_MAX_LEN)
+        numToRead = RX_BATCH_MAX_LEN;
+    _rxBatchLen = Serial.readBytes(_rxBatch, numToRead);
+    return _rxBatchLen;
+}
+
+// Returns false if a line is waiting to be accepted
+bool SerialConsole::handleChar(int ch)
+{
+    // Flow control chars from the host aren't part of a line (or echoed)
+    if ((ch == ASCII_XON) || (ch == ASCII_XOFF))
+        return true;
 
     // Check for line end
     if ((ch == '\r') || (ch == '\n'))
     {
         // Check for terminal sending a CRLF sequence
         if (_prevChar == '\r' || _prevChar == '\n')
-            return;
+            return true;
         _prevChar = ch;
 
-        // Check if empty line - show menu
-        if (_curLine.length() <= 0)
+        // Discard a line which was too long
+        if (_lineTooLong)
         {
-            Serial.printf("Configuration Options ch=%d\n", ch);
-            // Show endpoints
-            if (_pEndpoints)
-            {
-                for (int i = 0; i < _pEndpoints->getNumEndpoints(); i++)
-                {
-                    RestAPIEndpointDef* pEndpoint = _pEndpoints->getNthEndpoint(i);
-                    if (!pEndpoint)
-                        continue;
-                    Serial.println(String(" ") + pEndpoint->_endpointStr + String(": ") +  pEndpoint->_description);
-                    Serial.println();
-                }
-                return;
-            }
+            _lineTooLong = false;
+            _lineLen = 0;
+            _cmdRxState = CommandRx_idle;
+            return true;
         }
-
-        Serial.println();
-        // Check for immediate instructions
-        if (_pEndpoints)
-        {
-            Log.trace("CommsSerial: ->cmdInterp cmdStr %s\n", _curLine.c_str());
-            String retStr;
-            _pEndpoints->handleApiRequest(_curLine.c_str(), retStr);
-            // Display response
-            Serial.println(retStr);
-            Serial.println();
-        }
-
-        // Reset line
-        _curLine = "";
-        _cmdRxState = CommandRx_complete;
-        return;
+        _lineBuf[_lineLen] = 0;
+        return dispatchLine();
     }
 
     // Store previous char for CRLF checks
     _prevChar = ch;
 
     // Check line not too long
-    if (_curLine.length() >= ABS_MAX_LINE_LEN)
+    if (_lineTooLong)
+        return true;
+    if (_lineLen >= ABS_MAX_LINE_LEN)
     {
-        _curLine = "";
+        _lineTooLong = true;
         _cmdRxState = CommandRx_idle;
-        return;
+        return true;
     }
 
     // Check for backspace
     if (ch == 0x08)
     {
-        if (_curLine.length() > 0)
+        if (_lineLen > 0)
         {
-            _curLine.remove(_curLine.length() - 1);
-            Serial.print((char)ch);
-            Serial.print(' ');
-            Serial.print((char)ch);
+            _lineLen--;
+            echo("\b \b", 3);
         }
-        return;
+        return true;
     }
 
     // Output for user to see
-    if (_curLine.length() == 0)
-        Serial.println();
-    Serial.print((char)ch);
+    if (_lineLen == 0)
+        echo("\r\n", 2);
+    char chToEcho = ch;
+    echo(&chToEcho, 1);
 
     // Add char to line
-    _curLine.concat((char)ch);
+    _lineBuf[_lineLen++] = ch;
 
     // Set state to show we're busy getting a command
     _cmdRxState = CommandRx_newChar;
+    return true;
+}
+
+// Returns false if the line can't be accepted yet (it is then retried on later service calls)
+bool SerialConsole::dispatchLine()
+{
+    // Fast path
+    if (_lineHandler && (_lineLen > 0))
+    {
+        LineHandlerResult rslt = _lineHandler(_lineBuf);
+        _linePending = (rslt == LINE_BUSY);
+        if (_linePending)
+            return false;
+        if (rslt == LINE_HANDLED)
+        {
+            _lineLen = 0;
+            _cmdRxState = CommandRx_complete;
+            return true;
+        }
+    }
+
+    // Check if empty line - show menu
+    echoFlush();
+    if ((_lineLen <= 0) && _pEndpoints)
+    {
+        showEndpoints(_prevChar);
+        return true;
+    }
 
-    //Log.trace("Str = %s (%c)\n", _curLine.c_str(), ch);
+    Serial.println();
+    // Check for immediate instructions
+    if (_pEndpoints)
+    {
+        Log.trace("CommsSerial: ->cmdInterp cmdStr %s\n", _lineBuf);
+        String retStr;
+        _pEndpoints->handleApiRequest(_lineBuf, retStr);
+        // Display response
+        Serial.println(retStr);
+        Serial.println();
+    }
+
+    // Reset line
+    _lineLen = 0;
+    _cmdRxState = CommandRx_complete;
+    return true;
+}
+
+void SerialConsole::showEndpoints(int ch)
+{
+    Serial.printf("Configuration Options ch=%d\n", ch);
+    for (int i = 0; i < _pEndpoints->getNumEndpoints(); i++)
+    {
+        RestAPIEndpointDef* pEndpoint = _pEndpoints->getNthEndpoint(i);
+        if (!pEndpoint)
+            continue;
+        Serial.println(String(" ") + pEndpoint->_endpointStr + String(": ") +  pEndpoint->_description);
+        Serial.println();
+    }
+}
+
+// Flow control from the chars received but not yet handled (in the UART buffer and the batch)
+void SerialConsole::updateFlowControl()
+{
+    if (_serialPortNum != 0)
+        return;
+    int rxWaiting = Serial.available() + _rxBatchLen - _rxBatchPos;
+    if (_linePending || (rxWaiting >= RX_XOFF_HIGH_WATERMARK))
+        setFlowControl(true);
+    else if (rxWaiting <= RX_XON_LOW_WATERMARK)
+        setFlowControl(false);
+}
+
+// Tell the host to stop (XOFF) or resume (XON) sending - written on its own after any echo
+void SerialConsole::setFlowControl(bool rxPaused)
+{
+    if (rxPaused == _xoffSent)
+        return;
+    echoFlush();
+    Serial.write(rxPaused ? ASCII_XOFF : ASCII_XON);
+    _xoffSent = rxPaused;
+}
+
+void SerialConsole::echo(const char* pStr, int len)
+{
+    if (_echoLen + len > ECHO_BUF_MAX_LEN)
+        echoFlush();
+    memcpy(_echoBuf + _echoLen, pStr, len);
+    _echoLen += len;
+}
+
+void SerialConsole::echoFlush()
+{
+    if (_echoLen > 0)
+        Serial.write((const uint8_t*)_echoBuf, _echoLen);
+    _echoLen = 0;
 }
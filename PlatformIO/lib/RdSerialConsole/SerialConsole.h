@@ -4,6 +4,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include <functional>
 #include "RestAPIEndpoints.h"
 #include "ConfigBase.h"
 
@@ -20,29 +21,75 @@ public:
     static constexpr CommandRxState CommandRx_waiting = 'w';
     static constexpr CommandRxState CommandRx_complete = ASCII_XON;
 
+    // Result of the fast line handler
+    enum LineHandlerResult
+    {
+        LINE_NOT_HANDLED,   // Not for the fast path - handled as a REST API command
+        LINE_HANDLED,
+        LINE_BUSY           // Can't accept now - line is retried (host is sent XOFF while it is held)
+    };
+    typedef std::function<LineHandlerResult(const char* pLine)> LineHandlerType;
+
 private:
     int _serialPortNum;
-    String _curLine;
-    static const int MAX_REGULAR_LINE_LEN = 100;
     static const int ABS_MAX_LINE_LEN = 1000;
+    static const int RX_BATCH_MAX_LEN = 128;
     RestAPIEndpoints* _pEndpoints;
     int _prevChar;
     CommandRxState _cmdRxState;
 
+    // Line being received
+    char _lineBuf[ABS_MAX_LINE_LEN + 1];
+    int _lineLen;
+    bool _lineTooLong;
+
+    // Chars read from the serial port but not yet processed
+    uint8_t _rxBatch[RX_BATCH_MAX_LEN];
+    int _rxBatchLen;
+    int _rxBatchPos;
+
+    // Fast path for complete lines (e.g. G-code) with flow control - XOFF is sent when the chars
+    // waiting to be handled reach the high watermark (or a line is held) so there is room in the
+    // UART buffer (256 bytes) for chars sent before the host acts on it, and XON when below the low
+    static const int RX_XOFF_HIGH_WATERMARK = 128;
+    static const int RX_XON_LOW_WATERMARK = 32;
+    LineHandlerType _lineHandler;
+    bool _linePending;
+    bool _xoffSent;
+
+    // Echo of received chars (written once per service call)
+    static const int ECHO_BUF_MAX_LEN = 256;
+    char _echoBuf[ECHO_BUF_MAX_LEN];
+    int _echoLen;
+
 public:
     SerialConsole()
     {
         _pEndpoints = NULL;
         _serialPortNum = 0;
-        _curLine.reserve(MAX_REGULAR_LINE_LEN);
         _prevChar = -1;
         _cmdRxState = CommandRx_idle;
+        _lineLen = 0;
+        _lineBuf[0] = 0;
+        _lineTooLong = false;
+        _rxBatchLen = 0;
+        _rxBatchPos = 0;
+        _lineHandler = NULL;
+        _linePending = false;
+        _xoffSent = false;
+        _echoLen = 0;
     }
 
     // Init
     void setup(ConfigBase& hwConfig, RestAPIEndpoints &endpoints);
     int getChar();
 
+    // Set handler for complete lines - called before the REST API endpoints are tried
+    void setLineHandler(LineHandlerType lineHandler)
+    {
+        _lineHandler = lineHandler;
+    }
+
     // Get the state of the reception of Commands 
     // Maybe:
     //   idle = 'i' = no command entry in progress,
@@ -53,4 +100,14 @@ public:
 
     // Call frequently
     void service();
+
+private:
+    int readBatch();
+    bool handleChar(int ch);
+    bool dispatchLine();
+    void showEndpoints(int ch);
+    void updateFlowControl();
+    void setFlowControl(bool rxPaused);
+    void echo(const char* pStr, int len);
+    void echoFlush();
 };
@@ -0,0 +1,97 @@
+// FieldSplitter
+// Rob Dobson 2018-2019
+
+#include "FieldSplitter.h"
+
+// Longest number converted by toDouble/toLong
+static const unsigned int MAX_NUMBER_LEN = 40;
+
+StrView StrView::trimmed() const
+{
+    const char* pStart = _pStr;
+    const char* pEnd = _pStr + _len;
+    while ((pStart < pEnd) && isspace(*pStart))
+        pStart++;
+    while ((pEnd > pStart) && isspace(*(pEnd - 1)))
+        pEnd--;
+    return StrView(pStart, pEnd - pStart);
+}
+
+bool StrView::equals(const char* pStr) const
+{
+    return (strncmp(_pStr, pStr, _len) == 0) && (pStr[_len] == 0);
+}
+
+bool StrView::equalsIgnoreCase(const char* pStr) const
+{
+    return (strncasecmp(_pStr, pStr, _len) == 0) && (pStr[_len] == 0);
+}
+
+bool StrView::startsWith(const char* pStr) const
+{
+    unsigned int prefixLen = strlen(pStr);
+    return (prefixLen <= _len) && (strncmp(_pStr, pStr, prefixLen) == 0);
+}
+
+double StrView::toDouble() const
+{
+    // Copied as the field isn't terminated
+    char numBuf[MAX_NUMBER_LEN + 1];
+    copyTo(numBuf, sizeof(numBuf));
+    return strtod(numBuf, NULL);
+}
+
+long StrView::toLong() const
+{
+    char numBuf[MAX_NUMBER_LEN + 1];
+    copyTo(numBuf, sizeof(numBuf));
+    return strtol(numBuf, NULL, 10);
+}
+
+void StrView::copyTo(char* pBuf, unsigned int bufSize) const
+{
+    if (bufSize == 0)
+        return;
+    unsigned int copyLen = (_len < bufSize - 1) ? _len : bufSize - 1;
+    memcpy(pBuf, _pStr, copyLen);
+    pBuf[copyLen] = 0;
+}
+
+void StrView::toString(String& outStr) const
+{
+    outStr = "";
+    outStr.reserve(_len);
+    for (unsigned int i = 0; i < _len; i++)
+        outStr.concat(_pStr[i]);
+}
+
+FieldIter::FieldIter(const char* pStr, const char* separators, bool skipEmpty, int strLen)
+{
+    if (!pStr)
+        pStr = "";
+    _pCur = pStr;
+    _pEnd = pStr + ((strLen < 0) ? strlen(pStr) : strLen);
+    _separators = separators;
+    _skipEmpty = skipEmpty;
+    _done = false;
+}
+
+bool FieldIter::next(StrView& field)
+{
+    while (!_done)
+    {
+        // Find the end of the field
+        const char* pFieldStart = _pCur;
+        while ((_pCur < _pEnd) && !strchr(_separators, *_pCur))
+            _pCur++;
+        field = StrView(pFieldStart, _pCur - pFieldStart);
+        // Step over the separator - no separator means this was the last field
+        if (_pCur < _pEnd)
+            _pCur++;
+        else
+            _done = true;
+        if (!_skipEmpty || !field.isEmpty())
+            return true;
+    }
+    return false;
+}
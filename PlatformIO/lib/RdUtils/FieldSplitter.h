@@ -0,0 +1,131 @@
+// FieldSplitter
+// Rob Dobson 2018-2019
+
+// Splits a string into fields in a single pass without allocating - each field is a view
+// (pointer and length) into the original string which must remain valid while fields are used
+
+#pragma once
+
+#include <Arduino.h>
+
+// Span of chars within a string (not null-terminated)
+class StrView
+{
+public:
+    StrView()
+    {
+        _pStr = "";
+        _len = 0;
+    }
+
+    StrView(const char* pStr, unsigned int len)
+    {
+        _pStr = pStr;
+        _len = len;
+    }
+
+    const char* ptr() const
+    {
+        return _pStr;
+    }
+
+    unsigned int length() const
+    {
+        return _len;
+    }
+
+    bool isEmpty() const
+    {
+        return _len == 0;
+    }
+
+    // Without leading and trailing whitespace
+    StrView trimmed() const;
+
+    // Comparisons
+    bool equals(const char* pStr) const;
+    bool equalsIgnoreCase(const char* pStr) const;
+    bool startsWith(const char* pStr) const;
+
+    // Conversions (0 if not a number)
+    double toDouble() const;
+    long toLong() const;
+
+    // Copy into a buffer (bufSize includes the terminator) - truncated if too long
+    void copyTo(char* pBuf, unsigned int bufSize) const;
+
+    // Copy into a String
+    void toString(String& outStr) const;
+
+private:
+    const char* _pStr;
+    unsigned int _len;
+};
+
+// Iterates over the fields of a string - separators is a set of chars any of which ends a field
+class FieldIter
+{
+public:
+    // strLen < 0 means the string is null-terminated
+    FieldIter(const char* pStr, const char* separators, bool skipEmpty = false, int strLen = -1);
+
+    // Get the next field - returns false when there are no more
+    bool next(StrView& field);
+
+private:
+    const char* _pCur;
+    const char* _pEnd;
+    const char* _separators;
+    bool _skipEmpty;
+    bool _done;
+};
+
+// Splits into up to MAX_FIELDS fields (any further text is in the last field)
+template<int MAX_FIELDS>
+class FieldSplitter
+{
+public:
+    FieldSplitter()
+    {
+        _numFields = 0;
+    }
+
+    FieldSplitter(const char* pStr, const char* separators, bool skipEmpty = false, int strLen = -1)
+    {
+        split(pStr, separators, skipEmpty, strLen);
+    }
+
+    int split(const char* pStr, const char* separators, bool skipEmpty = false, int strLen = -1)
+    {
+        _numFields = 0;
+        if (!pStr)
+            return 0;
+        if (strLen < 0)
+            strLen = strlen(pStr);
+        FieldIter fieldIter(pStr, separators, skipEmpty, strLen);
+        StrView field;
+        while ((_numFields < MAX_FIELDS) && fieldIter.next(field))
+            _fields[_numFields++] = field;
+        // Remainder goes in the last field
+        if ((_numFields == MAX_FIELDS) && (field.ptr() + field.length() < pStr + strLen))
+            _fields[MAX_FIELDS - 1] = StrView(field.ptr(), pStr + strLen - field.ptr());
+        return _numFields;
+    }
+
+    int getNumFields() const
+    {
+        return _numFields;
+    }
+
+    // Empty if fieldIdx is out of range
+    StrView getField(int fieldIdx) const
+    {
+        if ((fieldIdx < 0) || (fieldIdx >= _numFields))
+            return StrView();
+        return _fields[fieldIdx];
+    }
+
+private:
+    StrView _fields[MAX_FIELDS];
+    int _numFields;
+};
@@ -33,6 +33,6 @@ public:
     // JSON only contains name/value pairs and not {}
     static String getJSONFromHTTPQueryStr(const char* inStr, bool mustStartWithQuestionMark = true);
 
-    // Get Nth field from string
+    // Get Nth field from string (use FieldSplitter to get several fields without rescanning)
     static String getNthField(const char* inStr, int N, char separator);
 };
@@ -105,6 +105,35 @@ void WebServer::addEndpoints(RestAPIEndpoints &endpoints)
                 // Default response
                 String respStr("{ \"rslt\": \"unknown\" }");
 
+                // Endpoints completed later (e.g. by another task) are sent as a chunked response
+                // whose filler tries again until the response is complete
+                if ((pEndpoint->_endpointType == RestAPIEndpointDef::ENDPOINT_CALLBACK) &&
+                            pEndpoint->hasCallbackAsync())
+                {
+                    String reqUrl = recreatedReqUrl(request);
+                    Log.verbose("%sCalling async %s url %s\n", MODULE_PREFIX,
+                                    pEndpoint->_endpointStr.c_str(), request->url().c_str());
+                    RestAPIAsyncRespPtr pResp = std::make_shared<RestAPIAsyncResp>();
+                    pEndpoint->callbackAsync(reqUrl, pResp);
+                    if (pResp->isComplete())
+                    {
+                        request->send(200, "application/json", pResp->getRespStr().c_str());
+                        return;
+                    }
+                    request->send(request->beginChunkedResponse("application/json",
+                        [pResp](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+                            if (!pResp->isComplete())
+                                return RESPONSE_TRY_AGAIN;
+                            const String& respStr = pResp->getRespStr();
+                            if (index >= respStr.length())
+                                return 0;
+                            size_t len = std::min(maxLen, (size_t)(respStr.length() - index));
+                            memcpy(buffer, respStr.c_str() + index, len);
+                            return len;
+                        }));
+                    return;
+                }
+
                 // Make the required action
                 if (pEndpoint->_endpointType == RestAPIEndpointDef::ENDPOINT_CALLBACK)
                 {
@@ -21,62 +21,67 @@ public:
     static bool isApproxWrap(double v1, double v2, double wrapSize=360.0, double withinRng = 0.0001);
 };
 
-class AxisFloats
+// Axis values are templated on the number of axes so that all per-axis loops have a
+// constant trip count - AxisFloats is the instantiation for this build
+template <int N_AXES>
+class AxisFloatsT
 {
   public:
-    float _pt[RobotConsts::MAX_AXES];
+    float _pt[N_AXES];
     uint8_t _validityFlags;
 
   public:
-    AxisFloats()
+    AxisFloatsT()
     {
         clear();
     }
-    AxisFloats(const AxisFloats &other)
+    AxisFloatsT(const AxisFloatsT &other)
     {
-        for (int i = 0; i < RobotConsts::MAX_AXES; i++)
+        for (int i = 0; i < N_AXES; i++)
             _pt[i] = other._pt[i];
         _validityFlags = other._validityFlags;
     }
-    AxisFloats(float x, float y)
+    AxisFloatsT(float x, float y)
     {
+        clear();
         _pt[0] = x;
         _pt[1] = y;
-        _pt[2] = 0;
         _validityFlags = 0x03;
     }
-    AxisFloats(float x, float y, float z)
+    AxisFloatsT(float x, float y, float z)
     {
+        clear();
         _pt[0] = x;
         _pt[1] = y;
-        _pt[2] = z;
-        _validityFlags = 0x07;
+        setVal(2, z);
+        _validityFlags = 0x03 | (N_AXES > 2 ? 0x04 : 0);
     }
-    AxisFloats(float x, float y, float z, bool xValid, bool yValid, bool zValid)
+    AxisFloatsT(float x, float y, float z, bool xValid, bool yValid, bool zValid)
     {
+        clear();
         _pt[0] = x;
         _pt[1] = y;
-        _pt[2] = z;
+        setVal(2, z);
         _validityFlags = xValid ? 0x01 : 0;
         _validityFlags |= yValid ? 0x02 : 0;
-        _validityFlags |= zValid ? 0x04 : 0;
+        _validityFlags |= (zValid && (N_AXES > 2)) ? 0x04 : 0;
     }
-    bool operator==(const AxisFloats& other)
+    bool operator==(const AxisFloatsT& other)
     {
         if (_validityFlags != other._validityFlags)
             return false;
-        for (int i = 0; i < RobotConsts::MAX_AXES; i++)
+        for (int i = 0; i < N_AXES; i++)
             if ((_validityFlags & (0x01 << i)) && (_pt[i] != other._pt[i]))
                 return false;
         return true;
     }
-    bool operator!=(const AxisFloats& other)
+    bool operator!=(const AxisFloatsT& other)
     {
         return !(*this == other);
     }
     void clear()
     {
-        for (int i = 0; i < RobotConsts::MAX_AXES; i++)
+        for (int i = 0; i < N_AXES; i++)
             _pt[i] = 0;
         _validityFlags = 0;
     }
@@ -86,13 +91,13 @@ class AxisFloats
     }
     float getVal(int axisIdx)
     {
-        if (axisIdx >= 0 && axisIdx < RobotConsts::MAX_AXES)
+        if (axisIdx >= 0 && axisIdx < N_AXES)
             return _pt[axisIdx];
         return 0;
     }
     void setVal(int axisIdx, float val)
     {
-        if (axisIdx >= 0 && axisIdx < RobotConsts::MAX_AXES)
+        if (axisIdx >= 0 && axisIdx < N_AXES)
         {
             int axisMask = 0x01 << axisIdx;
             _pt[axisIdx] = val;
@@ -103,12 +108,12 @@ class AxisFloats
     {
         _pt[0] = val0;
         _pt[1] = val1;
-        _pt[2] = val2;
-        _validityFlags = 0x07;
+        setVal(2, val2);
+        _validityFlags = 0x03 | (N_AXES > 2 ? 0x04 : 0);
     }
     void setValid(int axisIdx, bool isValid)
     {
-        if (axisIdx >= 0 && axisIdx < RobotConsts::MAX_AXES)
+        if (axisIdx >= 0 && axisIdx < N_AXES)
         {
             int axisMask = 0x01 << axisIdx;
             if (isValid)
@@ -119,7 +124,7 @@ class AxisFloats
     }
     bool isValid(int axisIdx)
     {
-        if (axisIdx >= 0 && axisIdx < RobotConsts::MAX_AXES)
+        if (axisIdx >= 0 && axisIdx < N_AXES)
         {
             int axisMask = 0x01 << axisIdx;
             return (_validityFlags & axisMask) != 0;
@@ -150,90 +155,89 @@ class AxisFloats
     }
     float Z()
     {
-        return _pt[2];
+        return getVal(2);
     }
     void Z(float val)
     {
-        _pt[2] = val;
-        _validityFlags |= 0x04;
+        setVal(2, val);
     }
-    AxisFloats &operator=(const AxisFloats &other)
+    AxisFloatsT &operator=(const AxisFloatsT &other)
     {
-        for (int i = 0; i < RobotConsts::MAX_AXES; i++)
+        for (int i = 0; i < N_AXES; i++)
             _pt[i] = other._pt[i];
         _validityFlags = other._validityFlags;
         return *this;
     }
-    AxisFloats operator-(const AxisFloats &pt)
+    AxisFloatsT operator-(const AxisFloatsT &pt)
     {
-        AxisFloats result;
-        for (int i = 0; i < RobotConsts::MAX_AXES; i++)
+        AxisFloatsT result;
+        for (int i = 0; i < N_AXES; i++)
             result._pt[i] = _pt[i] - pt._pt[i];
         return result;
     }
-    AxisFloats operator-(float val)
+    AxisFloatsT operator-(float val)
     {
-        AxisFloats result;
-        for (int i = 0; i < RobotConsts::MAX_AXES; i++)
+        AxisFloatsT result;
+        for (int i = 0; i < N_AXES; i++)
             result._pt[i] = _pt[i] - val;
         return result;
     }
-    AxisFloats operator+(const AxisFloats &pt)
+    AxisFloatsT operator+(const AxisFloatsT &pt)
     {
-        AxisFloats result;
-        for (int i = 0; i < RobotConsts::MAX_AXES; i++)
+        AxisFloatsT result;
+        for (int i = 0; i < N_AXES; i++)
             result._pt[i] = _pt[i] + pt._pt[i];
         return result;
     }
-    AxisFloats operator+(float val)
+    AxisFloatsT operator+(float val)
     {
-        AxisFloats result;
-        for (int i = 0; i < RobotConsts::MAX_AXES; i++)
+        AxisFloatsT result;
+        for (int i = 0; i < N_AXES; i++)
             result._pt[i] = _pt[i] + val;
         return result;
     }
-    AxisFloats operator/(const AxisFloats &pt)
+    AxisFloatsT operator/(const AxisFloatsT &pt)
     {
-        AxisFloats result;
-        for (int i = 0; i < RobotConsts::MAX_AXES; i++)
+        AxisFloatsT result;
+        for (int i = 0; i < N_AXES; i++)
         {
             if (pt._pt[i] != 0)
                 result._pt[i] = _pt[i] / pt._pt[i];
         }
         return result;
     }
-    AxisFloats operator/(float val)
+    AxisFloatsT operator/(float val)
     {
-        AxisFloats result;
-        for (int i = 0; i < RobotConsts::MAX_AXES; i++)
+        AxisFloatsT result;
+        for (int i = 0; i < N_AXES; i++)
         {
             if (val != 0)
                 result._pt[i] = _pt[i] / val;
         }
         return result;
     }
-    AxisFloats operator*(const AxisFloats &pt)
+    AxisFloatsT operator*(const AxisFloatsT &pt)
     {
-        AxisFloats result;
-        for (int i = 0; i < RobotConsts::MAX_AXES; i++)
+        AxisFloatsT result;
+        for (int i = 0; i < N_AXES; i++)
         {
             result._pt[i] = _pt[i] * pt._pt[i];
         }
         return result;
     }
-    AxisFloats operator*(float val)
+    AxisFloatsT operator*(float val)
     {
-        AxisFloats result;
-        for (int i = 0; i < RobotConsts::MAX_AXES; i++)
+        AxisFloatsT result;
+        for (int i = 0; i < N_AXES; i++)
         {
             result._pt[i] = _pt[i] * val;
         }
         return result;
     }
-    float distanceTo(const AxisFloats &pt, bool includeDist[] = NULL)
+    float distanceTo(const AxisFloatsT &pt, bool includeDist[] = NULL)
     {
         float distSum = 0;
-        for (int i = 0; i < RobotConsts::MAX_AXES; i++)
+        for (int i = 0; i < N_AXES; i++)
         {
             if ((includeDist == NULL) || includeDist[i])
             {
@@ -246,12 +250,12 @@ class AxisFloats
     }
     void logDebugStr(const char *prefixStr)
     {
-        Log.trace("%s X %F Y %F Z %F\n", prefixStr, _pt[0], _pt[1], _pt[2]);
+        Log.trace("%s X %F Y %F Z %F\n", prefixStr, _pt[0], _pt[1], getVal(2));
     }
     String toJSON()
     {
         String jsonStr = "[";
-        for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
+        for (int axisIdx = 0; axisIdx < N_AXES; axisIdx++)
         {
             if (axisIdx != 0)
                 jsonStr += ",";
@@ -262,6 +266,8 @@ class AxisFloats
     }
 };
 
+typedef AxisFloatsT<RobotConsts::MAX_AXES> AxisFloats;
+
 class AxisValidBools
 {
   public:
@@ -460,54 +466,54 @@ class AxisMinMaxBools
     }
 };
 
-class AxisInt32s
+template <int N_AXES>
+class AxisInt32sT
 {
   public:
-    int32_t vals[RobotConsts::MAX_AXES];
+    int32_t vals[N_AXES];
 
   public:
-    AxisInt32s()
+    AxisInt32sT()
     {
         clear();
     }
-    AxisInt32s(const AxisInt32s &u32s)
+    AxisInt32sT(const AxisInt32sT &u32s)
     {
-        for (int i = 0; i < RobotConsts::MAX_AXES; i++)
+        for (int i = 0; i < N_AXES; i++)
             vals[i] = u32s.vals[i];
     }
-    AxisInt32s &operator=(const AxisInt32s &u32s)
+    AxisInt32sT &operator=(const AxisInt32sT &u32s)
     {
-        for (int i = 0; i < RobotConsts::MAX_AXES; i++)
+        for (int i = 0; i < N_AXES; i++)
             vals[i] = u32s.vals[i];
         return *this;
     }
-    AxisInt32s(int32_t xVal, int32_t yVal, int32_t zVal)
+    AxisInt32sT(int32_t xVal, int32_t yVal, int32_t zVal)
     {
-        vals[0] = xVal;
-        vals[1] = yVal;
-        vals[2] = zVal;
+        clear();
+        set(xVal, yVal, zVal);
     }
-    bool operator==(const AxisInt32s& other)
+    bool operator==(const AxisInt32sT& other)
     {
-        for (int i = 0; i < RobotConsts::MAX_AXES; i++)
+        for (int i = 0; i < N_AXES; i++)
             if (vals[i] != other.vals[i])
                 return false;
         return true;
     }
-    bool operator!=(const AxisInt32s& other)
+    bool operator!=(const AxisInt32sT& other)
     {
         return !(*this == other);
     }
     void clear()
     {
-        for (int i = 0; i < RobotConsts::MAX_AXES; i++)
+        for (int i = 0; i < N_AXES; i++)
             vals[i] = 0;
     }
     void set(int32_t val0, int32_t val1, int32_t val2 = 0)
     {
         vals[0] = val0;
         vals[1] = val1;
-        vals[2] = val2;
+        setVal(2, val2);
     }
     int32_t X()
     {
@@ -519,23 +525,23 @@ class AxisInt32s
     }
     int32_t Z()
     {
-        return vals[2];
+        return getVal(2);
     }
     int32_t getVal(int axisIdx)
     {
-        if (axisIdx >= 0 && axisIdx < RobotConsts::MAX_AXES)
+        if (axisIdx >= 0 && axisIdx < N_AXES)
             return vals[axisIdx];
         return 0;
     }
     void setVal(int axisIdx, int32_t val)
     {
-        if (axisIdx >= 0 && axisIdx < RobotConsts::MAX_AXES)
+        if (axisIdx >= 0 && axisIdx < N_AXES)
             vals[axisIdx] = val;
     }
     String toJSON()
     {
         String jsonStr = "[";
-        for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
+        for (int axisIdx = 0; axisIdx < N_AXES; axisIdx++)
         {
             if (axisIdx != 0)
                 jsonStr += ",";
@@ -545,3 +551,5 @@ class AxisInt32s
         return jsonStr;
     }
 };
+
+typedef AxisInt32sT<RobotConsts::MAX_AXES> AxisInt32s;
@@ -0,0 +1,124 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+#include "CommandPathTiming.h"
+#ifdef ESP32
+#include "xtensa/core-macros.h"
+#endif
+
+static const char* CommandPathTiming_stageNames[CommandPathTiming::NUM_STAGES] = {
+    "queue", "evaluate", "gcode", "motion", "kinematics", "plan", "prepare", "step"
+};
+
+#ifdef ESP32
+static uint32_t CommandPathTiming_getCycleCount()
+{
+    return XTHAL_GET_CCOUNT();
+}
+CommandPathTiming::GetTicksFnType CommandPathTiming::_getTicksFn = CommandPathTiming_getCycleCount;
+// Default CPU clock
+float CommandPathTiming::_ticksPerUs = 240;
+#else
+static uint32_t CommandPathTiming_getMicros()
+{
+    return micros();
+}
+CommandPathTiming::GetTicksFnType CommandPathTiming::_getTicksFn = CommandPathTiming_getMicros;
+float CommandPathTiming::_ticksPerUs = 1;
+#endif
+uint64_t CommandPathTiming::_stageTicks[CommandPathTiming::NUM_STAGES];
+uint32_t CommandPathTiming::_stageCount[CommandPathTiming::NUM_STAGES];
+uint8_t CommandPathTiming::_stageStack[CommandPathTiming::MAX_DEPTH];
+int CommandPathTiming::_stackDepth = 0;
+int CommandPathTiming::_overflowDepth = 0;
+uint32_t CommandPathTiming::_lastTicks = 0;
+
+void CommandPathTiming::setClock(GetTicksFnType getTicksFn, float ticksPerUs)
+{
+    _getTicksFn = getTicksFn;
+    _ticksPerUs = ticksPerUs;
+    clear();
+}
+
+void CommandPathTiming::start(Stage stage)
+{
+    uint32_t nowTicks = _getTicksFn();
+    if (_stackDepth >= MAX_DEPTH)
+    {
+        _overflowDepth++;
+        return;
+    }
+    // Time so far is the enclosing stage's
+    if (_stackDepth > 0)
+        _stageTicks[_stageStack[_stackDepth - 1]] += uint32_t(nowTicks - _lastTicks);
+    _stageStack[_stackDepth++] = stage;
+    _stageCount[stage]++;
+    _lastTicks = nowTicks;
+}
+
+void CommandPathTiming::end()
+{
+    uint32_t nowTicks = _getTicksFn();
+    if (_overflowDepth > 0)
+    {
+        _overflowDepth--;
+        return;
+    }
+    if (_stackDepth <= 0)
+        return;
+    _stageTicks[_stageStack[--_stackDepth]] += uint32_t(nowTicks - _lastTicks);
+    _lastTicks = nowTicks;
+}
+
+void CommandPathTiming::clear()
+{
+    for (int stageIdx = 0; stageIdx < NUM_STAGES; stageIdx++)
+    {
+        _stageTicks[stageIdx] = 0;
+        _stageCount[stageIdx] = 0;
+    }
+    _lastTicks = _getTicksFn();
+}
+
+const char* CommandPathTiming::getStageName(int stage)
+{
+    if ((stage < 0) || (stage >= NUM_STAGES))
+        return "";
+    return CommandPathTiming_stageNames[stage];
+}
+
+double CommandPathTiming::getStageUs(int stage)
+{
+    if ((stage < 0) || (stage >= NUM_STAGES))
+        return 0;
+    return _stageTicks[stage] / _ticksPerUs;
+}
+
+uint32_t CommandPathTiming::getStageCount(int stage)
+{
+    if ((stage < 0) || (stage >= NUM_STAGES))
+        return 0;
+    return _stageCount[stage];
+}
+
+double CommandPathTiming::getTotalUs()
+{
+    double totalUs = 0;
+    for (int stageIdx = 0; stageIdx < NUM_STAGES; stageIdx++)
+        totalUs += getStageUs(stageIdx);
+    return totalUs;
+}
+
+void CommandPathTiming::getJSON(String& jsonStr)
+{
+    char tmpStr[100];
+    snprintf(tmpStr, sizeof(tmpStr), "{\"totalUs\":%0.1f,\"stages\":{", getTotalUs());
+    jsonStr = tmpStr;
+    for (int stageIdx = 0; stageIdx < NUM_STAGES; stageIdx++)
+    {
+        snprintf(tmpStr, sizeof(tmpStr), "%s\"%s\":{\"us\":%0.1f,\"count\":%u}", (stageIdx == 0) ? "" : ",",
+                    getStageName(stageIdx), getStageUs(stageIdx), _stageCount[stageIdx]);
+        jsonStr += tmpStr;
+    }
+    jsonStr += "}}";
+}
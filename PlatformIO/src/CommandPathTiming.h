@@ -0,0 +1,85 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+#pragma once
+
+// Comment out to enable/disable timing of the command path (the hooks compile to nothing when disabled)
+//#define INSTRUMENT_COMMAND_PATH_ENABLE 1
+
+#include <Arduino.h>
+
+// Command path timing
+// Accumulates the time spent in each stage a command passes through on its way to the steppers
+// (work item queue -> evaluators -> G-code interpreter -> motion helper -> kinematics -> planner ->
+// step preparation -> step generation). Stages nest (e.g. the G-code interpreter calls into the
+// planner) and time is only counted against the innermost stage so that the stage times add up
+// to the total time in the command path
+// Only to be used from a single task (the main loop) - the step ISR is timed separately by
+// MotionInstrumentation on the device
+class CommandPathTiming
+{
+public:
+    enum Stage
+    {
+        STAGE_QUEUE,
+        STAGE_EVALUATE,
+        STAGE_GCODE,
+        STAGE_MOTION,
+        STAGE_KINEMATICS,
+        STAGE_PLAN,
+        STAGE_PREPARE,
+        STAGE_STEP,
+        NUM_STAGES
+    };
+
+    // Clock used for timing - the default is the CPU cycle counter on the ESP32 (micros() elsewhere)
+    typedef uint32_t (*GetTicksFnType)();
+    static void setClock(GetTicksFnType getTicksFn, float ticksPerUs);
+
+    // Enter and leave a stage
+    static void start(Stage stage);
+    static void end();
+
+    // Clear accumulated times
+    static void clear();
+
+    // Accumulated values
+    static const char* getStageName(int stage);
+    static double getStageUs(int stage);
+    static uint32_t getStageCount(int stage);
+    static double getTotalUs();
+
+    // Get the times as JSON {"totalUs":1234.5,"stages":{"queue":{"us":12.3,"count":45},...}}
+    static void getJSON(String& jsonStr);
+
+private:
+    static constexpr int MAX_DEPTH = 12;
+    static GetTicksFnType _getTicksFn;
+    static float _ticksPerUs;
+    static uint64_t _stageTicks[NUM_STAGES];
+    static uint32_t _stageCount[NUM_STAGES];
+    static uint8_t _stageStack[MAX_DEPTH];
+    static int _stackDepth;
+    static int _overflowDepth;
+    static uint32_t _lastTicks;
+};
+
+// Times the rest of the enclosing scope as a stage
+class CommandPathTimingScope
+{
+public:
+    CommandPathTimingScope(CommandPathTiming::Stage stage)
+    {
+        CommandPathTiming::start(stage);
+    }
+    ~CommandPathTimingScope()
+    {
+        CommandPathTiming::end();
+    }
+};
+
+#ifdef INSTRUMENT_COMMAND_PATH_ENABLE
+#define INSTRUMENT_COMMAND_PATH_SCOPE(STAGE) CommandPathTimingScope _commandPathTimingScope(CommandPathTiming::STAGE);
+#else
+#define INSTRUMENT_COMMAND_PATH_SCOPE(STAGE)
+#endif
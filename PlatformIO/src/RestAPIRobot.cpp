@@ -61,15 +61,29 @@ void RestAPIRobot::apiSetLedBody(String& reqStr, uint8_t *pData, size_t len, siz
 void RestAPIRobot::apiExec(String &reqStr, String &respStr)
 {
     Log.notice("%sExec %s\n", MODULE_PREFIX, reqStr.c_str());
-    WorkItem workItem(RestAPIEndpoints::removeFirstArgStr(reqStr.c_str()).c_str());
-    _workManager.addWorkItem(workItem, respStr);
+    String cmdStr = RestAPIEndpoints::removeFirstArgStr(reqStr.c_str());
+    _workManager.addWorkItemFromTask(cmdStr.c_str(), respStr);
 }
 
 void RestAPIRobot::apiPlayFile(String &reqStr, String &respStr)
 {
     Log.notice("%splayFile %s\n", MODULE_PREFIX, reqStr.c_str());
-    WorkItem workItem(RestAPIEndpoints::removeFirstArgStr(reqStr.c_str()).c_str());
-    _workManager.addWorkItem(workItem, respStr);
+    String fileName = RestAPIEndpoints::removeFirstArgStr(reqStr.c_str());
+    _workManager.addWorkItemFromTask(fileName.c_str(), respStr);
+}
+
+// Start micro-benchmarks (run by the main loop - result from benchmarkresult)
+void RestAPIRobot::apiBenchmark(String &reqStr, String &respStr)
+{
+    Log.notice("%sbenchmark %s\n", MODULE_PREFIX, reqStr.c_str());
+    String iterationsStr = RestAPIEndpoints::getNthArgStr(reqStr.c_str(), 1);
+    _workManager.startBenchmarks(iterationsStr.toInt(), respStr);
+}
+
+// Result of the last micro-benchmarks
+void RestAPIRobot::apiBenchmarkResult(String &reqStr, String &respStr)
+{
+    _workManager.getBenchmarksResult(respStr);
 }
 
 void RestAPIRobot::setup(RestAPIEndpoints &endpoints)
@@ -108,6 +122,14 @@ void RestAPIRobot::setup(RestAPIEndpoints &endpoints)
                             std::bind(&RestAPIRobot::apiPlayFile, this, std::placeholders::_1, std::placeholders::_2),
                             "Play file filename ... ~ for / in filename");
                             
+    // Micro-benchmarks
+    endpoints.addEndpoint("benchmark", RestAPIEndpointDef::ENDPOINT_CALLBACK, RestAPIEndpointDef::ENDPOINT_GET,
+                            std::bind(&RestAPIRobot::apiBenchmark, this, std::placeholders::_1, std::placeholders::_2),
+                            "Start micro-benchmarks (run while idle), benchmark/N for N iterations");
+    endpoints.addEndpoint("benchmarkresult", RestAPIEndpointDef::ENDPOINT_CALLBACK, RestAPIEndpointDef::ENDPOINT_GET,
+                            std::bind(&RestAPIRobot::apiBenchmarkResult, this, std::placeholders::_1, std::placeholders::_2),
+                            "Result of last micro-benchmarks - CPU cycles per op");
+
     // Get status
     endpoints.addEndpoint("status", RestAPIEndpointDef::ENDPOINT_CALLBACK, RestAPIEndpointDef::ENDPOINT_GET,
                             std::bind(&RestAPIRobot::apiQueryStatus, this, std::placeholders::_1, std::placeholders::_2),
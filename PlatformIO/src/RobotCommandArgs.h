@@ -20,6 +20,7 @@ private:
     bool _dontSplitMove : 1;
     bool _extrudeValid : 1;
     bool _feedrateValid : 1;
+    bool _stepAccelValid : 1;
     bool _moveClockwise : 1;
     bool _moveRapid : 1;
     bool _allowOutOfBounds : 1;
@@ -36,6 +37,7 @@ private:
     AxisInt32s _ptInSteps;
     float _extrudeValue;
     float _feedrateValue;
+    float _stepAccelValue;
     RobotMoveTypeArg _moveType;
     AxisMinMaxBools _endstops;
 
@@ -51,6 +53,7 @@ public:
         _dontSplitMove = false;
         _extrudeValid = false;
         _feedrateValid = false;
+        _stepAccelValid = false;
         _moveClockwise = false;
         _moveRapid = false;
         _allowOutOfBounds = false;
@@ -67,6 +70,7 @@ public:
         _ptInSteps.clear();
         _extrudeValue = 0.0;
         _feedrateValue = 0.0;
+        _stepAccelValue = 0.0;
         _moveType = RobotMoveTypeArg_None;
         _endstops.none();
     }
@@ -85,6 +89,7 @@ public:
             (_dontSplitMove == other._dontSplitMove) &&
             (_extrudeValid == other._extrudeValid) &&
             (_feedrateValid == other._feedrateValid) &&
+            (_stepAccelValid == other._stepAccelValid) &&
             (_moveClockwise == other._moveClockwise) &&
             (_moveRapid == other._moveRapid) &&
             (_allowOutOfBounds == other._allowOutOfBounds) &&
@@ -96,6 +101,7 @@ public:
             // Endstops etc
             (_extrudeValue == other._extrudeValue) &&
             (_feedrateValue == other._feedrateValue) &&
+            (_stepAccelValue == other._stepAccelValue) &&
             (_moveType == other._moveType) &&
             (_endstops == other._endstops);
         if (!isEqual)
@@ -128,6 +134,7 @@ private:
         _dontSplitMove = copyFrom._dontSplitMove;
         _extrudeValid = copyFrom._extrudeValid;
         _feedrateValid = copyFrom._feedrateValid;
+        _stepAccelValid = copyFrom._stepAccelValid;
         _moveClockwise = copyFrom._moveClockwise;
         _moveRapid = copyFrom._moveRapid;
         _allowOutOfBounds = copyFrom._allowOutOfBounds;
@@ -142,6 +149,7 @@ private:
         _ptInSteps = copyFrom._ptInSteps;
         _extrudeValue = copyFrom._extrudeValue;
         _feedrateValue = copyFrom._feedrateValue;
+        _stepAccelValue = copyFrom._stepAccelValue;
         _moveType = copyFrom._moveType;
         _endstops = copyFrom._endstops;
     }
@@ -257,6 +265,24 @@ public:
     {
         return _feedrateValue;
     }
+    // Acceleration for stepwise moves in steps per second per second
+    void setStepAccel(float stepAccel)
+    {
+        _stepAccelValue = stepAccel;
+        _stepAccelValid = true;
+    }
+    void clearStepAccel()
+    {
+        _stepAccelValid = false;
+    }
+    bool isStepAccelValid()
+    {
+        return _stepAccelValid;
+    }
+    float getStepAccel()
+    {
+        return _stepAccelValue;
+    }
     void setExtrude(float extrude)
     {
         _extrudeValue = extrude;
@@ -356,6 +382,11 @@ public:
             String feedrateStr = String(_feedrateValue, 2);
             jsonStr += ",\"F\":" + feedrateStr;
         }
+        if (_stepAccelValid)
+        {
+            String stepAccelStr = String(_stepAccelValue, 2);
+            jsonStr += ",\"Acc\":" + stepAccelStr;
+        }
         if (_extrudeValid)
         {
             String extrudeStr = String(_extrudeValue, 2);
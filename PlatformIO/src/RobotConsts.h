@@ -1,8 +1,16 @@
 #pragma once
 
+// Number of axes is fixed for a build (e.g. build_flags = -DRBOT_MAX_AXES=2 in platformio.ini)
+// so per-axis loops in the planner and step ISR have a constant trip count
+#ifndef RBOT_MAX_AXES
+#define RBOT_MAX_AXES 3
+#endif
+
 namespace RobotConsts
 {
-static constexpr int MAX_AXES = 3;
+static constexpr int MAX_AXES = RBOT_MAX_AXES;
+// Axis validity is held in 8 bits and endstop checks in 30 bits (4 bits per axis)
+static_assert((MAX_AXES >= 2) && (MAX_AXES <= 7), "RBOT_MAX_AXES must be 2..7");
 static constexpr int MAX_ENDSTOPS_PER_AXIS = 2;
 
 // MOTOR_TYPE_DRIVER has an A4988 or similar stepper driver chip that just requires step and direction
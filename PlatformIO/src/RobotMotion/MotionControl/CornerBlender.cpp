@@ -0,0 +1,206 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+#include <Arduino.h>
+#include "CornerBlender.h"
+#include "RdJson.h"
+
+static const char* MODULE_PREFIX = "CornerBlender: ";
+
+CornerBlender::CornerBlender()
+{
+    _cornerBlendMM = cornerBlendMM_default;
+    clear();
+}
+
+void CornerBlender::configure(const char *robotConfigJSON)
+{
+    _cornerBlendMM = float(RdJson::getDouble("cornerBlendMM", cornerBlendMM_default, robotConfigJSON));
+    if (_cornerBlendMM < 0)
+        _cornerBlendMM = 0;
+    Log.notice("%stolerance %FMM (0=off)\n", MODULE_PREFIX, _cornerBlendMM);
+    clear();
+}
+
+void CornerBlender::clear()
+{
+    _pendingValid = false;
+    _pendingSinceMs = 0;
+    _outputCount = 0;
+    _outputReadIdx = 0;
+}
+
+bool CornerBlender::getEndPos(AxisFloats &endPos)
+{
+    if (_pendingValid)
+    {
+        endPos = _pendingDestPos;
+        return true;
+    }
+    if (_outputCount > 0)
+    {
+        endPos = _outputMoves[_outputReadIdx + _outputCount - 1]._destPos;
+        return true;
+    }
+    return false;
+}
+
+bool CornerBlender::isBlendable(RobotCommandArgs &args, AxisFloats &startPos, AxisFloats &destPos, AxesParams &axesParams)
+{
+    if (args.isStepwise() || args.getEndstopCheck().any())
+        return false;
+    bool primaryMove = false;
+    for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
+    {
+        if (destPos.getVal(axisIdx) == startPos.getVal(axisIdx))
+            continue;
+        if (!axesParams.isPrimaryAxis(axisIdx))
+            return false;
+        primaryMove = true;
+    }
+    return primaryMove;
+}
+
+bool CornerBlender::addMove(AxisFloats &startPos, AxisFloats &destPos, RobotCommandArgs &args, AxesParams &axesParams)
+{
+    // Nothing held so just hold this move
+    if (!_pendingValid)
+    {
+        setPending(startPos, destPos, args);
+        return true;
+    }
+
+    // Unit vectors and lengths of the held move (from its current start) and the new move
+    AxisFloats cornerPos = _pendingDestPos;
+    AxisFloats unitVecIn = cornerPos - _pendingStartPos;
+    AxisFloats unitVecOut = destPos - cornerPos;
+    float lenIn = 0, lenOut = 0;
+    for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
+    {
+        if (!axesParams.isPrimaryAxis(axisIdx))
+        {
+            unitVecIn.setVal(axisIdx, 0);
+            unitVecOut.setVal(axisIdx, 0);
+        }
+        lenIn += powf(unitVecIn.getVal(axisIdx), 2);
+        lenOut += powf(unitVecOut.getVal(axisIdx), 2);
+    }
+    lenIn = sqrtf(lenIn);
+    lenOut = sqrtf(lenOut);
+    float deviationAngle = 0;
+    if ((lenIn > 0) && (lenOut > 0))
+    {
+        unitVecIn = unitVecIn / lenIn;
+        unitVecOut = unitVecOut / lenOut;
+        float cosDeviation = 0;
+        for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
+            cosDeviation += unitVecIn.getVal(axisIdx) * unitVecOut.getVal(axisIdx);
+        deviationAngle = acosf(fmaxf(-1.0f, fminf(1.0f, cosDeviation)));
+    }
+
+    // Straight through, reversal or degenerate - release the held move unchanged
+    if ((deviationAngle < MIN_BLEND_ANGLE_RADS) || (deviationAngle > MAX_BLEND_ANGLE_RADS))
+    {
+        flush();
+        setPending(cornerPos, destPos, args);
+        return true;
+    }
+
+    // Distance back from the corner at which the arc starts (and forward at which it ends) to keep
+    // within tolerance - limited to the remaining held move and half of the new move (leaving the
+    // other half for the next corner)
+    float halfAngle = deviationAngle / 2;
+    float tangentDist = _cornerBlendMM * sinf(halfAngle) / (1 - cosf(halfAngle));
+    tangentDist = fminf(tangentDist, fminf(lenIn, lenOut / 2));
+    float arcRadius = tangentDist / tanf(halfAngle);
+
+    // Segments such that the chord sagitta is within tolerance
+    int numSegs = MAX_ARC_SEGS;
+    if (arcRadius > _cornerBlendMM)
+    {
+        float maxSegAngle = 2 * acosf(1 - _cornerBlendMM / arcRadius);
+        numSegs = int(ceilf(deviationAngle / maxSegAngle));
+    }
+    if (numSegs < 1)
+        numSegs = 1;
+    if (numSegs > MAX_ARC_SEGS)
+        numSegs = MAX_ARC_SEGS;
+
+    // Arc start and the normal from the arc start towards the centre
+    AxisFloats arcStart = cornerPos - unitVecIn * tangentDist;
+    AxisFloats normalVec = (unitVecOut - unitVecIn * cosf(deviationAngle)) / sinf(deviationAngle);
+    AxisFloats arcCentre = arcStart + normalVec * arcRadius;
+
+    // Held move up to the arc start then the arc
+    if (!addOutput(arcStart, _pendingArgs))
+        return false;
+    for (int segIdx = 1; segIdx <= numSegs; segIdx++)
+    {
+        float segAngle = deviationAngle * segIdx / numSegs;
+        AxisFloats arcPt = arcCentre - normalVec * (arcRadius * cosf(segAngle)) + unitVecIn * (arcRadius * sinf(segAngle));
+        // Non-primary axes stay at the corner value
+        for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
+            if (!axesParams.isPrimaryAxis(axisIdx))
+                arcPt.setVal(axisIdx, cornerPos.getVal(axisIdx));
+        if (!addOutput(arcPt, _pendingArgs))
+            return false;
+    }
+
+    // Hold the new move from the end of the arc
+    AxisFloats arcEnd = cornerPos + unitVecOut * tangentDist;
+    for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
+        if (!axesParams.isPrimaryAxis(axisIdx))
+            arcEnd.setVal(axisIdx, cornerPos.getVal(axisIdx));
+    setPending(arcEnd, destPos, args);
+    return true;
+}
+
+bool CornerBlender::addPassThrough(AxisFloats &destPos, RobotCommandArgs &args)
+{
+    flush();
+    return addOutput(destPos, args);
+}
+
+void CornerBlender::flush()
+{
+    if (!_pendingValid)
+        return;
+    addOutput(_pendingDestPos, _pendingArgs);
+    _pendingValid = false;
+}
+
+bool CornerBlender::getNextOutput(AxisFloats &destPos, RobotCommandArgs &args)
+{
+    if (_outputCount <= 0)
+        return false;
+    destPos = _outputMoves[_outputReadIdx]._destPos;
+    args = _outputMoves[_outputReadIdx]._args;
+    _outputReadIdx++;
+    _outputCount--;
+    if (_outputCount == 0)
+        _outputReadIdx = 0;
+    return true;
+}
+
+bool CornerBlender::addOutput(AxisFloats &destPos, RobotCommandArgs &args)
+{
+    if (_outputReadIdx + _outputCount >= MAX_OUTPUT_MOVES)
+    {
+        Log.warning("%soutput full\n", MODULE_PREFIX);
+        return false;
+    }
+    OutputMove &outputMove = _outputMoves[_outputReadIdx + _outputCount];
+    outputMove._destPos = destPos;
+    outputMove._args = args;
+    _outputCount++;
+    return true;
+}
+
+void CornerBlender::setPending(AxisFloats &startPos, AxisFloats &destPos, RobotCommandArgs &args)
+{
+    _pendingValid = true;
+    _pendingStartPos = startPos;
+    _pendingDestPos = destPos;
+    _pendingArgs = args;
+    _pendingSinceMs = millis();
+}
@@ -0,0 +1,99 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+#pragma once
+
+#include "AxisValues.h"
+#include "../AxesParams.h"
+#include "../../RobotCommandArgs.h"
+
+// Corner blending (G64 style path blending)
+// Each move is held back until the next one is known - the corner between them is then
+// replaced by a circular arc (as short line segments) which deviates from the corner point
+// by no more than the configured tolerance so that the planner can carry speed through it
+// Moves which aren't blendable (stepwise, end-stop checks, non-primary axis motion) are passed
+// through in order after flushing any held move
+class CornerBlender
+{
+public:
+    static constexpr float cornerBlendMM_default = 0.0f;
+    static constexpr int MAX_ARC_SEGS = 8;
+    static constexpr int MAX_OUTPUT_MOVES = MAX_ARC_SEGS + 2;
+    // Deviation angles below this are treated as straight and above this as reversals (not blended)
+    static constexpr float MIN_BLEND_ANGLE_RADS = 0.001f;
+    static constexpr float MAX_BLEND_ANGLE_RADS = 3.0f;
+    // Held move is flushed if no following move arrives within this time
+    static constexpr uint32_t PENDING_FLUSH_MS = 250;
+
+    CornerBlender();
+
+    void configure(const char *robotConfigJSON);
+    bool isEnabled()
+    {
+        return _cornerBlendMM > 0;
+    }
+    float getTolerance()
+    {
+        return _cornerBlendMM;
+    }
+
+    void clear();
+    bool isEmpty()
+    {
+        return !_pendingValid && (_outputCount == 0);
+    }
+    bool hasPending()
+    {
+        return _pendingValid;
+    }
+    bool hasOutput()
+    {
+        return _outputCount > 0;
+    }
+    uint32_t getPendingSinceMs()
+    {
+        return _pendingSinceMs;
+    }
+
+    // Position at the end of all motion held here (returns false if nothing held)
+    bool getEndPos(AxisFloats &endPos);
+
+    // Check if a move can be blended
+    static bool isBlendable(RobotCommandArgs &args, AxisFloats &startPos, AxisFloats &destPos, AxesParams &axesParams);
+
+    // Add a blendable move (startPos is only used when nothing is held)
+    bool addMove(AxisFloats &startPos, AxisFloats &destPos, RobotCommandArgs &args, AxesParams &axesParams);
+
+    // Add a move which must not be blended - any held move is flushed first
+    bool addPassThrough(AxisFloats &destPos, RobotCommandArgs &args);
+
+    // Release the held move (straight to its end point)
+    void flush();
+
+    // Get the next move to send to the planner
+    bool getNextOutput(AxisFloats &destPos, RobotCommandArgs &args);
+
+private:
+    // Tolerance (max distance of the blended path from the corner point)
+    float _cornerBlendMM;
+
+    // Move being held (from start to dest)
+    bool _pendingValid;
+    AxisFloats _pendingStartPos;
+    AxisFloats _pendingDestPos;
+    RobotCommandArgs _pendingArgs;
+    uint32_t _pendingSinceMs;
+
+    // Moves ready for the planner
+    struct OutputMove
+    {
+        AxisFloats _destPos;
+        RobotCommandArgs _args;
+    };
+    OutputMove _outputMoves[MAX_OUTPUT_MOVES];
+    int _outputCount;
+    int _outputReadIdx;
+
+    bool addOutput(AxisFloats &destPos, RobotCommandArgs &args);
+    void setPending(AxisFloats &startPos, AxisFloats &destPos, RobotCommandArgs &args);
+};
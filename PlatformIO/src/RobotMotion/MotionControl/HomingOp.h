@@ -0,0 +1,69 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+#pragma once
+
+#include "../AxesParams.h"
+
+// A single operation of a compiled homing sequence
+class HomingOp
+{
+public:
+    enum HomingOpType
+    {
+        HOMING_OP_MOVE,
+        HOMING_OP_SET_HOME,
+        HOMING_OP_FEEDRATE,
+        HOMING_OP_ACCEL,
+        HOMING_OP_EXEC,
+        HOMING_OP_DONE
+    };
+
+    enum FeedrateUnits
+    {
+        FEEDRATE_UNITS_NONE,
+        FEEDRATE_UNITS_RPM,
+        FEEDRATE_UNITS_STEPS_PER_SEC
+    };
+
+    HomingOpType _opType;
+    int _axisIdx;
+    int32_t _steps;
+    FeedrateUnits _feedrateUnits;
+    int32_t _feedrateVal;
+    int32_t _accelStepsPerSec2;
+    bool _centre;
+    bool _endStopValid;
+    int _endStopIdx;
+    bool _endStopCheckActive;
+    int32_t _latchBackoffSteps;
+
+    HomingOp(HomingOpType opType = HOMING_OP_DONE, int axisIdx = 0)
+    {
+        _opType = opType;
+        _axisIdx = axisIdx;
+        _steps = 0;
+        _feedrateUnits = FEEDRATE_UNITS_NONE;
+        _feedrateVal = 0;
+        _accelStepsPerSec2 = 0;
+        _centre = false;
+        _endStopValid = false;
+        _endStopIdx = 0;
+        _endStopCheckActive = false;
+        _latchBackoffSteps = 0;
+    }
+
+    // Feedrate in steps per second for an axis (or defaultValue if the op doesn't specify one)
+    int getFeedrateStepsPerSec(AxesParams &axesParams, int axisIdx, int defaultValue)
+    {
+        switch (_feedrateUnits)
+        {
+            case FEEDRATE_UNITS_RPM:
+                return _feedrateVal * axesParams.getStepsPerRot(axisIdx) / 60;
+            case FEEDRATE_UNITS_STEPS_PER_SEC:
+                return _feedrateVal;
+            default:
+                return defaultValue;
+        }
+    }
+};
@@ -6,7 +6,10 @@
 #include "math.h"
 #include "AxisValues.h"
 #include "../AxesParams.h"
+#include "MotionBlockExec.h"
 
+// Planner's record for a motion block - the values which the step generator uses are
+// in the block's MotionBlockExec record
 class MotionBlock
 {
 public:
@@ -32,6 +35,8 @@ public:
     float _moveDistPrimaryAxesMM;
     // Unit vector on axis with max movement
     float _unitVecAxisWithMaxDist;
+    // Acceleration along the path (limited by each axis) - 0 for stepwise blocks
+    float _accMMps2;
     // Computed max entry speed for a block based on max junction deviation calculation
     float _maxEntrySpeedMMps;
     // Computed entry speed for this block
@@ -39,56 +44,27 @@ public:
     // Computed exit speed for this block
     float _exitSpeedMMps;
     // Step distance in MM
-    double _debugStepDistMM;
-    // End-stops to test
-    AxisMinMaxBools _endStopsToCheck;
-    // Numbered command index - to help keep track of block execution from other processes
-    // like homing
-    int _numberedCommandIndex;
-
-    // Flags
-    struct
-    {
-        // Flag indicating the block is currently executing
-        volatile bool _isExecuting : 1;
-        // Flag indicating the block can start executing
-        volatile bool _canExecute : 1;
-        // Block is followed by others
-        bool _blockIsFollowed : 1;
-    };
-
-    // Steps to target and before deceleration
-    int32_t _stepsTotalMaybeNeg[RobotConsts::MAX_AXES];
-    int _axisIdxWithMaxSteps;
-    uint32_t _stepsBeforeDecel;
-
-    // Stepping acceleration/deceleration profile
-    uint32_t _initialStepRatePerTTicks;
-    uint32_t _maxStepRatePerTTicks;
-    uint32_t _finalStepRatePerTTicks;
-    uint32_t _accStepsPerTTicksPerMS;
+    float _debugStepDistMM;
+    // Block is followed by others
+    bool _blockIsFollowed;
 
 public:
     MotionBlock();
     void clear();
-    void setNumberedCommandIndex(int cmdIdx);
-    int IRAM_ATTR getNumberedCommandIndex();
-    int32_t getStepsToTarget(int axisIdx);
-    int32_t getAbsStepsToTarget(int axisIdx);
-    void setStepsToTarget(int axisIdx, int32_t steps);
-    uint32_t getExitStepRatePerTTicks();
     static float maxAchievableSpeed(float acceleration, float target_velocity, float distance);
     void forceInBounds(float &val, float lowBound, float highBound);
-    void setEndStopsToCheck(AxisMinMaxBools &endStopCheck);
 
     // The block's entry and exit speed are now known
     // The block can accelerate and decelerate as required as long as these criteria are met
-    // We now compute the stepping parameters to make motion happen
-    bool prepareForStepping(AxesParams &axesParams, bool isStepwise);
+    // We now compute the stepping parameters (in the execution record) to make motion happen
+    // For stepwise moves a non-zero acceleration ramps the step rate up and down
+    bool prepareForStepping(MotionBlockExec &exec, AxesParams &axesParams, bool isStepwise, float stepwiseAccStepsPerSec2 = 0);
+    static uint32_t calcStepsDecelerating(float initialStepRatePerSec, float finalStepRatePerSec, 
+                float& axisMaxStepRatePerSec, float maxAccStepsPerSec2, uint32_t absMaxStepsForAnyAxis);
 
     // Debug
     void debugShowBlkHead();
-    void debugShowBlock(int elemIdx, AxesParams &axesParams);
+    void debugShowBlock(int elemIdx, MotionBlockExec &exec, AxesParams &axesParams);
     float debugStepRateToMMps(float val)
     {
         return (((val * 1.0) * MotionBlock::TICKS_PER_SEC) / MotionBlock::TTICKS_VALUE) * _debugStepDistMM;
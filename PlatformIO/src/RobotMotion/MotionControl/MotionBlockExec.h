@@ -0,0 +1,108 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+#pragma once
+
+#include <stdlib.h>
+#include "AxisValues.h"
+
+// Execution record for a motion block - the only part of a block which the step
+// generator (RampGenerator ISR or Trinamics ramp streaming) reads
+// Kept separate from the planner's record (MotionBlock) and held in a parallel array in
+// the MotionPipeline so the ISR only touches a small, word-aligned structure
+class MotionBlockExec
+{
+public:
+    // Steps to target for each axis
+    int32_t _stepsTotalMaybeNeg[RobotConsts::MAX_AXES];
+
+    // Steps before deceleration on the axis with max steps
+    uint32_t _stepsBeforeDecel;
+
+    // Stepping acceleration/deceleration profile
+    uint32_t _initialStepRatePerTTicks;
+    uint32_t _maxStepRatePerTTicks;
+    uint32_t _finalStepRatePerTTicks;
+    uint32_t _accStepsPerTTicksPerMS;
+
+    // End-stops to test
+    AxisMinMaxBools _endStopsToCheck;
+
+    // Numbered command index - to help keep track of block execution from other processes
+    // like homing
+    int _numberedCommandIndex;
+
+    // Axis with max steps
+    uint8_t _axisIdxWithMaxSteps;
+
+    // Flag indicating the block can start executing
+    volatile bool _canExecute;
+    // Flag indicating the block is currently executing
+    volatile bool _isExecuting;
+
+public:
+    MotionBlockExec()
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
+            _stepsTotalMaybeNeg[axisIdx] = 0;
+        _stepsBeforeDecel = 0;
+        _initialStepRatePerTTicks = 0;
+        _maxStepRatePerTTicks = 0;
+        _finalStepRatePerTTicks = 0;
+        _accStepsPerTTicksPerMS = 0;
+        _endStopsToCheck.none();
+        _numberedCommandIndex = 0;
+        _axisIdxWithMaxSteps = 0;
+        _canExecute = false;
+        _isExecuting = false;
+    }
+
+    void setNumberedCommandIndex(int cmdIdx)
+    {
+        _numberedCommandIndex = cmdIdx;
+    }
+
+    inline int IRAM_ATTR getNumberedCommandIndex()
+    {
+        return _numberedCommandIndex;
+    }
+
+    int32_t getStepsToTarget(int axisIdx)
+    {
+        if (axisIdx >= 0 && axisIdx < RobotConsts::MAX_AXES)
+            return _stepsTotalMaybeNeg[axisIdx];
+        return 0;
+    }
+
+    int32_t getAbsStepsToTarget(int axisIdx)
+    {
+        if (axisIdx >= 0 && axisIdx < RobotConsts::MAX_AXES)
+            return abs(_stepsTotalMaybeNeg[axisIdx]);
+        return 0;
+    }
+
+    void setStepsToTarget(int axisIdx, int32_t steps)
+    {
+        if (axisIdx >= 0 && axisIdx < RobotConsts::MAX_AXES)
+        {
+            _stepsTotalMaybeNeg[axisIdx] = steps;
+            if (abs(steps) > abs(_stepsTotalMaybeNeg[_axisIdxWithMaxSteps]))
+                _axisIdxWithMaxSteps = axisIdx;
+        }
+    }
+
+    uint32_t getExitStepRatePerTTicks()
+    {
+        return _finalStepRatePerTTicks;
+    }
+
+    void setEndStopsToCheck(AxisMinMaxBools &endStopCheck)
+    {
+        _endStopsToCheck = endStopCheck;
+    }
+};
@@ -6,6 +6,8 @@
 #include "MotionHelper.h"
 #include "Utils.h"
 #include "AxisValues.h"
+#include "../../CommandPathTiming.h"
+#include "xtensa/core-macros.h"
 
 // #define MOTION_LOG_DEBUG 1
 // #define DEBUG_MOTION_HELPER 1
@@ -19,6 +21,8 @@ MotionHelper::MotionHelper() :
 {
     // Init
     _isPaused = false;
+    _stopRequested = false;
+    _stopRequestTimeMs = 0;
     _moveRelative = false;
     _blockDistanceMM = 0;
     _allowAllOutOfBounds = false;
@@ -76,14 +80,17 @@ void MotionHelper::configure(const char *robotConfigJSON)
     _blockDistanceMM = float(RdJson::getDouble("blockDistanceMM", blockDistanceMM_default, robotGeom.c_str()));
     _allowAllOutOfBounds = bool(RdJson::getLong("allowOutOfBounds", false, robotGeom.c_str()));
     float junctionDeviation = float(RdJson::getDouble("junctionDeviation", junctionDeviation_default, robotGeom.c_str()));
-    Log.notice("%sconfigMotionPipeline len %d, blockDistMM %F (0=no-max), allowOoB %s, jnDev %F\n", MODULE_PREFIX,
-               pipelineLen, _blockDistanceMM, _allowAllOutOfBounds ? "Y" : "N", junctionDeviation);
+    MotionPlanner::PlannerMode plannerMode = MotionPlanner::getPlannerModeFromStr(
+                RdJson::getString("plannerMode", "junctionDeviation", robotGeom.c_str()));
+    Log.notice("%sconfigMotionPipeline len %d, blockDistMM %F (0=no-max), allowOoB %s, jnDev %F, planner %s\n", MODULE_PREFIX,
+               pipelineLen, _blockDistanceMM, _allowAllOutOfBounds ? "Y" : "N", junctionDeviation,
+               MotionPlanner::getPlannerModeStr(plannerMode));
 
     // Pipeline length and block size
     _motionPipeline.init(pipelineLen);
 
     // Motion Pipeline and Planner
-    _motionPlanner.configure(junctionDeviation);
+    _motionPlanner.configure(junctionDeviation, plannerMode);
 
     // Clean up previous
     _trinamicsController.deinit();
@@ -117,6 +124,9 @@ void MotionHelper::configure(const char *robotConfigJSON)
     // Motor enabler
     _motorEnabler.configure(robotGeom.c_str());
 
+    // Corner blending
+    _cornerBlender.configure(robotGeom.c_str());
+
     // Start motion actuator
     _rampGenerator.configure(!_trinamicsController.isRampGenerator());
 
@@ -133,7 +143,7 @@ bool MotionHelper::canAccept()
     if (_motionHoming.isHomingInProgress())
         return false;
     // Check that the motion pipeline can accept new data
-    return (_blocksToAddTotal == 0) && _motionPipeline.canAccept();
+    return (_blocksToAddTotal == 0) && !_cornerBlender.hasOutput() && _motionPipeline.canAccept();
 }
 
 // Pause (or un-pause) all motion
@@ -155,6 +165,7 @@ bool MotionHelper::isPaused()
 void MotionHelper::stop()
 {
     _blocksToAddTotal = 0;
+    _cornerBlender.clear();
     _stopRequested = true;
     _stopRequestTimeMs = millis();
     _rampGenerator.stop();
@@ -167,7 +178,19 @@ void MotionHelper::stop()
 // Check if idle
 bool MotionHelper::isIdle()
 {
-    return !_motionPipeline.canGet();
+    return !_motionPipeline.canGet() && _cornerBlender.isEmpty();
+}
+
+// Check if moving with few blocks left in the pipeline
+bool MotionHelper::isPipelineLow()
+{
+    unsigned int numBlocks = _motionPipeline.count();
+    if (_isPaused || (numBlocks == 0))
+        return false;
+    unsigned int lowBlocks = (unsigned int)(_motionPipeline.size() * PIPELINE_LOW_FRACTION);
+    if (lowBlocks < PIPELINE_LOW_MIN_BLOCKS)
+        lowBlocks = PIPELINE_LOW_MIN_BLOCKS;
+    return numBlocks < lowBlocks;
 }
 
 void MotionHelper::setCurPosActualPosition()
@@ -248,25 +271,35 @@ void MotionHelper::goHome(RobotCommandArgs &args)
 // Command the robot to move (adding a command to the pipeline of motion)
 bool MotionHelper::moveTo(RobotCommandArgs &args)
 {
-    // Handle stepwise motion
+    INSTRUMENT_COMMAND_PATH_SCOPE(STAGE_MOTION)
+    // Handle stepwise motion (behind any moves held for corner blending)
     if (args.isStepwise())
     {
+        AxisFloats endPos = _lastCommandedAxisPos._axisPositionMM;
+        if (_cornerBlender.getEndPos(endPos))
+        {
+            bool moveOk = _cornerBlender.addPassThrough(endPos, args);
+            blocksToAddProcess();
+            return moveOk;
+        }
         return _motionPlanner.moveToStepwise(args, _lastCommandedAxisPos, _axesParams, _motionPipeline);
     }
     // Convert coordinates if required
     // Convert coords to MM (in-place conversion)
     if (_convertCoordsFn)
         _convertCoordsFn(args, _axesParams);
+    // Position at the end of motion so far (moves may be held for corner blending)
+    AxisFloats endPos = _lastCommandedAxisPos._axisPositionMM;
+    _cornerBlender.getEndPos(endPos);
+
     // Fill in the destPos for axes for which values not specified
     // Handle relative motion override if present
-    // Don't use servo values for computing distance to travel
     AxisFloats destPos = args.getPointMM();
-    bool includeDist[RobotConsts::MAX_AXES];
     for (int i = 0; i < RobotConsts::MAX_AXES; i++)
     {
         if (!args.isValid(i))
         {
-            destPos.setVal(i, _lastCommandedAxisPos._axisPositionMM.getVal(i));
+            destPos.setVal(i, endPos.getVal(i));
 #ifdef DEBUG_MOTION_HELPER
             Log.notice("%smoveTo ax %d, pos %F NoMovementOnThisAxis\n", MODULE_PREFIX, 
                     i, 
@@ -281,7 +314,7 @@ bool MotionHelper::moveTo(RobotCommandArgs &args)
             if (args.getMoveType() != RobotMoveTypeArg_None)
                 moveRelative = (args.getMoveType() == RobotMoveTypeArg_Relative);
             if (moveRelative)
-                destPos.setVal(i, _lastCommandedAxisPos._axisPositionMM.getVal(i) + args.getValMM(i));
+                destPos.setVal(i, endPos.getVal(i) + args.getValMM(i));
 #ifdef DEBUG_MOTION_HELPER
             Log.notice("%smoveTo ax %d, pos %F relative %s\n", MODULE_PREFIX, 
                     i, 
@@ -289,9 +322,30 @@ bool MotionHelper::moveTo(RobotCommandArgs &args)
                     moveRelative ? "Y" : "N");
 #endif
         }
-        includeDist[i] = _axesParams.isPrimaryAxis(i);
     }
 
+    // Corner blending holds moves back - moves which can't be blended are queued behind held ones
+    bool moveOk = true;
+    if (_cornerBlender.isEnabled() && CornerBlender::isBlendable(args, endPos, destPos, _axesParams))
+        moveOk = _cornerBlender.addMove(endPos, destPos, args, _axesParams);
+    else if (!_cornerBlender.isEmpty())
+        moveOk = _cornerBlender.addPassThrough(destPos, args);
+    else
+        blocksToAddStart(destPos, args);
+
+    // Process anything that can be done immediately
+    blocksToAddProcess();
+    return moveOk;
+}
+
+// Setup for splitting a move up into blocks to add to the pipeline
+void MotionHelper::blocksToAddStart(AxisFloats &destPos, RobotCommandArgs &args)
+{
+    // Don't use servo values for computing distance to travel
+    bool includeDist[RobotConsts::MAX_AXES];
+    for (int i = 0; i < RobotConsts::MAX_AXES; i++)
+        includeDist[i] = _axesParams.isPrimaryAxis(i);
+
     // Split up into blocks of maximum length
     double lineLen = destPos.distanceTo(_lastCommandedAxisPos._axisPositionMM, includeDist);
 
@@ -324,10 +378,6 @@ bool MotionHelper::moveTo(RobotCommandArgs &args)
     _blocksToAddEndPos = destPos;
     _blocksToAddCurBlock = 0;
     _blocksToAddTotal = numBlocks;
-
-    // Process anything that can be done immediately
-    blocksToAddProcess();
-    return true;
 }
 
 // A single moveTo command can be split into blocks - this function checks if such
@@ -337,9 +387,20 @@ void MotionHelper::blocksToAddProcess()
     // Check if we can add anything to the pipeline
     while (_motionPipeline.canAccept())
     {
-        // Check if any blocks remain to be expanded out
+        // Check if any blocks remain to be expanded out - if not then start on the next move
+        // released by corner blending (if any)
         if (_blocksToAddTotal <= 0)
-            return;
+        {
+            AxisFloats destPos;
+            RobotCommandArgs args;
+            if (!_cornerBlender.getNextOutput(destPos, args))
+                return;
+            if (args.isStepwise())
+                _motionPlanner.moveToStepwise(args, _lastCommandedAxisPos, _axesParams, _motionPipeline);
+            else
+                blocksToAddStart(destPos, args);
+            continue;
+        }
 
         // Add to pipeline any blocks that are waiting to be expanded out
         AxisFloats nextBlockDest = _blocksToAddStartPos + _blocksToAddDelta * float(_blocksToAddCurBlock + 1);
@@ -357,7 +418,7 @@ void MotionHelper::blocksToAddProcess()
 
         // Prepare add to planner
         _blocksToAddCommandArgs.setPointMM(nextBlockDest);
-        _blocksToAddCommandArgs.setMoreMovesComing(_blocksToAddTotal != 0);
+        _blocksToAddCommandArgs.setMoreMovesComing((_blocksToAddTotal != 0) || !_cornerBlender.isEmpty());
 
 
         // Add to planner
@@ -381,13 +442,19 @@ bool MotionHelper::addToPlanner(RobotCommandArgs &args)
     AxisFloats actuatorCoords;
     bool moveOk = false;
     if (_ptToActuatorFn)
+    {
+        INSTRUMENT_COMMAND_PATH_SCOPE(STAGE_KINEMATICS)
         moveOk = _ptToActuatorFn(args.getPointMM(), actuatorCoords, _lastCommandedAxisPos, _axesParams,
                     args.getAllowOutOfBounds() || _allowAllOutOfBounds);
+    }
 
     // Plan the move
     if (moveOk)
     {
-        moveOk = _motionPlanner.moveTo(args, actuatorCoords, _lastCommandedAxisPos, _axesParams, _motionPipeline);
+        {
+            INSTRUMENT_COMMAND_PATH_SCOPE(STAGE_PLAN)
+            moveOk = _motionPlanner.moveTo(args, actuatorCoords, _lastCommandedAxisPos, _axesParams, _motionPipeline);
+        }
 #ifdef MOTION_LOG_DEBUG
     Log.trace("~M%d %d %d %F %F OOB %d %d\n", millis(), int(actuatorCoords.getVal(0)), 
             int(actuatorCoords.getVal(1)), 
@@ -424,6 +491,7 @@ bool MotionHelper::addToPlanner(RobotCommandArgs &args)
 // disabled after a period of no motion
 void MotionHelper::service()
 {
+    INSTRUMENT_COMMAND_PATH_SCOPE(STAGE_MOTION)
     // Check if stop requested
     if (_stopRequested)
     {
@@ -446,6 +514,15 @@ void MotionHelper::service()
     // Process for trinamic devices
     _trinamicsController.process();
 
+    // Release a move held for corner blending if no following move has arrived in time or
+    // the pipeline is about to run dry
+    if (_cornerBlender.hasPending() && !_cornerBlender.hasOutput() && (_blocksToAddTotal == 0))
+    {
+        if ((_motionPipeline.count() <= 1) || 
+                Utils::isTimeout(millis(), _cornerBlender.getPendingSinceMs(), CornerBlender::PENDING_FLUSH_MS))
+            _cornerBlender.flush();
+    }
+
     // Process any split-up blocks to be added to the pipeline
     blocksToAddProcess();
 
@@ -460,6 +537,74 @@ void MotionHelper::service()
 
 }
 
+// Micro-benchmarks of the kinematics (ptToActuator) and planner (MotionPlanner::moveTo into a
+// scratch pipeline) using points on a circle in the working area - CPU cycles are added to the
+// totals so that a long run can be split over several calls from the main loop
+// Only a scratch planner and pipeline and a copy of the commanded position are used - the live
+// planner state is never touched
+bool MotionHelper::runBenchmarks(int iterations, uint32_t& kinematicsCycles, uint32_t& plannerCycles)
+{
+    if (!isIdle() || !canAccept() || !_ptToActuatorFn)
+        return false;
+
+    // Circle about the centre of the working area (or the current position if not known)
+    AxisPosition benchPos = _lastCommandedAxisPos;
+    AxisFloats centre = benchPos._axisPositionMM;
+    float radius = 10;
+    float sizeX = RdJson::getDouble("sizeX", 0, _robotAttributes.c_str());
+    float sizeY = RdJson::getDouble("sizeY", 0, _robotAttributes.c_str());
+    if ((sizeX > 0) && (sizeY > 0))
+    {
+        centre.setVal(0, sizeX / 2 - RdJson::getDouble("originX", 0, _robotAttributes.c_str()));
+        centre.setVal(1, sizeY / 2 - RdJson::getDouble("originY", 0, _robotAttributes.c_str()));
+        radius = fminf(sizeX, sizeY) / 4;
+    }
+    AxisFloats benchPts[BENCHMARK_NUM_PTS];
+    for (int ptIdx = 0; ptIdx < BENCHMARK_NUM_PTS; ptIdx++)
+    {
+        float angle = 2 * M_PI * ptIdx / BENCHMARK_NUM_PTS;
+        benchPts[ptIdx] = centre;
+        benchPts[ptIdx].setVal(0, centre.getVal(0) + radius * cosf(angle));
+        benchPts[ptIdx].setVal(1, centre.getVal(1) + radius * sinf(angle));
+    }
+
+    // Kinematics
+    AxisFloats actuatorCoords[BENCHMARK_NUM_PTS];
+    uint32_t startCycles = XTHAL_GET_CCOUNT();
+    for (int iterIdx = 0; iterIdx < iterations; iterIdx++)
+    {
+        int ptIdx = iterIdx % BENCHMARK_NUM_PTS;
+        _ptToActuatorFn(benchPts[ptIdx], actuatorCoords[ptIdx], benchPos, _axesParams, true);
+    }
+    kinematicsCycles += XTHAL_GET_CCOUNT() - startCycles;
+
+    // Planner - the oldest block is treated as executed when the scratch pipeline fills
+    MotionPlanner benchPlanner;
+    benchPlanner.configure(_motionPlanner.getJunctionDeviation(), _motionPlanner.getPlannerMode());
+    MotionPipeline benchPipeline;
+    benchPipeline.init(BENCHMARK_PIPELINE_LEN);
+    RobotCommandArgs args;
+    for (int iterIdx = 0; iterIdx < iterations; iterIdx++)
+    {
+        int ptIdx = iterIdx % BENCHMARK_NUM_PTS;
+        for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
+            args.setAxisValMM(axisIdx, benchPts[ptIdx].getVal(axisIdx), true);
+        args.setMoreMovesComing(true);
+        startCycles = XTHAL_GET_CCOUNT();
+        benchPlanner.moveTo(args, actuatorCoords[ptIdx], benchPos, _axesParams, benchPipeline);
+        plannerCycles += XTHAL_GET_CCOUNT() - startCycles;
+        benchPos._axisPositionMM = benchPts[ptIdx];
+        if (!benchPipeline.canAccept())
+        {
+            benchPipeline.remove();
+            MotionBlockExec *pExec = benchPipeline.peekExecNthFromGet(0);
+            if (pExec)
+                pExec->_isExecuting = true;
+        }
+    }
+    return true;
+}
+
 // Set home coordinates
 void MotionHelper::setCurPositionAsHome(int axisIdx)
 {
@@ -501,10 +646,11 @@ int MotionHelper::testGetPipelineCount()
     return _motionPipeline.count();
 }
 
-bool MotionHelper::testGetPipelineBlock(int elIdx, MotionBlock &block)
+bool MotionHelper::testGetPipelineBlock(int elIdx, MotionBlock &block, MotionBlockExec &blockExec)
 {
     if ((int)_motionPipeline.count() <= elIdx)
         return false;
     block = *_motionPipeline.peekNthFromPut(_motionPipeline.count() - 1 - elIdx);
+    blockExec = *_motionPipeline.peekExecNthFromPut(_motionPipeline.count() - 1 - elIdx);
     return true;
 }
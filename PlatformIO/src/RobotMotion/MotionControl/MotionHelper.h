@@ -11,6 +11,7 @@
 #include "MotionHoming.h"
 #include "Trinamics/TrinamicsController.h"
 #include "MotorEnabler.h"
+#include "CornerBlender.h"
 
 class MotionHelper
 {
@@ -19,7 +20,13 @@ public:
     static constexpr float junctionDeviation_default = 0.05f;
     static constexpr float distToTravelMM_ignoreBelow = 0.01f;
     static constexpr int pipelineLen_default = 100;
+    // Pipeline is low when it holds fewer than this fraction of its size (or the min blocks)
+    static constexpr float PIPELINE_LOW_FRACTION = 0.25f;
+    static constexpr unsigned int PIPELINE_LOW_MIN_BLOCKS = 5;
     static constexpr uint32_t MAX_TIME_BEFORE_STOP_COMPLETE_MS = 500;
+    // Micro-benchmarks
+    static constexpr int BENCHMARK_NUM_PTS = 32;
+    static constexpr int BENCHMARK_PIPELINE_LEN = 20;
 
 private:
     // Pause
@@ -54,6 +61,8 @@ private:
     MotionHoming _motionHoming;
     // Motor enabler
     MotorEnabler _motorEnabler;
+    // Corner blending
+    CornerBlender _cornerBlender;
 
     // Split-up movement blocks to be added to pipeline
     // Number of blocks to add
@@ -71,7 +80,7 @@ private:
 
     // Handling of stop
     bool _stopRequested;
-    bool _stopRequestTimeMs;
+    unsigned long _stopRequestTimeMs;
 
     // Debug
     unsigned long _debugLastPosDispMs;
@@ -96,6 +105,9 @@ public:
     void stop();
     // Check if idle
     bool isIdle();
+    // Check if moving with few blocks left in the pipeline (so other work that could
+    // delay planning, such as writing to flash, should wait)
+    bool isPipelineLow();
 
     double getStepsPerUnit(int axisIdx)
     {
@@ -140,13 +152,17 @@ public:
         return _motorEnabler.getLastActiveUnixTime();
     }
 
+    // Micro-benchmarks of kinematics and planning (returns false if not idle) - CPU cycles are
+    // added to the totals
+    bool runBenchmarks(int iterations, uint32_t& kinematicsCycles, uint32_t& plannerCycles);
+
     // Test code
     void debugShowBlocks();
     void debugShowTopBlock();
     void debugShowTiming();
     String getDebugStr();
     int testGetPipelineCount();
-    bool testGetPipelineBlock(int elIdx, MotionBlock &elem);
+    bool testGetPipelineBlock(int elIdx, MotionBlock &elem, MotionBlockExec &elemExec);
     void setIntrumentationMode(const char *testModeStr)
     {
         _rampGenerator.setInstrumentationMode(testModeStr);
@@ -157,6 +173,14 @@ public:
     {
         return &_motionHoming;
     }
+    RampGenerator* testGetRampGenerator()
+    {
+        return &_rampGenerator;
+    }
+    TrinamicsController* testGetTrinamicsController()
+    {
+        return &_trinamicsController;
+    }
 #endif
 
 private:
@@ -166,5 +190,6 @@ private:
     }
     void setCurPosActualPosition();
     bool addToPlanner(RobotCommandArgs &args);
+    void blocksToAddStart(AxisFloats &destPos, RobotCommandArgs &args);
     void blocksToAddProcess();
 };
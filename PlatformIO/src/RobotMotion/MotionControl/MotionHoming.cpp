@@ -10,16 +10,22 @@ MotionHoming::MotionHoming(MotionHelper *pMotionHelper)
 {
     _pMotionHelper = pMotionHelper;
     _homingInProgress = false;
-    _homingStrPos = 0;
+    _homingOpIdx = 0;
     _commandInProgress = false;
     _isHomedOk = false;
     _maxHomingSecs = maxHomingSecs_default;
     _homeReqMillis = 0;
     _homingCurCommandIndex = homing_baseCommandIndex;
     _feedrateStepsPerSecForHoming = -1;
+    _accelStepsPerSec2Config = 0;
+    _accelStepsPerSec2ForHoming = 0;
     _doCentring = false;
     _centringInProgress = false;
     _centringPhase = 0;
+    _doLatch = false;
+    _latchInProgress = false;
+    _latchPhase = 0;
+    _latchBackoffSteps = 0;
 }
 
 void MotionHoming::configure(const char *configJSON)
@@ -29,13 +35,24 @@ void MotionHoming::configure(const char *configJSON)
     _homingSequence = RdJson::getString("homing/homingSeq", "", configJSON, isValid);
     if (!isValid)
         _homingSequence = "";
+    // Compile the sequence - an invalid sequence leaves an empty program so homing fails
+    String errorMsg;
+    if (!compileSequence(_homingSequence, _homingProgram, errorMsg))
+    {
+        Log.warning("%sconfig sequence invalid %s\n", MODULE_PREFIX, errorMsg.c_str());
+        _homingProgram.clear();
+    }
     // Max time homing
     _maxHomingSecs = RdJson::getLong("homing/maxHomingSecs", maxHomingSecs_default, configJSON);
+    // Acceleration for homing moves (steps/s^2) - 0 means start and stop at the feedrate
+    _accelStepsPerSec2Config = RdJson::getLong("homing/accel", 0, configJSON);
     // No homing currently
-    _homingStrPos = 0;
+    _homingOpIdx = 0;
     _commandInProgress = false;
     _centringInProgress = false;
-    Log.notice("%sconfig sequence %s\n", MODULE_PREFIX, _homingSequence.c_str());
+    _latchInProgress = false;
+    Log.notice("%sconfig sequence %s ops %d accel %d\n", MODULE_PREFIX, _homingSequence.c_str(), 
+                (int)_homingProgram.size(), _accelStepsPerSec2Config);
 }
 
 bool MotionHoming::isHomingInProgress()
@@ -51,14 +68,17 @@ bool MotionHoming::isHomedOk()
 void MotionHoming::homingStart(RobotCommandArgs &args)
 {
     _axesToHome = args;
-    _homingStrPos = 0;
+    _homingOpIdx = 0;
     _homingInProgress = true;
     _commandInProgress = false;
     _isHomedOk = false;
     _centringInProgress = false;
     _doCentring = false;
+    _latchInProgress = false;
+    _doLatch = false;
     _homeReqMillis = millis();
     _feedrateStepsPerSecForHoming = -1;
+    _accelStepsPerSec2ForHoming = _accelStepsPerSec2Config;
     RobotCommandArgs curStatus;
     _pMotionHelper->getCurStatus(curStatus);
     _homingStartSteps = curStatus.getPointSteps();
@@ -101,6 +121,14 @@ void MotionHoming::service(AxesParams &axesParams)
         _centringInProgress = false;
     }
 
+    // Check if latching in progress
+    if (_latchInProgress)
+    {
+        if (nextLatchOperation())
+            return;
+        _latchInProgress = false;
+    }
+
     // Need to start a command or finish
     _curCommand.clear();
     String debugCmdStr;
@@ -114,16 +142,16 @@ void MotionHoming::service(AxesParams &axesParams)
     }
 }
 
-bool MotionHoming::getInteger(unsigned int &homingStrPos, int &retInt)
+bool MotionHoming::getInteger(const String& homingSequence, unsigned int &homingStrPos, int &retInt)
 {
     // Check for distance
     String distStr = "";
     while (true)
     {
-        if (isdigit(_homingSequence.charAt(homingStrPos)) || _homingSequence.charAt(homingStrPos) == '.' || 
-                _homingSequence.charAt(homingStrPos) == '+' || _homingSequence.charAt(homingStrPos) == '-')
+        if (isdigit(homingSequence.charAt(homingStrPos)) || homingSequence.charAt(homingStrPos) == '.' || 
+                homingSequence.charAt(homingStrPos) == '+' || homingSequence.charAt(homingStrPos) == '-')
         {
-            distStr += _homingSequence.charAt(homingStrPos);
+            distStr += homingSequence.charAt(homingStrPos);
             homingStrPos++;
         }
         else
@@ -139,74 +167,195 @@ bool MotionHoming::getInteger(unsigned int &homingStrPos, int &retInt)
     return false;
 }
 
-int MotionHoming::getFeedrate(unsigned int &homingStrPos, AxesParams &axesParams, int axisIdx, int defaultValue)
+bool MotionHoming::getFeedrate(const String& homingSequence, unsigned int &homingStrPos, HomingOp& homingOp)
+{
+    // R = RPM, S = steps per second
+    char unitsCh = toupper(homingSequence.charAt(homingStrPos));
+    if ((unitsCh != 'R') && (unitsCh != 'S'))
+        return false;
+    homingStrPos++;
+    int newFeedrate = 0;
+    if (!getInteger(homingSequence, homingStrPos, newFeedrate) || (newFeedrate <= 0))
+        return false;
+    homingOp._feedrateUnits = (unitsCh == 'R') ? HomingOp::FEEDRATE_UNITS_RPM : HomingOp::FEEDRATE_UNITS_STEPS_PER_SEC;
+    homingOp._feedrateVal = newFeedrate;
+    return true;
+}
+
+bool MotionHoming::compileSequence(const String& homingSequence, std::vector<HomingOp>& homingProgram, String& errorMsg)
 {
-    // Initially set to max rate
-    int feedrateStepsPerSec = defaultValue;
-    switch(_homingSequence.charAt(homingStrPos))
+    homingProgram.clear();
+    errorMsg = "";
+    unsigned int homingStrPos = 0;
+    while (homingStrPos < homingSequence.length())
     {
-        case 'R':
-        case 'r':
+        unsigned int opStrPos = homingStrPos;
+        char ch = toupper(homingSequence.charAt(homingStrPos++));
+        switch (ch)
         {
-            homingStrPos++;
-            int newFeedrate = 0;
-            if (getInteger(homingStrPos, newFeedrate))
+            case '$': // All done ok
             {
-                if (newFeedrate > 0)
-                    feedrateStepsPerSec = newFeedrate * axesParams.getStepsPerRot(axisIdx) / 60;
+                homingProgram.push_back(HomingOp(HomingOp::HOMING_OP_DONE));
+                break;
             }
-            break;
-        }
-        case 'S':
-        case 's':
-        {
-            homingStrPos++;
-            int newFeedrate = 0;
-            if (getInteger(homingStrPos, newFeedrate))
+            case '#': // Process command
             {
-                if (newFeedrate > 0)
-                    feedrateStepsPerSec = newFeedrate;
+                homingProgram.push_back(HomingOp(HomingOp::HOMING_OP_EXEC));
+                break;
+            }
+            case 'A': // Actuators
+            case 'B':
+            case 'C':
+            {
+                int axisIdx = ch - 'A';
+                if (axisIdx >= RobotConsts::MAX_AXES)
+                {
+                    errorMsg = "axis not in build at " + String(opStrPos);
+                    return false;
+                }
+                // Maybe this is saying the axis is now home
+                if (homingSequence.charAt(homingStrPos) == '=')
+                {
+                    homingStrPos++;
+                    if (toupper(homingSequence.charAt(homingStrPos)) != 'H')
+                    {
+                        errorMsg = "expected h after = at " + String(homingStrPos);
+                        return false;
+                    }
+                    homingStrPos++;
+                    homingProgram.push_back(HomingOp(HomingOp::HOMING_OP_SET_HOME, axisIdx));
+                    break;
+                }
+                // Steps to move
+                HomingOp homingOp(HomingOp::HOMING_OP_MOVE, axisIdx);
+                int stepsToMove = 0;
+                if (!getInteger(homingSequence, homingStrPos, stepsToMove))
+                {
+                    errorMsg = "expected steps or =h at " + String(homingStrPos);
+                    return false;
+                }
+                homingOp._steps = stepsToMove;
+                // Modifiers
+                bool modifierValid = true;
+                while (modifierValid)
+                {
+                    unsigned int modStrPos = homingStrPos;
+                    switch (toupper(homingSequence.charAt(homingStrPos)))
+                    {
+                        case 'R':
+                        case 'S':
+                            if (!getFeedrate(homingSequence, homingStrPos, homingOp))
+                            {
+                                errorMsg = "invalid feedrate at " + String(modStrPos);
+                                return false;
+                            }
+                            break;
+                        case 'Q':
+                            homingOp._centre = true;
+                            homingStrPos++;
+                            break;
+                        case 'N':
+                        case 'X':
+                        {
+                            char endStopCh = homingSequence.charAt(homingStrPos++);
+                            homingOp._endStopValid = true;
+                            homingOp._endStopIdx = (toupper(endStopCh) == 'N') ? 0 : 1;
+                            homingOp._endStopCheckActive = isupper(endStopCh);
+                            break;
+                        }
+                        case 'L':
+                        {
+                            homingStrPos++;
+                            int backoffSteps = 0;
+                            if (!getInteger(homingSequence, homingStrPos, backoffSteps) || (backoffSteps <= 0))
+                            {
+                                errorMsg = "invalid latch back-off at " + String(modStrPos);
+                                return false;
+                            }
+                            homingOp._latchBackoffSteps = backoffSteps;
+                            break;
+                        }
+                        default:
+                            modifierValid = false;
+                            break;
+                    }
+                }
+                homingProgram.push_back(homingOp);
+                break;
+            }
+            case 'F': // Feedrate for whole homing (unless specifically overridden)
+            {
+                HomingOp homingOp(HomingOp::HOMING_OP_FEEDRATE);
+                if (!getFeedrate(homingSequence, homingStrPos, homingOp))
+                {
+                    errorMsg = "invalid feedrate at " + String(opStrPos);
+                    return false;
+                }
+                homingProgram.push_back(homingOp);
+                break;
+            }
+            case 'K': // Acceleration for whole homing
+            {
+                HomingOp homingOp(HomingOp::HOMING_OP_ACCEL);
+                int accelStepsPerSec2 = 0;
+                if (!getInteger(homingSequence, homingStrPos, accelStepsPerSec2) || (accelStepsPerSec2 < 0))
+                {
+                    errorMsg = "invalid acceleration at " + String(opStrPos);
+                    return false;
+                }
+                homingOp._accelStepsPerSec2 = accelStepsPerSec2;
+                homingProgram.push_back(homingOp);
+                break;
+            }
+            case ';':
+            case ' ':
+                break;
+            default:
+            {
+                errorMsg = String("unexpected ") + homingSequence.charAt(opStrPos) + " at " + String(opStrPos);
+                return false;
             }
-            break;
         }
     }
-    return feedrateStepsPerSec;
+    return true;
 }
 
-void MotionHoming::setCentring(unsigned int &homingStrPos, int axisIdx)
+void MotionHoming::execMoveOp(HomingOp& homingOp, AxesParams &axesParams)
 {
-    if ((_homingSequence.charAt(homingStrPos) == 'Q') || (_homingSequence.charAt(homingStrPos) == 'q'))
-    {
+    int axisIdx = homingOp._axisIdx;
+    // We're homing
+    _curCommand.setIsHoming(true);
+    // All homing is relative
+    _curCommand.setMoveType(RobotMoveTypeArg_Relative);
+    // Set dist to move
+    if (_axesToHome.isValid(axisIdx))
+        _curCommand.setAxisSteps(axisIdx, homingOp._steps, true);
+    // Set feedrate to either max steps per second for this axis or a setting from the command string
+    int feedrateStepsPerSec = homingOp.getFeedrateStepsPerSec(axesParams, axisIdx, 
+                (_feedrateStepsPerSecForHoming == -1) ? axesParams.getMaxStepRatePerSec(axisIdx) : _feedrateStepsPerSecForHoming);
+    _curCommand.setFeedrate(feedrateStepsPerSec);
+    // Ramp up and down if acceleration set
+    if (_accelStepsPerSec2ForHoming > 0)
+        _curCommand.setStepAccel(_accelStepsPerSec2ForHoming);
+    // Check for centring mode
+    if (homingOp._centre)
         _doCentring = true;
-        homingStrPos++;
-    }
-}
-
-void MotionHoming::setEndstops(unsigned int &homingStrPos, int axisIdx)
-{
-    // Endstops
-    // Log.notice("%stestingCh %c, speed %F, dist %F\n", MODULE_PREFIX, _homingSequence.charAt(_homingStrPos),
-    //             _curCommand.getFeedrate(), _curCommand.getValMM(axisIdx));
-    int endStopIdx = 0;
-    bool checkActive = false;
-    bool setEndstopTest = false;
-    if ((_homingSequence.charAt(homingStrPos) == 'X') || (_homingSequence.charAt(homingStrPos) == 'x') ||
-        (_homingSequence.charAt(homingStrPos) == 'N') || (_homingSequence.charAt(homingStrPos) == 'n'))
+    // Set endstop tests
+    if (homingOp._endStopValid)
     {
-        endStopIdx = ((_homingSequence.charAt(homingStrPos) == 'N') || (_homingSequence.charAt(homingStrPos) == 'n')) ? 0 : 1;
-        checkActive = (_homingSequence.charAt(homingStrPos) == 'X') || (_homingSequence.charAt(homingStrPos) == 'N');
-        homingStrPos++;
-        setEndstopTest = true;
+        // Check axis should be homed
+        if (!_axesToHome.isValid(axisIdx))
+            Log.DBG_HOMING_LVL("%sAxis%d in sequence but not required to home\n", MODULE_PREFIX, axisIdx);
+        else
+            _curCommand.setTestEndStop(axisIdx, homingOp._endStopIdx, 
+                        homingOp._endStopCheckActive ? AxisMinMaxBools::END_STOP_HIT : AxisMinMaxBools::END_STOP_NOT_HIT);
     }
-    // Check axis should be homed
-    if (setEndstopTest && (!_axesToHome.isValid(axisIdx)))
+    // Check for latching
+    if (homingOp._latchBackoffSteps > 0)
     {
-        Log.DBG_HOMING_LVL("%sAxis%d in sequence but not required to home\n", MODULE_PREFIX, axisIdx);
-        return;
+        _doLatch = true;
+        _latchBackoffSteps = homingOp._latchBackoffSteps;
     }
-    // Check endStop
-    if (setEndstopTest)
-        _curCommand.setTestEndStop(axisIdx, endStopIdx, checkActive ? AxisMinMaxBools::END_STOP_HIT : AxisMinMaxBools::END_STOP_NOT_HIT);
 }
 
 void MotionHoming::startCentringOperation()
@@ -287,6 +436,56 @@ bool MotionHoming::nextCentringOperation()
     return true;
 }
 
+void MotionHoming::startLatchOperation()
+{
+    // Fast seek to the endstop first
+    _latchInProgress = true;
+    _latchPhase = 0;
+    processHomingCommand(_curCommand);
+}
+
+bool MotionHoming::nextLatchOperation()
+{
+    Log.DBG_HOMING_LVL("%slatch phase %i\n", MODULE_PREFIX, _latchPhase);
+
+    // Seek has stopped at the endstop (without decelerating) so back-off and re-approach slowly
+    _latchPhase++;
+    if (_latchPhase == 1)
+    {
+        // Back-off away from the endstop with no endstop checks
+        _latchCommand = _curCommand;
+        for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
+        {
+            if (_curCommand.isValid(axisIdx))
+                _latchCommand.setAxisSteps(axisIdx, 
+                            (_curCommand.getPointSteps().getVal(axisIdx) < 0) ? _latchBackoffSteps : -_latchBackoffSteps,
+                            true);
+        }
+        _latchCommand.setTestNoEndStops();
+        processHomingCommand(_latchCommand);
+        return true;
+    }
+    else if (_latchPhase == 2)
+    {
+        // Re-approach slowly with the original endstop checks - no ramp so the step
+        // where the endstop triggers is at a constant (low) rate
+        _latchCommand = _curCommand;
+        for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
+        {
+            if (_curCommand.isValid(axisIdx))
+                _latchCommand.setAxisSteps(axisIdx, 
+                            (_curCommand.getPointSteps().getVal(axisIdx) < 0) ? -2 * _latchBackoffSteps : 2 * _latchBackoffSteps,
+                            true);
+        }
+        float latchFeedrate = _curCommand.getFeedrate() / latchFeedrateDivisor;
+        _latchCommand.setFeedrate(latchFeedrate < 1 ? 1 : latchFeedrate);
+        _latchCommand.clearStepAccel();
+        processHomingCommand(_latchCommand);
+        return true;
+    }
+    return false;
+}
+
 void MotionHoming::processHomingCommand(RobotCommandArgs& commandArgs)
 {
     // Allow out of bounds movement while homing
@@ -304,102 +503,60 @@ void MotionHoming::processHomingCommand(RobotCommandArgs& commandArgs)
 
 bool MotionHoming::extractAndExecNextCmd(AxesParams &axesParams, String& debugCmdStr)
 {
-    while (_homingStrPos < _homingSequence.length())
+    while (_homingOpIdx < _homingProgram.size())
     {
-        // Get axis
-        int ch = _homingSequence.charAt(_homingStrPos);
-        switch (ch)
+        HomingOp& homingOp = _homingProgram[_homingOpIdx++];
+        switch (homingOp._opType)
         {
-            case '$': // All done ok
+            case HomingOp::HOMING_OP_DONE:
             {
                 // Check if homing commands complete
                 Log.notice("%sHomed ok\n", MODULE_PREFIX);
                 _isHomedOk = true;
                 _homingInProgress = false;
                 _commandInProgress = false;
-                _homingStrPos++;
                 _curCommand.setHasHomed(true);
                 debugCmdStr = "Done";
                 return true;
             }
-            case '#': // Process command
+            case HomingOp::HOMING_OP_EXEC:
             {
                 // Handle the start of a centring operation
                 if (_doCentring)
                     startCentringOperation();
+                else if (_doLatch)
+                    startLatchOperation();
                 else
                     processHomingCommand(_curCommand);
-                _homingStrPos++;
                 _doCentring = false;
+                _doLatch = false;
                 return true;
             }
-            case 'A':
-            case 'a': // Actuators
-            case 'B':
-            case 'b':
-            case 'C':
-            case 'c':
+            case HomingOp::HOMING_OP_MOVE:
+            {
+                execMoveOp(homingOp, axesParams);
+                debugCmdStr = "Move";
+                break;
+            }
+            case HomingOp::HOMING_OP_SET_HOME:
             {
-                // We're homing
                 _curCommand.setIsHoming(true);
-                // Axis index
-                int axisIdx = 0;
-                if ((ch == 'B') || (ch == 'b'))
-                    axisIdx = 1;
-                else if ((ch == 'C') || (ch == 'c'))
-                    axisIdx = 2;
-                // All homing is relative
                 _curCommand.setMoveType(RobotMoveTypeArg_Relative);
-                // Get the instruction
-                _homingStrPos++;
-                // See if we have an numeric value next
-                int stepsToMove = AxisParams::stepsForAxisHoming_default;
-                if (getInteger(_homingStrPos, stepsToMove))
-                {
-                    // Set dist to move
-                    if (_axesToHome.isValid(axisIdx))
-                        _curCommand.setAxisSteps(axisIdx, stepsToMove, true);
-                    // Set feedrate to either max steps per second for this axis or a setting from the command string
-                    int feedrateStepsPerSec = getFeedrate(_homingStrPos, axesParams, axisIdx, 
-                                (_feedrateStepsPerSecForHoming == -1) ? axesParams.getMaxStepRatePerSec(axisIdx) : _feedrateStepsPerSecForHoming);
-                    _curCommand.setFeedrate(feedrateStepsPerSec);
-                    // Check for centring mode
-                    setCentring(_homingStrPos, axisIdx);
-                    // Set endstop tests
-                    setEndstops(_homingStrPos, axisIdx);
-                    debugCmdStr = "Move";
-                }
-                // Maybe this is saying the axis is now home
-                else if (_homingSequence[_homingStrPos] == '=')
-                {
-                    _homingStrPos++;
-                    if ((_homingSequence.charAt(_homingStrPos) == 'H') || (_homingSequence.charAt(_homingStrPos) == 'h'))
-                    {
-                        setAtHomePos(axisIdx);
-                        _homingStrPos++;
-                        Log.notice("%sSetting at home for axis %d\n", MODULE_PREFIX, axisIdx);
-                        debugCmdStr = "Home";
-                    }
-                    break;
-                }
+                setAtHomePos(homingOp._axisIdx);
+                Log.notice("%sSetting at home for axis %d\n", MODULE_PREFIX, homingOp._axisIdx);
+                debugCmdStr = "Home";
                 break;
             }
-            case 'F':
-            case 'f':
+            case HomingOp::HOMING_OP_FEEDRATE:
             {
-                // Feedrate for whole homing (unless specifically overridden)
-                _homingStrPos++;
-                int feedrateStepsPerSec = getFeedrate(_homingStrPos, axesParams, 0, axesParams.getMaxStepRatePerSec(0));
-                if (feedrateStepsPerSec > 0)
-                {
-                    Log.trace("%sFeedrate set to %d steps per sec\n", MODULE_PREFIX, feedrateStepsPerSec);
-                    _feedrateStepsPerSecForHoming = feedrateStepsPerSec;
-                }
+                _feedrateStepsPerSecForHoming = homingOp.getFeedrateStepsPerSec(axesParams, 0, axesParams.getMaxStepRatePerSec(0));
+                Log.trace("%sFeedrate set to %d steps per sec\n", MODULE_PREFIX, _feedrateStepsPerSecForHoming);
+                break;
             }
-            default:
+            case HomingOp::HOMING_OP_ACCEL:
             {
-                // Skip other chars (including ;)
-                _homingStrPos++;
+                _accelStepsPerSec2ForHoming = homingOp._accelStepsPerSec2;
+                Log.trace("%sAccel set to %d steps per sec^2\n", MODULE_PREFIX, _accelStepsPerSec2ForHoming);
                 break;
             }
         }
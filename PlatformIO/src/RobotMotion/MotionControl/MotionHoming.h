@@ -5,22 +5,38 @@
 
 #include "RobotCommandArgs.h"
 #include "../AxesParams.h"
+#include "HomingOp.h"
+#include <vector>
 
 class MotionHelper;
 
 #define DBG_HOMING_LVL notice
 
+// Homing sequence syntax (commands separated by ;) - compiled into HomingOps by configure()
+//   A/B/C<steps>   relative move of an axis in steps
+//     R<rpm> or S<stepsPerSec>   feedrate for this move
+//     Q            centre between the endstop edges
+//     N/n X/x      stop when min/max endstop is hit (upper case) or not hit (lower case)
+//     L<steps>     back-off by <steps> after the endstop is hit then re-approach slowly to latch
+//   A/B/C=h        set current position as home for axis
+//   F<...>         feedrate (as R/S above) for the rest of the sequence
+//   K<stepsPerSec2> acceleration for the rest of the sequence (0 = no ramp)
+//   #              execute the move
+//   $              homing complete
+
 class MotionHoming
 {
 private:
     static constexpr int maxHomingSecs_default = 1000;
     static constexpr int homing_baseCommandIndex = 10000;
+    static constexpr int latchFeedrateDivisor = 10;
 
     bool _isHomedOk;
     String _homingSequence;
+    std::vector<HomingOp> _homingProgram;
     bool _homingInProgress;
     RobotCommandArgs _axesToHome;
-    unsigned int _homingStrPos;
+    unsigned int _homingOpIdx;
     bool _commandInProgress;
     RobotCommandArgs _curCommand;
     int _maxHomingSecs;
@@ -28,6 +44,8 @@ private:
     MotionHelper *_pMotionHelper;
     int _homingCurCommandIndex;
     int _feedrateStepsPerSecForHoming;
+    int _accelStepsPerSec2Config;
+    int _accelStepsPerSec2ForHoming;
 
     // Homing diagnostics
     AxisInt32s _homingStartSteps;
@@ -40,6 +58,13 @@ private:
     AxisInt32s _centringSteps[NUM_CENTRING_PHASES];
     RobotCommandArgs _centringReversedCommand;
 
+    // Latching (seek, back-off, slow re-approach)
+    bool _doLatch;
+    bool _latchInProgress;
+    int _latchPhase;
+    int _latchBackoffSteps;
+    RobotCommandArgs _latchCommand;
+
 public:
     MotionHoming(MotionHelper *pMotionHelper);
     void configure(const char *configJSON);
@@ -48,17 +73,19 @@ public:
     void homingStart(RobotCommandArgs &args);
     void service(AxesParams &axesParams);
     bool extractAndExecNextCmd(AxesParams &axesParams, String& debugCmdStr);
+    static bool compileSequence(const String& homingSequence, std::vector<HomingOp>& homingProgram, String& errorMsg);
 
 private:
     void moveTo(RobotCommandArgs &args);
     int getLastCompletedNumberedCmdIdx();
     void setAtHomePos(int axisIdx);
-    bool getInteger(unsigned int &homingStrPos, int &retInt);
-    int getFeedrate(unsigned int &homingStrPos, AxesParams &axesParams, int axisIdx, int defaultValue);
-    void setEndstops(unsigned int &homingStrPos, int axisIdx);
-    void setCentring(unsigned int &homingStrPos, int axisIdx);
+    static bool getInteger(const String& homingSequence, unsigned int &homingStrPos, int &retInt);
+    static bool getFeedrate(const String& homingSequence, unsigned int &homingStrPos, HomingOp& homingOp);
+    void execMoveOp(HomingOp& homingOp, AxesParams &axesParams);
     void startCentringOperation();
     bool nextCentringOperation();
+    void startLatchOperation();
+    bool nextLatchOperation();
     void processHomingCommand(RobotCommandArgs& commandArgs);
     void debugShowSteps(const char* debugMsg);
 
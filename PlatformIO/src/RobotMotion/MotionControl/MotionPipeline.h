@@ -5,13 +5,19 @@
 
 #include "MotionRingBuffer.h"
 #include "MotionBlock.h"
+#include "MemRegions.h"
 #include <vector>
 
+// Pipeline of motion blocks - the planner's records and the execution records used by the
+// step generator are held in parallel arrays (same index for the same block)
+// The planner's records are placed by MemRegions (they can be in PSRAM) but the execution
+// records are used in the step ISR so must stay in internal RAM
 class MotionPipeline
 {
   private:
     MotionRingBufferPosn _pipelinePosn;
-    std::vector<MotionBlock> _pipeline;
+    std::vector<MotionBlock, MemRegionAllocator<MotionBlock, MemRegions::SUBSYS_MOTION_PIPELINE>> _pipeline;
+    std::vector<MotionBlockExec> _execPipeline;
 
   public:
     MotionPipeline() : _pipelinePosn(0)
@@ -21,6 +27,7 @@ class MotionPipeline
     void init(int pipelineSize)
     {
         _pipeline.resize(pipelineSize);
+        _execPipeline.resize(pipelineSize);
         _pipelinePosn.init(pipelineSize);
     }
 
@@ -35,6 +42,11 @@ class MotionPipeline
         return _pipelinePosn.count();
     }
 
+    unsigned int size()
+    {
+        return _pipeline.size();
+    }
+
     // Check if ready to accept data
     bool canAccept()
     {
@@ -42,7 +54,7 @@ class MotionPipeline
     }
 
     // Add to pipeline
-    bool add(MotionBlock &block)
+    bool add(MotionBlock &block, MotionBlockExec &exec)
     {
         // Check if full
         if (!_pipelinePosn.canPut())
@@ -50,6 +62,7 @@ class MotionPipeline
 
         // Add the item
         _pipeline[_pipelinePosn._putPos] = block;
+        _execPipeline[_pipelinePosn._putPos] = exec;
         _pipelinePosn.hasPut();
         return true;
     }
@@ -61,7 +74,7 @@ class MotionPipeline
     }
 
     // Get from queue
-    bool IRAM_ATTR get(MotionBlock &block)
+    bool get(MotionBlock &block, MotionBlockExec &exec)
     {
         // Check if queue is empty
         if (!_pipelinePosn.canGet())
@@ -69,6 +82,7 @@ class MotionPipeline
 
         // read the item and remove
         block = _pipeline[_pipelinePosn._getPos];
+        exec = _execPipeline[_pipelinePosn._getPos];
         _pipelinePosn.hasGot();
         return true;
     }
@@ -85,14 +99,14 @@ class MotionPipeline
         return true;
     }
 
-    // Peek the block which would be got (if there is one)
-    MotionBlock* IRAM_ATTR peekGet()
+    // Peek the execution record of the block which would be got (if there is one)
+    MotionBlockExec* IRAM_ATTR peekGet()
     {
         // Check if queue is empty
         if (!_pipelinePosn.canGet())
             return NULL;
         // get pointer to the last item (don't remove)
-        return &(_pipeline[_pipelinePosn._getPos]);
+        return &(_execPipeline[_pipelinePosn._getPos]);
     }
 
     // Peek from the put position
@@ -121,6 +135,22 @@ class MotionPipeline
         return &(_pipeline[nthPos]);
     }
 
+    // Peek execution records (indexed as above)
+    MotionBlockExec *peekExecNthFromPut(unsigned int N)
+    {
+        int nthPos = _pipelinePosn.getNthFromPut(N);
+        if (nthPos < 0)
+            return NULL;
+        return &(_execPipeline[nthPos]);
+    }
+    MotionBlockExec *peekExecNthFromGet(unsigned int N)
+    {
+        int nthPos = _pipelinePosn.getNthFromGet(N);
+        if (nthPos < 0)
+            return NULL;
+        return &(_execPipeline[nthPos]);
+    }
+
     // Debug
     void debugShowBlocks(AxesParams &axesParams)
     {
@@ -129,14 +159,15 @@ class MotionPipeline
         for (int i = count() - 1; i >= 0; i--)
         {
             MotionBlock *pBlock = peekNthFromPut(i);
-            if (pBlock)
+            MotionBlockExec *pExec = peekExecNthFromPut(i);
+            if (pBlock && pExec)
             {
                 if (!headShown)
                 {
                     pBlock->debugShowBlkHead();
                     headShown = true;
                 }
-                pBlock->debugShowBlock(elIdx++, axesParams);
+                pBlock->debugShowBlock(elIdx++, *pExec, axesParams);
             }
         }
     }
@@ -148,7 +179,8 @@ class MotionPipeline
         if (cnt == 0)
             return;
         MotionBlock *pBlock = peekNthFromPut(cnt-1);
-        if (pBlock)
-            pBlock->debugShowBlock(0, axesParams);
+        MotionBlockExec *pExec = peekExecNthFromPut(cnt-1);
+        if (pBlock && pExec)
+            pBlock->debugShowBlock(0, *pExec, axesParams);
     }
 };
@@ -2,10 +2,107 @@
 // Rob Dobson 2016-18
 
 #include "MotionPlanner.h"
+#include "../../CommandPathTiming.h"
 
-void MotionPlanner::configure(float junctionDeviation)
+void MotionPlanner::configure(float junctionDeviation, PlannerMode plannerMode)
 {
     _junctionDeviation = junctionDeviation;
+    _plannerMode = plannerMode;
+}
+
+float MotionPlanner::calcBlockTimeSecs(MotionBlock &block, AxesParams &axesParams)
+{
+    // Trapezoid (or triangle) from entry speed up towards the feedrate and down to exit speed
+    float acc = getBlockAccMMps2(block, axesParams);
+    float dist = block._moveDistPrimaryAxesMM;
+    float vEntry = block._entrySpeedMMps;
+    float vExit = block._exitSpeedMMps;
+    if (acc <= 0 || dist <= 0)
+        return 0;
+    float vPeak = sqrtf((2.0F * acc * dist + vEntry * vEntry + vExit * vExit) / 2.0F);
+    if (vPeak > block._feedrate)
+        vPeak = fmaxf(block._feedrate, fmaxf(vEntry, vExit));
+    float distAcc = (vPeak * vPeak - vEntry * vEntry) / 2.0F / acc;
+    float distDec = (vPeak * vPeak - vExit * vExit) / 2.0F / acc;
+    float distCruise = fmaxf(dist - distAcc - distDec, 0);
+    float timeSecs = (vPeak - vEntry) / acc + (vPeak - vExit) / acc;
+    if (vPeak > 0)
+        timeSecs += distCruise / vPeak;
+    return timeSecs;
+}
+
+// Limit the block's feedrate and acceleration by each primary axis's limits projected along the unit vector
+// (as GRBL's limit_value_by_axis_maximum) so that a move dominated by a slow axis is limited by that axis
+// while other moves can use the full capability of their axes
+void MotionPlanner::applyAxisLimits(MotionBlock &block, AxisFloats &unitVectors, AxesParams &axesParams)
+{
+    float accMMps2 = 1e8;
+    for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
+    {
+        if (!axesParams.isPrimaryAxis(axisIdx))
+            continue;
+        float unitVecAbs = fabsf(unitVectors._pt[axisIdx]);
+        if (unitVecAbs < 1e-6f)
+            continue;
+        block._feedrate = fminf(block._feedrate, axesParams.getMaxSpeed(axisIdx) / unitVecAbs);
+        accMMps2 = fminf(accMMps2, axesParams.getMaxAccel(axisIdx) / unitVecAbs);
+    }
+    block._accMMps2 = (accMMps2 < 1e8) ? accMMps2 : axesParams._masterAxisMaxAccMMps2;
+}
+
+// Maximum speed at the junction between the previous block and this one
+float MotionPlanner::calcJunctionSpeed(MotionBlock &block, AxisFloats &unitVectors, AxesParams &axesParams)
+{
+    float vmaxJunction = _minimumPlannerSpeedMMps;
+    float prevParamSpeed = _prevMotionBlock._maxParamSpeedMMps;
+    if (_junctionDeviation <= 0.0f || prevParamSpeed <= 0.0f)
+        return vmaxJunction;
+
+    // Compute cosine of angle between previous and current path. (prev_unit_vec is negative)
+    // NOTE: Max junction velocity is computed without sin() or acos() by trig half angle identity.
+    float cosTheta = 0;
+    for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
+        cosTheta -= _prevMotionBlock._unitVectors._pt[axisIdx] * unitVectors._pt[axisIdx];
+
+    if (_plannerMode == PLANNER_MODE_CURVATURE_LIMITED)
+    {
+        // Full reversal - must stop
+        if (cosTheta > 0.999999F)
+            return vmaxJunction;
+        vmaxJunction = fminf(prevParamSpeed, block._feedrate);
+        // Straight through - limited by nominal speeds only
+        if (cosTheta < -0.999999F)
+            return vmaxJunction;
+
+        // Junction deviation limit using the lower of the two blocks' accelerations
+        float accMMps2 = fminf(getBlockAccMMps2(block, axesParams), _prevMotionBlock._accMMps2);
+        float sinThetaD2 = sqrtf(0.5F * (1.0F - cosTheta));
+        float vSqJnDev = accMMps2 * _junctionDeviation * sinThetaD2 / (1.0F - sinThetaD2);
+
+        // Curvature limit - treat the segment as a chord of an arc turned through the deviation angle
+        // (angle between the direction vectors) so that closely spaced points on a curve are limited by
+        // the curve's radius rather than by the junction deviation alone
+        float deviationAngle = (float)M_PI - acosf(fmaxf(-1.0F, fminf(1.0F, cosTheta)));
+        float vSqCurve = accMMps2 * block._moveDistPrimaryAxesMM / deviationAngle;
+        return fmaxf(_minimumPlannerSpeedMMps, fminf(vmaxJunction, sqrtf(fminf(vSqJnDev, vSqCurve))));
+    }
+
+    // Skip and use default max junction speed for 0 degree acute junction.
+    if (cosTheta < 0.95F)
+    {
+        vmaxJunction = fminf(prevParamSpeed, block._feedrate);
+        // Skip and avoid divide by zero for straight junctions at 180 degrees. Limit to min() of nominal speeds.
+        if (cosTheta > -0.95F)
+        {
+            // Compute maximum junction velocity based on maximum acceleration and junction deviation
+            // Trig half angle identity, always positive
+            float accMMps2 = fminf(getBlockAccMMps2(block, axesParams), _prevMotionBlock._accMMps2);
+            float sinThetaD2 = sqrtf(0.5F * (1.0F - cosTheta));
+            vmaxJunction = fminf(vmaxJunction,
+                                    sqrtf(accMMps2 * _junctionDeviation * sinThetaD2 / (1.0F - sinThetaD2)));
+        }
+    }
+    return vmaxJunction;
 }
 
 // Entry point for adding a motion block
@@ -14,14 +111,6 @@ bool MotionPlanner::moveTo(RobotCommandArgs &args,
             AxisPosition &curAxisPositions,
             AxesParams &axesParams, MotionPipeline &motionPipeline)
 {
-    // Find first primary axis
-    int firstPrimaryAxis = -1;
-    for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
-        if (axesParams.isPrimaryAxis(axisIdx))
-            firstPrimaryAxis = axisIdx;
-    if (firstPrimaryAxis == -1)
-        firstPrimaryAxis = 0;
-
     // Find axis deltas and sum of squares of motion on primary axes
     float deltas[RobotConsts::MAX_AXES];
     bool isAMove = false;
@@ -53,25 +142,22 @@ bool MotionPlanner::moveTo(RobotCommandArgs &args,
 
     // Create a block for this movement which will end up on the pipeline
     MotionBlock block;
+    MotionBlockExec blockExec;
 
     // Set flag to indicate if more moves coming
     block._blockIsFollowed = args.getMoreMovesComing();
 
     // set end-stop check requirements
-    block.setEndStopsToCheck(args.getEndstopCheck());
+    blockExec.setEndStopsToCheck(args.getEndstopCheck());
 
     // Set numbered command index if present
-    block.setNumberedCommandIndex(args.getNumberedCommandIndex());
+    blockExec.setNumberedCommandIndex(args.getNumberedCommandIndex());
 
     // Max speed (may be overridden downwards by feedrate)
     float validFeedrateMMps = 1e8;
     if (args.isFeedrateValid())
         validFeedrateMMps = args.getFeedrate();
 
-    // Check the feedrate against the first primary axis
-    if (validFeedrateMMps > axesParams.getMaxSpeed(firstPrimaryAxis))
-        validFeedrateMMps = axesParams.getMaxSpeed(firstPrimaryAxis);
-
     // Find the unit vectors for the primary axes and check the feedrate
     AxisFloats unitVectors;
     for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
@@ -97,14 +183,14 @@ bool MotionPlanner::moveTo(RobotCommandArgs &args,
         if (steps != 0)
             hasSteps = true;
         // Value (and direction)
-        block.setStepsToTarget(axisIdx, steps);
+        blockExec.setStepsToTarget(axisIdx, steps);
     }
 
 #ifdef DEBUG_MOTIONPLANNER_DETAILED_INFO
     Log.notice("F %F D %F uX %F uY %F, uZ %F maxStAx %d maxDAx %d %s\n", validFeedrateMMps,
             moveDist, 
             unitVectors.getVal(0), unitVectors.getVal(1), unitVectors.getVal(2), 
-            block._axisIdxWithMaxSteps, axisWithMaxMoveDist,
+            blockExec._axisIdxWithMaxSteps, axisWithMaxMoveDist,
             hasSteps ? "has steps" : "NO STEPS");
 #endif
 
@@ -115,54 +201,31 @@ bool MotionPlanner::moveTo(RobotCommandArgs &args,
     // Set the dist moved on the axis with max steps
     block._unitVecAxisWithMaxDist = unitVectors.getVal(axisWithMaxMoveDist);
 
-    // If there is a prior block then compute the maximum speed at exit of the second block to keep
-    // the junction deviation within bounds - there are more comments in the Smoothieware (and GRBL) code
-    float junctionDeviation = _junctionDeviation;
-    float vmaxJunction = _minimumPlannerSpeedMMps;
+    // Limit feedrate and acceleration using each axis's limits along the direction of travel
+    applyAxisLimits(block, unitVectors, axesParams);
 
     // Invalidate the data stored for the prev element if the pipeline becomes empty
     if (!motionPipeline.canGet())
         _prevMotionBlockValid = false;
 
-    // Calculate the maximum speed for the junction between two blocks
+    // If there is a prior block then compute the maximum speed at exit of the second block to keep
+    // the junction deviation within bounds - there are more comments in the Smoothieware (and GRBL) code
+    float vmaxJunction = _minimumPlannerSpeedMMps;
     if (isAPrimaryMove && _prevMotionBlockValid)
-    {
-        float prevParamSpeed = isAPrimaryMove ? _prevMotionBlock._maxParamSpeedMMps : 0;
-        if (junctionDeviation > 0.0f && prevParamSpeed > 0.0f)
-        {
-            // Compute cosine of angle between previous and current path. (prev_unit_vec is negative)
-            // NOTE: Max junction velocity is computed without sin() or acos() by trig half angle identity.
-            float cosTheta = -_prevMotionBlock._unitVectors.X() * unitVectors.X() - _prevMotionBlock._unitVectors.Y() * unitVectors.Y() - _prevMotionBlock._unitVectors.Z() * unitVectors.Z();
-
-            // Skip and use default max junction speed for 0 degree acute junction.
-            if (cosTheta < 0.95F)
-            {
-                vmaxJunction = fminf(prevParamSpeed, block._feedrate);
-                // Skip and avoid divide by zero for straight junctions at 180 degrees. Limit to min() of nominal speeds.
-                if (cosTheta > -0.95F)
-                {
-                    // Compute maximum junction velocity based on maximum acceleration and junction deviation
-                    // Trig half angle identity, always positive
-                    float sinThetaD2 = sqrtf(0.5F * (1.0F - cosTheta));
-                    vmaxJunction = fminf(vmaxJunction,
-                                            sqrtf(axesParams._masterAxisMaxAccMMps2 * junctionDeviation * sinThetaD2 /
-                                                (1.0F - sinThetaD2)));
-                }
-            }
-        }
-    }
+        vmaxJunction = calcJunctionSpeed(block, unitVectors, axesParams);
     block._maxEntrySpeedMMps = vmaxJunction;
 
 #ifdef DEBUG_MOTIONPLANNER_DETAILED_INFO
     Log.notice("PrevMoveInQueue %d, JunctionDeviation %F, VmaxJunction %F\n",
-                motionPipeline.canGet(), junctionDeviation, vmaxJunction);
+                motionPipeline.canGet(), _junctionDeviation, vmaxJunction);
 #endif
 
     // Add the element to the pipeline and remember previous element
-    motionPipeline.add(block);
+    motionPipeline.add(block, blockExec);
     MotionBlockSequentialData prevBlockInfo;
     prevBlockInfo._maxParamSpeedMMps = block._feedrate;
     prevBlockInfo._unitVectors = unitVectors;
+    prevBlockInfo._accMMps2 = getBlockAccMMps2(block, axesParams);
     _prevMotionBlock = prevBlockInfo;
     _prevMotionBlockValid = true;
 
@@ -172,7 +235,7 @@ bool MotionPlanner::moveTo(RobotCommandArgs &args,
     // Return the change in actuator position
     for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
         curAxisPositions._stepsFromHome.setVal(axisIdx,
-                    curAxisPositions._stepsFromHome.getVal(axisIdx) + block.getStepsToTarget(axisIdx));
+                    curAxisPositions._stepsFromHome.getVal(axisIdx) + blockExec.getStepsToTarget(axisIdx));
 
     return true;
 }
@@ -222,11 +285,18 @@ void MotionPlanner::recalculatePipeline(MotionPipeline &motionPipeline, AxesPara
     {
         // Get the block at current index
         pBlock = motionPipeline.peekNthFromPut(blockIdx);
-        if (pBlock == NULL)
+        MotionBlockExec *pExec = motionPipeline.peekExecNthFromPut(blockIdx);
+        if ((pBlock == NULL) || (pExec == NULL))
+        {
+            // Reached the oldest block without finding one executing - the block before it has already
+            // finished at this block's entry speed so that can't change (it is zero if the pipeline was empty)
+            if (pFollowingBlock)
+                previousBlockExitSpeed = pFollowingBlock->_entrySpeedMMps;
             break;
+        }
 
         // Stop if we don't need to recalculate beyond here or if this block is already executing
-        if (pBlock->_isExecuting)
+        if (pExec->_isExecuting)
         {
             // Get the exit speed from this executing block to use as the entry speed when going forwards
             previousBlockExitSpeed = pBlock->_exitSpeedMMps;
@@ -235,7 +305,7 @@ void MotionPlanner::recalculatePipeline(MotionPipeline &motionPipeline, AxesPara
 
         // If entry speed is already at the maximum entry speed then we can stop here as no further changes are
         // going to be made by going back further
-        if (pBlock->_entrySpeedMMps == pBlock->_maxEntrySpeedMMps && blockIdx > 1)
+        if ((pBlock->_entrySpeedMMps == pBlock->_maxEntrySpeedMMps) && (blockIdx > 1))
         {
 #ifdef DEBUG_MOTIONPLANNER_DETAILED_INFO
             Log.notice("++++++++++++++++++++++++++++++ Optimizing block %d, prevSpeed %F\n", blockIdx, pBlock->_exitSpeedMMps);
@@ -250,7 +320,7 @@ void MotionPlanner::recalculatePipeline(MotionPipeline &motionPipeline, AxesPara
         {
             // Assume for now that that whole block will be deceleration and calculate the max speed we can enter to be able to slow
             // to the exit speed required
-            float maxEntrySpeed = MotionBlock::maxAchievableSpeed(axesParams._masterAxisMaxAccMMps2,
+            float maxEntrySpeed = MotionBlock::maxAchievableSpeed(getBlockAccMMps2(*pFollowingBlock, axesParams),
                                                                     pFollowingBlock->_exitSpeedMMps, pFollowingBlock->_moveDistPrimaryAxesMM);
             pFollowingBlock->_entrySpeedMMps = fminf(maxEntrySpeed, pFollowingBlock->_maxEntrySpeedMMps);
 
@@ -284,7 +354,7 @@ void MotionPlanner::recalculatePipeline(MotionPipeline &motionPipeline, AxesPara
         pBlock->_entrySpeedMMps = previousBlockExitSpeed;
 
         // Calculate maximum speed possible for the block - based on acceleration at the best rate
-        float maxExitSpeed = pBlock->maxAchievableSpeed(axesParams._masterAxisMaxAccMMps2,
+        float maxExitSpeed = pBlock->maxAchievableSpeed(getBlockAccMMps2(*pBlock, axesParams),
                                                         pBlock->_entrySpeedMMps, pBlock->_moveDistPrimaryAxesMM);
         pBlock->_exitSpeedMMps = fminf(maxExitSpeed, pBlock->_exitSpeedMMps);
 
@@ -297,11 +367,17 @@ void MotionPlanner::recalculatePipeline(MotionPipeline &motionPipeline, AxesPara
     {
         // Get the block to calculate for
         pBlock = motionPipeline.peekNthFromPut(blockIdx);
-        if (!pBlock)
+        MotionBlockExec *pExec = motionPipeline.peekExecNthFromPut(blockIdx);
+        if (!pBlock || !pExec)
             break;
 
         // Prepare this block for stepping
-        if (pBlock->prepareForStepping(axesParams, false))
+        bool preparedOk = false;
+        {
+            INSTRUMENT_COMMAND_PATH_SCOPE(STAGE_PREPARE)
+            preparedOk = pBlock->prepareForStepping(*pExec, axesParams, false);
+        }
+        if (preparedOk)
         {
             // Check if the block is part of a split block and has at least one more block following it
             // in which case wait until at least two blocks are in the pipeline before locking down the
@@ -309,7 +385,7 @@ void MotionPlanner::recalculatePipeline(MotionPipeline &motionPipeline, AxesPara
             if ((!pBlock->_blockIsFollowed) || (motionPipeline.count() > 1))
             {
                 // No more changes
-                pBlock->_canExecute = true;
+                pExec->_canExecute = true;
             }
         }
     }
@@ -329,6 +405,7 @@ bool MotionPlanner::moveToStepwise(RobotCommandArgs &args,
 {
     // Create a block for this movement which will end up on the pipeline
     MotionBlock block;
+    MotionBlockExec blockExec;
     block._entrySpeedMMps = 0;
     block._exitSpeedMMps = 0;
 
@@ -355,7 +432,7 @@ bool MotionPlanner::moveToStepwise(RobotCommandArgs &args,
                 minFeedrateStepsPerSec = axesParams.getMaxStepRatePerSec(axisIdx);
         }
         // Value (and direction)
-        block.setStepsToTarget(axisIdx, steps);
+        blockExec.setStepsToTarget(axisIdx, steps);
     }
 
     // Check there are some actual steps
@@ -366,31 +443,32 @@ bool MotionPlanner::moveToStepwise(RobotCommandArgs &args,
     block._unitVecAxisWithMaxDist = 1.0;
 
     // set end-stop check requirements
-    block.setEndStopsToCheck(args.getEndstopCheck());
+    blockExec.setEndStopsToCheck(args.getEndstopCheck());
 
     // Set numbered command index if present
-    block.setNumberedCommandIndex(args.getNumberedCommandIndex());
+    blockExec.setNumberedCommandIndex(args.getNumberedCommandIndex());
 
     // feedrate override?
     if (args.isFeedrateValid())
         minFeedrateStepsPerSec = args.getFeedrate();
     block._feedrate = minFeedrateStepsPerSec;
 
-    // Prepare for stepping
-    if (block.prepareForStepping(axesParams, true))
+    // Prepare for stepping (with acceleration if specified)
+    float stepAccel = args.isStepAccelValid() ? args.getStepAccel() : 0;
+    if (block.prepareForStepping(blockExec, axesParams, true, stepAccel))
     {
         // No more changes
-        block._canExecute = true;
+        blockExec._canExecute = true;
     }
 
     // Add the block
-    motionPipeline.add(block);
+    motionPipeline.add(block, blockExec);
     _prevMotionBlockValid = true;
 
     // Return the change in actuator position
     for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
         curAxisPositions._stepsFromHome.setVal(axisIdx,
-            curAxisPositions._stepsFromHome.getVal(axisIdx) + block.getStepsToTarget(axisIdx));
+            curAxisPositions._stepsFromHome.getVal(axisIdx) + blockExec.getStepsToTarget(axisIdx));
 
 #ifdef DEBUG_MOTIONPLANNER_INFO
     Log.notice("^^^^^^^^^^^^^^^^^^^^^^^STEPWISE^^^^^^^^^^^^^^^^^^^^^^^^\n");
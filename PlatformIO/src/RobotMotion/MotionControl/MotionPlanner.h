@@ -21,7 +21,23 @@ typedef void (*setRobotAttributesFnType)(AxesParams& axesParams, String& robotAt
 
 class MotionPlanner
 {
+  public:
+    // Planner modes (both limit each block by the per-axis velocity and acceleration along its unit vector)
+    // JUNCTION_DEVIATION - GRBL/Smoothieware style with stops at acute corners and no limit on nearly
+    //                      straight junctions
+    // CURVATURE_LIMITED  - junction deviation at every angle and also a limit on the centripetal
+    //                      acceleration around curves made of short segments (radius from the segment
+    //                      length and turn angle) - never faster than JUNCTION_DEVIATION but the
+    //                      acceleration on dense curves (e.g. THR spirals) stays within the limit
+    enum PlannerMode
+    {
+        PLANNER_MODE_JUNCTION_DEVIATION,
+        PLANNER_MODE_CURVATURE_LIMITED
+    };
+
   private:
+    // Planner mode
+    PlannerMode _plannerMode;
     // Minimum planner speed mm/s
     float _minimumPlannerSpeedMMps;
     // Junction deviation
@@ -32,6 +48,7 @@ class MotionPlanner
     {
         AxisFloats _unitVectors;
         float _maxParamSpeedMMps;
+        float _accMMps2;
     };
     // Data on previously processed block
     bool _prevMotionBlockValid;
@@ -44,9 +61,41 @@ class MotionPlanner
         _minimumPlannerSpeedMMps = 0;
         // Configure the motion pipeline - these values will be changed in config
         _junctionDeviation = 0;
+        _plannerMode = PLANNER_MODE_JUNCTION_DEVIATION;
+    }
+
+    void configure(float junctionDeviation, PlannerMode plannerMode = PLANNER_MODE_JUNCTION_DEVIATION);
+
+    PlannerMode getPlannerMode()
+    {
+        return _plannerMode;
+    }
+
+    float getJunctionDeviation()
+    {
+        return _junctionDeviation;
+    }
+
+    static PlannerMode getPlannerModeFromStr(const String& modeStr)
+    {
+        if (modeStr.equalsIgnoreCase("curvatureLimited"))
+            return PLANNER_MODE_CURVATURE_LIMITED;
+        return PLANNER_MODE_JUNCTION_DEVIATION;
+    }
+
+    static const char* getPlannerModeStr(PlannerMode plannerMode)
+    {
+        return plannerMode == PLANNER_MODE_CURVATURE_LIMITED ? "curvatureLimited" : "junctionDeviation";
+    }
+
+    // Acceleration the planner uses for a block (stepwise blocks don't have one set)
+    static float getBlockAccMMps2(MotionBlock &block, AxesParams &axesParams)
+    {
+        return (block._accMMps2 > 0) ? block._accMMps2 : axesParams._masterAxisMaxAccMMps2;
     }
 
-    void configure(float junctionDeviation);
+    // Time to execute a planned block (trapezoidal profile between entry and exit speeds)
+    static float calcBlockTimeSecs(MotionBlock &block, AxesParams &axesParams);
 
     // Entry point for adding a motion block
     bool moveTo(RobotCommandArgs &args,
@@ -58,6 +107,12 @@ class MotionPlanner
 
     void recalculatePipeline(MotionPipeline &motionPipeline, AxesParams &axesParams);
 
+  private:
+    float calcJunctionSpeed(MotionBlock &block, AxisFloats &unitVectors, AxesParams &axesParams);
+    void applyAxisLimits(MotionBlock &block, AxisFloats &unitVectors, AxesParams &axesParams);
+
+  public:
+
     // Entry point for adding a motion block
     bool moveToStepwise(RobotCommandArgs &args,
                         AxisPosition &curAxisPositions,
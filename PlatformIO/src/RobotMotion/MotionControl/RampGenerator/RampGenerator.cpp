@@ -4,12 +4,18 @@
 #include "RampGenerator.h"
 #include "MotionInstrumentation.h"
 #include "../MotionPipeline.h"
+#ifdef ESP32
+#include <soc/gpio_struct.h>
+#endif
 
 //#define USE_FAST_PIN_ACCESS 1
 
 // Instrumentation of motion actuator
 INSTRUMENT_MOTION_ACTUATOR_INSTANCE
 
+// Definition needed as std::max takes the constant by reference (unoptimised/sanitizer builds)
+constexpr uint32_t RampGenerator::MIN_STEP_RATE_PER_TTICKS;
+
 //#define DEBUG_MONITOR_ISR_OPERATION 1
 
 // #ifdef USE_ESP32_TIMER_ISR
@@ -32,8 +38,6 @@ INSTRUMENT_MOTION_ACTUATOR_INSTANCE
 // uint32_t RampGenerator::_curAccumulatorStep = 0;
 // uint32_t RampGenerator::_curAccumulatorNS = 0;
 // uint32_t RampGenerator::_curAccumulatorRelative[RobotConsts::MAX_AXES];
-// int RampGenerator::_endStopCheckNum;
-// RampGenerator::EndStopChecks RampGenerator::_endStopChecks[RobotConsts::MAX_AXES];
 // bool RampGenerator::_isrTimerStarted = false;
 // RampGenIO* RampGenerator::_pMotionIO = NULL;
 // bool RampGenerator::_rampGenEnabled = false;
@@ -54,7 +58,9 @@ RampGenerator::RampGenerator(MotionPipeline* pMotionPipeline)
     _curStepRatePerTTicks = 0;
     _curAccumulatorStep = 0;
     _curAccumulatorNS = 0;
-    _endStopCheckNum = 0;
+    _endStopChecksActive = false;
+    _endStopMaskLo = _endStopMaskHi = 0;
+    _endStopHitValLo = _endStopHitValHi = 0;
     _isrTimerStarted = false;
     _rampGenEnabled = false;
 
@@ -185,10 +191,12 @@ bool IRAM_ATTR RampGenerator::handleStepEnd()
 
 // Setup new block - cache all the info needed to process the block and reset
 // motion accumulators to facilitate the block's execution
-void IRAM_ATTR RampGenerator::setupNewBlock(MotionBlock *pBlock)
+void IRAM_ATTR RampGenerator::setupNewBlock(MotionBlockExec *pBlock)
 {
     // Setup step counts, direction and endstops for each axis
-    _endStopCheckNum = 0;
+    _endStopChecksActive = false;
+    _endStopMaskLo = _endStopMaskHi = 0;
+    _endStopHitValLo = _endStopHitValHi = 0;
     for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
     {
         // Total steps
@@ -235,15 +243,12 @@ void IRAM_ATTR RampGenerator::setupNewBlock(MotionBlock *pBlock)
                                 _rawMotionHwInfo._axis[axisIdx]._pinEndStopMax;
 
             // Endstop test
-            valToTestFor = (minMaxType != AxisMinMaxBools::END_STOP_NOT_HIT) ? 
-                                _rawMotionHwInfo._axis[axisIdx]._pinEndStopMaxactLvl :
-                                !_rawMotionHwInfo._axis[axisIdx]._pinEndStopMaxactLvl;
+            bool actLvl = (minMaxIdx == AxisMinMaxBools::MIN_VAL_IDX) ?
+                                _rawMotionHwInfo._axis[axisIdx]._pinEndStopMinactLvl :
+                                _rawMotionHwInfo._axis[axisIdx]._pinEndStopMaxactLvl;
+            valToTestFor = (minMaxType != AxisMinMaxBools::END_STOP_NOT_HIT) ? actLvl : !actLvl;
             if (pinToTest != -1)
-            {
-                _endStopChecks[_endStopCheckNum].pin = pinToTest;
-                _endStopChecks[_endStopCheckNum].val = valToTestFor;
-                _endStopCheckNum++;
-            }
+                addEndStopCheck(pinToTest, valToTestFor);
         }
     }
 
@@ -255,8 +260,54 @@ void IRAM_ATTR RampGenerator::setupNewBlock(MotionBlock *pBlock)
     _curStepRatePerTTicks = pBlock->_initialStepRatePerTTicks;
 }
 
+// Add a pin to the end-stop masks - hitVal is the level which means the end-stop condition is met
+void IRAM_ATTR RampGenerator::addEndStopCheck(int pin, bool hitVal)
+{
+    if ((pin < 0) || (pin >= 40))
+        return;
+    if (pin < 32)
+    {
+        _endStopMaskLo |= (1UL << pin);
+        if (hitVal)
+            _endStopHitValLo |= (1UL << pin);
+    }
+    else
+    {
+        _endStopMaskHi |= (1UL << (pin - 32));
+        if (hitVal)
+            _endStopHitValHi |= (1UL << (pin - 32));
+    }
+    _endStopChecksActive = true;
+}
+
+// Check all end-stops for the current block using one read of each GPIO input register
+bool IRAM_ATTR RampGenerator::isAnyEndStopHit()
+{
+#ifdef ESP32
+    uint32_t inLo = GPIO.in;
+    uint32_t inHi = GPIO.in1.val;
+#else
+    uint32_t inLo = 0;
+    uint32_t inHi = 0;
+    for (int pin = 0; pin < 40; pin++)
+    {
+        uint32_t mask = (pin < 32) ? _endStopMaskLo : _endStopMaskHi;
+        if ((mask & (1UL << (pin % 32))) && digitalRead(pin))
+        {
+            if (pin < 32)
+                inLo |= (1UL << pin);
+            else
+                inHi |= (1UL << (pin - 32));
+        }
+    }
+#endif
+    // A bit is set in the result where an input matches the level being tested for
+    return ((~(inLo ^ _endStopHitValLo) & _endStopMaskLo) != 0) ||
+           ((~(inHi ^ _endStopHitValHi) & _endStopMaskHi) != 0);
+}
+
 // Update millisecond accumulator to handle acceleration and deceleration
-void IRAM_ATTR RampGenerator::updateMSAccumulator(MotionBlock *pBlock)
+void IRAM_ATTR RampGenerator::updateMSAccumulator(MotionBlockExec *pBlock)
 {
     // Bump the millisec accumulator
     _curAccumulatorNS += MotionBlock::TICK_INTERVAL_NS;
@@ -283,7 +334,7 @@ void IRAM_ATTR RampGenerator::updateMSAccumulator(MotionBlock *pBlock)
 }
 
 // Handle start of step on each axis
-bool IRAM_ATTR RampGenerator::handleStepMotion(MotionBlock *pBlock)
+bool IRAM_ATTR RampGenerator::handleStepMotion(MotionBlockExec *pBlock)
 {
     // Complete Flag
     bool anyAxisMoving = false;
@@ -336,7 +387,7 @@ bool IRAM_ATTR RampGenerator::handleStepMotion(MotionBlock *pBlock)
     return anyAxisMoving;
 }
 
-void IRAM_ATTR RampGenerator::endMotion(MotionBlock *pBlock)
+void IRAM_ATTR RampGenerator::endMotion(MotionBlockExec *pBlock)
 {
     _pMotionPipeline->remove();
     // Check if this is a numbered block - if so record its completion
@@ -377,7 +428,7 @@ void IRAM_ATTR RampGenerator::isrStepperMotion()
         return;
 
     // Peek a MotionPipelineElem from the queue
-    MotionBlock *pBlock = _pMotionPipeline->peekGet();
+    MotionBlockExec *pBlock = _pMotionPipeline->peekGet();
     if (!pBlock)
         return;
 
@@ -401,21 +452,13 @@ void IRAM_ATTR RampGenerator::isrStepperMotion()
         return;
     }
 
-    // Check endstops        
-    bool endStopHit = false;
-    for (int i = 0; i < _endStopCheckNum; i++)
-    {
-        bool pinVal = digitalRead(_endStopChecks[i].pin);
-        if (pinVal == _endStopChecks[i].val)
-            endStopHit = true;
-    }
-
-    // Handle end-stop hit
-    if (endStopHit)
+    // Check endstops
+    if (_endStopChecksActive && isAnyEndStopHit())
     {
         // Cancel motion (by removing the block) as end-stop reached
         _endStopReached = true;
         endMotion(pBlock);
+        return;
     }
 
     // Update the millisec accumulator - this handles the process of changing speed incrementally to
@@ -466,9 +509,9 @@ void RampGenerator::process()
     // If using a controller with a ramp generator then service the block handling
     if (_rampGenEnabled)
     {
-        // If not using ISR call _isrStepperMotion on every process call
+        // If not using ISR call isrStepperMotion on every process call
 #ifndef USE_ESP32_TIMER_ISR
-        _isrStepperMotion();
+        isrStepperMotion();
 #endif
     }
 
@@ -73,13 +73,13 @@ private:
     uint32_t _curAccumulatorNS;
     uint32_t _curAccumulatorRelative[RobotConsts::MAX_AXES];
 
-    int _endStopCheckNum;
-    struct EndStopChecks
-    {
-        int pin;
-        bool val;
-    };
-    EndStopChecks _endStopChecks[RobotConsts::MAX_AXES];
+    // End-stops are checked against a single snapshot of the GPIO input registers using masks
+    // computed when a block is set up (Lo = GPIO0..31, Hi = GPIO32..39)
+    bool _endStopChecksActive;
+    uint32_t _endStopMaskLo;
+    uint32_t _endStopMaskHi;
+    uint32_t _endStopHitValLo;
+    uint32_t _endStopHitValHi;
 
 public:
     RampGenerator(MotionPipeline* pMotionPipeline);
@@ -108,12 +108,23 @@ public:
     String getDebugStr();
     void showDebug();
 
+#ifdef UNIT_TEST
+    // Run one tick of the stepping ISR - used with the timer stopped (deinit) so that
+    // step output can be captured deterministically
+    void testTick()
+    {
+        isrStepperMotion();
+    }
+#endif
+
 private:
     static void _staticISRStepperMotion();
     void isrStepperMotion();
     bool handleStepEnd();
-    void setupNewBlock(MotionBlock *pBlock);
-    void updateMSAccumulator(MotionBlock *pBlock);
-    bool handleStepMotion(MotionBlock *pBlock);
-    void endMotion(MotionBlock *pBlock);
+    void setupNewBlock(MotionBlockExec *pBlock);
+    void updateMSAccumulator(MotionBlockExec *pBlock);
+    bool handleStepMotion(MotionBlockExec *pBlock);
+    void endMotion(MotionBlockExec *pBlock);
+    void addEndStopCheck(int pin, bool hitVal);
+    bool isAnyEndStopHit();
 };
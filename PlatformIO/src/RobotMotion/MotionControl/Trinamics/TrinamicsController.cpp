@@ -15,14 +15,15 @@ TrinamicsController::TrinamicsController(AxesParams& axesParams, MotionPipeline&
         _axesParams(axesParams), _motionPipeline(motionPipeline)
 {
     _pThisObj = this;
-    _pVSPI = NULL;
+    _pSPIBus = &_spiBusESP32;
     _isEnabled = false;
     _isRampGenerator = false;
     _trinamicsTimerStarted = false;
     _miso = _mosi = _sck = -1;
-    _cs1 = _cs2 = _cs3 =  -1;
-    _mux1 = _mux2 = _mux3 = -1;
-    _muxCS1 = _muxCS2 = _muxCS3 = -1;
+    for (int i = 0; i < TrinamicsSPIBusESP32::MAX_CHIPS; i++)
+        _csPins[i] = _muxCSVals[i] = -1;
+    for (int i = 0; i < TrinamicsSPIBusESP32::NUM_MUX_PINS; i++)
+        _muxPins[i] = -1;
     _lastDoneNumberedCmdIdx = RobotConsts::NUMBERED_COMMAND_NONE;
     for (int i = 0; i < RobotConsts::MAX_AXES; i++)
         _axisIdxToChipDriverIdx[i] = i;
@@ -31,8 +32,14 @@ TrinamicsController::TrinamicsController(AxesParams& axesParams, MotionPipeline&
     for (int i = 0; i < RobotConsts::MAX_AXES; i++)
     {
         _axisTargetSteps[i] = 0;
-        _axisMinDistForNextBlockStart[i] = MIN_STEP_DIST_FOR_NEXT_BLOCK_START_DEFAULT;
+        _axisMovingInBlock[i] = false;
+        _axisHandoverSteps[i] = HANDOVER_MIN_STEPS;
     }
+    _blockInProgress = false;
+    _pStagedBlock = NULL;
+    _isPaused = false;
+    _stopRequested = false;
+    _clockHz = TrinamicsRampRegs::CLOCK_HZ_DEFAULT;
     resetTotalStepPosition();
 }
 
@@ -43,29 +50,6 @@ TrinamicsController::~TrinamicsController()
 
 void TrinamicsController::deinit()
 {
-    // Release pins
-    if (_cs1 >= 0)
-        pinMode(_cs1, INPUT);
-    if (_cs2 >= 0)
-        pinMode(_cs2, INPUT);
-    if (_cs3 >= 0)
-        pinMode(_cs3, INPUT);
-    if (_mux1 >= 0)
-        pinMode(_mux1, INPUT);
-    if (_mux2 >= 0)
-        pinMode(_mux2, INPUT);
-    if (_mux3 >= 0)
-        pinMode(_mux3, INPUT);
-    if (_muxCS1 >= 0)
-        pinMode(_muxCS1, INPUT);
-    if (_muxCS2 >= 0)
-        pinMode(_muxCS2, INPUT);
-    if (_muxCS3 >= 0)
-        pinMode(_muxCS3, INPUT);
-    _cs1 = _cs2 = _cs3 =  -1;
-    _mux1 = _mux2 = _mux3 = -1;
-    _muxCS1 = _muxCS2 = _muxCS3 = -1;
-
     // Stop timer
     if (_trinamicsTimerStarted)
     {
@@ -76,9 +60,20 @@ void TrinamicsController::deinit()
     }
 
     // Stop SPI
-    if (_pVSPI)
+    _spiBusESP32.deinit();
+
+    // Release pins
+    for (int i = 0; i < TrinamicsSPIBusESP32::MAX_CHIPS; i++)
+    {
+        if (_csPins[i] >= 0)
+            pinMode(_csPins[i], INPUT);
+        _csPins[i] = _muxCSVals[i] = -1;
+    }
+    for (int i = 0; i < TrinamicsSPIBusESP32::NUM_MUX_PINS; i++)
     {
-        _pVSPI->end();
+        if (_muxPins[i] >= 0)
+            pinMode(_muxPins[i], INPUT);
+        _muxPins[i] = -1;
     }
 
     _isEnabled = false;
@@ -98,6 +93,9 @@ void TrinamicsController::configure(const char *configJSON)
 
     if ((mcChip == "TMC5072") || (mcChip == "TMC2130"))
     {
+        // Clock
+        _clockHz = RdJson::getDouble("clockHz", TrinamicsRampRegs::CLOCK_HZ_DEFAULT, motionController.c_str());
+
         // SPI settings
         String pinName = RdJson::getString("MOSI", "", motionController.c_str());
         int spiMOSIPin = ConfigPinMap::getPinFromName(pinName.c_str());
@@ -116,46 +114,40 @@ void TrinamicsController::configure(const char *configJSON)
             _miso = spiMISOPin;
             _mosi = spiMOSIPin;
             _sck = spiCLKPin;
-            _isEnabled = true;
+
+            // Non-multiplexed cs pins
+            _csPins[0] = getPinAndConfigure(motionController.c_str(), "CS1", OUTPUT, HIGH);
+            _csPins[1] = getPinAndConfigure(motionController.c_str(), "CS2", OUTPUT, HIGH);
+            _csPins[2] = getPinAndConfigure(motionController.c_str(), "CS3", OUTPUT, HIGH);
+
+            // Multiplexer settings
+            _muxPins[0] = getPinAndConfigure(motionController.c_str(), "MUX1", OUTPUT, LOW);
+            _muxPins[1] = getPinAndConfigure(motionController.c_str(), "MUX2", OUTPUT, LOW);
+            _muxPins[2] = getPinAndConfigure(motionController.c_str(), "MUX3", OUTPUT, HIGH);
+            String confName = RdJson::getString("MUX_CS_1", "", motionController.c_str());
+            _muxCSVals[0] = ConfigPinMap::getPinFromName(confName.c_str());
+            confName = RdJson::getString("MUX_CS_2", "", motionController.c_str());
+            _muxCSVals[1] = ConfigPinMap::getPinFromName(confName.c_str());
+            confName = RdJson::getString("MUX_CS_3", "", motionController.c_str());
+            _muxCSVals[2] = ConfigPinMap::getPinFromName(confName.c_str());
 
             // Start SPI
-            if (!_pVSPI)
-                _pVSPI = new SPIClass(VSPI);
-            _pVSPI->begin(_sck, _miso, _mosi); //SCLK, MISO, MOSI, SS - not specified
+            _isEnabled = _spiBusESP32.setup(_sck, _miso, _mosi, _csPins, _muxPins, _muxCSVals);
         }
     }
 
-    // Handle CS (may be multiplexed)
-    if (_isEnabled)
+    // Configure TMC2130s
+    if ((mcChip == "TMC2130") && _isEnabled)
     {
-        // Non-multiplexed cs pins
-        _cs1 = getPinAndConfigure(motionController.c_str(), "CS1", OUTPUT, HIGH);
-        _cs2 = getPinAndConfigure(motionController.c_str(), "CS2", OUTPUT, HIGH);
-        _cs3 = getPinAndConfigure(motionController.c_str(), "CS3", OUTPUT, HIGH);
-
-        // Multiplexer settings
-        _mux1 = getPinAndConfigure(motionController.c_str(), "MUX1", OUTPUT, LOW);
-        _mux2 = getPinAndConfigure(motionController.c_str(), "MUX2", OUTPUT, LOW);
-        _mux3 = getPinAndConfigure(motionController.c_str(), "MUX3", OUTPUT, HIGH);
-        String confName = RdJson::getString("MUX_CS_1", "", motionController.c_str());
-        _muxCS1 = ConfigPinMap::getPinFromName(confName.c_str());
-        confName = RdJson::getString("MUX_CS_2", "", motionController.c_str());
-        _muxCS2 = ConfigPinMap::getPinFromName(confName.c_str());
-        confName = RdJson::getString("MUX_CS_3", "", motionController.c_str());
-        _muxCS3 = ConfigPinMap::getPinFromName(confName.c_str());
-
-        // Configure TMC2130s
-        if (mcChip == "TMC2130")
+        for (int i = 0; i < MAX_TMC2130; i++)
         {
-            for (int i = 0; i < MAX_TMC2130; i++)
-            {
-                // Set IHOLD=0x10, IRUN=0x10
-                tmcWrite(i, TMC2130_REG_IHOLD_IRUN, 0x00001010UL);
-
-                // Set native 256 microsteps, MRES=0, TBL=1=24, TOFF=8
-                tmcWrite(i, TMC2130_REG_CHOPCONF, 0x00008008UL);
-            }
+            // Set IHOLD=0x10, IRUN=0x10
+            tmcWrite(i, TMC2130_REG_IHOLD_IRUN, 0x00001010UL);
+
+            // Set native 256 microsteps, MRES=0, TBL=1=24, TOFF=8
+            tmcWrite(i, TMC2130_REG_CHOPCONF, 0x00008008UL);
         }
+        tmcFlushWrites();
     }
 
     // Check for ramp-generator chip
@@ -163,6 +155,8 @@ void TrinamicsController::configure(const char *configJSON)
     {
         // Initialise chips
         tmc5072Init();
+        _blockInProgress = false;
+        _pStagedBlock = NULL;
 
         // Start timer for TMC5072 motion handling
         const esp_timer_create_args_t _timerArgs = {
@@ -276,7 +270,7 @@ void TrinamicsController::tmc5072Init()
         axisIdx = _chipDriverIdxToAxisIdx[chipIdx*MAX_TMC_DRIVERS_PER_CHIP+1];
         if ((axisIdx >= 0) && (axisIdx < RobotConsts::MAX_AXES))
             gConfValue |= (_axisSettings[axisIdx].reversed ? 0x200 : 0);
-        uint64_t retVal = tmcWrite(chipIdx, TMC5072_GCONF, gConfValue);
+        tmcWrite(chipIdx, TMC5072_GCONF, gConfValue);
 
         // Reset positions
         tmcWrite(chipIdx, TMC5072_RAMPMODE_1,TMC5072_MODE_POSITION);
@@ -304,11 +298,13 @@ void TrinamicsController::tmc5072Init()
         tmcWrite(chipIdx, TMC5072_DMAX_2, 5000);
         tmcWrite(chipIdx, TMC5072_D1_2, 5000);
         tmcWrite(chipIdx, TMC5072_VSTOP_2, 10);
-        Log.trace("%sTMC5072 Chip%dInit retVal %x,%x GCONF %x\n", MODULE_PREFIX,
+        Log.trace("%sTMC5072 Chip%dInit GCONF %x\n", MODULE_PREFIX,
             chipIdx,
-            (uint32_t)(retVal >> 32), (uint32_t)retVal,
             gConfValue);
     }
+
+    // Send
+    tmcFlushWrites();
 }
 
 int TrinamicsController::getPinAndConfigure(const char* configJSON, const char* pinSelector, int direction, int initValue)
@@ -323,88 +319,21 @@ int TrinamicsController::getPinAndConfigure(const char* configJSON, const char*
     return pinIdx;
 }
 
-void TrinamicsController::performSel(int singleCS, int mux1, int mux2, int mux3, int muxCS, bool en)
-{
-    if (singleCS >= 0)
-    {
-        digitalWrite(singleCS, !en);
-    }
-    else
-    {
-        if ((mux1 >= 0) && (mux2 >= 0) && (mux3 >= 0) && (muxCS >= 0))
-        {
-            digitalWrite(mux1, en ? (muxCS & 0x01) : 0);
-            digitalWrite(mux2, en ? (muxCS & 0x02) : 0);
-            digitalWrite(mux3, en ? (muxCS & 0x04) : 1);
-        }
-    }
-}
-
-void TrinamicsController::chipSel(int chipIdx, bool en)
-{
-    if (chipIdx == 0)
-        performSel(_cs1, _mux1, _mux2, _mux3, _muxCS1, en);
-    else if (chipIdx == 1)
-        performSel(_cs2, _mux1, _mux2, _mux3, _muxCS2, en);
-    else if (chipIdx == 2)
-        performSel(_cs3, _mux1, _mux2, _mux3, _muxCS3, en);
-}
-
-uint64_t TrinamicsController::tmcWrite(int chipIdx, uint8_t cmd, uint32_t data, bool addWriteFlag)
+// Queue a register write - writes are sent as a single batch by tmcFlushWrites()
+void TrinamicsController::tmcWrite(int chipIdx, uint8_t cmd, uint32_t data)
 {
-    if (!_pVSPI)
-        return 0;
-        
-    // Start SPI transaction
-    _pVSPI->beginTransaction(SPISettings(SPI_CLOCK_HZ, MSBFIRST, SPI_MODE3));
-
-    // Select chip
-    chipSel(chipIdx, true);
-
-    // Transfer data
-    uint64_t retVal = _pVSPI->transfer(cmd | (addWriteFlag ? TMC5072_WRITE : 0));
-    retVal <<= 8;
-    retVal |= _pVSPI->transfer((data>>24) & 0xFF) & 0xFF;
-    retVal <<= 8;
-    retVal |= _pVSPI->transfer((data>>16) & 0xFF) & 0xFF;
-    retVal <<= 8;
-    retVal |= _pVSPI->transfer((data>>8) & 0xFF) & 0xFF;
-    retVal <<= 8;
-    retVal |= _pVSPI->transfer((data>>0) & 0xFF) & 0xFF;
-
-    // Deselect chip and end transaction
-    chipSel(chipIdx, false);
-    _pVSPI->endTransaction();
-
-    return retVal;
+    if (_cmdBatch.isFull())
+        tmcFlushWrites();
+    _cmdBatch.addWrite(chipIdx, cmd, data);
 }
 
-uint8_t TrinamicsController::tmcReadLastAndSetCmd(int chipIdx, uint8_t cmd, uint32_t& dataOut)
+bool TrinamicsController::tmcFlushWrites()
 {
-    dataOut = 0;
-    if (!_pVSPI)
-        return 0;
-
-    // Start SPI transaction
-    _pVSPI->beginTransaction(SPISettings(SPI_CLOCK_HZ, MSBFIRST, SPI_MODE3));
-
-    // Select chip
-    chipSel(chipIdx, true);
-
-    // Transfer data
-    uint8_t retVal = _pVSPI->transfer(cmd);
-    dataOut = _pVSPI->transfer(0x00) & 0xFF;
-    dataOut <<= 8;
-    dataOut |= _pVSPI->transfer(0x00) & 0xFF;
-    dataOut <<= 8;
-    dataOut |= _pVSPI->transfer(0x00) & 0xFF;
-    dataOut <<= 8;
-    dataOut |= _pVSPI->transfer(0x00) & 0xFF;
-
-    // Deselect chip and end transaction
-    chipSel(chipIdx, false);
-    _pVSPI->endTransaction();
-    return retVal;    
+    if (_cmdBatch.count() == 0)
+        return true;
+    bool rslt = _pSPIBus->execBatch(_cmdBatch);
+    _cmdBatch.clear();
+    return rslt;
 }
 
 void TrinamicsController::process()
@@ -432,30 +361,44 @@ void TrinamicsController::process()
     // }
 }
 
-void TrinamicsController::updateStatus(int chipIdx)
+void TrinamicsController::updateStatus()
 {
-    // Check if the chip is used based on whether the cs pin is defined
-    int csPin = _cs1;
-    if (chipIdx == 1)
-        csPin = _cs2;
-    if (csPin < 0)
+    // Queue the status reads for all chips in a single batch
+    static const uint8_t statusRegs[NUM_STATUS_REGS] = 
+            { TMC5072_RAMPSTAT_1, TMC5072_RAMPSTAT_2, TMC5072_XACTUAL_1, TMC5072_XACTUAL_2 };
+    int readHandles[MAX_TMC5072][NUM_STATUS_REGS];
+    _statusBatch.clear();
+    for (int chipIdx = 0; chipIdx < MAX_TMC5072; chipIdx++)
+    {
+        // Check if the chip is used based on whether it can be selected
+        bool chipUsed = _pSPIBus->isChipSelectable(chipIdx);
+        for (int regIdx = 0; regIdx < NUM_STATUS_REGS; regIdx++)
+            readHandles[chipIdx][regIdx] = chipUsed ? _statusBatch.addRead(chipIdx, statusRegs[regIdx]) : -1;
+    }
+    if (_statusBatch.count() == 0)
+        return;
+
+    // Reads return data on the following datagram so finish with a harmless read
+    _statusBatch.completeReads(TMC5072_XACTUAL_2);
+    if (!_pSPIBus->execBatch(_statusBatch))
         return;
 
-    // Get status
-    uint32_t rampStat1 = 0;
-    uint32_t rampStat2 = 0;
-    uint32_t steps1 = 0;
-    uint32_t steps2 = 0;
-    uint8_t tmcStatus = tmcReadLastAndSetCmd(chipIdx, TMC5072_RAMPSTAT_1, rampStat1);
-    tmcReadLastAndSetCmd(chipIdx, TMC5072_RAMPSTAT_2, rampStat1);
-    tmcReadLastAndSetCmd(chipIdx, TMC5072_XACTUAL_1, rampStat2);
-    tmcReadLastAndSetCmd(chipIdx, TMC5072_XACTUAL_2, steps1);
-    tmcReadLastAndSetCmd(chipIdx, TMC5072_XACTUAL_2, steps2);
-    _tmc5072Status[chipIdx].set(tmcStatus, rampStat1, rampStat2, steps1, steps2);
-
-    if (Utils::isTimeout(millis(), _debugTimerLast, 5000))
+    // Extract status
+    bool gstatClearNeeded[MAX_TMC5072];
+    bool anyGstatClearNeeded = false;
+    for (int chipIdx = 0; chipIdx < MAX_TMC5072; chipIdx++)
     {
-        if (chipIdx == 0)
+        gstatClearNeeded[chipIdx] = false;
+        if (readHandles[chipIdx][0] < 0)
+            continue;
+        uint8_t tmcStatus = _statusBatch.getStatus(readHandles[chipIdx][0]);
+        uint32_t rampStat1 = _statusBatch.getReadData(readHandles[chipIdx][0]);
+        uint32_t rampStat2 = _statusBatch.getReadData(readHandles[chipIdx][1]);
+        uint32_t steps1 = _statusBatch.getReadData(readHandles[chipIdx][2]);
+        uint32_t steps2 = _statusBatch.getReadData(readHandles[chipIdx][3]);
+        _tmc5072Status[chipIdx].set(tmcStatus, rampStat1, rampStat2, steps1, steps2);
+
+        if ((chipIdx == 0) && Utils::isTimeout(millis(), _debugTimerLast, 5000))
         {
             Log.trace("%sStatus chip%d Steps1 %d Steps2 %d Driver1 %s Driver2 %s%s\n", MODULE_PREFIX, 
                     chipIdx+1, 
@@ -465,37 +408,52 @@ void TrinamicsController::updateStatus(int chipIdx)
                     _tmc5072Status[chipIdx].getStatusStr().c_str());
             _debugTimerLast = millis();
         }
-    }
 
-    // Update total steps moved
-    int axisIdx = _chipDriverIdxToAxisIdx[chipIdx*MAX_TMC_DRIVERS_PER_CHIP];
-    if ((axisIdx >= 0) && (axisIdx < RobotConsts::MAX_AXES))
-        _axisTotalSteps[axisIdx] = steps1;
-    axisIdx = _chipDriverIdxToAxisIdx[chipIdx*MAX_TMC_DRIVERS_PER_CHIP+1];
-    if ((axisIdx >= 0) && (axisIdx < RobotConsts::MAX_AXES))
-        _axisTotalSteps[axisIdx] = steps2;
+        // Update total steps moved
+        int axisIdx = _chipDriverIdxToAxisIdx[chipIdx*MAX_TMC_DRIVERS_PER_CHIP];
+        if ((axisIdx >= 0) && (axisIdx < RobotConsts::MAX_AXES))
+            _axisTotalSteps[axisIdx] = steps1;
+        axisIdx = _chipDriverIdxToAxisIdx[chipIdx*MAX_TMC_DRIVERS_PER_CHIP+1];
+        if ((axisIdx >= 0) && (axisIdx < RobotConsts::MAX_AXES))
+            _axisTotalSteps[axisIdx] = steps2;
 
-    // Check if we need to clear flags by reading GSTAT
-    if (_tmc5072Status[chipIdx].isGstatClearNeeded())
-    {
-        uint32_t discard = 0;
-        tmcReadLastAndSetCmd(chipIdx, TMC5072_GSTAT, discard);
+        // Check if we need to clear flags by reading GSTAT
+        gstatClearNeeded[chipIdx] = _tmc5072Status[chipIdx].isGstatClearNeeded();
+        anyGstatClearNeeded |= gstatClearNeeded[chipIdx];
     }
 
+    // Clear flags (GSTAT is cleared when the read request is received so data isn't needed)
+    if (anyGstatClearNeeded)
+    {
+        _statusBatch.clear();
+        for (int chipIdx = 0; chipIdx < MAX_TMC5072; chipIdx++)
+            if (gstatClearNeeded[chipIdx])
+                _statusBatch.addRead(chipIdx, TMC5072_GSTAT);
+        _pSPIBus->execBatch(_statusBatch);
+    }
 }
 
-void TrinamicsController::tmc5072SendCmd(int axisIdx, uint8_t baseCmd, uint32_t data)
+bool TrinamicsController::getAxisChipAndCmd(int axisIdx, uint8_t baseCmd, int& chipIdx, uint8_t& cmd)
 {
     int chipDriverIdx = _axisIdxToChipDriverIdx[axisIdx];
-    int chipIdx = chipDriverIdx / MAX_TMC_DRIVERS_PER_CHIP;
+    chipIdx = chipDriverIdx / MAX_TMC_DRIVERS_PER_CHIP;
     int driverIdx = chipDriverIdx % MAX_TMC_DRIVERS_PER_CHIP;
-    if ((chipIdx < 0) || (chipIdx > MAX_TMC5072))
-        return;
-    uint8_t cmd = baseCmd;
+    if ((chipIdx < 0) || (chipIdx >= MAX_TMC5072))
+        return false;
+    cmd = baseCmd;
     if (driverIdx == 0)
         cmd += TMC5072_MOTOR0;
     else
         cmd += TMC5072_MOTOR1;
+    return true;
+}
+
+void TrinamicsController::tmc5072SendCmd(int axisIdx, uint8_t baseCmd, uint32_t data)
+{
+    int chipIdx = 0;
+    uint8_t cmd = 0;
+    if (!getAxisChipAndCmd(axisIdx, baseCmd, chipIdx, cmd))
+        return;
     tmcWrite(chipIdx, cmd, data);
 
     // Debug
@@ -503,155 +461,146 @@ void TrinamicsController::tmc5072SendCmd(int axisIdx, uint8_t baseCmd, uint32_t
     //     Log.trace("C%d CMD %x %x\n", chipIdx, cmd, data);
 }
 
-bool TrinamicsController::isCloseToDestination()
+// Translate the next block into register writes ready to send when the block in progress completes
+bool TrinamicsController::stageNextBlock()
 {
+    // The block to stage follows the one in progress (if there is one)
+    MotionBlockExec *pBlock = _motionPipeline.peekExecNthFromGet(_blockInProgress ? 1 : 0);
+    if (!pBlock || !pBlock->_canExecute)
+        return false;
+
+    // Mark as executing so the planner no longer changes the block
+    pBlock->_isExecuting = true;
+
+    // Block starts where the previous one ends
+    _stagedRegs.compute(*pBlock, _blockInProgress ? _axisTargetSteps : _axisTotalSteps, _clockHz);
+
+    // Ramp settings are written before the target as writing XTARGET starts the move
+    _stagedBatch.clear();
     for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
     {
-        // Log.trace("TEST AXIS %d %d %d %d\n", axisIdx, 
-        //         _axisTargetSteps[axisIdx], _axisTotalSteps[axisIdx], _axisMinDistForNextBlockStart[axisIdx]);
-        if (std::abs(_axisTargetSteps[axisIdx] - _axisTotalSteps[axisIdx]) > _axisMinDistForNextBlockStart[axisIdx])
-        {
-                return false;
-        }
+        TrinamicsRampRegs::AxisRamp& ramp = _stagedRegs._axisRamps[axisIdx];
+        int chipIdx = 0;
+        uint8_t cmd = 0;
+        if (!ramp.isMoving)
+            continue;
+        if (getAxisChipAndCmd(axisIdx, TMC5072_VSTART, chipIdx, cmd))
+            _stagedBatch.addWrite(chipIdx, cmd, ramp.vStart);
+        if (getAxisChipAndCmd(axisIdx, TMC5072_AMAX, chipIdx, cmd))
+            _stagedBatch.addWrite(chipIdx, cmd, ramp.aMax);
+        if (getAxisChipAndCmd(axisIdx, TMC5072_DMAX, chipIdx, cmd))
+            _stagedBatch.addWrite(chipIdx, cmd, ramp.aMax);
+        if (getAxisChipAndCmd(axisIdx, TMC5072_VMAX, chipIdx, cmd))
+            _stagedBatch.addWrite(chipIdx, cmd, ramp.vMax);
+        if (getAxisChipAndCmd(axisIdx, TMC5072_VSTOP, chipIdx, cmd))
+            _stagedBatch.addWrite(chipIdx, cmd, ramp.vStop);
+        if (getAxisChipAndCmd(axisIdx, TMC5072_XTARGET, chipIdx, cmd))
+            _stagedBatch.addWrite(chipIdx, cmd, ramp.xTarget);
     }
+    _pStagedBlock = pBlock;
     return true;
 }
 
-void TrinamicsController::_timerCallback(void* arg)
+// Check the position-reached status of every axis moving in the block in progress
+bool TrinamicsController::isBlockTargetReached()
 {
-
-    // TODO DEBUG ONLY
-    // digitalWrite(21, 0);
-    // if (_debugTimerLast)
-    // {
-    //     tmcWrite(0, TMC5072_XTARGET_1, 0x0007D000);  //XTARGET=512000 | 10 revolutions with micro step = 256
-    //     tmcWrite(0, TMC5072_XTARGET_2, 0xFFF83000);  //XTARGET=-512000 | 10 revolutions with micro step = 256
-    // }
-    // else
-    // {
-    //     tmcWrite(0, TMC5072_XTARGET_1, 0x00000000); //XTARGET=0
-    //     tmcWrite(0, TMC5072_XTARGET_2, 0x00000000); //XTARGET=0
-    // }
-
-    // _debugTimerLast = !_debugTimerLast;
-
-    // Log.notice("tring\n");
-
-
-    // Log.notice("tring\n");
-
-    // return;
-
-    // Read status    
-    bool isMoving = false;
-    for (int i = 0; i < MAX_TMC5072; i++)
+    for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
     {
-        updateStatus(i);
-        isMoving |= _tmc5072Status[i].anyAxisMoving();
+        if (!_axisMovingInBlock[axisIdx])
+            continue;
+        int chipDriverIdx = _axisIdxToChipDriverIdx[axisIdx];
+        int chipIdx = chipDriverIdx / MAX_TMC_DRIVERS_PER_CHIP;
+        if ((chipIdx < 0) || (chipIdx >= MAX_TMC5072))
+            continue;
+        if (_axisTotalSteps[axisIdx] != _axisTargetSteps[axisIdx])
+            return false;
+        if (!_tmc5072Status[chipIdx].isPositionReached(chipDriverIdx % MAX_TMC_DRIVERS_PER_CHIP))
+            return false;
     }
+    return true;
+}
 
-    // Peek a MotionPipelineElem from the queue
-    MotionBlock *pBlock = _motionPipeline.peekGet();
-    if (!pBlock)
+// Check if every axis moving in the block in progress is close enough to its target that
+// the staged block should be started - writing the new target while the motors are still
+// running at the junction speed means they carry on without stopping
+// An axis which reverses in the staged block must reach its target first - the ramp generator
+// would otherwise decelerate through the old target (overshoot) and cut the corner
+bool TrinamicsController::isBlockHandoverDue()
+{
+    for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
     {
-        // Log.trace("Nothing in pipe\n");
-        return;
+        if (!_axisMovingInBlock[axisIdx])
+            continue;
+        int32_t stepsToTarget = _axisTargetSteps[axisIdx] - _axisTotalSteps[axisIdx];
+        TrinamicsRampRegs::AxisRamp& stagedRamp = _stagedRegs._axisRamps[axisIdx];
+        int32_t stagedSteps = stagedRamp.xTarget - _axisTargetSteps[axisIdx];
+        bool reverses = stagedRamp.isMoving && ((stagedSteps < 0) != (stepsToTarget < 0));
+        if (reverses && (stepsToTarget != 0))
+            return false;
+        if (abs(stepsToTarget) > _axisHandoverSteps[axisIdx])
+            return false;
     }
+    return true;
+}
 
-    // Check if the element can be executed
-    if (!pBlock->_canExecute)
+// Decelerate all motors to a halt (setting VMAX to 0 in positioning mode uses DMAX)
+void TrinamicsController::haltMotors()
+{
+    for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
     {
-        // Log.trace("Can't execute\n");
-        return;
+        tmc5072SendCmd(axisIdx, TMC5072_VMAX, 0);
+        _axisMovingInBlock[axisIdx] = false;
     }
+    tmcFlushWrites();
+    _blockInProgress = false;
+    _pStagedBlock = NULL;
+}
 
-    // See if the block was already executing and set isExecuting if not
-    bool blockIsNew = !pBlock->_isExecuting;
-    pBlock->_isExecuting = true;
+void TrinamicsController::_timerCallback(void* arg)
+{
+    // Read status    
+    updateStatus();
 
-    // Existing block
-    bool debugBlockCompleteCode = 0;
-    if (!blockIsNew)
+    // Handle stop
+    if (_stopRequested)
     {
-        bool blockFinished = false;
-        if (!isMoving)
-        {
-            // Log.trace("Removing\n");
-            _motionPipeline.remove();
-            blockFinished = true;
-            debugBlockCompleteCode = 1;
-            // Check if this is a numbered block - if so record its completion
-            if (pBlock->getNumberedCommandIndex() != RobotConsts::NUMBERED_COMMAND_NONE)
-                _lastDoneNumberedCmdIdx = pBlock->getNumberedCommandIndex();
-        }
-        else if (pBlock->getNumberedCommandIndex() == RobotConsts::NUMBERED_COMMAND_NONE)
-        {
-            // Check if close to destination
-            if (isCloseToDestination())
-            {
-                // Remove block and 
-                _motionPipeline.remove();
-                blockFinished = true;
-                debugBlockCompleteCode = 2;
-            }
-        }
+        haltMotors();
+        _stopRequested = false;
+        return;
+    }
 
-        // Check if we finished a block and, if so, see if there's a new one waiting
-        if (blockFinished)
-        {
-            // Peek a MotionPipelineElem from the queue
-            // Check if the element can be executed
-            MotionBlock *pBlock = _motionPipeline.peekGet();
-            if (pBlock && pBlock->_canExecute)
-            {
-                // Should be new!
-                blockIsNew = !pBlock->_isExecuting;
-                pBlock->_isExecuting = true;
-            }
-        }
+    // The block in progress is finished when it reaches its target or, if the next block is
+    // staged, when it is close enough to hand over to the next block (the remaining steps are
+    // completed by the ramp generator on the way to the new target)
+    bool startStaged = _pStagedBlock && !_isPaused;
+    if (_blockInProgress && ((startStaged && isBlockHandoverDue()) || isBlockTargetReached()))
+    {
+        // Check if this is a numbered block - if so record its completion
+        MotionBlockExec *pBlock = _motionPipeline.peekGet();
+        if (pBlock && (pBlock->getNumberedCommandIndex() != RobotConsts::NUMBERED_COMMAND_NONE))
+            _lastDoneNumberedCmdIdx = pBlock->getNumberedCommandIndex();
+        _motionPipeline.remove();
+        _blockInProgress = false;
     }
 
-    // New block
-    if (blockIsNew)
+    // Start the staged block
+    if (!_blockInProgress && startStaged)
     {
-        // Handle the motion by requesting the controller to make the move
-        int32_t maxAxisSteps = pBlock->_stepsTotalMaybeNeg[pBlock->_axisIdxWithMaxSteps];
-        float entrySpeedFactor = fabs(pBlock->_entrySpeedMMps / pBlock->_feedrate);
-        float exitSpeedFactor = fabs(pBlock->_exitSpeedMMps / pBlock->_feedrate);
+        _pSPIBus->execBatch(_stagedBatch);
+        float lookaheadSecs = HANDOVER_LOOKAHEAD_TICKS * TRINAMIC_TIMER_PERIOD_US / 1000000.0f;
         for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
         {
-            // Set VMAX based on the distance each axis will travel
-            uint32_t axisVMax = 100000 * abs(1000*pBlock->_stepsTotalMaybeNeg[axisIdx]/maxAxisSteps) / 1000;
-            uint32_t axisVStart = axisVMax * entrySpeedFactor;
-            tmc5072SendCmd(axisIdx, TMC5072_VSTART, axisVStart);
-            tmc5072SendCmd(axisIdx, TMC5072_VMAX, axisVMax);
-            uint32_t axisVStop = axisVMax * exitSpeedFactor;
-            if (axisVStop < 10)
-                axisVStop = 10;
-            
-            // Debug
-            // if (axisIdx == 0)
-            //     Log.trace("%F %F %F %F %F %d %d %d\n", pBlock->_entrySpeedMMps, pBlock->_exitSpeedMMps, pBlock->_feedrate, entrySpeedFactor, exitSpeedFactor,
-            //         axisVMax, axisVStart, axisVStop);
-            tmc5072SendCmd(axisIdx, TMC5072_VSTOP, axisVMax);
-        }
-        
-        // Send commnands for each axis movement
-        for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
-        {
-            _axisTargetSteps[axisIdx] = _axisTotalSteps[axisIdx] + pBlock->_stepsTotalMaybeNeg[axisIdx];
-            tmc5072SendCmd(axisIdx, TMC5072_XTARGET, _axisTargetSteps[axisIdx]);
-
-            // Log.trace("TARGET %d, %d, %d Total %d %d %d\n", 
-            //     _axisTargetSteps[0], _axisTargetSteps[1], _axisTargetSteps[2], 
-            //     _axisTotalSteps[0], _axisTotalSteps[1], _axisTotalSteps[2]);
+            TrinamicsRampRegs::AxisRamp& ramp = _stagedRegs._axisRamps[axisIdx];
+            _axisMovingInBlock[axisIdx] = ramp.isMoving;
+            _axisTargetSteps[axisIdx] = ramp.xTarget;
+            _axisHandoverSteps[axisIdx] = HANDOVER_MIN_STEPS +
+                        int32_t(TrinamicsRampRegs::stepRateFromVel(ramp.vStop, _clockHz) * lookaheadSecs);
         }
+        _pStagedBlock = NULL;
+        _blockInProgress = true;
     }
 
-    // Debug
-    if (debugBlockCompleteCode != 0)
-        Log.trace("BLOCK COMPLETE CODE %d Target %d, %d, %d Total %d %d %d\n", 
-                debugBlockCompleteCode,
-                _axisTargetSteps[0], _axisTargetSteps[1], _axisTargetSteps[2], 
-                _axisTotalSteps[0], _axisTotalSteps[1], _axisTotalSteps[2]);
+    // Stage the next block so it is ready before the one in progress completes
+    if (!_pStagedBlock && !_isPaused)
+        stageNextBlock();
 }
@@ -4,9 +4,10 @@
 #pragma once
 
 #include <ArduinoLog.h>
-#include <SPI.h>
 #include "../../AxesParams.h"
 #include "../MotionPipeline.h"
+#include "TrinamicsSPIBus.h"
+#include "TrinamicsRampRegs.h"
 
 class TrinamicsController
 {
@@ -30,8 +31,25 @@ public:
         return _isRampGenerator;
     }
 
+    // Replace the hardware SPI bus (e.g. with a mock for testing) - NULL restores the hardware bus
+    void setSPIBus(TrinamicsSPIBus* pSPIBus)
+    {
+        _pSPIBus = pSPIBus ? pSPIBus : &_spiBusESP32;
+    }
+
     void _timerCallback(void* arg);
 
+#ifdef UNIT_TEST
+    // Stop the timer (leaving the controller configured) so that _timerCallback can be
+    // called from a test
+    void testStopTimer()
+    {
+        if (_trinamicsTimerStarted)
+            esp_timer_stop(_trinamicsTimerHandle);
+        _trinamicsTimerStarted = false;
+    }
+#endif
+
     static void _staticTimerCb(void* arg)
     {
         if (_pThisObj)
@@ -66,7 +84,7 @@ public:
         {
             summary = sumry;
             d1RampStat = rampStat1;
-            d2RampStat = rampStat1;
+            d2RampStat = rampStat2;
             d1Steps = steps1;
             d2Steps = steps2;
         }
@@ -78,6 +96,10 @@ public:
         {
             return (summary & 0x07) != 0;
         }
+        bool isPositionReached(int driverIdx)
+        {
+            return ((driverIdx == 0) ? d1RampStat : d2RampStat) & 0x200;
+        }
         bool anyAxisMoving()
         {
             // if (d1MovePending || d2MovePending)
@@ -158,14 +180,17 @@ public:
     // void setAxisTarget(int axisIdx, int32_t steps);
     // void stopMotors();
 
+    // Motors decelerate to a halt and any staged block is dropped
     void stop()
     {
-        // TODO
+        _isPaused = true;
+        _stopRequested = true;
     }
 
+    // When paused the block in progress completes but no further blocks are started
     void pause(bool pauseIt)
     {
-        // TODO
+        _isPaused = pauseIt;
     }
 
     void resetTotalStepPosition()
@@ -193,9 +218,6 @@ public:
     }
 
 private:
-    // Min number of steps left in a block move before the next block is started
-    static const int MIN_STEP_DIST_FOR_NEXT_BLOCK_START_DEFAULT = 500;
-
     // TMC chips
     static const int MAX_TMC2130 = 3;
     static constexpr int MAX_TMC5072 = 2;
@@ -215,18 +237,25 @@ private:
     static const int TMC2130_REG_DCCTRL = 0x6E;
     static const int TMC2130_REG_DRVSTATUS = 0x6F;
 
+    // Status registers read from each TMC5072 on every timer tick
+    static constexpr int NUM_STATUS_REGS = 4;
+
     // Helpers
     int getPinAndConfigure(const char* configJSON, const char* pinSelector, int direction, int initValue);
-    uint64_t tmcWrite(int chipIdx, uint8_t cmd, uint32_t data, bool addWriteFlag=true);
-    uint8_t tmcReadLastAndSetCmd(int chipIdx, uint8_t cmd, uint32_t& dataOut);
-    void chipSel(int chipIdx, bool en);
-    void performSel(int singleCS, int mux1, int mux2, int mux3, int muxCS, bool en);
+    void tmcWrite(int chipIdx, uint8_t cmd, uint32_t data);
+    bool tmcFlushWrites();
     void tmc5072Init();
-    void updateStatus(int chipIdx);
+    void updateStatus();
+    bool getAxisChipAndCmd(int axisIdx, uint8_t baseCmd, int& chipIdx, uint8_t& cmd);
     void tmc5072SendCmd(int axisIdx, uint8_t baseCmd, uint32_t data);
     uint32_t getUint32WithBaseFromConfig(const char* dataPath, uint32_t defaultValue,
                             const char* pSourceStr);
-    bool isCloseToDestination();
+
+    // Block streaming
+    bool stageNextBlock();
+    bool isBlockTargetReached();
+    bool isBlockHandoverDue();
+    void haltMotors();
 
     // TMC5072 status
     tmc5072Status_t _tmc5072Status[MAX_TMC5072];
@@ -281,8 +310,24 @@ private:
     // Target step position
     int32_t _axisTargetSteps[RobotConsts::MAX_AXES];
 
-    // Min step distance for next block start
-    int32_t _axisMinDistForNextBlockStart[RobotConsts::MAX_AXES];
+    // Axes moving in the block in progress
+    bool _axisMovingInBlock[RobotConsts::MAX_AXES];
+
+    // Steps from target at which the staged block is handed over (covers the lookahead
+    // time at the block's exit speed)
+    int32_t _axisHandoverSteps[RobotConsts::MAX_AXES];
+
+    // Block streaming - the block following the one in progress is translated into
+    // register writes ahead of time and sent as soon as the target is reached
+    bool _blockInProgress;
+    MotionBlockExec* _pStagedBlock;
+    TrinamicsRampRegs _stagedRegs;
+    TrinamicsSPIBatch _stagedBatch;
+    volatile bool _isPaused;
+    volatile bool _stopRequested;
+
+    // TMC5072 clock frequency
+    float _clockHz;
 
     // SPI
     int _miso;
@@ -290,24 +335,26 @@ private:
     int _sck;
 
     // un-multiplexed chip selects
-    int _cs1;
-    int _cs2;
-    int _cs3;
+    int _csPins[TrinamicsSPIBusESP32::MAX_CHIPS];
 
     // multiplexer pins and chip select mux values
-    int _mux1;
-    int _mux2;
-    int _mux3;
-    int _muxCS1;
-    int _muxCS2;
-    int _muxCS3;
+    int _muxPins[TrinamicsSPIBusESP32::NUM_MUX_PINS];
+    int _muxCSVals[TrinamicsSPIBusESP32::MAX_CHIPS];
 
-    // SPI controller
-    SPIClass* _pVSPI;
+    // SPI bus (hardware unless replaced for testing)
+    TrinamicsSPIBusESP32 _spiBusESP32;
+    TrinamicsSPIBus* _pSPIBus;
+
+    // Batches of datagrams for status reads and for commands
+    TrinamicsSPIBatch _statusBatch;
+    TrinamicsSPIBatch _cmdBatch;
 
     static constexpr uint32_t TRINAMIC_TIMER_PERIOD_US = 500;
-    static constexpr double TRINAMIC_CLOCK_FACTOR = 75.0;
-    static const int SPI_CLOCK_HZ = 2000000;
+
+    // Block handover lookahead - the next target is written this many timer periods before
+    // the block in progress would reach its target
+    static constexpr int HANDOVER_LOOKAHEAD_TICKS = 2;
+    static constexpr int32_t HANDOVER_MIN_STEPS = 2;
 
     // Debug
     uint32_t _debugTimerLast;
@@ -0,0 +1,108 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+#pragma once
+
+#include "../MotionBlock.h"
+
+// Translation of a planned motion block into TMC5072 ramp generator register values
+// The block's step rates are for the axis with most steps - other axes are scaled
+// so that all axes reach their targets together
+class TrinamicsRampRegs
+{
+public:
+    // TMC5072 internal clock (datasheet nominal) unless configured otherwise
+    static constexpr float CLOCK_HZ_DEFAULT = 13200000;
+
+    // Register limits (datasheet pp 34-35)
+    static constexpr uint32_t VSTART_MAX = (1UL << 18) - 1;
+    static constexpr uint32_t VSTOP_MAX = (1UL << 18) - 1;
+    static constexpr uint32_t VMAX_MAX = (1UL << 23) - 512;
+    static constexpr uint32_t AMAX_MAX = (1UL << 16) - 1;
+
+    // VSTOP must not be 0 in positioning mode
+    static constexpr uint32_t VSTOP_MIN = 10;
+
+    class AxisRamp
+    {
+    public:
+        bool isMoving;
+        int32_t xTarget;
+        uint32_t vStart;
+        uint32_t vMax;
+        uint32_t aMax;
+        uint32_t vStop;
+    };
+
+    AxisRamp _axisRamps[RobotConsts::MAX_AXES];
+
+    // Velocity register value for a step rate (v[Hz] = v[5072] * fCLK / 2^24)
+    static uint32_t velFromStepRate(float stepsPerSec, float clockHz)
+    {
+        return uint32_t(fabsf(stepsPerSec) * 16777216.0f / clockHz + 0.5f);
+    }
+
+    // Acceleration register value for a step acceleration (a[Hz/s] = a[5072] * fCLK^2 / 2^41)
+    static uint32_t accFromStepAcc(float stepsPerSec2, float clockHz)
+    {
+        return uint32_t(fabsf(stepsPerSec2) * (2199023255552.0f / clockHz) / clockHz + 0.5f);
+    }
+
+    // Step rate for a velocity register value
+    static float stepRateFromVel(uint32_t vel, float clockHz)
+    {
+        return vel * clockHz / 16777216.0f;
+    }
+
+    // Step acceleration for an acceleration register value
+    static float stepAccFromAcc(uint32_t acc, float clockHz)
+    {
+        return acc * (clockHz / 2199023255552.0f) * clockHz;
+    }
+
+    static uint32_t clampVal(uint32_t val, uint32_t lowBound, uint32_t highBound)
+    {
+        if (val < lowBound)
+            return lowBound;
+        if (val > highBound)
+            return highBound;
+        return val;
+    }
+
+    // Compute register values for a block which starts at startSteps (the target of the previous block)
+    // The block must have been prepared for stepping
+    void compute(MotionBlockExec& block, const int32_t* startSteps, float clockHz)
+    {
+        float ttickRateToSec = MotionBlock::TICKS_PER_SEC / MotionBlock::TTICKS_VALUE;
+        float initialStepRate = block._initialStepRatePerTTicks * ttickRateToSec;
+        float maxStepRate = block._maxStepRatePerTTicks * ttickRateToSec;
+        float finalStepRate = block._finalStepRatePerTTicks * ttickRateToSec;
+        float stepAcc = block._accStepsPerTTicksPerMS * 1000 * ttickRateToSec;
+        float maxAxisSteps = abs(block._stepsTotalMaybeNeg[block._axisIdxWithMaxSteps]);
+
+        for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
+        {
+            AxisRamp& ramp = _axisRamps[axisIdx];
+            int32_t axisSteps = block._stepsTotalMaybeNeg[axisIdx];
+            ramp.isMoving = (axisSteps != 0) && (maxAxisSteps > 0);
+            ramp.xTarget = startSteps[axisIdx] + axisSteps;
+            if (!ramp.isMoving)
+            {
+                ramp.vStart = ramp.vMax = ramp.aMax = 0;
+                ramp.vStop = VSTOP_MIN;
+                continue;
+            }
+            float axisFactor = abs(axisSteps) / maxAxisSteps;
+            ramp.vMax = clampVal(velFromStepRate(maxStepRate * axisFactor, clockHz), 0, VMAX_MAX);
+            ramp.aMax = clampVal(accFromStepAcc(stepAcc * axisFactor, clockHz), 1, AMAX_MAX);
+            // Start and stop speeds are the junction speeds - blocks are normally handed over while
+            // moving so VSTART only applies if the axis has come to a halt before the next block
+            ramp.vStop = clampVal(velFromStepRate(finalStepRate * axisFactor, clockHz), VSTOP_MIN, VSTOP_MAX);
+            ramp.vStart = clampVal(velFromStepRate(initialStepRate * axisFactor, clockHz), 0, VSTART_MAX);
+            if (ramp.vMax < ramp.vStop)
+                ramp.vMax = ramp.vStop;
+            if (ramp.vMax < ramp.vStart)
+                ramp.vMax = ramp.vStart;
+        }
+    }
+};
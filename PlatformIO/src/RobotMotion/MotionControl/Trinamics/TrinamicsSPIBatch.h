@@ -0,0 +1,147 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+#pragma once
+
+#include <stdint.h>
+
+// A batch of 40-bit TMC datagrams which are sent to one or more chips in a single
+// bus transaction
+// Reads on TMC chips are pipelined - the data for a read request is only returned
+// by the next datagram sent to the same chip - so the batch records which datagram
+// will carry the result of each read
+class TrinamicsSPIBatch
+{
+public:
+    // Largest batch is a staged block - 6 register writes for each driver on two TMC5072s
+    static constexpr int MAX_DATAGRAMS = 24;
+    // Most chips on the bus in a supported config (3 x TMC2130)
+    static constexpr int MAX_CHIPS = 3;
+    static constexpr int DATAGRAM_BITS = 40;
+    static constexpr int DATAGRAM_BYTES = 5;
+    static constexpr uint8_t WRITE_FLAG = 0x80;
+
+    // Buffers are padded to a multiple of 4 bytes and word aligned so they can be
+    // used directly by DMA
+    static constexpr int DATAGRAM_BUF_LEN = 8;
+
+    struct Datagram
+    {
+        uint8_t txBuf[DATAGRAM_BUF_LEN] __attribute__((aligned(4)));
+        uint8_t rxBuf[DATAGRAM_BUF_LEN] __attribute__((aligned(4)));
+        uint8_t chipIdx;
+        // Index of the datagram which returns this read's data (-1 if none)
+        int8_t resultIdx;
+    };
+
+private:
+    Datagram _datagrams[MAX_DATAGRAMS];
+    int _numDatagrams;
+    int _pendingReadIdx[MAX_CHIPS];
+
+public:
+    TrinamicsSPIBatch()
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        _numDatagrams = 0;
+        for (int i = 0; i < MAX_CHIPS; i++)
+            _pendingReadIdx[i] = -1;
+    }
+
+    int count()
+    {
+        return _numDatagrams;
+    }
+
+    bool isFull()
+    {
+        return _numDatagrams >= MAX_DATAGRAMS;
+    }
+
+    Datagram* getDatagram(int idx)
+    {
+        if ((idx < 0) || (idx >= _numDatagrams))
+            return NULL;
+        return &_datagrams[idx];
+    }
+
+    // Add a register write - returns datagram index or -1 if full
+    int addWrite(int chipIdx, uint8_t reg, uint32_t data)
+    {
+        return add(chipIdx, reg | WRITE_FLAG, data, false);
+    }
+
+    // Add a register read - returns a handle for getReadData() or -1 if full
+    int addRead(int chipIdx, uint8_t reg)
+    {
+        return add(chipIdx, reg & ~WRITE_FLAG, 0, true);
+    }
+
+    // Ensure every read in the batch is followed by another datagram on the same chip
+    // so that its data is clocked out - flushReg must be safe to read (no clear-on-read)
+    bool completeReads(uint8_t flushReg)
+    {
+        for (int chipIdx = 0; chipIdx < MAX_CHIPS; chipIdx++)
+        {
+            if (_pendingReadIdx[chipIdx] < 0)
+                continue;
+            if (add(chipIdx, flushReg & ~WRITE_FLAG, 0, false) < 0)
+                return false;
+        }
+        return true;
+    }
+
+    // Data returned for a read (valid after the batch has been executed)
+    uint32_t getReadData(int readHandle)
+    {
+        if ((readHandle < 0) || (readHandle >= _numDatagrams))
+            return 0;
+        int resultIdx = _datagrams[readHandle].resultIdx;
+        if ((resultIdx < 0) || (resultIdx >= _numDatagrams))
+            return 0;
+        return getRxData(resultIdx);
+    }
+
+    // SPI status byte returned by the chip for a datagram
+    uint8_t getStatus(int datagramIdx)
+    {
+        if ((datagramIdx < 0) || (datagramIdx >= _numDatagrams))
+            return 0;
+        return _datagrams[datagramIdx].rxBuf[0];
+    }
+
+    // Raw data field of the response to a datagram
+    uint32_t getRxData(int datagramIdx)
+    {
+        uint8_t* pBuf = _datagrams[datagramIdx].rxBuf;
+        return ((uint32_t)pBuf[1] << 24) | ((uint32_t)pBuf[2] << 16) | ((uint32_t)pBuf[3] << 8) | pBuf[4];
+    }
+
+private:
+    int add(int chipIdx, uint8_t cmd, uint32_t data, bool isRead)
+    {
+        if ((chipIdx < 0) || (chipIdx >= MAX_CHIPS) || isFull())
+            return -1;
+        int idx = _numDatagrams++;
+        Datagram& dg = _datagrams[idx];
+        dg.chipIdx = chipIdx;
+        dg.resultIdx = -1;
+        dg.txBuf[0] = cmd;
+        dg.txBuf[1] = (data >> 24) & 0xff;
+        dg.txBuf[2] = (data >> 16) & 0xff;
+        dg.txBuf[3] = (data >> 8) & 0xff;
+        dg.txBuf[4] = data & 0xff;
+        for (int i = 0; i < DATAGRAM_BUF_LEN; i++)
+            dg.rxBuf[i] = 0;
+
+        // Any datagram on this chip clocks out the data for a pending read
+        if (_pendingReadIdx[chipIdx] >= 0)
+            _datagrams[_pendingReadIdx[chipIdx]].resultIdx = idx;
+        _pendingReadIdx[chipIdx] = isRead ? idx : -1;
+        return idx;
+    }
+};
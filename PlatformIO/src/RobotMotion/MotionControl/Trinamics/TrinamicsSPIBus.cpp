@@ -0,0 +1,201 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+#include "TrinamicsSPIBus.h"
+#include <ArduinoLog.h>
+#include <soc/gpio_struct.h>
+
+static const char* MODULE_PREFIX = "TrinamicsSPIBus: ";
+
+TrinamicsSPIBusESP32::TrinamicsSPIBusESP32()
+{
+    _busInitialised = false;
+    _spiDevice = NULL;
+    for (int i = 0; i < MAX_CHIPS; i++)
+    {
+        _csPins[i] = -1;
+        _chipSelSeqs[i].valid = false;
+    }
+    for (int i = 0; i < NUM_MUX_PINS; i++)
+        _muxPins[i] = -1;
+}
+
+TrinamicsSPIBusESP32::~TrinamicsSPIBusESP32()
+{
+    deinit();
+}
+
+void TrinamicsSPIBusESP32::GpioMasks::addPin(int pin, bool level)
+{
+    if ((pin < 0) || (pin >= 40))
+        return;
+    if (pin < 32)
+    {
+        if (level)
+            setLo |= (1UL << pin);
+        else
+            clrLo |= (1UL << pin);
+    }
+    else
+    {
+        if (level)
+            setHi |= (1UL << (pin - 32));
+        else
+            clrHi |= (1UL << (pin - 32));
+    }
+}
+
+bool TrinamicsSPIBusESP32::setup(int sck, int miso, int mosi, const int* csPins, const int* muxPins, const int* muxCSVals)
+{
+    deinit();
+
+    // Chip select pins - direct chip selects are active low and muxed selects are
+    // decoded from the mux pins (mux value 4 is used as the deselected state)
+    bool muxValid = true;
+    for (int i = 0; i < NUM_MUX_PINS; i++)
+    {
+        _muxPins[i] = muxPins[i];
+        if (_muxPins[i] < 0)
+            muxValid = false;
+    }
+    for (int chipIdx = 0; chipIdx < MAX_CHIPS; chipIdx++)
+    {
+        _csPins[chipIdx] = csPins[chipIdx];
+        ChipSelSeq& seq = _chipSelSeqs[chipIdx];
+        seq.valid = false;
+        seq.selMasks.clear();
+        seq.deselMasks.clear();
+        if (_csPins[chipIdx] >= 0)
+        {
+            seq.selMasks.addPin(_csPins[chipIdx], false);
+            seq.deselMasks.addPin(_csPins[chipIdx], true);
+            seq.valid = true;
+        }
+        else if (muxValid && (muxCSVals[chipIdx] >= 0))
+        {
+            for (int muxIdx = 0; muxIdx < NUM_MUX_PINS; muxIdx++)
+            {
+                seq.selMasks.addPin(_muxPins[muxIdx], (muxCSVals[chipIdx] & (1 << muxIdx)) != 0);
+                seq.deselMasks.addPin(_muxPins[muxIdx], muxIdx == NUM_MUX_PINS - 1);
+            }
+            seq.valid = true;
+        }
+    }
+
+    // SPI bus with DMA
+    spi_bus_config_t busConfig;
+    memset(&busConfig, 0, sizeof(busConfig));
+    busConfig.mosi_io_num = mosi;
+    busConfig.miso_io_num = miso;
+    busConfig.sclk_io_num = sck;
+    busConfig.quadwp_io_num = -1;
+    busConfig.quadhd_io_num = -1;
+    busConfig.max_transfer_sz = TrinamicsSPIBatch::DATAGRAM_BUF_LEN;
+    esp_err_t err = spi_bus_initialize(VSPI_HOST, &busConfig, SPI_DMA_CHANNEL);
+    if (err != ESP_OK)
+    {
+        Log.warning("%ssetup failed to init bus (error %s)\n", MODULE_PREFIX, esp_err_to_name(err));
+        return false;
+    }
+
+    // Device - chip select is handled in callbacks
+    spi_device_interface_config_t devConfig;
+    memset(&devConfig, 0, sizeof(devConfig));
+    devConfig.mode = SPI_MODE;
+    devConfig.clock_speed_hz = SPI_CLOCK_HZ;
+    devConfig.spics_io_num = -1;
+    devConfig.queue_size = TrinamicsSPIBatch::MAX_DATAGRAMS;
+    devConfig.pre_cb = spiPreTransferCb;
+    devConfig.post_cb = spiPostTransferCb;
+    err = spi_bus_add_device(VSPI_HOST, &devConfig, &_spiDevice);
+    if (err != ESP_OK)
+    {
+        Log.warning("%ssetup failed to add device (error %s)\n", MODULE_PREFIX, esp_err_to_name(err));
+        spi_bus_free(VSPI_HOST);
+        return false;
+    }
+    _busInitialised = true;
+    Log.notice("%ssetup ok SCK %d MISO %d MOSI %d\n", MODULE_PREFIX, sck, miso, mosi);
+    return true;
+}
+
+void TrinamicsSPIBusESP32::deinit()
+{
+    if (_busInitialised)
+    {
+        spi_bus_remove_device(_spiDevice);
+        spi_bus_free(VSPI_HOST);
+        _spiDevice = NULL;
+        _busInitialised = false;
+    }
+    for (int i = 0; i < MAX_CHIPS; i++)
+        _chipSelSeqs[i].valid = false;
+}
+
+bool TrinamicsSPIBusESP32::isChipSelectable(int chipIdx)
+{
+    if ((chipIdx < 0) || (chipIdx >= MAX_CHIPS))
+        return false;
+    return _chipSelSeqs[chipIdx].valid;
+}
+
+bool TrinamicsSPIBusESP32::execBatch(TrinamicsSPIBatch& batch)
+{
+    if (!_busInitialised)
+        return false;
+
+    // Queue all datagrams - the driver runs them back-to-back from its ISR
+    int numQueued = 0;
+    for (int i = 0; i < batch.count(); i++)
+    {
+        TrinamicsSPIBatch::Datagram* pDatagram = batch.getDatagram(i);
+        if (!isChipSelectable(pDatagram->chipIdx))
+            continue;
+        spi_transaction_t& trans = _spiTrans[numQueued];
+        memset(&trans, 0, sizeof(trans));
+        trans.length = TrinamicsSPIBatch::DATAGRAM_BITS;
+        trans.rxlength = TrinamicsSPIBatch::DATAGRAM_BITS;
+        trans.tx_buffer = pDatagram->txBuf;
+        trans.rx_buffer = pDatagram->rxBuf;
+        trans.user = &_chipSelSeqs[pDatagram->chipIdx];
+        if (spi_device_queue_trans(_spiDevice, &trans, portMAX_DELAY) != ESP_OK)
+            break;
+        numQueued++;
+    }
+
+    // Wait for completion
+    bool rslt = (numQueued == batch.count());
+    for (int i = 0; i < numQueued; i++)
+    {
+        spi_transaction_t* pTrans = NULL;
+        if (spi_device_get_trans_result(_spiDevice, &pTrans, portMAX_DELAY) != ESP_OK)
+            rslt = false;
+    }
+    return rslt;
+}
+
+void IRAM_ATTR TrinamicsSPIBusESP32::applyMasks(const GpioMasks& masks)
+{
+    if (masks.clrLo)
+        GPIO.out_w1tc = masks.clrLo;
+    if (masks.setLo)
+        GPIO.out_w1ts = masks.setLo;
+    if (masks.clrHi)
+        GPIO.out1_w1tc.val = masks.clrHi;
+    if (masks.setHi)
+        GPIO.out1_w1ts.val = masks.setHi;
+}
+
+void IRAM_ATTR TrinamicsSPIBusESP32::spiPreTransferCb(spi_transaction_t* pTrans)
+{
+    const ChipSelSeq* pSeq = (const ChipSelSeq*)pTrans->user;
+    if (pSeq)
+        applyMasks(pSeq->selMasks);
+}
+
+void IRAM_ATTR TrinamicsSPIBusESP32::spiPostTransferCb(spi_transaction_t* pTrans)
+{
+    const ChipSelSeq* pSeq = (const ChipSelSeq*)pTrans->user;
+    if (pSeq)
+        applyMasks(pSeq->deselMasks);
+}
@@ -0,0 +1,83 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+#pragma once
+
+#include <Arduino.h>
+#include <driver/spi_master.h>
+#include "TrinamicsSPIBatch.h"
+
+// Bus used to exchange batches of datagrams with TMC chips
+// A test build can replace the hardware bus with a mock which replays register contents
+class TrinamicsSPIBus
+{
+public:
+    virtual ~TrinamicsSPIBus()
+    {
+    }
+
+    // Check if a chip can be addressed on this bus
+    virtual bool isChipSelectable(int chipIdx) = 0;
+
+    // Send all datagrams in the batch and fill in the responses
+    virtual bool execBatch(TrinamicsSPIBatch& batch) = 0;
+};
+
+// Hardware bus using the ESP32 VSPI peripheral with DMA
+// Chip selects (direct or multiplexed) are driven from pre-computed GPIO set/clear masks
+// in the driver's pre/post transaction callbacks so each datagram gets its own CS frame
+class TrinamicsSPIBusESP32 : public TrinamicsSPIBus
+{
+public:
+    static constexpr int MAX_CHIPS = TrinamicsSPIBatch::MAX_CHIPS;
+    static constexpr int NUM_MUX_PINS = 3;
+    static const int SPI_CLOCK_HZ = 2000000;
+    static const int SPI_MODE = 3;
+    static const int SPI_DMA_CHANNEL = 2;
+
+    TrinamicsSPIBusESP32();
+    ~TrinamicsSPIBusESP32();
+
+    bool setup(int sck, int miso, int mosi, const int* csPins, const int* muxPins, const int* muxCSVals);
+    void deinit();
+
+    virtual bool isChipSelectable(int chipIdx);
+    virtual bool execBatch(TrinamicsSPIBatch& batch);
+
+    // Masks for GPIO set and clear registers (low = GPIO0..31, high = GPIO32..39)
+    struct GpioMasks
+    {
+        uint32_t setLo;
+        uint32_t clrLo;
+        uint32_t setHi;
+        uint32_t clrHi;
+        void clear()
+        {
+            setLo = clrLo = setHi = clrHi = 0;
+        }
+        void addPin(int pin, bool level);
+    };
+    struct ChipSelSeq
+    {
+        bool valid;
+        GpioMasks selMasks;
+        GpioMasks deselMasks;
+    };
+
+private:
+    static void IRAM_ATTR spiPreTransferCb(spi_transaction_t* pTrans);
+    static void IRAM_ATTR spiPostTransferCb(spi_transaction_t* pTrans);
+    static void IRAM_ATTR applyMasks(const GpioMasks& masks);
+
+    // Pins
+    int _csPins[MAX_CHIPS];
+    int _muxPins[NUM_MUX_PINS];
+
+    // Pre-computed chip select sequences
+    ChipSelSeq _chipSelSeqs[MAX_CHIPS];
+
+    // SPI driver
+    bool _busInitialised;
+    spi_device_handle_t _spiDevice;
+    spi_transaction_t _spiTrans[TrinamicsSPIBatch::MAX_DATAGRAMS];
+};
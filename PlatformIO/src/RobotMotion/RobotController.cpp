@@ -17,6 +17,7 @@ RobotController::RobotController()
 {
     // Init
     _pRobot = NULL;
+    _pipelineLow.store(false);
 }
 
 RobotController::~RobotController()
@@ -122,8 +123,12 @@ bool RobotController::isPaused()
 void RobotController::service()
 {
     if (!_pRobot)
+    {
+        _pipelineLow.store(false);
         return;
+    }
     _pRobot->service();
+    _pipelineLow.store(_motionHelper.isPipelineLow());
 }
 
 // Movement commands
@@ -197,6 +202,13 @@ bool RobotController::wasActiveInLastNSeconds(int nSeconds)
     return _pRobot->wasActiveInLastNSeconds(nSeconds);
 }
 
+bool RobotController::runBenchmarks(int iterations, uint32_t& kinematicsCycles, uint32_t& plannerCycles)
+{
+    if (!_pRobot)
+        return false;
+    return _motionHelper.runBenchmarks(iterations, kinematicsCycles, plannerCycles);
+}
+
 String RobotController::getDebugStr()
 {
     return _motionHelper.getDebugStr();
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include "MotionControl/MotionHelper.h"
 
 class RobotBase;
@@ -14,6 +15,9 @@ private:
     RobotBase* _pRobot;
     MotionHelper _motionHelper;
 
+    // Pipeline low state - updated by service() as other tasks read it
+    std::atomic<bool> _pipelineLow;
+
 public:
     RobotController();
     ~RobotController();
@@ -56,5 +60,22 @@ public:
 
     bool wasActiveInLastNSeconds(int nSeconds);
 
+    // Check if motion is close to running out of planned blocks (as of the last call to service -
+    // can be called from any task)
+    bool isPipelineLow()
+    {
+        return _pipelineLow.load(std::memory_order_relaxed);
+    }
+
+    // Micro-benchmarks of kinematics and planning (returns false if the robot isn't idle)
+    bool runBenchmarks(int iterations, uint32_t& kinematicsCycles, uint32_t& plannerCycles);
+
     String getDebugStr();
+
+#ifdef UNIT_TEST
+    MotionHelper* testGetMotionHelper()
+    {
+        return &_motionHelper;
+    }
+#endif
 };
@@ -4,12 +4,11 @@
 #pragma once
 
 #include "RobotBase.h"
+#include "AxisValues.h"
 
-class AxisFloats;
 class AxisPosition;
 class MotionHelper;
 class AxesParams;
-class AxisInt32s;
 
 class RobotSandTableScara : public RobotBase
 {
@@ -5,13 +5,12 @@
 
 #include "Utils.h"
 #include "RobotBase.h"
+#include "AxisValues.h"
 #include "math.h"
 
-class AxisFloats;
 class AxisPosition;
 class MotionHelper;
 class AxesParams;
-class AxisInt32s;
 
 class RobotXYBot : public RobotBase
 {
@@ -5,6 +5,7 @@
 #include <ArduinoLog.h>
 #include "EvaluatorFiles.h"
 #include "RdJson.h"
+#include "FieldSplitter.h"
 #include "../WorkManager.h"
 
 static const char* MODULE_PREFIX = "EvaluatorFiles: ";
@@ -35,7 +36,9 @@ bool EvaluatorFiles::isBusy()
 
 int EvaluatorFiles::getFileTypeFromExtension(String& fileName)
 {
-    String fileExt = FileManager::getFileExtension(fileName);
+    // Compressed files are played as the file they were compressed from
+    String uncompressedName = FileManager::getUncompressedName(fileName);
+    String fileExt = FileManager::getFileExtension(uncompressedName);
     int fileType = FILE_TYPE_UNKNOWN;
     if (fileExt.equalsIgnoreCase("gcode"))
         fileType = FILE_TYPE_GCODE;
@@ -112,21 +115,21 @@ void EvaluatorFiles::service()
     // Check if valid
     if (chunkLen > 0)
     {
-        // Process the line
-        String newLine = (char*)pLine;
-        newLine.replace("\n", "");
-        newLine.replace("\r", "");
-        newLine.trim();
+        // Trim the line (including line endings) and terminate it in place
+        char* pLineBuf = (char*)pLine;
+        StrView line = StrView(pLineBuf, chunkLen).trimmed();
+        const char* pLineStr = line.ptr();
+        pLineBuf[pLineStr - pLineBuf + line.length()] = 0;
 
         // Check for flags (can be in comments or not)
         if (_fileType == FILE_TYPE_THETA_RHO)
         {
-            if (newLine.indexOf("_NO_INTERPOLATE_") >= 0)
+            if (strstr(pLineStr, "_NO_INTERPOLATE_"))
             {
                 Log.notice("%sservice THR Interpolation Off\n", MODULE_PREFIX);
                 _interpolate = false;
             }
-            else if (newLine.indexOf("_INTERPOLATE_") >= 0)
+            else if (strstr(pLineStr, "_INTERPOLATE_"))
             {
                 Log.notice("%sservice THR Interpolation On\n", MODULE_PREFIX);
                 _interpolate = true;
@@ -136,34 +139,37 @@ void EvaluatorFiles::service()
         // Check for comments
         bool isComment = false;
         if (_fileType == FILE_TYPE_THETA_RHO)
-            isComment = newLine.startsWith("#");
+            isComment = line.startsWith("#");
         else if (_fileType == FILE_TYPE_GCODE)
-            isComment = newLine.startsWith(";");
+            isComment = line.startsWith(";");
 
         // Handle non-comments
         if (!isComment)
         {
             bool isValid = true;
-            // Format line if Theta-Rho
+            // Format line if Theta-Rho - theta and rho are split at the first space
+            char thrLineBuf[MAX_THR_LINE_LEN];
             if (_fileType == FILE_TYPE_THETA_RHO)
             {
-                int spacePos = newLine.indexOf(" ");
-                if (spacePos > 0)
-                {
-                    newLine = (_interpolate ? (!_firstValidLineProcessed ? "_THRLINE0_/" : "_THRLINEN_/") : "_THRLINE_/") +
-                             newLine.substring(0,spacePos) + "/" + newLine.substring(spacePos+1);
-                }
-                else
+                FieldSplitter<2> thrFields(pLineStr, " ", false, line.length());
+                StrView theta = thrFields.getField(0);
+                StrView rho = thrFields.getField(1);
+                isValid = false;
+                if ((thrFields.getNumFields() == 2) && !theta.isEmpty())
                 {
-                    isValid = false;
+                    const char* pPrefix = _interpolate ? (!_firstValidLineProcessed ? "_THRLINE0_/" : "_THRLINEN_/") : "_THRLINE_/";
+                    int formattedLen = snprintf(thrLineBuf, sizeof(thrLineBuf), "%s%.*s/%.*s", pPrefix,
+                                (int)theta.length(), theta.ptr(), (int)rho.length(), rho.ptr());
+                    isValid = formattedLen < (int)sizeof(thrLineBuf);
+                    pLineStr = thrLineBuf;
                 }
             }
             // Form the work item if valid
             if (isValid)
             {
-                Log.verbose("%sservice new line %s\n", MODULE_PREFIX, newLine.c_str());
+                Log.verbose("%sservice new line %s\n", MODULE_PREFIX, pLineStr);
                 String retStr;
-                WorkItem workItem(newLine.c_str());
+                WorkItem workItem(pLineStr);
                 _workManager.addWorkItem(workItem, retStr);
                 _firstValidLineProcessed = true;
             }
@@ -172,7 +178,7 @@ void EvaluatorFiles::service()
         {
             if (_fileType == FILE_TYPE_THETA_RHO)
             {
-                if (newLine.indexOf("Sandify") >= 0)
+                if (strstr(pLineStr, "Sandify"))
                 {
                     Log.notice("%sservice THR Interpolation Off\n", MODULE_PREFIX);
                     _interpolate = false;
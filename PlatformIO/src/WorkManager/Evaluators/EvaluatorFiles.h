@@ -56,6 +56,9 @@ private:
     // Settings
     bool _interpolate;
 
+    // Max length of a formatted theta-rho work item
+    static const int MAX_THR_LINE_LEN = 100;
+
 private:
     int getFileTypeFromExtension(String& fileName);
 
@@ -12,6 +12,14 @@
 static const char *MODULE_PREFIX = "EvaluatorGCode: ";
 #endif
 
+bool EvaluatorGCode::isGcode(const char* pCmdStr)
+{
+    while (isspace(*pCmdStr))
+        pCmdStr++;
+    char cmdCh = toupper(*pCmdStr);
+    return ((cmdCh == 'G') || (cmdCh == 'M')) && isdigit(*(pCmdStr + 1));
+}
+
 bool EvaluatorGCode::getCmdNumber(const char* pCmdStr, int& cmdNum)
 {
     // String passed in should start with a G or M
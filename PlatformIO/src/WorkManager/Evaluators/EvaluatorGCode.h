@@ -11,6 +11,8 @@ class EvaluatorGCode
 {
 
 public:
+    // Check if a command is a G or M code (letter immediately followed by a number)
+    static bool isGcode(const char* pCmdStr);
     static bool getCmdNumber(const char* pCmdStr, int& cmdNum);
     static bool getGcodeCmdArgs(const char* pArgStr, RobotCommandArgs& cmdArgs);
     // Interpret GCode G commands
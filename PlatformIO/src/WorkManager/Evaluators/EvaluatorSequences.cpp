@@ -61,30 +61,15 @@ bool EvaluatorSequences::isValid(WorkItem& workItem)
     return rslt;
 }
 
-// Count lines
-int EvaluatorSequences::countLines(String& lines)
+// Split the command list into non-blank lines
+void EvaluatorSequences::splitLines()
 {
-    int lineCount = 0;
-    bool lineBlank = true;
-    const char* pStr = lines.c_str();
-    while(true)
-    {
-        if ((*pStr == '\n') || (*pStr == 0))
-        {
-            if (!lineBlank)
-                lineCount++;
-            lineBlank = true;
-            if (*pStr == 0)
-                break;
-        }
-        else
-        {
-            if (*pStr != '\r')
-                lineBlank = false;
-        }
-        pStr++;
-    }
-    return lineCount;
+    _lines.clear();
+    FieldIter lineIter(_commandList.c_str(), "\r\n", true, _commandList.length());
+    StrView line;
+    while (lineIter.next(line))
+        _lines.push_back(line);
+    _lineCount = _lines.size();
 }
 
 // Process WorkItem
@@ -98,7 +83,7 @@ bool EvaluatorSequences::execWorkItem(WorkItem& workItem)
         _inProgress = true;
         _shuffleMode = _defaultShuffleMode;
         _repeatMode = _defaultRepeatMode;
-        _lineCount = countLines(_commandList);
+        splitLines();
         if (_commandList.indexOf("ShuffleMode") >= 0)
             _shuffleMode = true;
         if (_commandList.indexOf("NoShuffleMode") >= 0)
@@ -109,7 +94,7 @@ bool EvaluatorSequences::execWorkItem(WorkItem& workItem)
             _repeatMode = false;
         _linesDone = 0;
         _reqLineIdx = 0;
-        if (_shuffleMode)
+        if (_shuffleMode && (_lineCount > 0))
             _reqLineIdx = rand() % _lineCount;
         Log.trace("%sexecWorkItem len %d lineCount %d reqLineIdx %d shuffleMode %s repeatMode %s\n", MODULE_PREFIX, 
                 _commandList.length(), _lineCount, _reqLineIdx, _shuffleMode ? "Y" : "N",  _repeatMode ? "Y" : "N");
@@ -130,35 +115,12 @@ void EvaluatorSequences::service()
         return;
         
     // Get required line
-    const char* pCommandList = _commandList.c_str();
-    const char* pStr = pCommandList;
-    int lineStartPos = 0;
-    int sepIdx = 0;
-    bool lineBlank = true;
-    while(true)
-    {
-        if ((*pStr == '\n') || (*pStr == 0))
-        {
-            if (!lineBlank)
-                sepIdx++;
-            if ((sepIdx == _reqLineIdx+1) || (*pStr == 0))
-                break;
-            lineBlank = true;
-            lineStartPos = pStr - pCommandList;
-        }
-        else
-        {
-            if (*pStr != '\r')
-                lineBlank = false;
-        }
-        pStr++;
-    }
-    if (sepIdx == _reqLineIdx+1)
+    if ((_reqLineIdx >= 0) && (_reqLineIdx < _lineCount))
     {
         // Line to process
-        String newCmd = _commandList.substring(lineStartPos, pStr-pCommandList);
-        newCmd.trim();
-        // Separator found so add command
+        String newCmd;
+        _lines[_reqLineIdx].trimmed().toString(newCmd);
+        // Add command
         Log.trace("%sservice reqLineIdx %d cmd %s\n", MODULE_PREFIX, 
                 _reqLineIdx, newCmd.c_str());
         if (newCmd.length() > 0)
@@ -181,10 +143,19 @@ void EvaluatorSequences::service()
             _reqLineIdx = 0;
         if (_shuffleMode)
             _reqLineIdx = rand() % _lineCount;
+
+        // Announce the next entry so the start of it can be read while this one plays
+        if (_inProgress)
+        {
+            String nextCmd;
+            _lines[_reqLineIdx].trimmed().toString(nextCmd);
+            if (nextCmd.length() > 0)
+                _fileManager.chunkedFilePrefetch("", nextCmd);
+        }
     }
     else
     {
-        // Separator not found so stop
+        // Line not found so stop
         _inProgress = false;
         Log.trace("%sservice reqLineIdx %d not found so stopping\n", MODULE_PREFIX, 
                 _reqLineIdx);
@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <vector>
+#include "FieldSplitter.h"
+
 class WorkManager;
 class WorkItem;
 class FileManager;
@@ -41,8 +44,8 @@ public:
     void stop();
     
 private:
-    // Count lines
-    int countLines(String& lines);
+    // Split the command list into non-blank lines
+    void splitLines();
 
     // Full configuration JSON
     String _jsonConfigStr;
@@ -54,6 +57,9 @@ private:
     // List of commands to add to workflow - delimited string
     String _commandList;
 
+    // Lines of the command list (views into _commandList)
+    std::vector<StrView> _lines;
+
     // Busy and current line
     int _inProgress;
     int _reqLineIdx;
@@ -5,7 +5,7 @@
 #include <ArduinoLog.h>
 #include "EvaluatorThetaRhoLine.h"
 #include "RdJson.h"
-#include "Utils.h"
+#include "FieldSplitter.h"
 #include "../WorkManager.h"
 
 // #define THETA_RHO_DEBUG 1
@@ -64,19 +64,19 @@ const char *EvaluatorThetaRhoLine::getConfig()
 bool EvaluatorThetaRhoLine::isValid(WorkItem &workItem)
 {
     // Check if theta-rho
-    String cmdStr = workItem.getString();
-    cmdStr.trim();
-    return cmdStr.startsWith("_THRLINE");
+    const char* pCmdStr = workItem.getCString();
+    while (isspace(*pCmdStr))
+        pCmdStr++;
+    return strncmp(pCmdStr, "_THRLINE", strlen("_THRLINE")) == 0;
 }
 
 // Process WorkItem
 bool EvaluatorThetaRhoLine::execWorkItem(WorkItem &workItem)
 {
     // Extract the details
-    String thetaStr = Utils::getNthField(workItem.getCString(), 1, '/');
-    String rhoStr = Utils::getNthField(workItem.getCString(), 2, '/');
-    double newTheta = atof(thetaStr.c_str());
-    double newRho = atof(rhoStr.c_str());
+    FieldSplitter<THR_LINE_FIELDS> fields(workItem.getCString(), "/");
+    double newTheta = fields.getField(1).toDouble();
+    double newRho = fields.getField(2).toDouble();
 #ifdef THETA_RHO_DEBUG
     Log.trace("%sexecWorkItem %s\n", MODULE_PREFIX,
               workItem.getCString());
@@ -121,27 +121,7 @@ bool EvaluatorThetaRhoLine::execWorkItem(WorkItem &workItem)
     // Must be a _THRLINEN_ then
     double deltaTheta = newTheta - _thetaStartOffset - _prevTheta;
     double absDeltaTheta = abs(deltaTheta);
-    double adaptedStepAngle = _stepAngle;
-    if (_stepAdaptation)
-    {
-        double avgRho = std::max(fabs(newRho), fabs(_prevRho));
-        if (avgRho > 1)
-            avgRho = 1;
-        double maxStepAngle = _stepAngle * 16;
-        if (maxStepAngle > M_PI / 2)
-            maxStepAngle = M_PI / 2;
-        double minStepAngle = _stepAngle / 4;
-        if (avgRho > RHO_AT_DEFAULT_STEP_ANGLE)
-        {
-            adaptedStepAngle = ((avgRho - RHO_AT_DEFAULT_STEP_ANGLE) / (1 - RHO_AT_DEFAULT_STEP_ANGLE)) * 
-                    (minStepAngle - _stepAngle) + _stepAngle;
-        }
-        else
-        {
-            adaptedStepAngle = (avgRho / RHO_AT_DEFAULT_STEP_ANGLE) * 
-                    (_stepAngle - maxStepAngle) + maxStepAngle;
-        }
-    }
+    double adaptedStepAngle = getAdaptedStepAngle(_stepAngle, _stepAdaptation, _prevRho, newRho);
     _thetaInc = deltaTheta >= 0 ? adaptedStepAngle : -adaptedStepAngle;
     double deltaRho = newRho - _prevRho;
     if (absDeltaTheta < adaptedStepAngle)
@@ -230,4 +210,25 @@ void EvaluatorThetaRhoLine::calcXYPos(double theta, double rho, double& x, doubl
 {
     x = sin(theta) * rho * _bedRadiusMM + _centreOffsetX;
     y = cos(theta) * rho * _bedRadiusMM + _centreOffsetY;
-}
\ No newline at end of file
+}
+
+double EvaluatorThetaRhoLine::getAdaptedStepAngle(double stepAngle, bool stepAdaptation, double prevRho, double newRho)
+{
+    // Smaller steps further out where the same angle is a longer move
+    if (!stepAdaptation)
+        return stepAngle;
+    double avgRho = std::max(fabs(newRho), fabs(prevRho));
+    if (avgRho > 1)
+        avgRho = 1;
+    double maxStepAngle = stepAngle * 16;
+    if (maxStepAngle > M_PI / 2)
+        maxStepAngle = M_PI / 2;
+    double minStepAngle = stepAngle / 4;
+    if (avgRho > RHO_AT_DEFAULT_STEP_ANGLE)
+    {
+        return ((avgRho - RHO_AT_DEFAULT_STEP_ANGLE) / (1 - RHO_AT_DEFAULT_STEP_ANGLE)) * 
+                (minStepAngle - stepAngle) + stepAngle;
+    }
+    return (avgRho / RHO_AT_DEFAULT_STEP_ANGLE) * 
+            (stepAngle - maxStepAngle) + maxStepAngle;
+}
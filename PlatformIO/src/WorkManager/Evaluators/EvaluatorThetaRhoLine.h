@@ -30,10 +30,13 @@ public:
     // Control
     void stop();
 
+    // Angle step used to interpolate a line between points at these rho values
+    static double getAdaptedStepAngle(double stepAngle, bool stepAdaptation, double prevRho, double newRho);
+
 private:
     // Config
-    const double DEFAULT_STEP_ANGLE = M_PI / 64;
-    const double RHO_AT_DEFAULT_STEP_ANGLE = 0.5;
+    static constexpr double DEFAULT_STEP_ANGLE = M_PI / 64;
+    static constexpr double RHO_AT_DEFAULT_STEP_ANGLE = 0.5;
     double _stepAngle;
     bool _stepAdaptation;
     bool _continueFromPrevious;
@@ -62,6 +65,9 @@ private:
     // Process steps per service
     static const int PROCESS_STEPS_PER_SERVICE = 20;
 
+    // Fields of a work item - _THRLINEx_/theta/rho
+    static const int THR_LINE_FIELDS = 3;
+
     void calcXYPos(double theta, double rho, double& x, double& y);
 
 };
\ No newline at end of file
@@ -0,0 +1,520 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+#include "PatternIndexer.h"
+#include <ArduinoLog.h>
+#include <algorithm>
+#include "FileManager.h"
+#include "RdJson.h"
+#include "FieldSplitter.h"
+#include "RobotCommandArgs.h"
+#include "Evaluators/EvaluatorGCode.h"
+#include "Evaluators/EvaluatorThetaRhoLine.h"
+#include "../RobotMotion/MotionControl/MotionHelper.h"
+#include "../RobotMotion/MotionControl/MotionBlock.h"
+
+static const char* MODULE_PREFIX = "PatternIndexer: ";
+
+PatternIndexer::PatternIndexer(FileManager& fileManager) :
+            _fileManager(fileManager)
+{
+    _lastChangeCount = 0;
+    _scanNeeded = true;
+    _listingFiles = false;
+    _paused.store(false);
+    _fileLen = -1;
+    _filePos = 0;
+    _fileCompressed = false;
+    _lineLen = 0;
+    _config._junctionDeviation = MotionHelper::junctionDeviation_default;
+    _config._stepAngle = M_PI / 64;
+    _config._stepAdaptation = true;
+    _config._bedRadiusMM = 0;
+    _config._centreOffsetX = 0;
+    _config._centreOffsetY = 0;
+    _configValid = false;
+    _newConfigPending = false;
+    _configMutex = xSemaphoreCreateMutex();
+    statsStart(true);
+
+    // Steps run on the file system task
+    _fileManager.setBackgroundJob([this]() { return backgroundStep(); });
+}
+
+void PatternIndexer::setConfig(const char* robotConfigJSON, const char* evaluatorConfig, const char* robotAttributes)
+{
+    // Planner limits
+    IndexConfig newConfig;
+    String robotGeom = RdJson::getString("robotGeom", "{}", robotConfigJSON);
+    newConfig._axesParams.clearAxes();
+    String axisJSON;
+    for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
+        newConfig._axesParams.configureAxis(robotGeom.c_str(), axisIdx, axisJSON);
+    newConfig._junctionDeviation = float(RdJson::getDouble("junctionDeviation", MotionHelper::junctionDeviation_default, robotGeom.c_str()));
+
+    // THR interpolation and bed size as in EvaluatorThetaRhoLine
+    newConfig._stepAngle = AxisUtils::d2r(RdJson::getDouble("thrStepDegs", AxisUtils::r2d(M_PI / 64), evaluatorConfig));
+    newConfig._stepAdaptation = RdJson::getLong("thrStepAdaptation", 1, evaluatorConfig) != 0;
+    double sizeX = RdJson::getDouble("sizeX", 0, robotAttributes);
+    double sizeY = RdJson::getDouble("sizeY", 0, robotAttributes);
+    newConfig._bedRadiusMM = std::min(sizeX, sizeY) / 2;
+    newConfig._centreOffsetX = sizeX / 2 - RdJson::getDouble("originX", 0, robotAttributes);
+    newConfig._centreOffsetY = sizeY / 2 - RdJson::getDouble("originY", 0, robotAttributes);
+
+    // Used from the next file (metadata already made with other settings is kept)
+    xSemaphoreTake(_configMutex, portMAX_DELAY);
+    _newConfig = newConfig;
+    _newConfigPending = true;
+    xSemaphoreGive(_configMutex);
+    _fileManager.backgroundJobWake();
+}
+
+void PatternIndexer::setPaused(bool paused)
+{
+    // Steps stop while paused so wake when unpaused
+    if (_paused.exchange(paused) && !paused)
+        _fileManager.backgroundJobWake();
+}
+
+bool PatternIndexer::backgroundStep()
+{
+    if (_paused.load())
+        return false;
+
+    // Read a block of the file in progress
+    if (_fileLen >= 0)
+    {
+        indexNextBlock();
+        return true;
+    }
+
+    // List a few files in the folder being scanned
+    if (_listingFiles)
+    {
+        bool rslt = false;
+        if (!_fileManager.backgroundFileListStep(rslt))
+            return true;
+        _listingFiles = false;
+        if (_pendingFiles.size() > 0)
+            Log.trace("%sfound %d files to index\n", MODULE_PREFIX, (int)_pendingFiles.size());
+        return true;
+    }
+
+    // Nothing is indexed until there is a config
+    takeNewConfig();
+    if (!_configValid)
+        return false;
+
+    // Next file
+    if (!_pendingFiles.empty())
+    {
+        String filename = _pendingFiles.back();
+        _pendingFiles.pop_back();
+        startFile(filename);
+        return true;
+    }
+
+    // Look for files without metadata when files have changed (or there were more than fitted
+    // in the pending list)
+    uint32_t changeCount = _fileManager.getFileListChangeCount();
+    if (!_scanNeeded && (changeCount == _lastChangeCount))
+        return false;
+    _lastChangeCount = changeCount;
+
+    // Pattern files in the root folder of the default file system
+    _scanNeeded = false;
+    _listingFiles = _fileManager.backgroundFileListStart("", "/",
+                [this](const String& filename, int fileSize, const String& metaJson) {
+                    listedFile(filename, fileSize, metaJson);
+                });
+    return _listingFiles;
+}
+
+void PatternIndexer::listedFile(const String& filename, int fileSize, const String& metaJson)
+{
+    // Pattern files without metadata (that haven't failed at this length)
+    if (metaJson.length() > 0)
+        return;
+    String name = filename;
+    String uncompressedName = FileManager::getUncompressedName(name);
+    String fileExt = FileManager::getFileExtension(uncompressedName);
+    if (!fileExt.equalsIgnoreCase("thr") && !fileExt.equalsIgnoreCase("gcode"))
+        return;
+    String failedKey = filename + "/" + String(fileSize);
+    if (std::find(_failedFiles.begin(), _failedFiles.end(), failedKey) != _failedFiles.end())
+        return;
+
+    // Files that don't fit in the pending list are found by another scan
+    if ((int)_pendingFiles.size() >= MAX_PENDING_FILES)
+    {
+        _scanNeeded = true;
+        return;
+    }
+    _pendingFiles.push_back(filename);
+}
+
+void PatternIndexer::fileFailed(const String& filename, int fileLen)
+{
+    // Not tried again this session unless the file changes
+    Log.trace("%sfailed to index %s\n", MODULE_PREFIX, filename.c_str());
+    _failedFiles.push_back(filename + "/" + String(fileLen));
+    _fileLen = -1;
+}
+
+void PatternIndexer::startFile(const String& filename)
+{
+    // Get length (metadata is only valid for this length)
+    int fileLen = 0;
+    if (!_fileManager.getFileInfo("", filename, fileLen))
+        return;
+    _filename = filename;
+    _fileLen = fileLen;
+    _filePos = 0;
+    _fileCompressed = FileManager::isCompressedFile(_filename);
+    _decoder.reset();
+    _lineLen = 0;
+    String uncompressedName = FileManager::getUncompressedName(_filename);
+    statsStart(FileManager::getFileExtension(uncompressedName).equalsIgnoreCase("thr"));
+}
+
+void PatternIndexer::indexNextBlock()
+{
+    uint8_t readBuf[READ_BLOCK_LEN];
+    int readLen = 0;
+    if (!_fileManager.readFileBlock("", _filename, _filePos, readBuf, READ_BLOCK_LEN, readLen))
+    {
+        fileFailed(_filename, _fileLen);
+        return;
+    }
+    _filePos += readLen;
+    bool endOfFile = (readLen < READ_BLOCK_LEN) || (_filePos >= _fileLen);
+
+    // Decode compressed files (and get the rest of the output at the end)
+    if (_fileCompressed)
+    {
+        uint8_t decodeBuf[READ_BLOCK_LEN];
+        int inPos = 0;
+        while (true)
+        {
+            size_t inUsed = 0;
+            size_t outLen = _decoder.decode(readBuf + inPos, readLen - inPos, inUsed, decodeBuf, sizeof(decodeBuf));
+            inPos += inUsed;
+            addBytes(decodeBuf, outLen);
+            if ((outLen == 0) && (inPos >= readLen))
+                break;
+        }
+    }
+    else
+    {
+        addBytes(readBuf, readLen);
+    }
+    if (!endOfFile)
+        return;
+
+    // Last line may not have a line ending
+    if (_lineLen > 0)
+    {
+        _lineBuf[std::min(_lineLen, MAX_LINE_LEN - 1)] = 0;
+        statsAddLine(_lineBuf);
+    }
+    String metaJson;
+    statsGetJSON(metaJson);
+    if (!_fileManager.setFileMeta("", _filename, _fileLen, metaJson))
+    {
+        fileFailed(_filename, _fileLen);
+        return;
+    }
+    Log.notice("%sindexed %s %s\n", MODULE_PREFIX, _filename.c_str(), metaJson.c_str());
+    _fileLen = -1;
+}
+
+void PatternIndexer::addBytes(const uint8_t* pBytes, int len)
+{
+    // Split into lines (the rest of a line that's too long is ignored)
+    for (int byteIdx = 0; byteIdx < len; byteIdx++)
+    {
+        char ch = pBytes[byteIdx];
+        if (ch == '\n')
+        {
+            _lineBuf[std::min(_lineLen, MAX_LINE_LEN - 1)] = 0;
+            statsAddLine(_lineBuf);
+            _lineLen = 0;
+            continue;
+        }
+        if (ch == '\r')
+            continue;
+        if (_lineLen < MAX_LINE_LEN - 1)
+            _lineBuf[_lineLen] = ch;
+        _lineLen++;
+    }
+}
+
+void PatternIndexer::takeNewConfig()
+{
+    xSemaphoreTake(_configMutex, portMAX_DELAY);
+    if (_newConfigPending)
+    {
+        _config = _newConfig;
+        _configValid = true;
+        _newConfigPending = false;
+    }
+    xSemaphoreGive(_configMutex);
+}
+
+void PatternIndexer::statsStart(bool isThetaRho)
+{
+    takeNewConfig();
+    _isThetaRho = isThetaRho;
+    _lineCount = 0;
+    _vertexCount = 0;
+    _boundsValid = false;
+    _minX = _maxX = _minY = _maxY = 0;
+    _maxRho = 0;
+    _pathLenMM = 0;
+    _estSecs = 0;
+    _thrInterpolate = true;
+    _thrPrevValid = false;
+    _thrPrevTheta = 0;
+    _thrPrevRho = 0;
+    _gcodeRelative = false;
+    _posValid = false;
+    _curX = _curY = 0;
+    _moveValid = false;
+    _moveLenMM = 0;
+    _moveUnitX = _moveUnitY = 0;
+    _moveFeedMMps = 0;
+    _moveAccMMps2 = 0;
+    _moveEntryMMps = 0;
+}
+
+void PatternIndexer::statsAddLine(const char* pLine)
+{
+    _lineCount++;
+    StrView line = StrView(pLine, strlen(pLine)).trimmed();
+    if (line.isEmpty())
+        return;
+
+    // G-code (comments start with ;)
+    if (!_isThetaRho)
+    {
+        if (!line.startsWith(";"))
+            addGcode(line.ptr());
+        return;
+    }
+
+    // THR flags as handled by EvaluatorFiles
+    if (strstr(pLine, "_NO_INTERPOLATE_"))
+        _thrInterpolate = false;
+    else if (strstr(pLine, "_INTERPOLATE_"))
+        _thrInterpolate = true;
+    if (line.startsWith("#"))
+    {
+        if (strstr(pLine, "Sandify"))
+            _thrInterpolate = false;
+        return;
+    }
+
+    // Theta and rho
+    FieldSplitter<2> thrFields(line.ptr(), " ", false, line.length());
+    if ((thrFields.getNumFields() != 2) || thrFields.getField(0).isEmpty())
+        return;
+    addThetaRho(thrFields.getField(0).toDouble(), thrFields.getField(1).toDouble());
+}
+
+void PatternIndexer::statsGetJSON(String& metaJson)
+{
+    // Finish the last move
+    if (_moveValid)
+        finishMove(0);
+
+    char jsonStr[300];
+    int jsonLen = snprintf(jsonStr, sizeof(jsonStr), "{\"lines\":%d,\"vertices\":%d,\"minX\":%0.1f,\"maxX\":%0.1f,"
+                "\"minY\":%0.1f,\"maxY\":%0.1f,\"pathMM\":%0.0f,\"estSecs\":%0.1f",
+                _lineCount, _vertexCount, _minX, _maxX, _minY, _maxY, _pathLenMM, _estSecs);
+    if (_isThetaRho)
+        snprintf(jsonStr + jsonLen, sizeof(jsonStr) - jsonLen, ",\"maxRho\":%0.4f}", _maxRho);
+    else
+        snprintf(jsonStr + jsonLen, sizeof(jsonStr) - jsonLen, "}");
+    metaJson = jsonStr;
+}
+
+void PatternIndexer::addThetaRho(double theta, double rho)
+{
+    _vertexCount++;
+    if (fabs(rho) > _maxRho)
+        _maxRho = fabs(rho);
+
+    // Straight move (or the first point which is moved to from wherever the ball is)
+    float x = 0, y = 0;
+    if (!_thrInterpolate || !_thrPrevValid)
+    {
+        calcXYPos(theta, rho, x, y);
+        addMove(x, y, 0);
+        _thrPrevTheta = theta;
+        _thrPrevRho = rho;
+        _thrPrevValid = true;
+        return;
+    }
+
+    // Interpolate as EvaluatorThetaRhoLine does
+    double deltaTheta = theta - _thrPrevTheta;
+    double absDeltaTheta = fabs(deltaTheta);
+    double adaptedStepAngle = EvaluatorThetaRhoLine::getAdaptedStepAngle(_config._stepAngle, _config._stepAdaptation, _thrPrevRho, rho);
+    double thetaInc = deltaTheta >= 0 ? adaptedStepAngle : -adaptedStepAngle;
+    double rhoInc = rho - _thrPrevRho;
+    int interpolateSteps = 1;
+    if (absDeltaTheta < adaptedStepAngle)
+    {
+        thetaInc = deltaTheta;
+    }
+    else
+    {
+        interpolateSteps = int(floor(absDeltaTheta / adaptedStepAngle));
+        rhoInc = rhoInc * adaptedStepAngle / absDeltaTheta;
+    }
+    double curTheta = _thrPrevTheta;
+    double curRho = _thrPrevRho;
+    for (int stepIdx = 0; stepIdx < interpolateSteps; stepIdx++)
+    {
+        curTheta += thetaInc;
+        curRho += rhoInc;
+        calcXYPos(curTheta, curRho, x, y);
+        addMove(x, y, 0);
+    }
+    _thrPrevTheta = theta;
+    _thrPrevRho = rho;
+}
+
+void PatternIndexer::addGcode(const char* pLine)
+{
+    // Moves (G0 and G1) and absolute/relative mode
+    int cmdNum = 0;
+    if ((toupper(*pLine) != 'G') || !EvaluatorGCode::getCmdNumber(pLine, cmdNum))
+        return;
+    if ((cmdNum == 90) || (cmdNum == 91))
+        _gcodeRelative = cmdNum == 91;
+    if ((cmdNum != 0) && (cmdNum != 1))
+        return;
+    const char* pArgsStr = strstr(pLine, " ");
+    if (!pArgsStr)
+        return;
+    RobotCommandArgs cmdArgs;
+    EvaluatorGCode::getGcodeCmdArgs(pArgsStr + 1, cmdArgs);
+    if (!cmdArgs.isValid(0) && !cmdArgs.isValid(1))
+        return;
+    _vertexCount++;
+    float x = _gcodeRelative ? _curX : 0;
+    float y = _gcodeRelative ? _curY : 0;
+    if (cmdArgs.isValid(0))
+        x += cmdArgs.getValMM(0);
+    else if (!_gcodeRelative)
+        x = _curX;
+    if (cmdArgs.isValid(1))
+        y += cmdArgs.getValMM(1);
+    else if (!_gcodeRelative)
+        y = _curY;
+    // Rapid moves aren't limited by the feedrate
+    addMove(x, y, ((cmdNum == 1) && cmdArgs.isFeedrateValid()) ? cmdArgs.getFeedrate() : 0);
+}
+
+void PatternIndexer::addMove(float x, float y, float feedMMps)
+{
+    // Bounds
+    if (!_boundsValid || (x < _minX))
+        _minX = x;
+    if (!_boundsValid || (x > _maxX))
+        _maxX = x;
+    if (!_boundsValid || (y < _minY))
+        _minY = y;
+    if (!_boundsValid || (y > _maxY))
+        _maxY = y;
+    _boundsValid = true;
+
+    // The start position isn't known so the first point is the start
+    if (!_posValid)
+    {
+        _curX = x;
+        _curY = y;
+        _posValid = true;
+        return;
+    }
+    float deltaX = x - _curX;
+    float deltaY = y - _curY;
+    float moveLenMM = sqrtf(deltaX * deltaX + deltaY * deltaY);
+    _curX = x;
+    _curY = y;
+    if (moveLenMM < MotionBlock::MINIMUM_MOVE_DIST_MM)
+        return;
+    _pathLenMM += moveLenMM;
+
+    // Speed and acceleration limited by each axis as in the planner
+    float unitVec[2] = { deltaX / moveLenMM, deltaY / moveLenMM };
+    float moveFeedMMps = (feedMMps > 0) ? feedMMps : 1e8;
+    float moveAccMMps2 = 1e8;
+    for (int axisIdx = 0; axisIdx < 2; axisIdx++)
+    {
+        float unitVecAbs = fabsf(unitVec[axisIdx]);
+        if (unitVecAbs < 1e-6f)
+            continue;
+        moveFeedMMps = fminf(moveFeedMMps, _config._axesParams.getMaxSpeed(axisIdx) / unitVecAbs);
+        moveAccMMps2 = fminf(moveAccMMps2, _config._axesParams.getMaxAccel(axisIdx) / unitVecAbs);
+    }
+
+    // Junction speed with the previous move (junction deviation)
+    float entryMMps = 0;
+    if (_moveValid)
+    {
+        float cosTheta = -(_moveUnitX * unitVec[0] + _moveUnitY * unitVec[1]);
+        float junctionMMps = 0;
+        if (cosTheta < 0.95F)
+        {
+            junctionMMps = fminf(_moveFeedMMps, moveFeedMMps);
+            if (cosTheta > -0.95F)
+            {
+                float accMMps2 = fminf(moveAccMMps2, _moveAccMMps2);
+                float sinThetaD2 = sqrtf(0.5F * (1.0F - cosTheta));
+                junctionMMps = fminf(junctionMMps, sqrtf(accMMps2 * _config._junctionDeviation * sinThetaD2 / (1.0F - sinThetaD2)));
+            }
+        }
+        entryMMps = finishMove(junctionMMps);
+    }
+    _moveValid = true;
+    _moveLenMM = moveLenMM;
+    _moveUnitX = unitVec[0];
+    _moveUnitY = unitVec[1];
+    _moveFeedMMps = moveFeedMMps;
+    _moveAccMMps2 = moveAccMMps2;
+    _moveEntryMMps = entryMMps;
+}
+
+float PatternIndexer::finishMove(float exitMMps)
+{
+    // Trapezoidal profile - exit speed limited to what can be reached and entry speed to what can
+    // be slowed from (as the planner's forward and reverse passes but with one move of lookahead)
+    float accMMps2 = _moveAccMMps2;
+    float lenMM = _moveLenMM;
+    float entryMMps = _moveEntryMMps;
+    exitMMps = fminf(exitMMps, sqrtf(entryMMps * entryMMps + 2 * accMMps2 * lenMM));
+    entryMMps = fminf(entryMMps, sqrtf(exitMMps * exitMMps + 2 * accMMps2 * lenMM));
+    float maxMMps = _moveFeedMMps;
+    float accelDistMM = (maxMMps * maxMMps - entryMMps * entryMMps) / (2 * accMMps2);
+    float decelDistMM = (maxMMps * maxMMps - exitMMps * exitMMps) / (2 * accMMps2);
+    if (accelDistMM + decelDistMM <= lenMM)
+    {
+        _estSecs += (maxMMps - entryMMps) / accMMps2 + (maxMMps - exitMMps) / accMMps2 +
+                    (lenMM - accelDistMM - decelDistMM) / maxMMps;
+    }
+    else
+    {
+        float peakMMps = sqrtf((2 * accMMps2 * lenMM + entryMMps * entryMMps + exitMMps * exitMMps) / 2);
+        _estSecs += (peakMMps - entryMMps) / accMMps2 + (peakMMps - exitMMps) / accMMps2;
+    }
+    _moveValid = false;
+    return exitMMps;
+}
+
+void PatternIndexer::calcXYPos(double theta, double rho, float& x, float& y)
+{
+    x = sin(theta) * rho * _config._bedRadiusMM + _config._centreOffsetX;
+    y = cos(theta) * rho * _config._bedRadiusMM + _config._centreOffsetY;
+}
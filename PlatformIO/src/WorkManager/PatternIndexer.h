@@ -0,0 +1,123 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+#include <atomic>
+#include "../RobotMotion/AxesParams.h"
+#include "HeatshrinkDecoder.h"
+
+class FileManager;
+
+// Pattern Indexer - scans THR and G-code files (including compressed ones) when files change
+// and stores their metadata with FileManager::setFileMeta so it is included in file listings:
+// line and vertex count, bounds (mm), max rho (THR), path length (mm) and an estimated run time.
+// The run time comes from the axis speed and acceleration limits and the junction deviation in
+// the robot config, with the same limits per move and at junctions as the planner (junction
+// deviation mode) - it doesn't include homing, and THR files are assumed to start from their
+// first point. Indexing is the FileManager background job so it runs on the file system task
+// a block (or a few folder entries) at a time when that task is otherwise idle. It is paused by
+// the WorkManager while there is work queued or an evaluator is busy (e.g. a pattern playing)
+class PatternIndexer
+{
+public:
+    PatternIndexer(FileManager& fileManager);
+
+    // Config - robotConfigJSON for the planner settings, evaluator config for THR interpolation
+    // and robot attributes for the bed size (indexing starts once this has been set)
+    void setConfig(const char* robotConfigJSON, const char* evaluatorConfig, const char* robotAttributes);
+
+    // Pause (e.g. while a pattern is being run) - indexing carries on from where it was when
+    // unpaused
+    void setPaused(bool paused);
+
+    // Statistics for a file - lines are added in order and the result is a JSON object
+    void statsStart(bool isThetaRho);
+    void statsAddLine(const char* pLine);
+    void statsGetJSON(String& metaJson);
+
+private:
+    FileManager& _fileManager;
+
+    // A block of the file is read in each step
+    static const int READ_BLOCK_LEN = 256;
+    static const int MAX_LINE_LEN = 100;
+    static const int MAX_PENDING_FILES = 20;
+
+    // Files to index - files which couldn't be indexed (with their length) aren't tried again
+    // until they change
+    std::vector<String> _pendingFiles;
+    std::vector<String> _failedFiles;
+    uint32_t _lastChangeCount;
+    bool _scanNeeded;
+    bool _listingFiles;
+    std::atomic<bool> _paused;
+
+    // File in progress
+    String _filename;
+    int _fileLen;
+    int _filePos;
+    bool _fileCompressed;
+    HeatshrinkDecoder _decoder;
+    char _lineBuf[MAX_LINE_LEN];
+    int _lineLen;
+
+    // Config - set on the caller's task and taken between files (under the mutex)
+    struct IndexConfig
+    {
+        AxesParams _axesParams;
+        float _junctionDeviation;
+        double _stepAngle;
+        bool _stepAdaptation;
+        double _bedRadiusMM;
+        double _centreOffsetX;
+        double _centreOffsetY;
+    };
+    IndexConfig _config;
+    bool _configValid;
+    IndexConfig _newConfig;
+    bool _newConfigPending;
+    SemaphoreHandle_t _configMutex;
+
+    // Statistics
+    bool _isThetaRho;
+    int _lineCount;
+    int _vertexCount;
+    bool _boundsValid;
+    float _minX, _maxX, _minY, _maxY;
+    double _maxRho;
+    double _pathLenMM;
+    double _estSecs;
+
+    // THR and G-code state
+    bool _thrInterpolate;
+    bool _thrPrevValid;
+    double _thrPrevTheta;
+    double _thrPrevRho;
+    bool _gcodeRelative;
+
+    // Move in progress for the time estimate (waits for the next move to find the exit speed)
+    bool _posValid;
+    float _curX, _curY;
+    bool _moveValid;
+    float _moveLenMM;
+    float _moveUnitX, _moveUnitY;
+    float _moveFeedMMps;
+    float _moveAccMMps2;
+    float _moveEntryMMps;
+
+    bool backgroundStep();
+    void takeNewConfig();
+    void listedFile(const String& filename, int fileSize, const String& metaJson);
+    void fileFailed(const String& filename, int fileLen);
+    void startFile(const String& filename);
+    void indexNextBlock();
+    void addBytes(const uint8_t* pBytes, int len);
+    void addThetaRho(double theta, double rho);
+    void addGcode(const char* pLine);
+    void addMove(float x, float y, float feedMMps);
+    float finishMove(float exitMMps);
+    void calcXYPos(double theta, double rho, float& x, float& y);
+};
@@ -0,0 +1,120 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+// Lock-free multi-producer single-consumer queue of command strings. Network tasks (web server
+// and MQTT callbacks) add to it and return immediately, and the main loop is the only consumer.
+// Each slot has a sequence number (bounded queue from D. Vyukov) - a producer claims a slot
+// with a compare-and-swap on the add position and publishes it by setting the sequence number,
+// the consumer doesn't need any read-modify-write operations
+// The strings are copied to the heap by the producer and freed by the consumer
+class WorkItemIngressQueue
+{
+public:
+    // Must be a power of 2
+    static const uint32_t QUEUE_SLOTS = 16;
+
+    WorkItemIngressQueue()
+    {
+        for (uint32_t i = 0; i < QUEUE_SLOTS; i++)
+        {
+            _slots[i]._seq.store(i, std::memory_order_relaxed);
+            _slots[i]._pStr = NULL;
+        }
+        _addPos.store(0, std::memory_order_relaxed);
+        _getPos = 0;
+    }
+
+    ~WorkItemIngressQueue()
+    {
+        char* pStr = NULL;
+        while ((pStr = get()) != NULL)
+            release(pStr);
+    }
+
+    // Add (any task) - returns false if the queue is full
+    bool add(const char* pCmdStr)
+    {
+        // Claim a slot
+        uint32_t pos = _addPos.load(std::memory_order_relaxed);
+        Slot* pSlot = NULL;
+        while (true)
+        {
+            pSlot = &_slots[pos & (QUEUE_SLOTS - 1)];
+            int32_t diff = (int32_t)(pSlot->_seq.load(std::memory_order_acquire) - pos);
+            if (diff == 0)
+            {
+                if (_addPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                // Slot not yet consumed so full
+                return false;
+            }
+            else
+            {
+                // Another producer got there first
+                pos = _addPos.load(std::memory_order_relaxed);
+            }
+        }
+
+        // Copy the string and publish the slot
+        size_t strLen = strlen(pCmdStr);
+        char* pStr = new char[strLen + 1];
+        memcpy(pStr, pCmdStr, strLen + 1);
+        pSlot->_pStr = pStr;
+        pSlot->_seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Next string without removing it (consumer only) - NULL if empty
+    const char* peek()
+    {
+        Slot* pSlot = &_slots[_getPos & (QUEUE_SLOTS - 1)];
+        if (pSlot->_seq.load(std::memory_order_acquire) != _getPos + 1)
+            return NULL;
+        return pSlot->_pStr;
+    }
+
+    // Remove the next string (consumer only) - NULL if empty, otherwise must be passed to release()
+    char* get()
+    {
+        Slot* pSlot = &_slots[_getPos & (QUEUE_SLOTS - 1)];
+        if (pSlot->_seq.load(std::memory_order_acquire) != _getPos + 1)
+            return NULL;
+        char* pStr = pSlot->_pStr;
+        pSlot->_pStr = NULL;
+        // Slot free for the producers' next pass round the queue
+        pSlot->_seq.store(_getPos + QUEUE_SLOTS, std::memory_order_release);
+        _getPos++;
+        return pStr;
+    }
+
+    void release(char* pStr)
+    {
+        delete [] pStr;
+    }
+
+    // Check if empty (consumer only)
+    bool isEmpty()
+    {
+        return peek() == NULL;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<uint32_t> _seq;
+        char* _pStr;
+    };
+    Slot _slots[QUEUE_SLOTS];
+
+    // Position of the next add (shared by producers) and the next get (consumer only)
+    std::atomic<uint32_t> _addPos;
+    uint32_t _getPos;
+};
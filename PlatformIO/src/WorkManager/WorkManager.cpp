@@ -7,6 +7,8 @@
 #include "RestAPISystem.h"
 #include "Evaluators/EvaluatorGCode.h"
 #include "RobotConfigurations.h"
+#include "CommandPathTiming.h"
+#include "xtensa/core-macros.h"
 
 static const char* MODULE_PREFIX = "WorkManager: ";
 
@@ -27,10 +29,16 @@ WorkManager::WorkManager(ConfigBase& mainConfig,
             _evaluatorPatterns(fileManager, *this),
             _evaluatorSequences(fileManager, *this),
             _evaluatorFiles(fileManager, *this),
-            _evaluatorThetaRhoLine(*this)
+            _evaluatorThetaRhoLine(*this),
+            _patternIndexer(fileManager)
 {
     _statusReportLastCheck = 0;
     _statusLastHashVal = 0;
+    _benchmarkState.store(BENCHMARK_IDLE);
+    _benchmarkMutex = xSemaphoreCreateMutex();
+    _benchmarkIterations = 0;
+    _benchmarkIterationsDone = 0;
+    _benchmarkKinematicsCycles = _benchmarkPlannerCycles = _benchmarkGcodeCycles = _benchmarkJsonCycles = 0;
 #ifdef DEBUG_WORK_ITEM_SERVICE
     _debugLastWorkServiceMs = 0;
 #endif
@@ -87,7 +95,7 @@ bool WorkManager::canAcceptWorkItem()
 
 bool WorkManager::queueIsEmpty()
 {
-    return _workItemQueue.isEmpty();
+    return _workItemQueue.isEmpty() && _ingressQueue.isEmpty();
 }
 
 void WorkManager::getRobotConfig(String &respStr)
@@ -159,6 +167,7 @@ void WorkManager::processSingle(const char *pCmdStr, String &retStr)
     {
         _robotController.stop();
         _workItemQueue.clear();
+        _ingressHeld.clear();
         evaluatorsStop();
         retStr = okRslt;
     }
@@ -171,7 +180,11 @@ void WorkManager::processSingle(const char *pCmdStr, String &retStr)
             Log.trace("%sprocessSingle add %s\n", MODULE_PREFIX, 
                         pCmdStr);
 #endif
-            bool rslt = _workItemQueue.add(pCmdStr);
+            bool rslt = false;
+            {
+                INSTRUMENT_COMMAND_PATH_SCOPE(STAGE_QUEUE)
+                rslt = _workItemQueue.add(pCmdStr);
+            }
             if (!rslt)
             {
                 retStr = "{\"rslt\":\"busy\"}";
@@ -186,6 +199,65 @@ void WorkManager::processSingle(const char *pCmdStr, String &retStr)
     // Log.verbose("%sprocSingle rslt %s\n", MODULE_PREFIX, retStr.c_str());
 }
 
+bool WorkManager::isImmediateCommand(const char *pCmdStr)
+{
+    static const char* immediateCmds[] = { "pause", "sleep", "resume", "playpause", "stop" };
+    for (const char* pImmediateCmd : immediateCmds)
+        if (strcasecmp(pCmdStr, pImmediateCmd) == 0)
+            return true;
+    return false;
+}
+
+void WorkManager::addWorkItemFromTask(const char* pCmdStr, String &retStr)
+{
+    // Only the main loop touches the work item queue and robot so just hand over the command
+    if (!_ingressQueue.add(pCmdStr))
+    {
+        retStr = "{\"rslt\":\"busy\"}";
+        return;
+    }
+    retStr = "{\"rslt\":\"ok\"}";
+}
+
+void WorkManager::serviceIngress()
+{
+    // Items held back while the work item queue was full go first (in order)
+    while (!_ingressHeld.empty() && !_workItemQueue.isFull())
+    {
+        String cmdStr = _ingressHeld.front();
+        _ingressHeld.erase(_ingressHeld.begin());
+        addIngressItem(cmdStr.c_str());
+    }
+
+    // Immediate commands (like stop) are done straight away - others are held back in order
+    // while the work item queue is full (until the held list is full)
+    for (uint32_t itemIdx = 0; itemIdx < WorkItemIngressQueue::QUEUE_SLOTS; itemIdx++)
+    {
+        const char* pCmdStr = _ingressQueue.peek();
+        if (!pCmdStr)
+            break;
+        bool holdBack = !isImmediateCommand(pCmdStr) && (_workItemQueue.isFull() || !_ingressHeld.empty());
+        if (holdBack && ((int)_ingressHeld.size() >= INGRESS_HELD_MAX))
+            break;
+        char* pStr = _ingressQueue.get();
+        if (holdBack)
+            _ingressHeld.push_back(pStr);
+        else
+            addIngressItem(pStr);
+        _ingressQueue.release(pStr);
+    }
+}
+
+void WorkManager::addIngressItem(const char* pCmdStr)
+{
+    // The task which added the item has already had its response
+    WorkItem workItem(pCmdStr);
+    String retStr;
+    addWorkItem(workItem, retStr);
+    if (retStr.indexOf("\"ok\"") < 0)
+        Log.notice("%saddIngressItem %s failed %s\n", MODULE_PREFIX, pCmdStr, retStr.c_str());
+}
+
 void WorkManager::addWorkItem(WorkItem& workItem, String &retStr, int cmdIdx)
 {
     // Handle the case of a single string
@@ -355,23 +427,41 @@ void WorkManager::service()
     }
 #endif
 
+    // Commands from other tasks
+    serviceIngress();
+
     // Pump the workflow here
     // Check if the RobotController can accept more
     if (_robotController.canAcceptCommand())
     {
         // Peek at next work item
         WorkItem workItem;
-        bool rslt = _workItemQueue.peek(workItem);
+        bool rslt = false;
+        {
+            INSTRUMENT_COMMAND_PATH_SCOPE(STAGE_QUEUE)
+            rslt = _workItemQueue.peek(workItem);
+        }
         if (rslt)
         {
             // Check if this work item can be processed
-            if (canBeProcessed(workItem))
+            bool canProcess = false;
             {
-                rslt = _workItemQueue.get(workItem);
+                INSTRUMENT_COMMAND_PATH_SCOPE(STAGE_EVALUATE)
+                canProcess = canBeProcessed(workItem);
+            }
+            if (canProcess)
+            {
+                {
+                    INSTRUMENT_COMMAND_PATH_SCOPE(STAGE_QUEUE)
+                    rslt = _workItemQueue.get(workItem);
+                }
                 if (rslt)
                 {
                     // Check for extended commands
-                    rslt = execWorkItem(workItem);
+                    {
+                        INSTRUMENT_COMMAND_PATH_SCOPE(STAGE_EVALUATE)
+                        rslt = execWorkItem(workItem);
+                    }
 
 #ifdef DEBUG_WORK_ITEM_SERVICE
                     Log.trace("%sgetWorkflow execRslt=%d (waiting %d), %s\n", MODULE_PREFIX,
@@ -381,7 +471,10 @@ void WorkManager::service()
 #endif
                     // Check for GCode
                     if (!rslt)
+                    {
+                        INSTRUMENT_COMMAND_PATH_SCOPE(STAGE_GCODE)
                         EvaluatorGCode::interpretGcode(workItem, &_robotController, true);
+                    }
                 }
             }
         }
@@ -389,6 +482,12 @@ void WorkManager::service()
 
     // Service evaluators
     evaluatorsService();
+
+    // File indexing waits while there is work to do
+    _patternIndexer.setPaused(!queueIsEmpty() || evaluatorsBusy(true));
+
+    // Micro-benchmarks
+    serviceBenchmarks();
 }
 
 void WorkManager::reconfigure()
@@ -456,6 +555,7 @@ void WorkManager::evaluatorsStop()
 
 void WorkManager::evaluatorsService()
 {
+    INSTRUMENT_COMMAND_PATH_SCOPE(STAGE_EVALUATE)
     _evaluatorThetaRhoLine.service();
     _evaluatorPatterns.service();
     if (!evaluatorsBusy(false))
@@ -490,6 +590,110 @@ void WorkManager::evaluatorsSetConfig(const char* configJson, const char* jsonPa
     _evaluatorSequences.setConfig(evaluatorConfig.c_str());
     _evaluatorFiles.setConfig(evaluatorConfig.c_str());
     _evaluatorThetaRhoLine.setConfig(evaluatorConfig.c_str(), robotAttributes);
+    _patternIndexer.setConfig(configJson, evaluatorConfig.c_str(), robotAttributes);
+}
+
+void WorkManager::startBenchmarks(int iterations, String &respStr)
+{
+    if (iterations < 1)
+        iterations = BENCHMARK_ITERATIONS_DEFAULT;
+    if (iterations > BENCHMARK_ITERATIONS_MAX)
+        iterations = BENCHMARK_ITERATIONS_MAX;
+
+    // Hand over to the main loop (which owns the robot and planner) if not already running
+    xSemaphoreTake(_benchmarkMutex, portMAX_DELAY);
+    if (_benchmarkState.load() != BENCHMARK_IDLE)
+    {
+        xSemaphoreGive(_benchmarkMutex);
+        respStr = "{\"rslt\":\"busy\"}";
+        return;
+    }
+    _benchmarkIterations = iterations;
+    _benchmarkResult = "";
+    _benchmarkState.store(BENCHMARK_REQUESTED, std::memory_order_release);
+    xSemaphoreGive(_benchmarkMutex);
+    respStr = "{\"rslt\":\"ok\"}";
+}
+
+void WorkManager::getBenchmarksResult(String &respStr)
+{
+    xSemaphoreTake(_benchmarkMutex, portMAX_DELAY);
+    if (_benchmarkState.load() != BENCHMARK_IDLE)
+        respStr = "{\"rslt\":\"busy\"}";
+    else if (_benchmarkResult.length() == 0)
+        respStr = "{\"rslt\":\"fail\",\"error\":\"notrun\"}";
+    else
+        respStr = _benchmarkResult;
+    xSemaphoreGive(_benchmarkMutex);
+}
+
+void WorkManager::serviceBenchmarks()
+{
+    int benchmarkState = _benchmarkState.load(std::memory_order_acquire);
+    if (benchmarkState == BENCHMARK_IDLE)
+        return;
+
+    // Only run if nothing else is going on (abandoned if work arrives part way through)
+    if (!_workItemQueue.isEmpty() || !_ingressQueue.isEmpty() || evaluatorsBusy(true))
+    {
+        xSemaphoreTake(_benchmarkMutex, portMAX_DELAY);
+        _benchmarkResult = "{\"rslt\":\"fail\",\"error\":\"notidle\"}";
+        _benchmarkState.store(BENCHMARK_IDLE);
+        xSemaphoreGive(_benchmarkMutex);
+        return;
+    }
+    if (benchmarkState == BENCHMARK_REQUESTED)
+    {
+        _benchmarkIterationsDone = 0;
+        _benchmarkKinematicsCycles = _benchmarkPlannerCycles = _benchmarkGcodeCycles = _benchmarkJsonCycles = 0;
+        _benchmarkState.store(BENCHMARK_RUNNING);
+    }
+    int iterations = _benchmarkIterations - _benchmarkIterationsDone;
+    if (iterations > BENCHMARK_ITERATIONS_PER_SERVICE)
+        iterations = BENCHMARK_ITERATIONS_PER_SERVICE;
+
+    // Kinematics and planner
+    if (!_robotController.runBenchmarks(iterations, _benchmarkKinematicsCycles, _benchmarkPlannerCycles))
+    {
+        xSemaphoreTake(_benchmarkMutex, portMAX_DELAY);
+        _benchmarkResult = "{\"rslt\":\"fail\",\"error\":\"notidle\"}";
+        _benchmarkState.store(BENCHMARK_IDLE);
+        xSemaphoreGive(_benchmarkMutex);
+        return;
+    }
+
+    // G-code argument parsing
+    uint32_t startCycles = XTHAL_GET_CCOUNT();
+    for (int iterIdx = 0; iterIdx < iterations; iterIdx++)
+    {
+        RobotCommandArgs cmdArgs;
+        EvaluatorGCode::getGcodeCmdArgs(BENCHMARK_GCODE_ARGS, cmdArgs);
+    }
+    _benchmarkGcodeCycles += XTHAL_GET_CCOUNT() - startCycles;
+
+    // JSON lookup (same configuration on every board so results are comparable)
+    const char* pConfig = RobotConfigurations::_robotConfigs[0];
+    startCycles = XTHAL_GET_CCOUNT();
+    for (int iterIdx = 0; iterIdx < iterations; iterIdx++)
+        RdJson::getDouble(BENCHMARK_JSON_PATH, 0, pConfig);
+    _benchmarkJsonCycles += XTHAL_GET_CCOUNT() - startCycles;
+    _benchmarkIterationsDone += iterations;
+    if (_benchmarkIterationsDone < _benchmarkIterations)
+        return;
+
+    // Result
+    char jsonStr[200];
+    int numIters = _benchmarkIterations;
+    snprintf(jsonStr, sizeof(jsonStr), "{\"rslt\":\"ok\",\"iterations\":%d,\"cpuMHz\":%d,\"cyclesPerOp\":{"
+                "\"ptToActuator\":%0.1f,\"plannerMoveTo\":%0.1f,\"gcodeArgs\":%0.1f,\"rdJsonGetDouble\":%0.1f}}",
+                numIters, ESP.getCpuFreqMHz(),
+                float(_benchmarkKinematicsCycles) / numIters, float(_benchmarkPlannerCycles) / numIters,
+                float(_benchmarkGcodeCycles) / numIters, float(_benchmarkJsonCycles) / numIters);
+    xSemaphoreTake(_benchmarkMutex, portMAX_DELAY);
+    _benchmarkResult = jsonStr;
+    _benchmarkState.store(BENCHMARK_IDLE);
+    xSemaphoreGive(_benchmarkMutex);
+    Log.notice("%sbenchmarks %s\n", MODULE_PREFIX, jsonStr);
 }
 
 bool WorkManager::checkStatusChanged()
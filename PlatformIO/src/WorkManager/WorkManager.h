@@ -6,12 +6,16 @@
 // #define DEBUG_WORK_ITEM_SERVICE 1
 
 #include <Arduino.h>
+#include <vector>
+#include <atomic>
 #include "LedStrip.h"
 #include "WorkItemQueue.h"
+#include "WorkItemIngressQueue.h"
 #include "Evaluators/EvaluatorPatterns.h"
 #include "Evaluators/EvaluatorSequences.h"
 #include "Evaluators/EvaluatorFiles.h"
 #include "Evaluators/EvaluatorThetaRhoLine.h"
+#include "PatternIndexer.h"
 #include "RobotCommandArgs.h"
 
 class ConfigBase;
@@ -29,6 +33,12 @@ private:
     RobotController& _robotController;
     LedStrip& _ledStrip;
     WorkItemQueue _workItemQueue;
+    // Commands from other tasks waiting to be added to the work item queue
+    WorkItemIngressQueue _ingressQueue;
+    // Commands taken from the ingress queue while the work item queue is full (so that immediate
+    // commands behind them can be done) - main loop only and cleared by stop
+    static const int INGRESS_HELD_MAX = WorkItemIngressQueue::QUEUE_SLOTS;
+    std::vector<String> _ingressHeld;
     RestAPISystem& _restAPISystem;
     FileManager& _fileManager;
     CommandScheduler& _commandScheduler;
@@ -39,6 +49,9 @@ private:
     EvaluatorFiles _evaluatorFiles;
     EvaluatorThetaRhoLine _evaluatorThetaRhoLine;
 
+    // Metadata for pattern files
+    PatternIndexer _patternIndexer;
+
     // Status updates
     RobotCommandArgs _statusLastCmdArgs;
     unsigned long _statusLastHashVal;
@@ -49,6 +62,29 @@ private:
     // A status update will always be sent (even if no change) after this time
     const unsigned long STATUS_ALWAYS_UPDATE_MS = 10000;
 
+    // Micro-benchmarks - requested from the web server task and run by service() in steps of
+    // BENCHMARK_ITERATIONS_PER_SERVICE so the main loop is never held up for long
+    static constexpr int BENCHMARK_ITERATIONS_DEFAULT = 1000;
+    static constexpr int BENCHMARK_ITERATIONS_MAX = 10000;
+    static constexpr int BENCHMARK_ITERATIONS_PER_SERVICE = 250;
+    static constexpr const char* BENCHMARK_GCODE_ARGS = "X123.456 Y-78.901 Z2.5 F3000";
+    static constexpr const char* BENCHMARK_JSON_PATH = "robotGeom/axis1/maxAcc";
+    enum BenchmarkState
+    {
+        BENCHMARK_IDLE,
+        BENCHMARK_REQUESTED,
+        BENCHMARK_RUNNING
+    };
+    std::atomic<int> _benchmarkState;
+    SemaphoreHandle_t _benchmarkMutex;
+    int _benchmarkIterations;
+    int _benchmarkIterationsDone;
+    uint32_t _benchmarkKinematicsCycles;
+    uint32_t _benchmarkPlannerCycles;
+    uint32_t _benchmarkGcodeCycles;
+    uint32_t _benchmarkJsonCycles;
+    String _benchmarkResult;
+
     // Debug
 #ifdef DEBUG_WORK_ITEM_SERVICE
     uint32_t _debugLastWorkServiceMs;
@@ -90,12 +126,32 @@ public:
     // Add a work item to the queue
     void addWorkItem(WorkItem& workItem, String &retStr, int cmdIdx = -1);
 
+    // Add a work item from another task (web server or MQTT) - returns immediately and the
+    // item is added to the queue by service(). retStr is only whether the item was accepted
+    // (ok or busy) - the result of adding it to the queue isn't available to the caller and
+    // is logged if it fails
+    void addWorkItemFromTask(const char* pCmdStr, String &retStr);
+
     // Check status changed
     bool checkStatusChanged();
 
     // Get debug string
     String getDebugStr();
 
+    // Start micro-benchmarks (run by service() while idle) - respStr is ok or busy
+    void startBenchmarks(int iterations, String &respStr);
+
+    // Result of the last micro-benchmarks - JSON with CPU cycles per operation (busy while
+    // they are running)
+    void getBenchmarksResult(String &respStr);
+
+#ifdef UNIT_TEST
+    bool testEvaluatorsBusy()
+    {
+        return evaluatorsBusy(true);
+    }
+#endif
+
 private:
     // Execute an item of work
     bool execWorkItem(WorkItem& workItem);
@@ -103,6 +159,13 @@ private:
     // Process a single 
     void processSingle(const char *pCmdStr, String &retStr);
 
+    // Move work items added from other tasks to the queue
+    void serviceIngress();
+    void addIngressItem(const char* pCmdStr);
+
+    // Check for commands which act immediately rather than being queued
+    static bool isImmediateCommand(const char *pCmdStr);
+
     // Stop Evaluators
     void evaluatorsStop();
 
@@ -117,4 +180,7 @@ private:
 
     // Can be processed
     bool canBeProcessed(WorkItem& workItem);
+
+    // Run a step of the micro-benchmarks if requested
+    void serviceBenchmarks();
 };
@@ -93,6 +93,9 @@ WebServer webServer;
 #include "MQTTManager.h"
 MQTTManager mqttManager(wifiManager, restAPIEndpoints);
 
+// Memory regions
+#include "MemRegions.h"
+
 // Firmware update
 #include <RdOTAUpdate.h>
 RdOTAUpdate otaUpdate;
@@ -178,12 +181,27 @@ WorkManager _workManager(hwConfig,
                 fileManager,
                 commandScheduler);
 
+// Serial console lines which are G-code go straight to the work manager
+#include "WorkManager/Evaluators/EvaluatorGCode.h"
+SerialConsole::LineHandlerResult serialConsoleLineHandler(const char* pLine)
+{
+    if (!EvaluatorGCode::isGcode(pLine))
+        return SerialConsole::LINE_NOT_HANDLED;
+    if (!_workManager.canAcceptWorkItem())
+        return SerialConsole::LINE_BUSY;
+    WorkItem workItem(pLine);
+    String retStr;
+    _workManager.addWorkItem(workItem, retStr);
+    return SerialConsole::LINE_HANDLED;
+}
+
 // REST API Robot
 #include "RestAPIRobot.h"
 RestAPIRobot restAPIRobot(_workManager, fileManager);
 
 // Debug loop used to time main loop
 #include "DebugLoopTimer.h"
+#include "CommandPathTiming.h"
 
 // Debug loop timer and callback function
 void debugLoopInfoCallback(String &infoStr)
@@ -194,6 +212,12 @@ void debugLoopInfoCallback(String &infoStr)
         infoStr = "WiFi Disabled, Heap " + String(ESP.getFreeHeap());
     infoStr += _workManager.getDebugStr();
     infoStr += _robotController.getDebugStr();
+#ifdef INSTRUMENT_COMMAND_PATH_ENABLE
+    String timingJson;
+    CommandPathTiming::getJSON(timingJson);
+    CommandPathTiming::clear();
+    infoStr += " Path " + timingJson;
+#endif
 }
 DebugLoopTimer debugLoopTimer(10000, debugLoopInfoCallback);
 
@@ -210,6 +234,9 @@ void setup()
     // Robot config
     robotConfig.setup();
 
+    // Memory regions for large buffers
+    MemRegions::setup(robotConfig, "robotConfig/memRegions");
+
     // Status Led
     wifiStatusLed.setup(&robotConfig, "robotConfig/wifiLed");
 
@@ -233,6 +260,7 @@ void setup()
 
     // Serial console
     serialConsole.setup(hwConfig, restAPIEndpoints);
+    serialConsole.setLineHandler(serialConsoleLineHandler);
 
     // WiFi Manager
     wifiManager.setup(hwConfig, &wifiConfig, systemType, &wifiStatusLed);
@@ -242,6 +270,8 @@ void setup()
 
     // Firmware update
     otaUpdate.setup(hwConfig, systemType, systemVersion);
+    // Called on the OTA task - isPipelineLow() returns a flag set by the main loop
+    otaUpdate.setFlashWriteOkCallback([] { return !_robotController.isPipelineLow(); });
 
     // Add API endpoints
     restAPISystem.setup(restAPIEndpoints);
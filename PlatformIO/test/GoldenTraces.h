@@ -0,0 +1,605 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+#pragma once
+
+// Golden step traces for UnitTestGoldenTraces - regenerate with Tests/GoldenTraces (or by defining
+// GOLDEN_TRACES_RECORD in UnitTestGoldenTraces.h) and replace this file with the output
+
+static const int32_t GoldenTrace_SandTableScaraPiHat2[] = {
+    0, 0, 6, 6, 22, 22, 47, 47, 85, 85, 137, 137, 198, 198, 260, 260,
+    323, 323, 386, 386, 450, 450, 515, 515, 581, 581, 648, 648, 706, 706, 750, 750,
+    781, 781, 798, 798, 785, 815, 745, 856, 683, 923, 599, 1018, 500, 1140, 403, 1271,
+    316, 1403, 240, 1534, 175, 1665, 119, 1794, 75, 1920, 41, 2046, 18, 2165, 7, 2261,
+    2, 2333, 0, 2380, -1, 2400, -26, 2400, -74, 2401, -148, 2406, -247, 2419, -367, 2444,
+    -493, 2478, -621, 2524, -750, 2580, -880, 2648, -1012, 2726, -1145, 2814, -1277, 2912, -1407, 3020,
+    -1534, 3135, -1656, 3257, -1772, 3384, -1880, 3514, -1979, 3646, -2068, 3779, -2146, 3910, -2214, 4041,
+    -2272, 4170, -2318, 4298, -2353, 4424, -2379, 4546, -2392, 4646, -2398, 4722, -2400, 4773, -2400, 4798,
+    -2417, 4800, -2458, 4801, -2525, 4805, -2616, 4815, -2733, 4836, -2858, 4868, -2985, 4910, -3113, 4964,
+    -3244, 5028, -3376, 5103, -3508, 5189, -3640, 5284, -3771, 5389, -3899, 5502, -4023, 5623, -4140, 5749,
+    -4251, 5878, -4352, 6009, -4444, 6142, -4526, 6274, -4596, 6404, -4657, 6535, -4706, 6662, -4744, 6789,
+    -4773, 6913, -4789, 7021, -4797, 7104, -4799, 7161, -4800, 7194, -4809, 7200, -4844, 7200, -4904, 7203,
+    -4989, 7211, -5098, 7228, -5223, 7258, -5350, 7297, -5477, 7347, -5608, 7409, -5739, 7480, -5871, 7564,
+    -6004, 7656, -6135, 7759, -6263, 7870, -6389, 7989, -6508, 8113, -6620, 8241, -6725, 8373, -6820, 8505,
+    -6904, 8637, -6978, 8769, -7041, 8899, -7093, 9028, -7135, 9154, -7166, 9279, -7186, 9393, -7195, 9483,
+    -7199, 9547, -7200, 9587, -7202, 9600, -7227, 9590, -7278, 9570, -7352, 9544, -7450, 9516, -7571, 9490,
+    -7698, 9475, -7829, 9470, -7966, 9479, -8111, 9505, -8267, 9548, -8436, 9612, -8619, 9701, -8818, 9819,
+    -9034, 9966, -9261, 10142, -9456, 10308, -9607, 10446, -9709, 10543, -9761, 10594, -9772, 10590, -9794, 10569,
+    -9831, 10532, -9880, 10482, -9943, 10420, -10009, 10353, -10070, 10292, -10117, 10246, -10149, 10214, -10165, 10182,
+    -10368, 10373, -10809, 10823, -11249, 11272, -11682, 11719, -11559, 11619, -11272, 11378, -10860, 11026, -10415, 10649,
+    -9969, 10268, -9523, 9887, -9090, 9519, -8711, 9197, -8369, 8908, -8036, 8622, -7697, 8334, -7350, 8041,
+    -7048, 7784, -6782, 7558, -6537, 7351, -6305, 7155, -6080, 6963, -5858, 6774, -5636, 6586, -5409, 6394,
+    -5169, 6191, -4927, 5987, -4708, 5804, -4508, 5635, -4325, 5478, -4148, 5330, -3978, 5189, -3813, 5047,
+    -3649, 4912, -3486, 4773, -3323, 4637, -3157, 4501, -2988, 4356, -2811, 4207, -2622, 4052, -2434, 3893,
+    -2267, 3752, -2107, 3621, -1960, 3495, -1816, 3377, -1680, 3263, -1546, 3152, -1414, 3042, -1285, 2935,
+    -1156, 2827, -1028, 2722, -900, 2615, -772, 2511, -640, 2399, -507, 2291, -367, 2174, -224, 2057,
+    -69, 1929, 80, 1804, 227, 1688, 355, 1579, 486, 1476, 604, 1375, 723, 1280, 836, 1187,
+    947, 1095, 1058, 1007, 1164, 917, 1272, 834, 1376, 745, 1482, 659, 1588, 577, 1694, 486,
+    1803, 404, 1908, 314, 2020, 225, 2132, 136, 2250, 38, 2371, -53, 2496, -160, 2630, -259,
+    2748, -363, 2871, -454, 2978, -544, 3087, -630, 3192, -711, 3289, -793, 3390, -867, 3484, -944,
+    3577, -1020, 3674, -1089, 3763, -1164, 3854, -1238, 3949, -1304, 4037, -1379, 4127, -1450, 4221, -1516,
+    4310, -1592, 4402, -1664, 4499, -1731, 4591, -1810, 4688, -1884, 4788, -1953, 4887, -2038, 4995, -2117,
+    5100, -2197, 5216, -2288, 5334, -2368, 5435, -2454, 5543, -2530, 5641, -2603, 5732, -2677, 5831, -2743,
+    5919, -2810, 6004, -2878, 6094, -2938, 6180, -2999, 6260, -3065, 6345, -3123, 6433, -3177, 6508, -3242,
+    6590, -3302, 6677, -3355, 6756, -3414, 6835, -3476, 6920, -3531, 7005, -3583, 7084, -3649, 7169, -3706,
+    7259, -3755, 7342, -3822, 7429, -3883, 7525, -3937, 7614, -4000, 7709, -4068, 7814, -4125, 7913, -4192,
+    8022, -4266, 8144, -4321, 8235, -4392, 8334, -4451, 8447, -4496, 8529, -4557, 8618, -4610, 8722, -4650,
+    8814, -4694, 8894, -4747, 8989, -4784, 9103, -4802, 9181, -4850, 9267, -4888, 9353, -4900, 9436, -4892,
+    9513, -4863, 9592, -4807
+};
+
+static const int32_t GoldenTrace_SandTableScaraPiHat3_6[] = {
+    0, 0, 2, 2, 8, 8, 17, 17, 29, 29, 44, 44, 65, 65, 88, 88,
+    116, 116, 149, 149, 186, 186, 227, 227, 270, 270, 312, 312, 354, 354, 398, 398,
+    440, 440, 485, 485, 529, 529, 573, 573, 616, 616, 654, 654, 688, 688, 719, 719,
+    745, 745, 765, 765, 782, 782, 793, 793, 799, 799, 792, 808, 776, 824, 751, 850,
+    719, 883, 680, 926, 633, 979, 581, 1040, 522, 1112, 460, 1192, 397, 1280, 337, 1370,
+    282, 1460, 232, 1549, 187, 1638, 147, 1725, 112, 1813, 82, 1898, 57, 1984, 37, 2065,
+    23, 2136, 14, 2199, 7, 2254, 4, 2299, 1, 2337, 1, 2366, 0, 2387, 0, 2399,
+    -8, 2400, -24, 2400, -49, 2400, -82, 2401, -124, 2405, -173, 2409, -232, 2418, -299, 2429,
+    -375, 2446, -459, 2468, -545, 2495, -632, 2528, -719, 2567, -808, 2609, -896, 2657, -987, 2710,
+    -1076, 2767, -1166, 2829, -1255, 2895, -1344, 2966, -1431, 3040, -1518, 3120, -1601, 3201, -1682, 3285,
+    -1760, 3371, -1835, 3459, -1906, 3548, -1972, 3637, -2034, 3727, -2092, 3817, -2144, 3906, -2191, 3995,
+    -2234, 4084, -2272, 4171, -2304, 4257, -2332, 4343, -2354, 4427, -2371, 4503, -2382, 4570, -2390, 4629,
+    -2395, 4678, -2398, 4720, -2399, 4752, -2400, 4777, -2400, 4794, -2401, 4800, -2413, 4800, -2432, 4800,
+    -2459, 4801, -2495, 4802, -2540, 4806, -2593, 4812, -2654, 4820, -2725, 4834, -2804, 4853, -2889, 4877,
+    -2975, 4907, -3062, 4941, -3150, 4980, -3239, 5025, -3328, 5074, -3417, 5129, -3507, 5188, -3597, 5251,
+    -3686, 5319, -3774, 5392, -3861, 5468, -3947, 5548, -4029, 5630, -4110, 5715, -4187, 5802, -4260, 5890,
+    -4329, 5979, -4395, 6068, -4455, 6158, -4511, 6248, -4561, 6337, -4607, 6426, -4648, 6514, -4683, 6601,
+    -4714, 6688, -4740, 6773, -4761, 6855, -4775, 6928, -4785, 6991, -4792, 7047, -4796, 7094, -4798, 7132,
+    -4799, 7162, -4800, 7184, -4800, 7197, -4804, 7200, -4819, 7200, -4841, 7200, -4871, 7201, -4910, 7203,
+    -4957, 7208, -5013, 7214, -5078, 7225, -5151, 7240, -5233, 7260, -5318, 7287, -5405, 7318, -5492, 7354,
+    -5581, 7396, -5669, 7442, -5759, 7493, -5848, 7549, -5938, 7609, -6027, 7675, -6116, 7744, -6204, 7818,
+    -6291, 7895, -6376, 7976, -6457, 8059, -6536, 8145, -6612, 8232, -6684, 8320, -6752, 8409, -6815, 8499,
+    -6875, 8590, -6929, 8679, -6978, 8768, -7021, 8856, -7060, 8944, -7094, 9031, -7124, 9117, -7148, 9202,
+    -7166, 9280, -7179, 9350, -7188, 9411, -7193, 9464, -7197, 9508, -7199, 9543, -7200, 9571, -7200, 9589,
+    -7200, 9599, -7206, 9598, -7220, 9592, -7243, 9583, -7275, 9571, -7315, 9556, -7362, 9542, -7418, 9525,
+    -7483, 9508, -7557, 9493, -7639, 9481, -7726, 9473, -7814, 9470, -7906, 9474, -8000, 9484, -8099, 9502,
+    -8202, 9528, -8311, 9563, -8425, 9608, -8546, 9663, -8675, 9733, -8811, 9814, -8956, 9910, -9100, 10014,
+    -9235, 10121, -9357, 10221, -9465, 10316, -9558, 10400, -9634, 10471, -9693, 10528, -9735, 10568, -9760, 10593,
+    -9766, 10596, -9774, 10589, -9786, 10576, -9803, 10559, -9825, 10538, -9852, 10511, -9882, 10480, -9918, 10445,
+    -9956, 10406, -9999, 10364, -10036, 10326, -10069, 10293, -10099, 10264, -10123, 10240, -10141, 10221, -10157, 10206,
+    -10165, 10188, -10165, 10167, -10514, 10522, -10952, 10969, -11389, 11416, -11741, 11779, -11610, 11661, -11502, 11574,
+    -11303, 11403, -11063, 11199, -10789, 10965, -10496, 10718, -10194, 10461, -9878, 10191, -9555, 9914, -9238, 9645,
+    -8960, 9409, -8708, 9194, -8470, 8992, -8243, 8798, -8018, 8607, -7792, 8415, -7559, 8218, -7327, 8022,
+    -7119, 7844, -6931, 7683, -6755, 7535, -6587, 7392, -6427, 7256, -6272, 7127, -6119, 6995, -5969, 6868,
+    -5818, 6741, -5669, 6614, -5515, 6487, -5358, 6350, -5195, 6214, -5027, 6073, -4871, 5939, -4725, 5819,
+    -4589, 5702, -4459, 5595, -4336, 5488, -4214, 5388, -4098, 5288, -3982, 5192, -3870, 5096, -3759, 5004,
+    -3649, 4912, -3540, 4818, -3429, 4730, -3320, 4634, -3208, 4541, -3096, 4446, -2979, 4348, -2862, 4251,
+    -2739, 4147, -2611, 4041, -2484, 3933, -2366, 3838, -2255, 3741, -2145, 3653, -2045, 3567, -1945, 3484,
+    -1847, 3404, -1755, 3325, -1663, 3249, -1572, 3175, -1484, 3099, -1396, 3027, -1309, 2956, -1224, 2883,
+    -1136, 2812, -1050, 2742, -964, 2667, -878, 2597, -791, 2527, -703, 2451, -612, 2378, -523, 2305,
+    -432, 2227, -336, 2149, -241, 2072, -139, 1985, -33, 1903, 65, 1818, 165, 1736, 258, 1663,
+    343, 1589, 431, 1517, 516, 1451, 595, 1383, 674, 1318, 755, 1256, 829, 1193, 902, 1131,
+    978, 1072, 1052, 1013, 1122, 952, 1194, 893, 1267, 837, 1338, 779, 1408, 719, 1480, 661,
+    1553, 607, 1622, 547, 1694, 486, 1767, 430, 1839, 375, 1910, 313, 1985, 252, 2061, 195,
+    2136, 132, 2215, 66, 2296, 2, 2377, -59, 2460, -131, 2550, -202, 2638, -267, 2717, -336,
+    2799, -403, 2881, -460, 2952, -523, 3024, -582, 3098, -638, 3170, -690, 3234, -747, 3300, -802,
+    3368, -852, 3436, -900, 3497, -955, 3559, -1006, 3623, -1054, 3689, -1099, 3747, -1150, 3807, -1201,
+    3868, -1248, 3932, -1293, 3993, -1340, 4051, -1391, 4112, -1439, 4175, -1485, 4238, -1527, 4296, -1580,
+    4357, -1630, 4420, -1677, 4485, -1722, 4546, -1771, 4608, -1823, 4674, -1874, 4743, -1921, 4807, -1971,
+    4875, -2028, 4945, -2082, 5019, -2132, 5089, -2188, 5163, -2249, 5244, -2308, 5324, -2359, 5390, -2418,
+    5460, -2473, 5533, -2524, 5604, -2570, 5662, -2621, 5724, -2671, 5790, -2717, 5856, -2758, 5913, -2805,
+    5969, -2851, 6028, -2895, 6088, -2935, 6151, -2972, 6203, -3019, 6257, -3062, 6314, -3104, 6372, -3140,
+    6432, -3176, 6482, -3220, 6535, -3263, 6590, -3302, 6647, -3338, 6707, -3371, 6756, -3414, 6809, -3457,
+    6864, -3496, 6921, -3532, 6981, -3564, 7033, -3607, 7087, -3651, 7143, -3689, 7202, -3726, 7265, -3758,
+    7318, -3802, 7374, -3846, 7434, -3887, 7498, -3924, 7564, -3956, 7621, -4005, 7684, -4052, 7752, -4094,
+    7824, -4129, 7890, -4173, 7956, -4225, 8033, -4272, 8115, -4310, 8183, -4350, 8244, -4398, 8310, -4439,
+    8382, -4473, 8458, -4499, 8510, -4543, 8567, -4582, 8630, -4616, 8699, -4643, 8774, -4661, 8823, -4701,
+    8877, -4737, 8936, -4766, 9003, -4788, 9079, -4800, 9142, -4822, 9191, -4856, 9241, -4880, 9292, -4894,
+    9343, -4900, 9392, -4899, 9440, -4891, 9485, -4876, 9526, -4856, 9580, -4816
+};
+
+static const int32_t GoldenTrace_SandTableScaraPiHat4[] = {
+    0, 0, 2, 2, 11, 11, 24, 24, 41, 41, 64, 64, 93, 93, 127, 127,
+    167, 167, 212, 212, 261, 261, 310, 310, 359, 359, 408, 408, 459, 459, 512, 512,
+    566, 566, 618, 618, 663, 663, 702, 702, 737, 737, 766, 766, 787, 787, 801, 803,
+    805, 816, 792, 816, 770, 833, 736, 867, 692, 914, 639, 973, 577, 1045, 507, 1129,
+    433, 1225, 360, 1331, 293, 1439, 232, 1547, 177, 1655, 131, 1761, 91, 1864, 60, 1967,
+    36, 2065, 20, 2151, 10, 2225, 3, 2288, 1, 2338, 0, 2376, -1, 2400, -15, 2400,
+    -40, 2400, -77, 2401, -125, 2405, -185, 2411, -255, 2420, -316, 2431, -382, 2444, -448, 2461,
+    -512, 2482, -582, 2507, -658, 2536, -732, 2570, -816, 2610, -904, 2657, -995, 2712, -1090, 2774,
+    -1191, 2845, -1293, 2924, -1396, 3009, -1498, 3100, -1597, 3196, -1693, 3295, -1785, 3398, -1871, 3502,
+    -1954, 3609, -2030, 3717, -2097, 3825, -2160, 3933, -2215, 4040, -2263, 4147, -2301, 4252, -2336, 4354,
+    -2360, 4453, -2378, 4540, -2388, 4615, -2395, 4678, -2398, 4729, -2400, 4768, -2400, 4795, -2408, 4800,
+    -2430, 4800, -2463, 4801, -2507, 4803, -2563, 4808, -2629, 4817, -2699, 4826, -2759, 4839, -2819, 4855,
+    -2888, 4874, -2957, 4897, -3031, 4925, -3107, 4958, -3186, 4996, -3270, 5040, -3361, 5092, -3455, 5151,
+    -3556, 5219, -3657, 5295, -3761, 5379, -3862, 5468, -3963, 5562, -4060, 5660, -4153, 5762, -4241, 5865,
+    -4325, 5972, -4404, 6079, -4474, 6187, -4539, 6295, -4596, 6402, -4646, 6510, -4689, 6616, -4725, 6718,
+    -4753, 6820, -4773, 6911, -4786, 6990, -4793, 7057, -4797, 7112, -4799, 7156, -4800, 7187, -4804, 7200,
+    -4821, 7200, -4850, 7201, -4891, 7202, -4942, 7207, -5005, 7214, -5079, 7223, -5138, 7234, -5200, 7249,
+    -5268, 7267, -5333, 7289, -5406, 7315, -5478, 7346, -5559, 7382, -5641, 7424, -5730, 7473, -5822, 7529,
+    -5919, 7594, -6021, 7668, -6124, 7749, -6228, 7836, -6328, 7928, -6426, 8025, -6521, 8126, -6612, 8229,
+    -6697, 8334, -6777, 8441, -6850, 8549, -6917, 8657, -6977, 8765, -7030, 8872, -7076, 8979, -7112, 9083,
+    -7144, 9185, -7167, 9280, -7182, 9364, -7191, 9435, -7197, 9494, -7199, 9541, -7200, 9576, -7200, 9600,
+    -7210, 9615, -7215, 9626, -7215, 9632, -7215, 9634, -7215, 9630, -7215, 9622, -7215, 9615, -7215, 9607,
+    -7215, 9600, -7228, 9591, -7259, 9578, -7303, 9562, -7357, 9544, -7423, 9524, -7501, 9504, -7590, 9486,
+    -7689, 9474, -7794, 9470, -7901, 9474, -8013, 9486, -8100, 9500, -8174, 9518, -8249, 9540, -8330, 9566,
+    -8415, 9599, -8503, 9639, -8596, 9687, -8703, 9745, -8819, 9814, -8945, 9897, -9079, 9995, -9223, 10109,
+    -9369, 10230, -9496, 10343, -9599, 10438, -9678, 10512, -9733, 10565, -9761, 10593, -9773, 10605, -9773, 10609,
+    -9773, 10604, -9773, 10592, -9786, 10579, -9806, 10559, -9830, 10534, -9861, 10503, -9899, 10467, -9941, 10424,
+    -9989, 10375, -10035, 10327, -10077, 10284, -10114, 10247, -10144, 10219, -10162, 10201, -10165, 10175, -10475, 10474,
+    -11039, 11050, -11579, 11610, -11901, 11946, -12076, 12147, -12107, 12231, -11927, 12121, -11729, 11943, -11615, 11764,
+    -11555, 11600, -11373, 11497, -11184, 11303, -10880, 11065, -10567, 10789, -10215, 10481, -9828, 10152, -9430, 9811,
+    -9038, 9477, -8685, 9177, -8370, 8908, -8086, 8662, -7805, 8423, -7516, 8177, -7229, 7938, -6975, 7722,
+    -6748, 7530, -6543, 7356, -6350, 7189, -6163, 7028, -5979, 6874, -5795, 6720, -5611, 6566, -5423, 6409,
+    -5225, 6242, -5021, 6069, -4832, 5904, -4657, 5760, -4493, 5622, -4341, 5491, -4193, 5370, -4052, 5250,
+    -3913, 5135, -3781, 5019, -3647, 4907, -3515, 4794, -3382, 4690, -3253, 4579, -3120, 4467, -2981, 4348,
+    -2839, 4233, -2691, 4108, -2537, 3980, -2388, 3854, -2251, 3735, -2119, 3629, -1997, 3525, -1876, 3427,
+    -1762, 3332, -1651, 3239, -1541, 3150, -1434, 3060, -1327, 2975, -1227, 2887, -1125, 2800, -1021, 2717,
+    -919, 2629, -815, 2547, -716, 2464, -611, 2375, -502, 2289, -392, 2195, -274, 2102, -160, 2004,
+    -31, 1900, 90, 1796, 209, 1700, 316, 1613, 421, 1526, 524, 1444, 620, 1360, 717, 1282,
+    810, 1211, 895, 1135, 985, 1064, 1071, 999, 1150, 927, 1236, 858, 1323, 794, 1402, 725,
+    1487, 654, 1573, 591, 1650, 524, 1735, 453, 1823, 387, 1906, 317, 1997, 243, 2090, 171,
+    2182, 92, 2277, 15, 2373, -53, 2458, -128, 2565, -212, 2668, -293, 2761, -374, 2860, -447,
+    2945, -514, 3027, -585, 3115, -651, 3196, -713, 3273, -779, 3352, -842, 3432, -896, 3498, -954,
+    3570, -1015, 3646, -1072, 3722, -1127, 3791, -1189, 3863, -1246, 3938, -1299, 4006, -1350, 4072, -1408,
+    4144, -1464, 4219, -1516, 4291, -1575, 4361, -1635, 4436, -1690, 4512, -1741, 4578, -1797, 4654, -1858,
+    4736, -1918, 4808, -1969, 4874, -2026, 4956, -2089, 5045, -2150, 5132, -2223, 5224, -2295, 5319, -2356,
+    5389, -2415, 5469, -2479, 5555, -2539, 5628, -2590, 5695, -2647, 5771, -2706, 5848, -2755, 5919, -2809,
+    5983, -2864, 6052, -2914, 6125, -2958, 6186, -3002, 6245, -3052, 6309, -3102, 6378, -3145, 6445, -3184,
+    6492, -3227, 6554, -3275, 6620, -3323, 6688, -3362, 6742, -3400, 6795, -3444, 6859, -3492, 6928, -3537,
+    6998, -3576, 7062, -3632, 7127, -3681, 7194, -3722, 7267, -3760, 7334, -3814, 7402, -3868, 7474, -3912,
+    7549, -3948, 7601, -3986, 7657, -4030, 7731, -4081, 7815, -4126, 7897, -4179, 7973, -4238, 8060, -4287,
+    8155, -4325, 8199, -4360, 8252, -4402, 8329, -4449, 8414, -4486, 8478, -4514, 8522, -4548, 8579, -4588,
+    8654, -4628, 8735, -4654, 8810, -4692, 8869, -4734, 8934, -4767, 9008, -4790, 9093, -4801, 9161, -4838,
+    9219, -4872, 9279, -4891, 9338, -4900, 9395, -4897, 9450, -4889, 9496, -4876, 9536, -4854, 9592, -4814
+};
+
+static const int32_t GoldenTrace_SandTableScaraMatt[] = {
+    0, 0, 1, 1, 4, 4, 9, 9, 17, 17, 26, 26, 36, 36, 46, 46,
+    56, 56, 67, 67, 77, 77, 88, 88, 98, 98, 108, 108, 118, 118, 129, 129,
+    139, 139, 149, 149, 159, 159, 169, 169, 179, 179, 190, 190, 201, 201, 211, 211,
+    221, 221, 231, 231, 242, 242, 252, 252, 263, 263, 273, 273, 283, 283, 293, 293,
+    304, 304, 315, 315, 325, 325, 335, 335, 346, 346, 356, 356, 366, 366, 378, 378,
+    388, 388, 399, 399, 409, 409, 420, 420, 430, 430, 441, 441, 452, 452, 462, 462,
+    473, 473, 484, 484, 494, 494, 506, 506, 516, 516, 527, 527, 538, 538, 549, 549,
+    560, 560, 571, 571, 582, 582, 593, 593, 604, 604, 615, 615, 626, 626, 638, 638,
+    648, 648, 660, 660, 671, 671, 682, 682, 693, 693, 705, 705, 717, 717, 728, 728,
+    739, 739, 751, 751, 762, 762, 774, 774, 784, 784, 792, 792, 797, 797, 799, 801,
+    794, 806, 784, 816, 771, 829, 753, 848, 734, 868, 713, 890, 695, 910, 675, 931,
+    656, 953, 637, 975, 618, 996, 599, 1018, 582, 1039, 564, 1061, 546, 1083, 529, 1104,
+    510, 1127, 494, 1148, 477, 1170, 460, 1193, 443, 1215, 428, 1237, 412, 1258, 397, 1281,
+    382, 1303, 366, 1325, 353, 1347, 338, 1369, 324, 1391, 311, 1413, 297, 1436, 283, 1458,
+    270, 1480, 258, 1501, 246, 1524, 234, 1546, 222, 1568, 211, 1590, 200, 1611, 190, 1633,
+    179, 1655, 168, 1677, 159, 1698, 150, 1719, 140, 1741, 131, 1763, 123, 1784, 115, 1806,
+    106, 1827, 99, 1848, 91, 1869, 85, 1891, 78, 1912, 71, 1933, 65, 1954, 59, 1975,
+    54, 1996, 48, 2017, 43, 2038, 39, 2059, 34, 2079, 30, 2100, 26, 2120, 22, 2142,
+    19, 2162, 15, 2182, 13, 2203, 10, 2224, 8, 2244, 6, 2264, 5, 2285, 3, 2305,
+    2, 2326, 1, 2347, 1, 2366, 0, 2381, 0, 2392, 0, 2399, -2, 2400, -10, 2400,
+    -21, 2400, -36, 2400, -55, 2401, -76, 2402, -97, 2403, -117, 2404, -137, 2406, -158, 2408,
+    -178, 2410, -199, 2412, -220, 2415, -240, 2418, -260, 2422, -281, 2425, -302, 2429, -323, 2433,
+    -343, 2438, -365, 2443, -385, 2448, -406, 2454, -427, 2459, -448, 2465, -469, 2471, -490, 2478,
+    -511, 2485, -533, 2491, -554, 2499, -575, 2506, -596, 2515, -618, 2523, -639, 2531, -661, 2540,
+    -683, 2550, -704, 2559, -725, 2569, -747, 2579, -769, 2590, -791, 2600, -813, 2611, -834, 2622,
+    -856, 2634, -878, 2646, -900, 2658, -923, 2671, -944, 2684, -966, 2697, -989, 2711, -1011, 2725,
+    -1033, 2738, -1055, 2753, -1077, 2767, -1099, 2782, -1121, 2797, -1143, 2812, -1166, 2829, -1187, 2844,
+    -1209, 2861, -1232, 2878, -1254, 2895, -1276, 2912, -1297, 2929, -1319, 2946, -1341, 2965, -1363, 2982,
+    -1385, 3001, -1406, 3019, -1427, 3037, -1449, 3057, -1471, 3076, -1492, 3096, -1512, 3115, -1534, 3135,
+    -1554, 3155, -1575, 3175, -1595, 3195, -1616, 3216, -1635, 3236, -1656, 3257, -1675, 3278, -1695, 3299,
+    -1715, 3320, -1733, 3341, -1753, 3363, -1771, 3384, -1790, 3406, -1808, 3427, -1827, 3449, -1844, 3470,
+    -1862, 3492, -1880, 3514, -1898, 3536, -1914, 3558, -1931, 3580, -1947, 3602, -1963, 3624, -1980, 3647,
+    -1995, 3669, -2010, 3691, -2025, 3713, -2040, 3735, -2055, 3757, -2069, 3780, -2083, 3802, -2096, 3823,
+    -2109, 3846, -2123, 3868, -2135, 3890, -2147, 3912, -2159, 3933, -2171, 3955, -2183, 3977, -2194, 4000,
+    -2205, 4021, -2216, 4043, -2226, 4064, -2236, 4086, -2245, 4108, -2254, 4129, -2264, 4151, -2272, 4172,
+    -2281, 4194, -2289, 4215, -2297, 4237, -2304, 4258, -2312, 4279, -2319, 4301, -2325, 4322, -2332, 4342,
+    -2337, 4363, -2343, 4385, -2349, 4405, -2354, 4426, -2359, 4447, -2364, 4468, -2368, 4489, -2372, 4509,
+    -2376, 4530, -2380, 4551, -2382, 4571, -2386, 4591, -2388, 4613, -2391, 4633, -2392, 4653, -2395, 4674,
+    -2396, 4694, -2397, 4715, -2398, 4735, -2399, 4756, -2400, 4773, -2400, 4786, -2400, 4796, -2400, 4800,
+    -2405, 4800, -2414, 4800, -2427, 4800, -2444, 4801, -2464, 4801, -2485, 4802, -2506, 4804, -2526, 4805,
+    -2547, 4807, -2567, 4808, -2587, 4811, -2608, 4813, -2629, 4817, -2649, 4819, -2670, 4823, -2691, 4828,
+    -2711, 4831, -2732, 4836, -2752, 4840, -2774, 4845, -2795, 4850, -2815, 4856, -2837, 4862, -2858, 4867,
+    -2878, 4874, -2899, 4880, -2921, 4887, -2942, 4895, -2963, 4902, -2984, 4910, -3006, 4919, -3028, 4927,
+    -3049, 4936, -3071, 4945, -3092, 4954, -3114, 4963, -3135, 4973, -3157, 4984, -3179, 4995, -3200, 5005,
+    -3223, 5016, -3245, 5028, -3266, 5039, -3288, 5052, -3310, 5064, -3332, 5077, -3354, 5090, -3377, 5103,
+    -3398, 5116, -3420, 5130, -3443, 5145, -3465, 5159, -3487, 5174, -3509, 5189, -3531, 5204, -3553, 5220,
+    -3576, 5236, -3598, 5252, -3619, 5268, -3642, 5285, -3664, 5302, -3686, 5319, -3708, 5337, -3730, 5355,
+    -3751, 5372, -3772, 5390, -3794, 5409, -3816, 5428, -3837, 5446, -3859, 5466, -3880, 5485, -3901, 5504,
+    -3922, 5524, -3943, 5544, -3964, 5564, -3984, 5584, -4004, 5604, -4025, 5625, -4045, 5646, -4064, 5666,
+    -4085, 5688, -4103, 5708, -4123, 5729, -4142, 5751, -4162, 5773, -4180, 5794, -4199, 5815, -4217, 5837,
+    -4235, 5859, -4253, 5881, -4270, 5902, -4287, 5924, -4304, 5946, -4322, 5968, -4338, 5991, -4355, 6013,
+    -4370, 6034, -4386, 6056, -4402, 6079, -4417, 6101, -4432, 6123, -4446, 6145, -4461, 6167, -4475, 6189,
+    -4488, 6211, -4502, 6234, -4515, 6255, -4528, 6277, -4541, 6299, -4553, 6322, -4565, 6344, -4577, 6366,
+    -4588, 6387, -4599, 6409, -4609, 6431, -4620, 6453, -4631, 6475, -4640, 6496, -4650, 6517, -4659, 6539,
+    -4668, 6561, -4676, 6582, -4684, 6604, -4693, 6625, -4700, 6646, -4708, 6667, -4715, 6689, -4721, 6710,
+    -4728, 6731, -4734, 6752, -4740, 6773, -4746, 6794, -4752, 6815, -4757, 6835, -4761, 6857, -4766, 6877,
+    -4770, 6898, -4774, 6918, -4777, 6940, -4781, 6960, -4784, 6980, -4787, 7001, -4789, 7022, -4792, 7042,
+    -4793, 7062, -4795, 7083, -4797, 7103, -4798, 7124, -4799, 7145, -4799, 7164, -4800, 7180, -4800, 7191,
+    -4800, 7198, -4802, 7200, -4809, 7200, -4819, 7200, -4834, 7200, -4853, 7201, -4874, 7202, -4895, 7203,
+    -4915, 7204, -4935, 7205, -4956, 7208, -4976, 7209, -4997, 7212, -5018, 7215, -5038, 7218, -5058, 7222,
+    -5079, 7225, -5100, 7229, -5121, 7233, -5141, 7238, -5162, 7242, -5183, 7247, -5204, 7253, -5225, 7258,
+    -5246, 7264, -5267, 7270, -5288, 7277, -5309, 7284, -5331, 7291, -5352, 7298, -5373, 7306, -5394, 7314,
+    -5416, 7322, -5437, 7330, -5459, 7339, -5480, 7349, -5502, 7358, -5523, 7368, -5545, 7378, -5567, 7389,
+    -5589, 7399, -5610, 7410, -5632, 7421, -5654, 7434, -5676, 7445, -5698, 7457, -5720, 7469, -5742, 7482,
+    -5764, 7496, -5787, 7510, -5809, 7523, -5830, 7537, -5852, 7551, -5875, 7566, -5897, 7581, -5919, 7596,
+    -5942, 7612, -5963, 7627, -5985, 7643, -6007, 7659, -6030, 7676, -6052, 7693, -6073, 7709, -6095, 7727,
+    -6117, 7745, -6139, 7763, -6161, 7781, -6182, 7798, -6204, 7817, -6225, 7836, -6247, 7855, -6269, 7875,
+    -6290, 7894, -6310, 7913, -6332, 7933, -6352, 7953, -6373, 7973, -6393, 7993, -6414, 8014, -6433, 8034,
+    -6454, 8055, -6473, 8076, -6494, 8097, -6513, 8118, -6532, 8139, -6551, 8161, -6570, 8182, -6588, 8204,
+    -6607, 8225, -6625, 8247, -6642, 8268, -6660, 8290, -6678, 8312, -6696, 8334, -6712, 8356, -6729, 8378,
+    -6746, 8400, -6762, 8422, -6778, 8445, -6794, 8467, -6808, 8488, -6824, 8511, -6839, 8533, -6853, 8555,
+    -6868, 8578, -6881, 8599, -6895, 8621, -6908, 8644, -6921, 8666, -6934, 8688, -6946, 8709, -6958, 8731,
+    -6970, 8753, -6981, 8775, -6993, 8798, -7004, 8819, -7015, 8841, -7025, 8862, -7035, 8884, -7044, 8906,
+    -7053, 8927, -7063, 8949, -7071, 8970, -7080, 8992, -7088, 9013, -7096, 9035, -7104, 9056, -7111, 9077,
+    -7118, 9099, -7125, 9120, -7131, 9140, -7137, 9161, -7143, 9183, -7149, 9203, -7154, 9224, -7159, 9245,
+    -7163, 9266, -7168, 9286, -7171, 9307, -7175, 9328, -7179, 9349, -7182, 9369, -7185, 9389, -7188, 9411,
+    -7191, 9431, -7192, 9451, -7195, 9472, -7196, 9492, -7197, 9512, -7198, 9533, -7199, 9554, -7200, 9572,
+    -7200, 9585, -7200, 9595, -7200, 9600, -7203, 9599, -7211, 9596, -7223, 9591, -7238, 9585, -7258, 9577,
+    -7278, 9570, -7298, 9563, -7318, 9555, -7338, 9549, -7357, 9543, -7377, 9536, -7397, 9530, -7418, 9524,
+    -7437, 9519, -7458, 9515, -7477, 9509, -7498, 9505, -7518, 9500, -7538, 9496, -7558, 9493, -7578, 9489,
+    -7599, 9486, -7619, 9483, -7640, 9480, -7661, 9478, -7682, 9476, -7703, 9474, -7724, 9473, -7745, 9472,
+    -7767, 9471, -7788, 9470, -7810, 9470, -7831, 9470, -7854, 9471, -7875, 9472, -7898, 9473, -7920, 9475,
+    -7943, 9477, -7966, 9479, -7990, 9483, -8013, 9486, -8037, 9490, -8060, 9494, -8085, 9499, -8109, 9504,
+    -8134, 9510, -8159, 9516, -8184, 9522, -8210, 9530, -8236, 9537, -8262, 9546, -8289, 9555, -8316, 9564,
+    -8344, 9575, -8371, 9586, -8399, 9596, -8428, 9608, -8456, 9621, -8486, 9634, -8516, 9649, -8546, 9663,
+    -8577, 9680, -8607, 9695, -8639, 9713, -8671, 9730, -8703, 9748, -8737, 9768, -8770, 9789, -8804, 9809,
+    -8838, 9832, -8873, 9854, -8908, 9878, -8944, 9902, -8980, 9927, -9017, 9954, -9054, 9981, -9092, 10010,
+    -9131, 10039, -9169, 10068, -9208, 10100, -9247, 10131, -9287, 10163, -9327, 10196, -9367, 10230, -9407, 10265,
+    -9448, 10301, -9489, 10337, -9529, 10374, -9570, 10410, -9611, 10449, -9652, 10488, -9691, 10525, -9723, 10556,
+    -9746, 10579, -9760, 10593, -9765, 10598, -9768, 10595, -9773, 10589, -9781, 10581, -9792, 10571, -9803, 10560,
+    -9814, 10548, -9826, 10537, -9836, 10527, -9847, 10515, -9858, 10504, -9870, 10493, -9881, 10482, -9892, 10471,
+    -9902, 10460, -9913, 10449, -9925, 10438, -9936, 10427, -9947, 10416, -9958, 10405, -9969, 10394, -9979, 10384,
+    -9990, 10373, -10001, 10362, -10012, 10350, -10023, 10339, -10034, 10328, -10045, 10317, -10055, 10307, -10066, 10296,
+    -10077, 10285, -10088, 10274, -10099, 10263, -10110, 10252, -10121, 10241, -10131, 10231, -10142, 10220, -10153, 10209,
+    -10162, 10200, -10170, 10192, -10173, 10182, -10233, 10234, -10535, 10541, -10839, 10849, -11142, 11156, -11437, 11458,
+    -11663, 11693, -11733, 11772, -11644, 11692, -11563, 11622, -11490, 11565, -11339, 11434, -11206, 11323, -11057, 11194,
+    -10940, 11096, -10819, 10991, -10717, 10907, -10608, 10812, -10508, 10727, -10412, 10646, -10309, 10557, -10217, 10480,
+    -10122, 10398, -10022, 10313, -9931, 10237, -9829, 10148, -9725, 10060, -9625, 9975, -9526, 9890, -9434, 9813,
+    -9351, 9742, -9271, 9673, -9194, 9608, -9122, 9547, -9052, 9487, -8983, 9428, -8918, 9374, -8854, 9319,
+    -8791, 9265, -8728, 9211, -8669, 9162, -8610, 9111, -8550, 9059, -8491, 9009, -8434, 8961, -8377, 8914,
+    -8319, 8863, -8260, 8812, -8203, 8764, -8147, 8718, -8091, 8670, -8031, 8617, -7972, 8568, -7914, 8519,
+    -7858, 8473, -7798, 8420, -7735, 8366, -7673, 8314, -7614, 8265, -7552, 8212, -7487, 8155, -7424, 8101,
+    -7362, 8051, -7307, 8004, -7253, 7957, -7200, 7912, -7148, 7868, -7096, 7825, -7048, 7785, -7001, 7743,
+    -6954, 7703, -6907, 7664, -6861, 7625, -6817, 7589, -6774, 7551, -6731, 7514, -6689, 7478, -6647, 7442,
+    -6606, 7409, -6565, 7375, -6525, 7340, -6486, 7306, -6446, 7271, -6407, 7239, -6367, 7206, -6329, 7174,
+    -6290, 7143, -6252, 7109, -6214, 7075, -6177, 7044, -6139, 7011, -6101, 6980, -6064, 6949, -6027, 6919,
+    -5989, 6886, -5952, 6854, -5915, 6822, -5878, 6791, -5841, 6760, -5804, 6730, -5767, 6699, -5729, 6666,
+    -5690, 6632, -5650, 6597, -5612, 6566, -5574, 6534, -5536, 6503, -5498, 6472, -5458, 6436, -5418, 6401,
+    -5378, 6367, -5337, 6333, -5296, 6300, -5255, 6267, -5215, 6231, -5169, 6191, -5124, 6153, -5078, 6115,
+    -5033, 6077, -4991, 6044, -4952, 6009, -4914, 5976, -4875, 5942, -4837, 5910, -4798, 5878, -4760, 5848,
+    -4724, 5818, -4690, 5788, -4656, 5758, -4622, 5729, -4588, 5701, -4555, 5673, -4521, 5645, -4488, 5619,
+    -4457, 5592, -4426, 5565, -4396, 5539, -4366, 5513, -4335, 5487, -4305, 5462, -4275, 5437, -4245, 5413,
+    -4216, 5390, -4187, 5365, -4158, 5339, -4130, 5315, -4101, 5290, -4073, 5267, -4045, 5243, -4016, 5220,
+    -3988, 5197, -3959, 5174, -3931, 5150, -3904, 5125, -3876, 5101, -3849, 5078, -3821, 5054, -3793, 5031,
+    -3766, 5009, -3739, 4987, -3711, 4965, -3683, 4941, -3656, 4918, -3629, 4893, -3602, 4870, -3575, 4847,
+    -3547, 4824, -3520, 4802, -3493, 4779, -3466, 4758, -3439, 4737, -3411, 4713, -3384, 4689, -3357, 4666,
+    -3330, 4642, -3303, 4619, -3276, 4596, -3249, 4575, -3221, 4551, -3194, 4530, -3166, 4508, -3138, 4483,
+    -3109, 4457, -3080, 4432, -3051, 4407, -3022, 4383, -2993, 4359, -2963, 4336, -2934, 4313, -2906, 4290,
+    -2875, 4262, -2844, 4235, -2812, 4207, -2780, 4181, -2748, 4154, -2716, 4128, -2684, 4102, -2653, 4078,
+    -2622, 4051, -2590, 4024, -2559, 3995, -2527, 3969, -2495, 3942, -2463, 3916, -2431, 3891, -2400, 3866,
+    -2372, 3843, -2344, 3818, -2317, 3794, -2289, 3770, -2262, 3747, -2235, 3725, -2207, 3701, -2179, 3680,
+    -2152, 3658, -2125, 3637, -2101, 3616, -2078, 3596, -2054, 3575, -2030, 3553, -2006, 3533, -1982, 3514,
+    -1958, 3494, -1934, 3475, -1910, 3456, -1885, 3436, -1860, 3417, -1837, 3396, -1815, 3376, -1792, 3357,
+    -1770, 3337, -1747, 3317, -1724, 3299, -1701, 3280, -1678, 3262, -1655, 3243, -1632, 3225, -1610, 3208,
+    -1587, 3189, -1566, 3170, -1545, 3151, -1523, 3132, -1502, 3114, -1479, 3094, -1458, 3076, -1436, 3059,
+    -1414, 3042, -1392, 3024, -1370, 3007, -1348, 2991, -1327, 2973, -1306, 2953, -1285, 2935, -1264, 2917,
+    -1243, 2899, -1222, 2881, -1200, 2862, -1178, 2845, -1158, 2829, -1136, 2811, -1114, 2794, -1092, 2777,
+    -1072, 2761, -1050, 2742, -1030, 2723, -1009, 2706, -988, 2687, -967, 2669, -946, 2652, -925, 2635,
+    -903, 2617, -882, 2600, -861, 2584, -838, 2566, -817, 2550, -795, 2531, -774, 2512, -753, 2493,
+    -732, 2476, -710, 2457, -688, 2438, -667, 2421, -645, 2404, -623, 2385, -601, 2369, -580, 2352,
+    -556, 2335, -534, 2315, -512, 2296, -489, 2276, -466, 2256, -442, 2235, -419, 2216, -395, 2197,
+    -372, 2178, -347, 2158, -324, 2140, -300, 2123, -277, 2103, -253, 2082, -228, 2060, -202, 2037,
+    -176, 2015, -150, 1994, -125, 1973, -98, 1952, -72, 1932, -45, 1912, -20, 1892, 4, 1870,
+    28, 1850, 53, 1827, 77, 1807, 102, 1786, 127, 1767, 152, 1746, 177, 1727, 202, 1708,
+    227, 1689, 250, 1670, 271, 1651, 291, 1633, 313, 1614, 335, 1596, 355, 1579, 377, 1561,
+    400, 1543, 421, 1525, 443, 1508, 466, 1491, 487, 1475, 508, 1459, 527, 1442, 546, 1425,
+    565, 1408, 584, 1392, 603, 1376, 622, 1359, 641, 1344, 661, 1328, 681, 1313, 699, 1298,
+    719, 1283, 739, 1269, 759, 1254, 778, 1238, 796, 1222, 813, 1206, 831, 1191, 849, 1175,
+    867, 1159, 886, 1144, 904, 1129, 923, 1114, 941, 1100, 959, 1085, 978, 1071, 997, 1058,
+    1016, 1043, 1034, 1029, 1052, 1013, 1068, 999, 1085, 983, 1103, 968, 1121, 953, 1138, 938,
+    1156, 923, 1173, 909, 1191, 895, 1209, 881, 1228, 867, 1246, 853, 1263, 840, 1282, 826,
+    1300, 813, 1317, 797, 1333, 782, 1351, 767, 1368, 752, 1385, 738, 1402, 723, 1419, 709,
+    1437, 695, 1455, 681, 1472, 667, 1490, 653, 1508, 640, 1526, 626, 1544, 614, 1562, 600,
+    1579, 585, 1596, 569, 1613, 555, 1630, 540, 1647, 525, 1664, 510, 1682, 496, 1699, 482,
+    1717, 467, 1735, 454, 1753, 440, 1772, 426, 1789, 414, 1808, 400, 1825, 387, 1843, 371,
+    1861, 355, 1879, 339, 1897, 323, 1915, 308, 1933, 292, 1952, 277, 1970, 263, 1989, 248,
+    2008, 233, 2027, 219, 2046, 206, 2065, 191, 2083, 179, 2102, 163, 2121, 146, 2140, 129,
+    2159, 112, 2179, 95, 2198, 79, 2218, 63, 2237, 48, 2258, 31, 2278, 16, 2298, 1,
+    2318, -13, 2339, -28, 2359, -42, 2378, -60, 2400, -79, 2420, -97, 2442, -116, 2464, -134,
+    2486, -152, 2508, -169, 2530, -186, 2553, -204, 2575, -220, 2598, -237, 2621, -252, 2640, -270,
+    2660, -288, 2680, -305, 2699, -322, 2720, -339, 2739, -355, 2760, -371, 2780, -387, 2801, -403,
+    2822, -418, 2842, -433, 2864, -449, 2884, -463, 2902, -478, 2919, -494, 2937, -509, 2955, -525,
+    2971, -539, 2989, -554, 3007, -569, 3026, -583, 3043, -597, 3062, -611, 3080, -625, 3098, -638,
+    3117, -651, 3136, -665, 3154, -677, 3171, -691, 3186, -705, 3201, -719, 3217, -733, 3233, -746,
+    3249, -760, 3265, -773, 3281, -786, 3297, -799, 3314, -812, 3330, -824, 3347, -836, 3364, -849,
+    3381, -861, 3398, -873, 3415, -884, 3431, -896, 3446, -910, 3460, -923, 3475, -936, 3490, -949,
+    3505, -962, 3521, -975, 3535, -987, 3551, -1000, 3567, -1012, 3582, -1024, 3598, -1036, 3614, -1047,
+    3630, -1059, 3647, -1070, 3662, -1081, 3679, -1093, 3695, -1103, 3709, -1117, 3723, -1130, 3738, -1143,
+    3752, -1154, 3766, -1167, 3781, -1180, 3796, -1192, 3811, -1204, 3826, -1216, 3841, -1228, 3856, -1239,
+    3871, -1250, 3887, -1262, 3902, -1273, 3919, -1284, 3934, -1295, 3950, -1305, 3966, -1316, 3980, -1329,
+    3994, -1342, 4008, -1355, 4023, -1367, 4037, -1379, 4051, -1392, 4066, -1403, 4081, -1416, 4096, -1427,
+    4111, -1438, 4126, -1450, 4142, -1462, 4156, -1473, 4172, -1483, 4187, -1493, 4203, -1504, 4219, -1514,
+    4235, -1525, 4249, -1538, 4264, -1552, 4278, -1565, 4292, -1577, 4307, -1589, 4322, -1603, 4337, -1614,
+    4352, -1626, 4367, -1638, 4382, -1649, 4398, -1661, 4414, -1673, 4430, -1684, 4445, -1695, 4461, -1705,
+    4477, -1716, 4493, -1727, 4509, -1738, 4524, -1752, 4539, -1766, 4554, -1779, 4569, -1792, 4586, -1806,
+    4601, -1818, 4617, -1831, 4633, -1844, 4649, -1856, 4665, -1868, 4682, -1880, 4698, -1891, 4715, -1903,
+    4732, -1914, 4749, -1925, 4766, -1936, 4782, -1948, 4797, -1962, 4814, -1977, 4830, -1991, 4847, -2006,
+    4863, -2019, 4880, -2033, 4897, -2046, 4915, -2060, 4932, -2072, 4950, -2086, 4967, -2098, 4985, -2110,
+    5004, -2122, 5021, -2134, 5040, -2145, 5057, -2158, 5075, -2175, 5093, -2191, 5111, -2206, 5130, -2223,
+    5149, -2238, 5168, -2253, 5187, -2267, 5206, -2281, 5226, -2295, 5246, -2309, 5266, -2322, 5287, -2336,
+    5308, -2349, 5327, -2362, 5342, -2376, 5359, -2391, 5374, -2404, 5391, -2419, 5408, -2433, 5424, -2446,
+    5441, -2459, 5458, -2472, 5475, -2485, 5493, -2497, 5511, -2509, 5528, -2521, 5547, -2533, 5565, -2544,
+    5584, -2555, 5601, -2567, 5615, -2581, 5629, -2593, 5645, -2607, 5659, -2619, 5674, -2632, 5689, -2643,
+    5705, -2656, 5720, -2668, 5736, -2680, 5751, -2691, 5768, -2702, 5784, -2713, 5801, -2724, 5817, -2735,
+    5833, -2745, 5851, -2755, 5867, -2764, 5881, -2776, 5894, -2788, 5907, -2799, 5921, -2812, 5934, -2823,
+    5948, -2835, 5962, -2846, 5976, -2857, 5990, -2867, 6004, -2878, 6019, -2889, 6033, -2898, 6048, -2909,
+    6063, -2919, 6078, -2928, 6093, -2937, 6108, -2947, 6123, -2956, 6139, -2964, 6153, -2974, 6165, -2985,
+    6179, -2997, 6191, -3009, 6204, -3020, 6217, -3031, 6230, -3041, 6243, -3051, 6257, -3062, 6270, -3072,
+    6284, -3083, 6298, -3092, 6312, -3102, 6325, -3111, 6340, -3121, 6355, -3130, 6369, -3139, 6384, -3148,
+    6399, -3156, 6413, -3164, 6429, -3173, 6441, -3184, 6452, -3195, 6465, -3206, 6478, -3217, 6491, -3228,
+    6503, -3238, 6516, -3249, 6529, -3259, 6543, -3268, 6555, -3278, 6569, -3287, 6583, -3297, 6597, -3307,
+    6610, -3315, 6625, -3325, 6639, -3334, 6653, -3342, 6668, -3350, 6683, -3358, 6698, -3366, 6712, -3375,
+    6724, -3386, 6736, -3398, 6748, -3408, 6760, -3419, 6773, -3429, 6786, -3439, 6799, -3450, 6812, -3459,
+    6825, -3470, 6839, -3479, 6852, -3488, 6866, -3498, 6880, -3507, 6894, -3516, 6908, -3524, 6923, -3533,
+    6937, -3541, 6952, -3549, 6967, -3556, 6982, -3564, 6995, -3573, 7008, -3585, 7020, -3596, 7033, -3607,
+    7046, -3618, 7058, -3628, 7072, -3639, 7085, -3649, 7098, -3659, 7112, -3669, 7126, -3679, 7139, -3688,
+    7154, -3697, 7168, -3706, 7183, -3715, 7197, -3723, 7212, -3731, 7227, -3739, 7242, -3747, 7258, -3755,
+    7274, -3763, 7287, -3774, 7299, -3785, 7312, -3797, 7325, -3808, 7339, -3819, 7352, -3829, 7365, -3840,
+    7379, -3850, 7394, -3860, 7408, -3870, 7423, -3881, 7437, -3889, 7452, -3898, 7467, -3907, 7483, -3916,
+    7498, -3924, 7514, -3932, 7531, -3940, 7547, -3948, 7563, -3955, 7577, -3967, 7590, -3980, 7605, -3993,
+    7620, -4004, 7635, -4016, 7650, -4028, 7665, -4039, 7681, -4050, 7697, -4061, 7714, -4072, 7730, -4081,
+    7747, -4092, 7764, -4101, 7782, -4109, 7799, -4118, 7817, -4126, 7836, -4134, 7855, -4142, 7869, -4154,
+    7885, -4169, 7902, -4183, 7918, -4196, 7935, -4210, 7952, -4222, 7970, -4234, 7988, -4245, 8007, -4257,
+    8025, -4267, 8045, -4278, 8065, -4288, 8085, -4298, 8105, -4306, 8126, -4315, 8149, -4323, 8164, -4333,
+    8177, -4345, 8192, -4359, 8206, -4370, 8220, -4381, 8236, -4393, 8251, -4404, 8266, -4414, 8283, -4423,
+    8299, -4434, 8316, -4442, 8333, -4451, 8350, -4460, 8368, -4467, 8386, -4475, 8404, -4482, 8424, -4488,
+    8444, -4494, 8462, -4502, 8474, -4513, 8487, -4524, 8500, -4535, 8514, -4546, 8527, -4556, 8541, -4565,
+    8555, -4575, 8570, -4585, 8585, -4593, 8600, -4602, 8616, -4610, 8632, -4617, 8648, -4624, 8665, -4631,
+    8682, -4637, 8701, -4643, 8719, -4649, 8737, -4654, 8756, -4657, 8776, -4661, 8787, -4671, 8799, -4682,
+    8811, -4692, 8823, -4702, 8836, -4711, 8848, -4719, 8862, -4728, 8875, -4737, 8889, -4744, 8903, -4751,
+    8919, -4759, 8934, -4765, 8949, -4771, 8965, -4777, 8982, -4782, 8999, -4787, 9016, -4791, 9034, -4794,
+    9053, -4797, 9071, -4799, 9092, -4801, 9112, -4802, 9125, -4809, 9136, -4818, 9148, -4828, 9160, -4836,
+    9173, -4845, 9186, -4853, 9199, -4861, 9213, -4868, 9227, -4874, 9242, -4880, 9258, -4885, 9274, -4889,
+    9291, -4893, 9308, -4896, 9327, -4899, 9346, -4900, 9367, -4900, 9389, -4900, 9412, -4897, 9438, -4891,
+    9467, -4883, 9498, -4870, 9527, -4856, 9555, -4838, 9590, -4809
+};
+
+static const int32_t GoldenTrace_NejeMasterPiHat3_6[] = {
+    0, 0, 50, 33, 199, 132, 440, 293, 767, 511, 1178, 785, 1667, 1111, 2231, 1487,
+    2866, 1910, 3569, 2379, 4337, 2891, 5166, 3444, 6014, 4009, 6863, 4575, 7713, 5141, 8561, 5707,
+    9410, 6273, 10259, 6839, 11108, 7405, 11957, 7971, 12806, 8537, 13655, 9103, 14504, 9669, 15353, 10235,
+    16202, 10801, 17050, 11367, 17899, 11932, 18748, 12498, 19597, 13064, 20446, 13631, 21295, 14196, 22144, 14763,
+    22993, 15329, 23842, 15894, 24691, 16460, 25528, 17019, 26309, 17539, 27026, 18017, 27676, 18451, 28254, 18836,
+    28759, 19173, 29186, 19457, 29531, 19687, 29789, 19859, 29955, 19970, 30000, 20060, 30000, 20241, 30000, 20500,
+    30000, 20845, 30000, 21273, 30000, 21778, 30000, 22357, 30000, 23006, 30000, 23723, 30000, 24505, 30000, 25338,
+    30000, 26133, 30000, 26864, 30000, 27528, 30000, 28122, 30000, 28643, 30000, 29087, 30000, 29450, 30000, 29727,
+    30000, 29914, 29995, 30000, 29886, 30000, 29685, 30000, 29398, 30000, 29026, 30000, 28573, 30000, 28044, 30000,
+    27442, 30000, 26770, 30000, 26032, 30000, 25231, 30000, 24384, 30000, 23534, 30000, 22685, 30000, 21836, 30000,
+    20987, 30000, 20137, 30000, 19288, 30000, 18439, 30000, 17589, 30000, 16740, 30000, 15891, 30000, 15041, 30000,
+    14219, 30000, 13459, 30000, 12764, 30000, 12138, 30000, 11583, 30000, 11104, 30000, 10704, 30000, 10387, 30000,
+    10159, 30000, 10024, 30000, 10000, 29947, 10000, 29786, 10000, 29539, 10000, 29204, 10000, 28788, 10000, 28293,
+    10000, 27723, 10000, 27082, 10000, 26374, 10000, 25601, 10000, 24768, 10000, 23919, 10000, 23069, 10000, 22220,
+    10000, 21371, 10000, 20522, 10000, 19672, 10000, 18823, 10000, 17974, 10000, 17124, 10000, 16275, 10000, 15426,
+    10000, 14584, 10000, 13795, 10000, 13070, 10000, 12412, 10000, 11825, 10000, 11311, 10000, 10875, 10000, 10520,
+    10000, 10251, 10000, 10074, 10011, 10000, 10130, 10000, 10338, 10000, 10634, 10000, 11014, 10000, 11474, 10000,
+    12010, 10000, 12619, 10000, 13297, 10000, 14041, 10000, 14849, 10000, 15697, 10000, 16546, 10000, 17396, 10000,
+    18245, 10000, 19094, 10000, 19943, 10000, 20793, 10000, 21642, 10000, 22491, 10000, 23341, 10000, 24190, 10000,
+    25039, 10000, 25855, 10000, 26609, 10000, 27297, 10000, 27916, 10000, 28463, 10000, 28935, 10000, 29327, 10000,
+    29634, 10000, 29853, 10000, 29978, 10000, 29984, 10040, 29925, 10183, 29828, 10416, 29694, 10737, 29526, 11141,
+    29324, 11624, 29092, 12182, 28830, 12811, 28539, 13508, 28221, 14272, 27878, 15096, 27524, 15945, 27170, 16794,
+    26824, 17626, 26502, 18399, 26206, 19107, 25941, 19746, 25703, 20315, 25497, 20809, 25324, 21225, 25185, 21558,
+    25082, 21804, 25019, 21956, 24969, 21988, 24829, 21932, 24601, 21841, 24286, 21715, 23886, 21555, 23408, 21364,
+    22855, 21143, 22242, 20897, 21675, 20671, 21184, 20474, 20771, 20309, 20441, 20177, 20198, 20080, 20046, 20019,
+    20003, 20019, 20022, 20138, 20086, 20340, 20270, 20595, 20627, 20819, 21127, 20883, 21687, 20730, 22235, 20336,
+    22653, 19697, 22866, 18906, 22845, 18060, 22589, 17226, 22091, 16423, 21365, 15705, 20545, 15227, 19709, 14935,
+    18865, 14799, 18021, 14802, 17180, 14938, 16349, 15206, 15524, 15621, 14729, 16193, 13974, 16954, 13391, 17771,
+    12966, 18609, 12668, 19443, 12464, 20286, 12357, 21133, 12373, 21979, 12462, 22819, 12633, 23665, 12933, 24495,
+    13311, 25320, 13795, 26158, 14435, 26946, 15200, 27712, 16004, 28369, 16839, 28893, 17672, 29291, 18508, 29638,
+    19357, 29844, 20203, 30015, 21047, 30081, 21894, 30101, 22741, 30029, 23583, 29903, 24429, 29692, 25257, 29418,
+    26099, 29058, 26913, 28617, 27742, 28091, 28537, 27440, 29350, 26703, 30037, 25864, 30633, 25052, 31124, 24207,
+    31539, 23379, 31863, 22533, 32146, 21695, 32322, 20851, 32498, 20008, 32539, 19165, 32578, 18318, 32534, 17474,
+    32438, 16628, 32310, 15787, 32075, 14943, 31838, 14096, 31480, 13276, 31090, 12429, 30614, 11606, 30049, 10763,
+    29418, 9949, 28659, 9135, 27862, 8389, 27021, 7734, 26207, 7160, 25361, 6694, 24531, 6238, 23685, 5926,
+    22836, 5622, 21994, 5374, 21146, 5215, 20298, 5056, 19455, 4987, 18612, 4965, 17769, 4942, 16927, 5029,
+    16081, 5143, 15233, 5256, 14397, 5502, 13549, 5757, 12710, 6034, 11879, 6436, 11032, 6845, 10209, 7326,
+    9371, 7909, 8523, 8500, 7737, 9254, 6917, 10046, 6230, 10864, 5594, 11709, 5010, 12522, 4563, 13368,
+    4114, 14216, 3731, 15045, 3444, 15890, 3156, 16735, 2917, 17574, 2772, 18420, 2627, 19268, 2499, 20116,
+    2490, 20960, 2480, 21804, 2471, 22647, 2574, 23491, 2700, 24338, 2825, 25185, 3025, 26021, 3292, 26868,
+    3560, 27716, 3871, 28549, 4290, 29388, 4714, 30235, 5170, 31065, 5752, 31877, 6360, 32725, 7019, 33538,
+    7804, 34333, 8607, 35144, 9429, 35808, 10276, 36430, 11101, 37035, 11937, 37499, 12783, 37933, 13625, 38366,
+    14459, 38704, 15295, 38978, 16075, 39233, 16790, 39467, 17457, 39594, 18058, 39690, 18586, 39774, 19037, 39846,
+    19408, 39905, 19693, 39951, 19889, 39982, 19992, 39998
+};
+
+static const int32_t GoldenTrace_NejeMasterPiHat3_9[] = {
+    0, 0, 50, 33, 199, 132, 440, 293, 767, 511, 1178, 785, 1667, 1111, 2231, 1487,
+    2866, 1910, 3569, 2379, 4337, 2891, 5166, 3444, 6014, 4009, 6863, 4575, 7713, 5141, 8561, 5707,
+    9410, 6273, 10259, 6839, 11108, 7405, 11957, 7971, 12806, 8537, 13655, 9103, 14504, 9669, 15353, 10235,
+    16202, 10801, 17050, 11367, 17899, 11932, 18748, 12498, 19597, 13064, 20446, 13631, 21295, 14196, 22144, 14763,
+    22993, 15329, 23842, 15894, 24691, 16460, 25528, 17019, 26309, 17539, 27026, 18017, 27676, 18451, 28254, 18836,
+    28759, 19173, 29186, 19457, 29531, 19687, 29789, 19859, 29955, 19970, 30000, 20060, 30000, 20241, 30000, 20500,
+    30000, 20845, 30000, 21273, 30000, 21778, 30000, 22357, 30000, 23006, 30000, 23723, 30000, 24505, 30000, 25338,
+    30000, 26133, 30000, 26864, 30000, 27528, 30000, 28122, 30000, 28643, 30000, 29087, 30000, 29450, 30000, 29727,
+    30000, 29914, 29995, 30000, 29886, 30000, 29685, 30000, 29398, 30000, 29026, 30000, 28573, 30000, 28044, 30000,
+    27442, 30000, 26770, 30000, 26032, 30000, 25231, 30000, 24384, 30000, 23534, 30000, 22685, 30000, 21836, 30000,
+    20987, 30000, 20137, 30000, 19288, 30000, 18439, 30000, 17589, 30000, 16740, 30000, 15891, 30000, 15041, 30000,
+    14219, 30000, 13459, 30000, 12764, 30000, 12138, 30000, 11583, 30000, 11104, 30000, 10704, 30000, 10387, 30000,
+    10159, 30000, 10024, 30000, 10000, 29947, 10000, 29786, 10000, 29539, 10000, 29204, 10000, 28788, 10000, 28293,
+    10000, 27723, 10000, 27082, 10000, 26374, 10000, 25601, 10000, 24768, 10000, 23919, 10000, 23069, 10000, 22220,
+    10000, 21371, 10000, 20522, 10000, 19672, 10000, 18823, 10000, 17974, 10000, 17124, 10000, 16275, 10000, 15426,
+    10000, 14584, 10000, 13795, 10000, 13070, 10000, 12412, 10000, 11825, 10000, 11311, 10000, 10875, 10000, 10520,
+    10000, 10251, 10000, 10074, 10011, 10000, 10130, 10000, 10338, 10000, 10634, 10000, 11014, 10000, 11474, 10000,
+    12010, 10000, 12619, 10000, 13297, 10000, 14041, 10000, 14849, 10000, 15697, 10000, 16546, 10000, 17396, 10000,
+    18245, 10000, 19094, 10000, 19943, 10000, 20793, 10000, 21642, 10000, 22491, 10000, 23341, 10000, 24190, 10000,
+    25039, 10000, 25855, 10000, 26609, 10000, 27297, 10000, 27916, 10000, 28463, 10000, 28935, 10000, 29327, 10000,
+    29634, 10000, 29853, 10000, 29978, 10000, 29984, 10040, 29925, 10183, 29828, 10416, 29694, 10737, 29526, 11141,
+    29324, 11624, 29092, 12182, 28830, 12811, 28539, 13508, 28221, 14272, 27878, 15096, 27524, 15945, 27170, 16794,
+    26824, 17626, 26502, 18399, 26206, 19107, 25941, 19746, 25703, 20315, 25497, 20809, 25324, 21225, 25185, 21558,
+    25082, 21804, 25019, 21956, 24969, 21988, 24829, 21932, 24601, 21841, 24286, 21715, 23886, 21555, 23408, 21364,
+    22855, 21143, 22242, 20897, 21675, 20671, 21184, 20474, 20771, 20309, 20441, 20177, 20198, 20080, 20046, 20019,
+    20003, 20019, 20022, 20138, 20086, 20340, 20270, 20595, 20627, 20819, 21127, 20883, 21687, 20730, 22235, 20336,
+    22653, 19697, 22866, 18906, 22845, 18060, 22589, 17226, 22091, 16423, 21365, 15705, 20545, 15227, 19709, 14935,
+    18865, 14799, 18021, 14802, 17180, 14938, 16349, 15206, 15524, 15621, 14729, 16193, 13974, 16954, 13391, 17771,
+    12966, 18609, 12668, 19443, 12464, 20286, 12357, 21133, 12373, 21979, 12462, 22819, 12633, 23665, 12933, 24495,
+    13311, 25320, 13795, 26158, 14435, 26946, 15200, 27712, 16004, 28369, 16839, 28893, 17672, 29291, 18508, 29638,
+    19357, 29844, 20203, 30015, 21047, 30081, 21894, 30101, 22741, 30029, 23583, 29903, 24429, 29692, 25257, 29418,
+    26099, 29058, 26913, 28617, 27742, 28091, 28537, 27440, 29350, 26703, 30037, 25864, 30633, 25052, 31124, 24207,
+    31539, 23379, 31863, 22533, 32146, 21695, 32322, 20851, 32498, 20008, 32539, 19165, 32578, 18318, 32534, 17474,
+    32438, 16628, 32310, 15787, 32075, 14943, 31838, 14096, 31480, 13276, 31090, 12429, 30614, 11606, 30049, 10763,
+    29418, 9949, 28659, 9135, 27862, 8389, 27021, 7734, 26207, 7160, 25361, 6694, 24531, 6238, 23685, 5926,
+    22836, 5622, 21994, 5374, 21146, 5215, 20298, 5056, 19455, 4987, 18612, 4965, 17769, 4942, 16927, 5029,
+    16081, 5143, 15233, 5256, 14397, 5502, 13549, 5757, 12710, 6034, 11879, 6436, 11032, 6845, 10209, 7326,
+    9371, 7909, 8523, 8500, 7737, 9254, 6917, 10046, 6230, 10864, 5594, 11709, 5010, 12522, 4563, 13368,
+    4114, 14216, 3731, 15045, 3444, 15890, 3156, 16735, 2917, 17574, 2772, 18420, 2627, 19268, 2499, 20116,
+    2490, 20960, 2480, 21804, 2471, 22647, 2574, 23491, 2700, 24338, 2825, 25185, 3025, 26021, 3292, 26868,
+    3560, 27716, 3871, 28549, 4290, 29388, 4714, 30235, 5170, 31065, 5752, 31877, 6360, 32725, 7019, 33538,
+    7804, 34333, 8607, 35144, 9429, 35808, 10276, 36430, 11101, 37035, 11937, 37499, 12783, 37933, 13625, 38366,
+    14459, 38704, 15295, 38978, 16075, 39233, 16790, 39467, 17457, 39594, 18058, 39690, 18586, 39774, 19037, 39846,
+    19408, 39905, 19693, 39951, 19889, 39982, 19992, 39998
+};
+
+static const int32_t GoldenTrace_NejeMasterPiHat4[] = {
+    0, 0, 1129, 753, 4066, 2710, 7138, 4758, 10210, 6806, 13282, 8854, 16354, 10903, 19426, 12951,
+    22498, 14999, 25570, 17047, 28642, 19094, 31714, 21142, 34786, 23190, 37858, 25239, 40930, 27287, 44002, 29335,
+    47074, 31383, 50146, 33431, 53218, 35479, 56290, 37527, 59362, 39575, 62434, 41623, 65506, 43671, 68579, 45719,
+    71651, 47767, 74723, 49815, 77795, 51863, 80867, 53911, 83939, 55959, 87011, 58006, 90083, 60055, 93155, 62103,
+    96227, 64151, 99299, 66199, 102371, 68247, 105443, 70295, 108515, 72343, 111587, 74391, 114659, 76439, 117731, 78487,
+    120803, 80535, 123875, 82583, 126947, 84631, 130019, 86680, 133091, 88728, 136163, 90776, 139235, 92823, 142307, 94871,
+    145379, 96919, 148451, 98968, 151523, 101016, 154596, 103064, 157668, 105112, 160740, 107160, 163812, 109208, 166884, 111255,
+    169956, 113303, 173028, 115351, 176100, 117399, 179172, 119447, 182244, 121495, 185316, 123544, 188388, 125592, 191460, 127640,
+    194532, 129688, 197604, 131735, 200676, 133783, 203748, 135832, 206820, 137880, 209892, 139928, 212964, 141976, 216036, 144024,
+    219108, 146072, 221778, 147851, 222000, 149661, 222000, 152729, 222000, 155801, 222000, 158873, 222000, 161945, 222000, 165017,
+    222000, 168089, 222000, 171161, 222000, 174233, 222000, 177305, 222000, 180377, 222000, 183449, 222000, 186521, 222000, 189593,
+    222000, 192665, 222000, 195737, 222000, 198809, 222000, 201881, 222000, 204953, 222000, 208025, 222000, 211097, 222000, 214169,
+    222000, 217241, 222000, 220310, 221845, 222000, 219480, 222000, 216408, 222000, 213336, 222000, 210264, 222000, 207192, 222000,
+    204120, 222000, 201048, 222000, 197976, 222000, 194904, 222000, 191832, 222000, 188760, 222000, 185688, 222000, 182616, 222000,
+    179544, 222000, 176472, 222000, 173400, 222000, 170328, 222000, 167256, 222000, 164184, 222000, 161112, 222000, 158040, 222000,
+    154967, 222000, 151895, 222000, 148823, 222000, 145751, 222000, 142679, 222000, 139607, 222000, 136535, 222000, 133463, 222000,
+    130391, 222000, 127319, 222000, 124247, 222000, 121175, 222000, 118103, 222000, 115031, 222000, 111959, 222000, 108887, 222000,
+    105815, 222000, 102743, 222000, 99671, 222000, 96599, 222000, 93527, 222000, 90455, 222000, 87383, 222000, 84311, 222000,
+    81239, 222000, 78167, 222000, 75165, 222000, 74000, 221563, 74000, 218897, 74000, 215824, 74000, 212752, 74000, 209680,
+    74000, 206608, 74000, 203536, 74000, 200464, 74000, 197392, 74000, 194320, 74000, 191248, 74000, 188176, 74000, 185104,
+    74000, 182032, 74000, 178960, 74000, 175888, 74000, 172816, 74000, 169744, 74000, 166672, 74000, 163600, 74000, 160528,
+    74000, 157456, 74000, 154384, 74000, 151312, 74000, 148240, 74000, 145168, 74000, 142096, 74000, 139024, 74000, 135952,
+    74000, 132880, 74000, 129808, 74000, 126735, 74000, 123663, 74000, 120591, 74000, 117519, 74000, 114447, 74000, 111375,
+    74000, 108303, 74000, 105231, 74000, 102159, 74000, 99087, 74000, 96015, 74000, 92943, 74000, 89871, 74000, 86799,
+    74000, 83727, 74000, 80655, 74000, 77583, 74000, 74731, 74802, 74000, 77686, 74000, 80758, 74000, 83831, 74000,
+    86903, 74000, 89975, 74000, 93047, 74000, 96119, 74000, 99191, 74000, 102263, 74000, 105335, 74000, 108407, 74000,
+    111479, 74000, 114551, 74000, 117623, 74000, 120695, 74000, 123767, 74000, 126839, 74000, 129911, 74000, 132983, 74000,
+    136055, 74000, 139127, 74000, 142199, 74000, 145271, 74000, 148343, 74000, 151415, 74000, 154487, 74000, 157559, 74000,
+    160631, 74000, 163703, 74000, 166775, 74000, 169847, 74000, 172920, 74000, 175992, 74000, 179064, 74000, 182136, 74000,
+    185208, 74000, 188280, 74000, 191352, 74000, 194424, 74000, 197496, 74000, 200568, 74000, 203640, 74000, 206712, 74000,
+    209784, 74000, 212856, 74000, 215928, 74000, 219000, 74000, 221573, 74000, 222241, 74841, 221620, 76865, 220353, 77970,
+    219073, 81042, 217793, 84114, 216513, 87186, 215233, 90258, 213953, 93330, 212673, 96402, 211393, 99474, 210113, 102545,
+    208832, 105617, 207553, 108689, 206272, 111761, 204993, 114833, 203713, 117906, 202433, 120978, 201153, 124050, 199873, 127122,
+    198593, 130194, 197313, 133266, 196032, 136338, 194753, 139410, 193472, 142482, 192193, 145554, 190912, 148626, 189633, 151698,
+    188353, 154770, 187073, 157842, 185792, 160914, 184973, 162851, 183275, 163246, 182154, 162376, 180848, 161148, 177776, 159919,
+    174704, 158690, 171634, 157461, 168562, 156233, 165490, 155004, 162419, 153775, 159347, 152546, 156275, 151318, 153203, 150088,
+    150131, 148860, 148100, 148041, 147636, 149121, 147580, 149828, 147946, 149828, 148460, 150638, 149919, 152763, 152884, 154126,
+    155956, 154531, 159028, 154379, 160214, 153688, 162767, 152184, 165318, 149578, 167300, 146506, 168485, 143434, 169272, 140362,
+    169414, 137290, 169540, 134929, 169201, 134929, 168834, 131916, 168016, 129656, 166886, 126584, 165302, 123854, 163072, 120986,
+    160349, 118154, 157277, 115675, 154205, 113722, 151133, 112294, 148061, 111019, 144989, 110315, 141917, 109627, 138845, 109468,
+    135773, 109308, 133177, 109356, 131763, 109719, 128702, 110081, 126346, 110766, 123274, 111668, 120213, 112741, 117458, 114237,
+    114386, 115807, 111506, 117986, 108442, 120229, 105534, 123267, 102760, 126339, 100568, 129411, 98391, 132483, 96983, 135555,
+    95480, 138628, 94381, 141700, 93462, 144772, 92543, 147844, 92119, 150916, 91735, 153988, 91344, 157060, 90997, 160079,
+    90733, 160079, 90553, 160079, 90456, 160079, 90475, 160079, 90587, 160079, 90698, 160079, 90810, 160079, 90922, 160079,
+    91033, 160079, 91145, 160079, 91257, 160079, 91368, 160079, 91480, 160416, 91593, 163488, 91708, 166560, 92096, 168650,
+    92717, 171353, 93339, 174425, 94108, 177497, 95272, 180135, 96436, 183207, 97721, 186277, 99499, 189111, 101277, 192181,
+    103265, 195253, 105785, 198155, 108304, 201224, 111194, 203955, 114266, 206662, 117338, 209353, 120410, 211189, 123482, 213118,
+    126554, 214983, 129626, 216277, 132698, 217574, 135770, 218869, 138842, 219947, 141914, 220527, 144986, 221272, 148058, 222016,
+    151130, 222244, 154202, 222481, 157274, 222718, 160346, 222952, 162902, 223061, 162902, 222818, 164161, 222560, 167229, 222302,
+    170301, 222044, 173373, 221730, 175559, 221020, 178631, 220254, 181703, 219488, 184775, 218699, 187493, 217441, 190564, 216125,
+    193635, 214809, 196706, 213435, 199570, 211505, 202642, 209557, 205714, 207609, 208786, 205323, 211703, 202600, 214775, 199878,
+    217664, 197068, 220155, 193996, 222663, 190924, 225177, 187852, 227048, 184780, 228827, 181708, 230609, 178636, 232391, 175564,
+    233593, 172491, 234768, 169419, 235943, 166347, 237120, 163275, 238128, 160203, 238593, 157131, 239236, 154059, 239878, 150987,
+    240520, 147915, 240648, 144843, 240792, 141771, 240935, 138699, 241078, 135627, 241214, 132555, 240991, 130247, 240643, 128388,
+    240294, 125318, 239946, 122247, 239598, 119178, 239090, 116107, 238235, 113749, 237377, 110677, 236519, 107605, 235662, 104533,
+    234583, 101461, 233168, 98695, 231753, 95623, 230339, 92551, 228923, 89480, 227040, 86604, 224979, 83532, 222918, 80460,
+    220858, 77392, 218494, 74320, 215633, 71405, 212772, 68333, 209910, 65261, 206921, 62502, 203849, 60243, 200777, 57851,
+    197705, 55458, 194633, 53173, 191561, 51664, 188489, 49975, 185417, 48286, 182345, 46597, 179273, 45066, 176201, 44167,
+    173129, 43070, 170057, 41971, 166985, 40873, 163913, 39805, 160841, 39397, 157769, 38825, 154697, 38250, 151625, 37676,
+    148553, 37101, 145481, 36924, 142409, 36854, 139337, 36773, 136264, 36693, 133192, 36614, 130120, 36572, 127048, 36983,
+    123976, 37392, 120904, 37802, 117832, 38212, 114760, 38622, 111688, 39061, 109199, 39913, 106133, 40834, 103061, 41755,
+    99989, 42676, 96923, 43598, 93851, 44611, 91063, 46090, 87991, 47574, 84919, 49058, 81847, 50543, 78775, 52027,
+    75834, 53955, 72815, 56095, 69743, 58237, 66672, 60378, 63600, 62519, 60679, 65161, 57606, 68123, 54534, 71086,
+    51468, 74049, 48459, 77038, 46282, 80110, 43981, 83182, 41669, 86254, 39358, 89326, 37077, 92398, 35571, 95470,
+    33947, 98542, 32324, 101614, 30699, 104686, 29074, 107758, 27573, 110830, 26727, 113902, 25681, 116974, 24635, 120046,
+    23589, 123118, 22543, 126190, 21708, 129262, 21182, 132335, 20656, 135407, 20129, 138479, 19603, 141551, 19076, 144623,
+    18550, 147695, 18468, 150767, 18434, 153839, 18399, 156911, 18364, 159983, 18329, 163055, 18294, 166127, 18368, 169199,
+    18822, 172271, 19276, 175343, 19731, 178415, 20186, 181487, 20640, 184559, 21095, 187631, 21644, 190703, 22598, 193238,
+    23566, 196310, 24535, 199382, 25503, 202454, 26471, 205526, 27439, 208598, 28704, 211670, 30240, 214475, 31776, 217547,
+    33311, 220611, 34847, 223683, 36383, 226755, 38081, 229827, 40282, 232724, 42484, 235796, 44685, 238868, 46886, 241940,
+    49088, 245012, 51676, 248084, 54715, 251002, 57754, 254074, 60792, 257146, 63832, 260218, 66887, 263075, 69959, 265139,
+    73031, 267391, 76103, 269636, 79175, 271888, 82247, 274140, 85319, 276141, 88391, 277531, 91464, 279109, 94536, 280687,
+    97608, 282265, 100680, 283843, 103752, 285415, 106824, 286363, 109896, 287367, 112968, 288372, 116040, 289378, 119112, 290382,
+    122184, 291388, 125256, 292393, 128328, 292863, 131400, 293353, 134472, 293844, 137544, 294334, 140616, 294824, 143688, 295315,
+    146681, 295791, 147995, 295999
+};
+
+static const int32_t GoldenTrace_XYBot[] = {
+    0, 0, 50, 33, 199, 132, 440, 293, 767, 511, 1178, 785, 1667, 1111, 2231, 1487,
+    2866, 1910, 3569, 2379, 4337, 2891, 5166, 3444, 6014, 4009, 6863, 4575, 7713, 5141, 8561, 5707,
+    9410, 6273, 10259, 6839, 11108, 7405, 11957, 7971, 12806, 8537, 13655, 9103, 14504, 9669, 15353, 10235,
+    16202, 10801, 17050, 11367, 17899, 11932, 18748, 12498, 19597, 13064, 20446, 13631, 21295, 14196, 22144, 14763,
+    22993, 15329, 23842, 15894, 24691, 16460, 25528, 17019, 26309, 17539, 27026, 18017, 27676, 18451, 28254, 18836,
+    28759, 19173, 29186, 19457, 29531, 19687, 29789, 19859, 29955, 19970, 30000, 20060, 30000, 20241, 30000, 20500,
+    30000, 20845, 30000, 21273, 30000, 21778, 30000, 22357, 30000, 23006, 30000, 23723, 30000, 24505, 30000, 25338,
+    30000, 26133, 30000, 26864, 30000, 27528, 30000, 28122, 30000, 28643, 30000, 29087, 30000, 29450, 30000, 29727,
+    30000, 29914, 29995, 30000, 29886, 30000, 29685, 30000, 29398, 30000, 29026, 30000, 28573, 30000, 28044, 30000,
+    27442, 30000, 26770, 30000, 26032, 30000, 25231, 30000, 24384, 30000, 23534, 30000, 22685, 30000, 21836, 30000,
+    20987, 30000, 20137, 30000, 19288, 30000, 18439, 30000, 17589, 30000, 16740, 30000, 15891, 30000, 15041, 30000,
+    14219, 30000, 13459, 30000, 12764, 30000, 12138, 30000, 11583, 30000, 11104, 30000, 10704, 30000, 10387, 30000,
+    10159, 30000, 10024, 30000, 10000, 29947, 10000, 29786, 10000, 29539, 10000, 29204, 10000, 28788, 10000, 28293,
+    10000, 27723, 10000, 27082, 10000, 26374, 10000, 25601, 10000, 24768, 10000, 23919, 10000, 23069, 10000, 22220,
+    10000, 21371, 10000, 20522, 10000, 19672, 10000, 18823, 10000, 17974, 10000, 17124, 10000, 16275, 10000, 15426,
+    10000, 14584, 10000, 13795, 10000, 13070, 10000, 12412, 10000, 11825, 10000, 11311, 10000, 10875, 10000, 10520,
+    10000, 10251, 10000, 10074, 10011, 10000, 10130, 10000, 10338, 10000, 10634, 10000, 11014, 10000, 11474, 10000,
+    12010, 10000, 12619, 10000, 13297, 10000, 14041, 10000, 14849, 10000, 15697, 10000, 16546, 10000, 17396, 10000,
+    18245, 10000, 19094, 10000, 19943, 10000, 20793, 10000, 21642, 10000, 22491, 10000, 23341, 10000, 24190, 10000,
+    25039, 10000, 25855, 10000, 26609, 10000, 27297, 10000, 27916, 10000, 28463, 10000, 28935, 10000, 29327, 10000,
+    29634, 10000, 29853, 10000, 29978, 10000, 29984, 10040, 29925, 10183, 29828, 10416, 29694, 10737, 29526, 11141,
+    29324, 11624, 29092, 12182, 28830, 12811, 28539, 13508, 28221, 14272, 27878, 15096, 27524, 15945, 27170, 16794,
+    26824, 17626, 26502, 18399, 26206, 19107, 25941, 19746, 25703, 20315, 25497, 20809, 25324, 21225, 25185, 21558,
+    25082, 21804, 25019, 21956, 24969, 21988, 24829, 21932, 24601, 21841, 24286, 21715, 23886, 21555, 23408, 21364,
+    22855, 21143, 22242, 20897, 21675, 20671, 21184, 20474, 20771, 20309, 20441, 20177, 20198, 20080, 20046, 20019,
+    20003, 20019, 20022, 20138, 20086, 20340, 20270, 20595, 20627, 20819, 21127, 20883, 21687, 20730, 22235, 20336,
+    22653, 19697, 22866, 18906, 22845, 18060, 22589, 17226, 22091, 16423, 21365, 15705, 20545, 15227, 19709, 14935,
+    18865, 14799, 18021, 14802, 17180, 14938, 16349, 15206, 15524, 15621, 14729, 16193, 13974, 16954, 13391, 17771,
+    12966, 18609, 12668, 19443, 12464, 20286, 12357, 21133, 12373, 21979, 12462, 22819, 12633, 23665, 12933, 24495,
+    13311, 25320, 13795, 26158, 14435, 26946, 15200, 27712, 16004, 28369, 16839, 28893, 17672, 29291, 18508, 29638,
+    19357, 29844, 20203, 30015, 21047, 30081, 21894, 30101, 22741, 30029, 23583, 29903, 24429, 29692, 25257, 29418,
+    26099, 29058, 26913, 28617, 27742, 28091, 28537, 27440, 29350, 26703, 30037, 25864, 30633, 25052, 31124, 24207,
+    31539, 23379, 31863, 22533, 32146, 21695, 32322, 20851, 32498, 20008, 32539, 19165, 32578, 18318, 32534, 17474,
+    32438, 16628, 32310, 15787, 32075, 14943, 31838, 14096, 31480, 13276, 31090, 12429, 30614, 11606, 30049, 10763,
+    29418, 9949, 28659, 9135, 27862, 8389, 27021, 7734, 26207, 7160, 25361, 6694, 24531, 6238, 23685, 5926,
+    22836, 5622, 21994, 5374, 21146, 5215, 20298, 5056, 19455, 4987, 18612, 4965, 17769, 4942, 16927, 5029,
+    16081, 5143, 15233, 5256, 14397, 5502, 13549, 5757, 12710, 6034, 11879, 6436, 11032, 6845, 10209, 7326,
+    9371, 7909, 8523, 8500, 7737, 9254, 6917, 10046, 6230, 10864, 5594, 11709, 5010, 12522, 4563, 13368,
+    4114, 14216, 3731, 15045, 3444, 15890, 3156, 16735, 2917, 17574, 2772, 18420, 2627, 19268, 2499, 20116,
+    2490, 20960, 2480, 21804, 2471, 22647, 2574, 23491, 2700, 24338, 2825, 25185, 3025, 26021, 3292, 26868,
+    3560, 27716, 3871, 28549, 4290, 29388, 4714, 30235, 5170, 31065, 5752, 31877, 6360, 32725, 7019, 33538,
+    7804, 34333, 8607, 35144, 9429, 35808, 10276, 36430, 11101, 37035, 11937, 37499, 12783, 37933, 13625, 38366,
+    14459, 38704, 15295, 38978, 16075, 39233, 16790, 39467, 17457, 39594, 18058, 39690, 18586, 39774, 19037, 39846,
+    19408, 39905, 19693, 39951, 19889, 39982, 19992, 39998
+};
+
+static const GoldenTrace GoldenTraces[] = {
+    { "SandTableScaraPiHat2", 1526411, { 9599, -4801 }, 306, GoldenTrace_SandTableScaraPiHat2 },
+    { "SandTableScaraPiHat3.6", 2349025, { 9599, -4801 }, 470, GoldenTrace_SandTableScaraPiHat3_6 },
+    { "SandTableScaraPiHat4", 2118201, { 9600, -4800 }, 424, GoldenTrace_SandTableScaraPiHat4 },
+    { "SandTableScaraMatt", 8182955, { 9599, -4801 }, 1637, GoldenTrace_SandTableScaraMatt },
+    { "NejeMasterPiHat3.6", 1736030, { 20000, 39999 }, 348, GoldenTrace_NejeMasterPiHat3_6 },
+    { "NejeMasterPiHat3.9", 1736030, { 20000, 39999 }, 348, GoldenTrace_NejeMasterPiHat3_9 },
+    { "NejeMasterPiHat4", 2965301, { 148001, 296000 }, 594, GoldenTrace_NejeMasterPiHat4 },
+    { "XYBot", 1736030, { 20000, 39999 }, 348, GoldenTrace_XYBot },
+};
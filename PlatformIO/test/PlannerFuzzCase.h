@@ -0,0 +1,255 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+#include "../src/RobotMotion/MotionControl/MotionPlanner.h"
+#include "../src/RobotMotion/MotionControl/RampGenerator/RampGenerator.h"
+
+// Property check of the planner and step generation for an arbitrary byte string
+// The bytes are decoded into an axis configuration, planner settings and a sequence of moves
+// (with feedrates and a number of step generator ticks to run after each one so that blocks are
+// executing while later moves are planned) - invariants are checked as the moves are planned
+// and once all motion has completed:
+// - speeds are continuous between blocks and within the feedrate and max entry speed
+// - each block's speed change is achievable with its acceleration
+// - no axis exceeds its own max speed or acceleration
+// - step rates and accelerations can't overflow the RampGenerator's TTICKS arithmetic
+// - the steps generated on each axis match the planned target
+// Used by UnitTestPlannerFuzz and the libFuzzer target in Tests/FuzzPlanner
+class PlannerFuzzCase
+{
+public:
+    static constexpr int MAX_MOVES = 12;
+    static constexpr int MAX_STEPS_PER_MOVE = 1000;
+    static constexpr int PIPELINE_LEN_MIN = 3;
+    static constexpr int PIPELINE_LEN_MAX = 40;
+    static constexpr uint32_t MAX_TICKS = 20000000;
+    static constexpr float SPEED_TOLERANCE = 0.001f;
+    static constexpr float AXIS_LIMIT_TOLERANCE = 0.02f;
+    static constexpr int FAIL_MSG_LEN = 200;
+
+    PlannerFuzzCase()
+    {
+        _failMsg[0] = 0;
+    }
+
+    // Returns NULL if all invariants hold - otherwise a description of the first failure
+    const char* run(const uint8_t* pData, size_t dataLen)
+    {
+        _pData = pData;
+        _dataLen = dataLen;
+        _dataPos = 0;
+        _failMsg[0] = 0;
+
+        // Axis configuration
+        char configJSON[400];
+        float stepsPerRot[2], unitsPerRot[2], maxSpeed[2], maxAcc[2], maxRPM[2];
+        for (int axisIdx = 0; axisIdx < 2; axisIdx++)
+        {
+            stepsPerRot[axisIdx] = 200.0f * (1 + getByte() % 16);
+            unitsPerRot[axisIdx] = 1 + getByte() % 64;
+            maxSpeed[axisIdx] = 5 + getByte();
+            maxAcc[axisIdx] = 10 + getByte() * 4;
+            maxRPM[axisIdx] = 60 + getByte() * 12;
+        }
+        snprintf(configJSON, sizeof(configJSON),
+                "{\"axis0\":{\"maxSpeed\":%.1f,\"maxAcc\":%.1f,\"stepsPerRot\":%.1f,\"unitsPerRot\":%.1f,\"maxRPM\":%.1f},"
+                "\"axis1\":{\"maxSpeed\":%.1f,\"maxAcc\":%.1f,\"stepsPerRot\":%.1f,\"unitsPerRot\":%.1f,\"maxRPM\":%.1f},"
+                "\"axis2\":{\"isPrimaryAxis\":0}}",
+                maxSpeed[0], maxAcc[0], stepsPerRot[0], unitsPerRot[0], maxRPM[0],
+                maxSpeed[1], maxAcc[1], stepsPerRot[1], unitsPerRot[1], maxRPM[1]);
+        AxesParams axesParams;
+        String axisJSON;
+        for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
+            axesParams.configureAxis(configJSON, axisIdx, axisJSON);
+
+        // Planner
+        int pipelineLen = PIPELINE_LEN_MIN + getByte() % (PIPELINE_LEN_MAX - PIPELINE_LEN_MIN + 1);
+        float junctionDeviation = 0.001f + getByte() / 256.0f;
+        MotionPlanner::PlannerMode plannerMode = (getByte() & 1) ? MotionPlanner::PLANNER_MODE_CURVATURE_LIMITED :
+                    MotionPlanner::PLANNER_MODE_JUNCTION_DEVIATION;
+        MotionPipeline motionPipeline;
+        motionPipeline.init(pipelineLen);
+        MotionPlanner motionPlanner;
+        motionPlanner.configure(junctionDeviation, plannerMode);
+        AxisPosition curAxisPositions;
+        curAxisPositions.clear();
+
+        // Step generation is ticked from here (the timer is never started)
+        RampGenerator rampGenerator(&motionPipeline);
+        rampGenerator.configureAxis(0, R"({"stepPin":"27","dirnPin":"33"})");
+        rampGenerator.configureAxis(1, R"({"stepPin":"12","dirnPin":"16"})");
+        rampGenerator.configure(false);
+        rampGenerator.pause(false);
+        _pRampGenerator = &rampGenerator;
+        _tickCount = 0;
+        _plannedMoveDeltas.clear();
+
+        // Moves
+        int numMoves = 1 + getByte() % MAX_MOVES;
+        for (int moveIdx = 0; moveIdx < numMoves; moveIdx++)
+        {
+            // Destination limited so each axis has a bounded number of steps
+            float dest[2];
+            for (int axisIdx = 0; axisIdx < 2; axisIdx++)
+            {
+                float maxDeltaMM = MAX_STEPS_PER_MOVE / axesParams.getStepsPerUnit(axisIdx);
+                float deltaMM = (int8_t(getByte()) / 128.0f) * fminf(maxDeltaMM, 10);
+                dest[axisIdx] = curAxisPositions._axisPositionMM.getVal(axisIdx) + deltaMM;
+            }
+            uint8_t flags = getByte();
+            RobotCommandArgs args;
+            args.setAxisValMM(0, dest[0], true);
+            args.setAxisValMM(1, dest[1], true);
+            args.setAxisValMM(2, 0, true);
+            if (flags & 0x01)
+                args.setFeedrate(5 + getByte());
+            args.setMoreMovesComing((flags & 0x02) != 0);
+            uint32_t ticksAfter = (flags & 0x04) ? getByte() * 100 : 0;
+
+            // Wait for space in the pipeline
+            while (!motionPipeline.canAccept() && (_tickCount < MAX_TICKS))
+                tick();
+            if (!motionPipeline.canAccept())
+                return fail("pipeline never accepted move %d", moveIdx);
+
+            // Plan
+            AxisFloats destActuatorCoords(dest[0] * axesParams.getStepsPerUnit(0),
+                        dest[1] * axesParams.getStepsPerUnit(1), 0);
+            if (motionPlanner.moveTo(args, destActuatorCoords, curAxisPositions, axesParams, motionPipeline))
+            {
+                _plannedMoveDeltas.push_back(AxisFloats(dest[0] - curAxisPositions._axisPositionMM.getVal(0),
+                            dest[1] - curAxisPositions._axisPositionMM.getVal(1), 0));
+                curAxisPositions._axisPositionMM.set(dest[0], dest[1], 0);
+            }
+            const char* pFailMsg = checkPipeline(motionPipeline, axesParams);
+            if (pFailMsg)
+                return pFailMsg;
+
+            for (uint32_t tickIdx = 0; tickIdx < ticksAfter; tickIdx++)
+                tick();
+        }
+
+        // Blocks held back for following moves can now execute
+        for (unsigned int blockIdx = 0; blockIdx < motionPipeline.count(); blockIdx++)
+        {
+            MotionBlockExec* pExec = motionPipeline.peekExecNthFromGet(blockIdx);
+            if (pExec)
+                pExec->_canExecute = true;
+        }
+
+        // Run to completion
+        while (motionPipeline.canGet() && (_tickCount < MAX_TICKS))
+            tick();
+        if (motionPipeline.canGet())
+            return fail("motion not complete after %u ticks", _tickCount);
+        for (int tickIdx = 0; tickIdx < 2; tickIdx++)
+            tick();
+
+        // Steps generated match the target
+        AxisInt32s totalSteps;
+        rampGenerator.getTotalStepPosition(totalSteps);
+        for (int axisIdx = 0; axisIdx < 2; axisIdx++)
+        {
+            if (totalSteps.getVal(axisIdx) != curAxisPositions._stepsFromHome.getVal(axisIdx))
+                return fail("axis %d stepped to %d target %d", axisIdx, totalSteps.getVal(axisIdx),
+                            curAxisPositions._stepsFromHome.getVal(axisIdx));
+        }
+        return NULL;
+    }
+
+private:
+    const uint8_t* _pData;
+    size_t _dataLen;
+    size_t _dataPos;
+    RampGenerator* _pRampGenerator;
+    uint32_t _tickCount;
+    // Deltas (in MM) of the moves planned so far - the blocks in the pipeline are the most recent
+    std::vector<AxisFloats> _plannedMoveDeltas;
+    char _failMsg[FAIL_MSG_LEN];
+
+    // Next input byte (zero once the input is exhausted)
+    uint8_t getByte()
+    {
+        if (_dataPos >= _dataLen)
+            return 0;
+        return _pData[_dataPos++];
+    }
+
+    void tick()
+    {
+        _pRampGenerator->testTick();
+        _tickCount++;
+    }
+
+    template<typename... Args>
+    const char* fail(const char* pFormat, Args... args)
+    {
+        snprintf(_failMsg, FAIL_MSG_LEN, pFormat, args...);
+        return _failMsg;
+    }
+
+    const char* checkPipeline(MotionPipeline &motionPipeline, AxesParams &axesParams)
+    {
+        MotionBlock* pPrevBlock = NULL;
+        unsigned int firstMoveIdx = _plannedMoveDeltas.size() - motionPipeline.count();
+        for (unsigned int blockIdx = 0; blockIdx < motionPipeline.count(); blockIdx++)
+        {
+            MotionBlock* pBlock = motionPipeline.peekNthFromGet(blockIdx);
+            MotionBlockExec* pExec = motionPipeline.peekExecNthFromGet(blockIdx);
+            if (!pBlock || !pExec)
+                break;
+            float entry = pBlock->_entrySpeedMMps;
+            float exit = pBlock->_exitSpeedMMps;
+            float speedTol = SPEED_TOLERANCE * fmaxf(1, fmaxf(entry, exit));
+
+            // Speeds continuous and within limits
+            if (pPrevBlock && (fabsf(pPrevBlock->_exitSpeedMMps - entry) > speedTol))
+                return fail("block %d entry %f != previous exit %f", blockIdx, entry, pPrevBlock->_exitSpeedMMps);
+            if ((entry > pBlock->_feedrate + speedTol) || (exit > pBlock->_feedrate + speedTol))
+                return fail("block %d entry %f exit %f above feedrate %f", blockIdx, entry, exit, pBlock->_feedrate);
+            if (entry > pBlock->_maxEntrySpeedMMps + speedTol)
+                return fail("block %d entry %f above max entry %f", blockIdx, entry, pBlock->_maxEntrySpeedMMps);
+
+            // Speed change achievable
+            float acc = MotionPlanner::getBlockAccMMps2(*pBlock, axesParams);
+            float maxSpeedChangeSq = 2 * acc * pBlock->_moveDistPrimaryAxesMM;
+            if (fabsf(exit * exit - entry * entry) > maxSpeedChangeSq * (1 + SPEED_TOLERANCE) + speedTol)
+                return fail("block %d entry %f exit %f not achievable with acc %f over %fmm", blockIdx,
+                            entry, exit, acc, pBlock->_moveDistPrimaryAxesMM);
+
+            // Axis limits
+            AxisFloats& moveDelta = _plannedMoveDeltas[firstMoveIdx + blockIdx];
+            for (int axisIdx = 0; axisIdx < 2; axisIdx++)
+            {
+                float unitVec = fabsf(moveDelta.getVal(axisIdx) / pBlock->_moveDistPrimaryAxesMM);
+                float limitTol = 1 + AXIS_LIMIT_TOLERANCE;
+                if (pBlock->_feedrate * unitVec > axesParams.getMaxSpeed(axisIdx) * limitTol)
+                    return fail("block %d axis %d speed %f above max %f", blockIdx, axisIdx,
+                                pBlock->_feedrate * unitVec, axesParams.getMaxSpeed(axisIdx));
+                if (acc * unitVec > axesParams.getMaxAccel(axisIdx) * limitTol)
+                    return fail("block %d axis %d acc %f above max %f", blockIdx, axisIdx,
+                                acc * unitVec, axesParams.getMaxAccel(axisIdx));
+            }
+
+            // TTICKS arithmetic - step rates are at most one step per tick so the step accumulator
+            // (less than TTICKS_VALUE before each addition) can't overflow and neither can a rate
+            // plus an acceleration increment
+            if ((pExec->_initialStepRatePerTTicks > MotionBlock::TTICKS_VALUE) ||
+                        (pExec->_maxStepRatePerTTicks > MotionBlock::TTICKS_VALUE) ||
+                        (pExec->_finalStepRatePerTTicks > MotionBlock::TTICKS_VALUE))
+                return fail("block %d step rate (%u %u %u) above one step per tick", blockIdx,
+                            pExec->_initialStepRatePerTTicks, pExec->_maxStepRatePerTTicks, pExec->_finalStepRatePerTTicks);
+            if (uint64_t(pExec->_accStepsPerTTicksPerMS) + MotionBlock::TTICKS_VALUE > UINT32_MAX)
+                return fail("block %d acc %u overflows", blockIdx, pExec->_accStepsPerTTicksPerMS);
+            if (pExec->_stepsBeforeDecel > uint32_t(pExec->getAbsStepsToTarget(pExec->_axisIdxWithMaxSteps)))
+                return fail("block %d steps before decel %u above steps %d", blockIdx,
+                            pExec->_stepsBeforeDecel, pExec->getAbsStepsToTarget(pExec->_axisIdxWithMaxSteps));
+            pPrevBlock = pBlock;
+        }
+        return NULL;
+    }
+};
@@ -0,0 +1,224 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+#pragma once
+
+#include "../src/RobotMotion/MotionControl/Trinamics/TrinamicsSPIBus.h"
+#include "../src/RobotMotion/MotionControl/Trinamics/TrinamicsRampRegs.h"
+#include "../src/RobotMotion/MotionControl/Trinamics/TMC5072_registers.h"
+
+// Register-level simulation of TMC5072 chips on the SPI bus
+// Replaces the hardware bus in TrinamicsController (setSPIBus) and models each
+// driver's positioning ramp (VSTART -> AMAX -> VMAX -> DMAX -> VSTOP) closely enough
+// to check streaming of blocks
+class TrinamicsSimulator : public TrinamicsSPIBus
+{
+public:
+    static constexpr int NUM_CHIPS = 2;
+    static constexpr int NUM_DRIVERS = 2;
+    static constexpr int NUM_REGS = 128;
+
+    TrinamicsSimulator(float clockHz = TrinamicsRampRegs::CLOCK_HZ_DEFAULT)
+    {
+        _clockHz = clockHz;
+        for (int chipIdx = 0; chipIdx < NUM_CHIPS; chipIdx++)
+        {
+            for (int regIdx = 0; regIdx < NUM_REGS; regIdx++)
+                _regs[chipIdx][regIdx] = 0;
+            _readData[chipIdx] = 0;
+            for (int drvIdx = 0; drvIdx < NUM_DRIVERS; drvIdx++)
+            {
+                _pos[chipIdx][drvIdx] = 0;
+                _vel[chipIdx][drvIdx] = 0;
+            }
+        }
+        _xTargetWrites = 0;
+    }
+
+    virtual bool isChipSelectable(int chipIdx)
+    {
+        return (chipIdx >= 0) && (chipIdx < NUM_CHIPS);
+    }
+
+    virtual bool execBatch(TrinamicsSPIBatch& batch)
+    {
+        for (int i = 0; i < batch.count(); i++)
+        {
+            TrinamicsSPIBatch::Datagram* pDatagram = batch.getDatagram(i);
+            int chipIdx = pDatagram->chipIdx;
+            if (!isChipSelectable(chipIdx))
+                return false;
+            uint8_t cmd = pDatagram->txBuf[0];
+            uint32_t data = ((uint32_t)pDatagram->txBuf[1] << 24) | ((uint32_t)pDatagram->txBuf[2] << 16) |
+                            ((uint32_t)pDatagram->txBuf[3] << 8) | pDatagram->txBuf[4];
+
+            // Response carries the data for the previous read on this chip
+            pDatagram->rxBuf[0] = 0;
+            pDatagram->rxBuf[1] = (_readData[chipIdx] >> 24) & 0xff;
+            pDatagram->rxBuf[2] = (_readData[chipIdx] >> 16) & 0xff;
+            pDatagram->rxBuf[3] = (_readData[chipIdx] >> 8) & 0xff;
+            pDatagram->rxBuf[4] = _readData[chipIdx] & 0xff;
+
+            uint8_t reg = cmd & ~TMC5072_WRITE;
+            if (cmd & TMC5072_WRITE)
+            {
+                writeReg(chipIdx, reg, data);
+                _readData[chipIdx] = data;
+            }
+            else
+            {
+                _readData[chipIdx] = readReg(chipIdx, reg);
+            }
+        }
+        return true;
+    }
+
+    // Advance time - the ramps are integrated in small time steps
+    void advance(float secs)
+    {
+        const float SIM_STEP_SECS = 0.0001f;
+        for (float t = 0; t < secs; t += SIM_STEP_SECS)
+            for (int chipIdx = 0; chipIdx < NUM_CHIPS; chipIdx++)
+                for (int drvIdx = 0; drvIdx < NUM_DRIVERS; drvIdx++)
+                    advanceDriver(chipIdx, drvIdx, SIM_STEP_SECS);
+    }
+
+    int32_t getXActual(int chipIdx, int drvIdx)
+    {
+        return (int32_t)_pos[chipIdx][drvIdx];
+    }
+
+    bool isMoving(int chipIdx, int drvIdx)
+    {
+        return _vel[chipIdx][drvIdx] != 0;
+    }
+
+    bool anyMoving()
+    {
+        for (int chipIdx = 0; chipIdx < NUM_CHIPS; chipIdx++)
+            for (int drvIdx = 0; drvIdx < NUM_DRIVERS; drvIdx++)
+                if (isMoving(chipIdx, drvIdx))
+                    return true;
+        return false;
+    }
+
+    uint32_t getReg(int chipIdx, int drvIdx, uint8_t baseReg)
+    {
+        return _regs[chipIdx][baseReg + drvRegOffset(drvIdx)];
+    }
+
+    int getXTargetWrites()
+    {
+        return _xTargetWrites;
+    }
+
+private:
+    float _clockHz;
+    uint32_t _regs[NUM_CHIPS][NUM_REGS];
+    uint32_t _readData[NUM_CHIPS];
+    double _pos[NUM_CHIPS][NUM_DRIVERS];
+    float _vel[NUM_CHIPS][NUM_DRIVERS];
+    int _xTargetWrites;
+
+    static int drvRegOffset(int drvIdx)
+    {
+        return drvIdx == 0 ? TMC5072_MOTOR0 : TMC5072_MOTOR1;
+    }
+
+    static int regToDriver(uint8_t reg)
+    {
+        if ((reg >= TMC5072_MOTOR0) && (reg < TMC5072_MOTOR1))
+            return 0;
+        if ((reg >= TMC5072_MOTOR1) && (reg < TMC5072_MOTOR1 + 0x20))
+            return 1;
+        return -1;
+    }
+
+    void writeReg(int chipIdx, uint8_t reg, uint32_t data)
+    {
+        _regs[chipIdx][reg] = data;
+        int drvIdx = regToDriver(reg);
+        if (drvIdx < 0)
+            return;
+        uint8_t baseReg = reg - drvRegOffset(drvIdx);
+        if (baseReg == TMC5072_XACTUAL)
+            _pos[chipIdx][drvIdx] = (int32_t)data;
+        else if (baseReg == TMC5072_XTARGET)
+            _xTargetWrites++;
+    }
+
+    uint32_t readReg(int chipIdx, uint8_t reg)
+    {
+        int drvIdx = regToDriver(reg);
+        if (drvIdx < 0)
+            return _regs[chipIdx][reg];
+        uint8_t baseReg = reg - drvRegOffset(drvIdx);
+        if (baseReg == TMC5072_XACTUAL)
+            return (uint32_t)getXActual(chipIdx, drvIdx);
+        if (baseReg == TMC5072_RAMPSTAT)
+        {
+            uint32_t rampStat = 0;
+            if (getXActual(chipIdx, drvIdx) == (int32_t)getReg(chipIdx, drvIdx, TMC5072_XTARGET))
+                rampStat |= TMC5072_RS_POSREACHED;
+            if (!isMoving(chipIdx, drvIdx))
+                rampStat |= TMC5072_RS_VZERO;
+            return rampStat;
+        }
+        return _regs[chipIdx][reg];
+    }
+
+    void advanceDriver(int chipIdx, int drvIdx, float dt)
+    {
+        // Velocity is signed (positive towards increasing XACTUAL)
+        double& pos = _pos[chipIdx][drvIdx];
+        float& vel = _vel[chipIdx][drvIdx];
+        double dist = (int32_t)getReg(chipIdx, drvIdx, TMC5072_XTARGET) - pos;
+        if ((fabs(dist) < 1) && (fabsf(vel) == 0))
+        {
+            pos = (int32_t)getReg(chipIdx, drvIdx, TMC5072_XTARGET);
+            return;
+        }
+        float vStart = TrinamicsRampRegs::stepRateFromVel(getReg(chipIdx, drvIdx, TMC5072_VSTART), _clockHz);
+        float vMax = TrinamicsRampRegs::stepRateFromVel(getReg(chipIdx, drvIdx, TMC5072_VMAX), _clockHz);
+        float vStop = TrinamicsRampRegs::stepRateFromVel(getReg(chipIdx, drvIdx, TMC5072_VSTOP), _clockHz);
+        float aMax = TrinamicsRampRegs::stepAccFromAcc(getReg(chipIdx, drvIdx, TMC5072_AMAX), _clockHz);
+        float dMax = TrinamicsRampRegs::stepAccFromAcc(getReg(chipIdx, drvIdx, TMC5072_DMAX), _clockHz);
+        float dirn = (dist >= 0) ? 1 : -1;
+        float speed = fabsf(vel);
+
+        // Moving away from the target (target changed direction) - decelerate to zero first
+        if ((speed > 0) && (vel * dirn < 0))
+        {
+            speed -= dMax * dt;
+            if ((speed <= 0) || (vMax == 0))
+                speed = 0;
+            vel = (vel < 0) ? -speed : speed;
+            pos += vel * dt;
+            return;
+        }
+
+        // Ramp
+        if ((speed == 0) && (vMax > 0))
+            speed = vStart;
+        float brakeDist = (dMax > 0) ? (speed * speed - vStop * vStop) / 2 / dMax : 0;
+        if ((vMax == 0) || (fabs(dist) <= brakeDist))
+            speed = fmaxf(speed - dMax * dt, vMax == 0 ? 0 : vStop);
+        else if (speed < vMax)
+            speed = fminf(speed + aMax * dt, vMax);
+        else
+            speed = fmaxf(speed - dMax * dt, vMax);
+
+        // Move - the velocity drops to zero from VSTOP at the target
+        double stepDist = speed * dt;
+        if (stepDist >= fabs(dist))
+        {
+            pos = (int32_t)getReg(chipIdx, drvIdx, TMC5072_XTARGET);
+            vel = 0;
+        }
+        else
+        {
+            pos += dirn * stepDist;
+            vel = dirn * speed;
+        }
+    }
+};
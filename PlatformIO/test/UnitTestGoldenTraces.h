@@ -0,0 +1,260 @@
+#pragma once
+
+#include <Arduino.h>
+#include <unity.h>
+#include <vector>
+#include "../src/RobotConfigurations.h"
+#include "../src/RobotMotion/MotionControl/MotionHelper.h"
+#include "../src/RobotMotion/Robots/RobotSandTableScara.h"
+#include "../src/RobotMotion/Robots/RobotXYBot.h"
+#include "TrinamicsSimulator.h"
+#include <ArduinoLog.h>
+
+// Define to print a replacement for GoldenTraces.h instead of checking the traces (Tests/GoldenTraces
+// does this on a host)
+// #define GOLDEN_TRACES_RECORD 1
+
+// Golden trace of a robot type - step positions of the first two axes sampled at a fixed
+// interval while running the test inputs
+struct GoldenTrace
+{
+    const char* robotType;
+    uint32_t totalTicks;
+    int32_t finalSteps[2];
+    int numSamples;
+    const int32_t* samples;
+};
+
+#include "GoldenTraces.h"
+
+// G-code style moves (absolute, as fractions of the robot's radius about its centre)
+static const float UnitTestGoldenTraces_GCodeMoves[][2] = {
+    { 0.5f, 0 },
+    { 0.5f, 0.5f },
+    { -0.5f, 0.5f },
+    { -0.5f, -0.5f },
+    { 0.5f, -0.5f },
+    { 0.25f, 0.1f },
+    { 0, 0 },
+};
+
+// Runs every robot configuration in RobotConfigurations through G-code style moves and a THR
+// (theta-rho) spiral - steps are generated by calling the RampGenerator ISR directly (or the
+// Trinamics controller's timer against the TrinamicsSimulator for ramp-generator chips) and the
+// sampled step positions are compared with the golden traces so that changes to planning or
+// step generation which alter the motion are detected
+class UnitTestGoldenTraces
+{
+public:
+    static constexpr int TRACE_AXES = 2;
+    static constexpr uint32_t SAMPLE_INTERVAL_TICKS = 5000;
+    static constexpr uint32_t SERVICE_INTERVAL_TICKS = 50;
+    static constexpr uint32_t MAX_TICKS = 20000000;
+    static constexpr int THR_POINTS = 80;
+    static constexpr float THR_TURNS = 2;
+    static constexpr float TRINAMICS_TIMER_PERIOD_SECS = 0.0005f;
+    static constexpr uint32_t TRINAMICS_TIMER_INTERVAL_TICKS = uint32_t(TRINAMICS_TIMER_PERIOD_SECS * MotionBlock::TICKS_PER_SEC);
+    // Tolerances - allow for floating point differences between the host and target
+    static constexpr int32_t SAMPLE_TOLERANCE_STEPS = 50;
+    static constexpr float TOTAL_TICKS_TOLERANCE = 0.001f;
+    static constexpr int32_t FINAL_TOLERANCE_STEPS = 1;
+
+    void runTests()
+    {
+        Serial.println("UnitTestGoldenTraces");
+#ifdef GOLDEN_TRACES_RECORD
+        // The output (after the line above) is a replacement for GoldenTraces.h
+        Serial.printf("// RBotFirmware\n// Rob Dobson 2016-19\n\n#pragma once\n\n");
+        Serial.printf("// Golden step traces for UnitTestGoldenTraces - regenerate with Tests/GoldenTraces (or by defining\n");
+        Serial.printf("// GOLDEN_TRACES_RECORD in UnitTestGoldenTraces.h) and replace this file with the output\n\n");
+        _recordedTable = "";
+#endif
+        for (int configIdx = 0; configIdx < RobotConfigurations::_numRobotConfigurations; configIdx++)
+            runConfig(RobotConfigurations::_robotConfigs[configIdx]);
+#ifdef GOLDEN_TRACES_RECORD
+        Serial.printf("static const GoldenTrace GoldenTraces[] = {\n%s};\n", _recordedTable.c_str());
+#endif
+    }
+
+    void runConfig(const char* robotConfig)
+    {
+        String robotType = RdJson::getString("robotType", "", robotConfig);
+
+        // Construct the robot
+        MotionHelper motionHelper;
+        TrinamicsSimulator simulator;
+        motionHelper.testGetTrinamicsController()->setSPIBus(&simulator);
+        RobotBase* pRobot = NULL;
+        String robotGeom = RdJson::getString("robotGeom", "NONE", robotConfig);
+        String robotModel = RdJson::getString("model", "", robotGeom.c_str());
+        if (robotModel.equalsIgnoreCase("SingleArmScara"))
+            pRobot = new RobotSandTableScara(robotModel.c_str(), motionHelper);
+        else if (robotModel.equalsIgnoreCase("Cartesian") || robotModel.equalsIgnoreCase("XYBot"))
+            pRobot = new RobotXYBot(robotModel.c_str(), motionHelper);
+        TEST_ASSERT_NOT_NULL(pRobot);
+        if (!pRobot)
+            return;
+        pRobot->init(robotConfig);
+
+        // Stop the timers - ticks are generated here
+        _pRampGenerator = motionHelper.testGetRampGenerator();
+        _pRampGenerator->deinit();
+        _pTrinamicsController = motionHelper.testGetTrinamicsController();
+        _pTrinamicsController->testStopTimer();
+        _pSimulator = &simulator;
+        motionHelper.pause(false);
+
+        // Centre and radius of the robot's working area
+        String robotAttrs;
+        pRobot->getRobotAttributes(robotAttrs);
+        float sizeX = RdJson::getDouble("sizeX", 100, robotAttrs.c_str());
+        float sizeY = RdJson::getDouble("sizeY", 100, robotAttrs.c_str());
+        _centreX = sizeX / 2 - RdJson::getDouble("originX", 0, robotAttrs.c_str());
+        _centreY = sizeY / 2 - RdJson::getDouble("originY", 0, robotAttrs.c_str());
+        _radius = fminf(sizeX, sizeY) / 2;
+
+        // Run the inputs
+        _trace.clear();
+        _tickCount = 0;
+        int numMoves = sizeof(UnitTestGoldenTraces_GCodeMoves) / sizeof(UnitTestGoldenTraces_GCodeMoves[0]);
+        for (int moveIdx = 0; moveIdx < numMoves; moveIdx++)
+            moveTo(*pRobot, UnitTestGoldenTraces_GCodeMoves[moveIdx][0], UnitTestGoldenTraces_GCodeMoves[moveIdx][1]);
+        for (int ptIdx = 0; ptIdx <= THR_POINTS; ptIdx++)
+        {
+            // Same conversion as the THR evaluator
+            float theta = 2 * M_PI * THR_TURNS * ptIdx / THR_POINTS;
+            float rho = float(ptIdx) / THR_POINTS;
+            moveTo(*pRobot, sinf(theta) * rho, cosf(theta) * rho);
+        }
+        while ((!motionHelper.isIdle() || !motionHelper.canAccept()) && (_tickCount < MAX_TICKS))
+            tick(*pRobot);
+        AxisInt32s finalSteps;
+        getStepPosition(finalSteps);
+
+        // Done with the robot - freed before any asserts as a failing assert returns
+        delete pRobot;
+
+        // Metrics
+        float maxAcc[TRACE_AXES];
+        calcMaxAcc(maxAcc);
+        Log.notice("UnitTestGoldenTraces {\"robotType\":\"%s\",\"totalSecs\":%F,\"samples\":%d,\"maxAccStepsPerSec2\":[%F,%F]}\n",
+                    robotType.c_str(), _tickCount / MotionBlock::TICKS_PER_SEC, _trace.size() / TRACE_AXES,
+                    maxAcc[0], maxAcc[1]);
+        TEST_ASSERT_TRUE(_tickCount < MAX_TICKS);
+
+#ifdef GOLDEN_TRACES_RECORD
+        recordTrace(robotType, finalSteps);
+#else
+        checkTrace(robotType, finalSteps);
+#endif
+    }
+
+    void moveTo(RobotBase& robot, float fracX, float fracY)
+    {
+        while (!robot.canAcceptCommand())
+            tick(robot);
+        RobotCommandArgs args;
+        args.setAxisValMM(0, _centreX + fracX * _radius, true);
+        args.setAxisValMM(1, _centreY + fracY * _radius, true);
+        robot.moveTo(args);
+    }
+
+    void tick(RobotBase& robot)
+    {
+        if (_tickCount % SERVICE_INTERVAL_TICKS == 0)
+            robot.service();
+        if (!_pTrinamicsController->isRampGenerator())
+        {
+            _pRampGenerator->testTick();
+        }
+        else if (_tickCount % TRINAMICS_TIMER_INTERVAL_TICKS == 0)
+        {
+            _pTrinamicsController->_timerCallback(NULL);
+            _pSimulator->advance(TRINAMICS_TIMER_PERIOD_SECS);
+        }
+        if (_tickCount % SAMPLE_INTERVAL_TICKS == 0)
+        {
+            AxisInt32s steps;
+            getStepPosition(steps);
+            for (int axisIdx = 0; axisIdx < TRACE_AXES; axisIdx++)
+                _trace.push_back(steps.getVal(axisIdx));
+        }
+        _tickCount++;
+    }
+
+    void getStepPosition(AxisInt32s& steps)
+    {
+        if (_pTrinamicsController->isRampGenerator())
+            _pTrinamicsController->getTotalStepPosition(steps);
+        else
+            _pRampGenerator->getTotalStepPosition(steps);
+    }
+
+    void calcMaxAcc(float maxAcc[])
+    {
+        float sampleSecs = SAMPLE_INTERVAL_TICKS / MotionBlock::TICKS_PER_SEC;
+        int numSamples = _trace.size() / TRACE_AXES;
+        for (int axisIdx = 0; axisIdx < TRACE_AXES; axisIdx++)
+        {
+            maxAcc[axisIdx] = 0;
+            for (int sampleIdx = 1; sampleIdx < numSamples - 1; sampleIdx++)
+            {
+                int32_t secondDiff = _trace[(sampleIdx + 1) * TRACE_AXES + axisIdx] -
+                            2 * _trace[sampleIdx * TRACE_AXES + axisIdx] + _trace[(sampleIdx - 1) * TRACE_AXES + axisIdx];
+                maxAcc[axisIdx] = fmaxf(maxAcc[axisIdx], fabsf(secondDiff / (sampleSecs * sampleSecs)));
+            }
+        }
+    }
+
+    void checkTrace(String& robotType, AxisInt32s& finalSteps)
+    {
+        const GoldenTrace* pGolden = NULL;
+        for (unsigned traceIdx = 0; traceIdx < sizeof(GoldenTraces) / sizeof(GoldenTraces[0]); traceIdx++)
+            if (robotType.equals(GoldenTraces[traceIdx].robotType))
+                pGolden = &GoldenTraces[traceIdx];
+        TEST_ASSERT_NOT_NULL(pGolden);
+
+        // Overall time and end position
+        TEST_ASSERT_TRUE(fabsf(float(_tickCount) - pGolden->totalTicks) <= pGolden->totalTicks * TOTAL_TICKS_TOLERANCE);
+        for (int axisIdx = 0; axisIdx < TRACE_AXES; axisIdx++)
+            TEST_ASSERT_TRUE(abs(finalSteps.getVal(axisIdx) - pGolden->finalSteps[axisIdx]) <= FINAL_TOLERANCE_STEPS);
+
+        // Sampled positions (over the samples common to both)
+        int numSamples = _trace.size() / TRACE_AXES;
+        if (numSamples > pGolden->numSamples)
+            numSamples = pGolden->numSamples;
+        int32_t maxDevSteps = 0;
+        for (int valIdx = 0; valIdx < numSamples * TRACE_AXES; valIdx++)
+        {
+            int32_t devSteps = abs(_trace[valIdx] - pGolden->samples[valIdx]);
+            if (devSteps > maxDevSteps)
+                maxDevSteps = devSteps;
+        }
+        Log.notice("UnitTestGoldenTraces %s maxDevSteps %d\n", robotType.c_str(), maxDevSteps);
+        TEST_ASSERT_TRUE(maxDevSteps <= SAMPLE_TOLERANCE_STEPS);
+    }
+
+    void recordTrace(String& robotType, AxisInt32s& finalSteps)
+    {
+        String arrayName = robotType;
+        arrayName.replace(".", "_");
+        Serial.printf("static const int32_t GoldenTrace_%s[] = {", arrayName.c_str());
+        for (unsigned valIdx = 0; valIdx < _trace.size(); valIdx++)
+            Serial.printf("%s%d%s", (valIdx % 16 == 0) ? "\n    " : " ", _trace[valIdx],
+                        (valIdx + 1 < _trace.size()) ? "," : "");
+        Serial.printf("\n};\n\n");
+        char entryStr[200];
+        snprintf(entryStr, sizeof(entryStr), "    { \"%s\", %u, { %d, %d }, %d, GoldenTrace_%s },\n", robotType.c_str(),
+                    _tickCount, finalSteps.getVal(0), finalSteps.getVal(1), int(_trace.size() / TRACE_AXES), arrayName.c_str());
+        _recordedTable += entryStr;
+    }
+
+private:
+    RampGenerator* _pRampGenerator;
+    TrinamicsController* _pTrinamicsController;
+    TrinamicsSimulator* _pSimulator;
+    float _centreX, _centreY, _radius;
+    uint32_t _tickCount;
+    std::vector<int32_t> _trace;
+    String _recordedTable;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Arduino.h>
+#include <unity.h>
+#include "HeatshrinkDecoder.h"
+#include "FileManager.h"
+#include <ArduinoLog.h>
+
+// Decoding of compressed pattern files (the data was compressed with Tests/CompressPatterns which
+// also checks round trips and decode speed on larger files)
+class UnitTestHeatshrink
+{
+public:
+    void runTests()
+    {
+        Serial.println("UnitTestHeatshrink");
+
+        static const char* pExpected = "# test\r\n0.00000 0.00000\r\n0.10000 0.05000\r\n"
+                    "0.20000 0.10000\r\n0.30000 0.15000\r\n0.40000 0.20000\r\n";
+        static const uint8_t compressed[] = {
+            0x91, 0xc8, 0x2e, 0x96, 0x5b, 0x9d, 0xd2, 0x1b, 0x0a, 0x98, 0x4b, 0xa6, 0x00, 0x00, 0x72, 0x00,
+            0x07, 0x60, 0x10, 0x39, 0x88, 0x08, 0x3c, 0xd4, 0x04, 0x1a, 0x64, 0x02, 0x0c, 0x03, 0x08, 0x02,
+            0x07, 0x33, 0x01, 0x07, 0x02, 0x17, 0x9a, 0x00, 0x83, 0x01, 0x4a, 0x00, 0x80, 0x80,
+        };
+        HeatshrinkDecoder decoder;
+
+        // All at once
+        char outBuf[200];
+        size_t inUsed = 0;
+        size_t outLen = decoder.decode(compressed, sizeof(compressed), inUsed, (uint8_t*)outBuf, sizeof(outBuf));
+        TEST_ASSERT_EQUAL(sizeof(compressed), inUsed);
+        TEST_ASSERT_EQUAL(strlen(pExpected), outLen);
+        TEST_ASSERT_EQUAL_MEMORY(pExpected, outBuf, outLen);
+
+        // A byte at a time in and out
+        decoder.reset();
+        size_t inPos = 0;
+        outLen = 0;
+        while (outLen < sizeof(outBuf))
+        {
+            size_t inLen = (inPos < sizeof(compressed)) ? 1 : 0;
+            size_t decodedLen = decoder.decode(compressed + inPos, inLen, inUsed, (uint8_t*)outBuf + outLen, 1);
+            inPos += inUsed;
+            outLen += decodedLen;
+            if ((decodedLen == 0) && (inLen == 0))
+                break;
+        }
+        TEST_ASSERT_EQUAL(strlen(pExpected), outLen);
+        TEST_ASSERT_EQUAL_MEMORY(pExpected, outBuf, outLen);
+
+        // File names
+        String compressedName = "pattern.thr.hs";
+        String plainName = "pattern.thr";
+        TEST_ASSERT_TRUE(FileManager::isCompressedFile(compressedName));
+        TEST_ASSERT_FALSE(FileManager::isCompressedFile(plainName));
+        TEST_ASSERT_EQUAL_STRING("pattern.thr", FileManager::getUncompressedName(compressedName).c_str());
+        TEST_ASSERT_EQUAL_STRING("pattern.thr", FileManager::getUncompressedName(plainName).c_str());
+    }
+};
@@ -94,6 +94,16 @@ static char const* UnitTestHomingSeq_Test2_JsonRslts[] = {
     )strDelim"
 };
 
+// Sequences which should fail to compile
+static char const* UnitTestHomingSeq_InvalidSeqs[] = {
+    "A-10000Z;#;$",
+    "A;#;$",
+    "FX100;$",
+    "B=q;$",
+    "A100L;#;$",
+    "A100S0;#;$",
+};
+
 class UnitTestHomingSeq
 {
 public:
@@ -107,6 +117,40 @@ public:
         TEST_ASSERT_FALSE(pMotionHoming->_commandInProgress);
         TEST_ASSERT_EQUAL_STRING("", pMotionHoming->_homingSequence.c_str());
 
+        /////////////////////////////////////////////////////////////////////////////////////
+        //// Sequence compilation
+        /////////////////////////////////////////////////////////////////////////////////////
+
+        Serial.println("UnitTestHomingSeq Compile");
+
+        std::vector<HomingOp> homingProgram;
+        String errorMsg;
+        TEST_ASSERT_TRUE(MotionHoming::compileSequence("K2000;A-10000R30NL200;#;A=h;$", homingProgram, errorMsg));
+        TEST_ASSERT_EQUAL(5, homingProgram.size());
+        TEST_ASSERT_EQUAL(HomingOp::HOMING_OP_ACCEL, homingProgram[0]._opType);
+        TEST_ASSERT_EQUAL(2000, homingProgram[0]._accelStepsPerSec2);
+        TEST_ASSERT_EQUAL(HomingOp::HOMING_OP_MOVE, homingProgram[1]._opType);
+        TEST_ASSERT_EQUAL(0, homingProgram[1]._axisIdx);
+        TEST_ASSERT_EQUAL(-10000, homingProgram[1]._steps);
+        TEST_ASSERT_EQUAL(HomingOp::FEEDRATE_UNITS_RPM, homingProgram[1]._feedrateUnits);
+        TEST_ASSERT_EQUAL(30, homingProgram[1]._feedrateVal);
+        TEST_ASSERT_TRUE(homingProgram[1]._endStopValid);
+        TEST_ASSERT_EQUAL(0, homingProgram[1]._endStopIdx);
+        TEST_ASSERT_TRUE(homingProgram[1]._endStopCheckActive);
+        TEST_ASSERT_EQUAL(200, homingProgram[1]._latchBackoffSteps);
+        TEST_ASSERT_EQUAL(HomingOp::HOMING_OP_EXEC, homingProgram[2]._opType);
+        TEST_ASSERT_EQUAL(HomingOp::HOMING_OP_SET_HOME, homingProgram[3]._opType);
+        TEST_ASSERT_EQUAL(HomingOp::HOMING_OP_DONE, homingProgram[4]._opType);
+
+        for (unsigned int i = 0; i < sizeof(UnitTestHomingSeq_InvalidSeqs)/sizeof(const char*); i++)
+        {
+            TEST_ASSERT_FALSE(MotionHoming::compileSequence(UnitTestHomingSeq_InvalidSeqs[i], homingProgram, errorMsg));
+            TEST_ASSERT_TRUE(errorMsg.length() > 0);
+        }
+
+        // Third axis is only valid if the build has one
+        TEST_ASSERT_EQUAL(RobotConsts::MAX_AXES > 2, MotionHoming::compileSequence("C100;#;C=h;$", homingProgram, errorMsg));
+
         // Prep for tests
         String debugCmdStr;
         String homingJson;
@@ -124,12 +168,13 @@ public:
         // Set config
         pMotionHelper->configure(UnitTestHomingSeq_Test1_Config);
         axesParams = pMotionHelper->getAxesParams();
+        TEST_ASSERT_EQUAL(18, pMotionHoming->_homingProgram.size());
 
         // Test homing
         pMotionHoming->homingStart(homingCommand);
 
         // Loop through expected responses
-        for (int i = 0; i < sizeof(UnitTestHomingSeq_Test1_DebugCmdStrs)/sizeof(const char*); i++)
+        for (unsigned int i = 0; i < sizeof(UnitTestHomingSeq_Test1_DebugCmdStrs)/sizeof(const char*); i++)
         {
             String testRlstStr = UnitTestHomingSeq_Test1_JsonRslts[i];
             testRlstStr.trim();
@@ -138,7 +183,9 @@ public:
             homingJson = pMotionHoming->_curCommand.toJSON();
             Serial.println(homingJson);
             TEST_ASSERT_EQUAL_STRING(UnitTestHomingSeq_Test1_DebugCmdStrs[i], debugCmdStr.c_str());
-            TEST_ASSERT_EQUAL_STRING(testRlstStr.c_str(), homingJson.c_str());
+            // Expected JSON has three axes
+            if (RobotConsts::MAX_AXES == 3)
+                TEST_ASSERT_EQUAL_STRING(testRlstStr.c_str(), homingJson.c_str());
         }
 
         /////////////////////////////////////////////////////////////////////////////////////
@@ -155,7 +202,7 @@ public:
         pMotionHoming->homingStart(homingCommand);
 
         // Loop through expected responses
-        for (int i = 0; i < sizeof(UnitTestHomingSeq_Test2_DebugCmdStrs)/sizeof(const char*); i++)
+        for (unsigned int i = 0; i < sizeof(UnitTestHomingSeq_Test2_DebugCmdStrs)/sizeof(const char*); i++)
         {
             String testRlstStr = UnitTestHomingSeq_Test2_JsonRslts[i];
             testRlstStr.trim();
@@ -164,7 +211,9 @@ public:
             homingJson = pMotionHoming->_curCommand.toJSON();
             Serial.println(homingJson);
             TEST_ASSERT_EQUAL_STRING(UnitTestHomingSeq_Test2_DebugCmdStrs[i], debugCmdStr.c_str());
-            TEST_ASSERT_EQUAL_STRING(testRlstStr.c_str(), homingJson.c_str());
+            // Expected JSON has three axes
+            if (RobotConsts::MAX_AXES == 3)
+                TEST_ASSERT_EQUAL_STRING(testRlstStr.c_str(), homingJson.c_str());
         }
 
         // Cleanup
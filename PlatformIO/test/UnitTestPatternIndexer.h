@@ -0,0 +1,130 @@
+#pragma once
+
+#include <Arduino.h>
+#include <unity.h>
+#include "FileManager.h"
+#include "RdJson.h"
+#include "../src/WorkManager/PatternIndexer.h"
+#include <ArduinoLog.h>
+
+static const char* UnitTestPatternIndexer_RobotConfig = R"strDelim(
+    {"robotGeom":{"junctionDeviation":0.05,
+     "axis0":{"maxSpeed":100,"maxAcc":200,"stepsPerRot":200,"unitsPerRot":4},
+     "axis1":{"maxSpeed":100,"maxAcc":200,"stepsPerRot":200,"unitsPerRot":4},
+     "axis2":{"isPrimaryAxis":0}}}
+    )strDelim";
+
+// Enough metadata to make an index larger than 32KB
+static const int UnitTestPatternIndexer_ManyFiles = 130;
+static const int UnitTestPatternIndexer_LongMetaLen = 250;
+
+// Pattern file metadata - the estimated time for the G-code is two 10mm moves at F50 with a 90 degree
+// junction (junction speed 4.9mm/s and neither move reaches the feedrate). The metadata is then stored
+// and listed by a FileManager on the internal flash file system
+class UnitTestPatternIndexer
+{
+public:
+    void runTests()
+    {
+        Serial.println("UnitTestPatternIndexer");
+        testStats();
+        testFileMeta();
+    }
+
+    void testStats()
+    {
+        FileManager fileManager;
+        PatternIndexer patternIndexer(fileManager);
+        patternIndexer.setConfig(UnitTestPatternIndexer_RobotConfig, "{}",
+                    "{\"sizeX\":200,\"sizeY\":200,\"originX\":100,\"originY\":100}");
+
+        // G-code
+        String metaJson;
+        patternIndexer.statsStart(false);
+        patternIndexer.statsAddLine("; square");
+        patternIndexer.statsAddLine("G90");
+        patternIndexer.statsAddLine("G1 X0 Y0 F50");
+        patternIndexer.statsAddLine("G1 X10 Y0 F50");
+        patternIndexer.statsAddLine("G1 X10 Y10 F50");
+        patternIndexer.statsGetJSON(metaJson);
+        TEST_ASSERT_EQUAL(5, RdJson::getLong("lines", 0, metaJson.c_str()));
+        TEST_ASSERT_EQUAL(3, RdJson::getLong("vertices", 0, metaJson.c_str()));
+        TEST_ASSERT_FLOAT_WITHIN(0.01, 10, RdJson::getDouble("maxX", 0, metaJson.c_str()));
+        TEST_ASSERT_FLOAT_WITHIN(0.01, 10, RdJson::getDouble("maxY", 0, metaJson.c_str()));
+        TEST_ASSERT_FLOAT_WITHIN(0.5, 20, RdJson::getDouble("pathMM", 0, metaJson.c_str()));
+        TEST_ASSERT_FLOAT_WITHIN(0.05, 0.85, RdJson::getDouble("estSecs", 0, metaJson.c_str()));
+
+        // Theta-rho - centre to edge of the bed
+        patternIndexer.statsStart(true);
+        patternIndexer.statsAddLine("# comment");
+        patternIndexer.statsAddLine("0 0");
+        patternIndexer.statsAddLine("0 1");
+        patternIndexer.statsGetJSON(metaJson);
+        TEST_ASSERT_EQUAL(2, RdJson::getLong("vertices", 0, metaJson.c_str()));
+        TEST_ASSERT_FLOAT_WITHIN(0.001, 1, RdJson::getDouble("maxRho", 0, metaJson.c_str()));
+        TEST_ASSERT_FLOAT_WITHIN(0.01, 100, RdJson::getDouble("maxY", 0, metaJson.c_str()));
+        TEST_ASSERT_FLOAT_WITHIN(0.5, 100, RdJson::getDouble("pathMM", 0, metaJson.c_str()));
+    }
+
+    void testFileMeta()
+    {
+        // The file manager's task keeps running so it isn't on the stack
+        static FileManager fileManager;
+        static bool setupDone = false;
+        if (!setupDone)
+        {
+            ConfigBase fsConfig("{\"fileManager\":{\"spiffsEnabled\":1}}");
+            fileManager.setup(fsConfig);
+            setupDone = true;
+        }
+        String fileContents = "0 0\n0 1\n";
+        TEST_ASSERT_TRUE(fileManager.setFileContents("spiffs", "__metatest.thr", fileContents));
+
+        // Listed with the metadata while the length matches (and setting it isn't a change to the files)
+        uint32_t changeCount = fileManager.getFileListChangeCount();
+        TEST_ASSERT_TRUE(fileManager.setFileMeta("spiffs", "__metatest.thr", fileContents.length(), "{\"lines\":2}"));
+        TEST_ASSERT_EQUAL(changeCount, fileManager.getFileListChangeCount());
+        String listJson;
+        TEST_ASSERT_TRUE(fileManager.getFilesJSON("spiffs", "/", listJson));
+        TEST_ASSERT_TRUE(listJson.indexOf("\"name\":\"__metatest.thr\",\"size\":8,\"meta\":{\"lines\":2}") >= 0);
+        TEST_ASSERT_TRUE(listJson.indexOf("__fileindex__") < 0);
+        TEST_ASSERT_TRUE(fileManager.setFileMeta("spiffs", "__metatest.thr", 7, "{\"lines\":3}"));
+        TEST_ASSERT_TRUE(fileManager.getFilesJSON("spiffs", "/", listJson));
+        TEST_ASSERT_TRUE(listJson.indexOf("\"name\":\"__metatest.thr\",\"size\":8}") >= 0);
+
+        // Removed with the file
+        TEST_ASSERT_TRUE(fileManager.setFileMeta("spiffs", "__metatest.thr", fileContents.length(), "{\"lines\":2}"));
+        TEST_ASSERT_TRUE(fileManager.deleteFile("spiffs", "__metatest.thr"));
+        TEST_ASSERT_TRUE(fileManager.getFilesJSON("spiffs", "/", listJson));
+        TEST_ASSERT_TRUE(listJson.indexOf("__metatest.thr") < 0);
+        TEST_ASSERT_TRUE(fileManager.setFileContents("spiffs", "__metatest.thr", fileContents));
+        TEST_ASSERT_TRUE(fileManager.getFilesJSON("spiffs", "/", listJson));
+        TEST_ASSERT_TRUE(listJson.indexOf("\"name\":\"__metatest.thr\",\"size\":8}") >= 0);
+
+        // Entries aren't lost when the index is larger than would be read in one go
+        TEST_ASSERT_TRUE(fileManager.setFileMeta("spiffs", "__metatest.thr", fileContents.length(), "{\"lines\":2}"));
+        String longMetaJson = "{\"note\":\"";
+        for (int charIdx = 0; charIdx < UnitTestPatternIndexer_LongMetaLen; charIdx++)
+            longMetaJson += "x";
+        longMetaJson += "\"}";
+        for (int fileIdx = 0; fileIdx < UnitTestPatternIndexer_ManyFiles; fileIdx++)
+            TEST_ASSERT_TRUE(fileManager.setFileMeta("spiffs", "__metamany" + String(fileIdx) + ".thr", 1, longMetaJson));
+        TEST_ASSERT_TRUE(fileManager.getFilesJSON("spiffs", "/", listJson));
+        TEST_ASSERT_TRUE(listJson.indexOf("\"name\":\"__metatest.thr\",\"size\":8,\"meta\":{\"lines\":2}") >= 0);
+
+        // Stepped listing as used by the indexer
+        String metaJson;
+        TEST_ASSERT_TRUE(fileManager.backgroundFileListStart("spiffs", "/",
+                    [&metaJson](const String& filename, int fileSize, const String& fileMetaJson) {
+                        if (filename.equals("__metatest.thr"))
+                            metaJson = fileMetaJson;
+                    }));
+        bool rslt = false;
+        while (!fileManager.backgroundFileListStep(rslt))
+            ;
+        TEST_ASSERT_TRUE(rslt);
+        TEST_ASSERT_EQUAL_STRING("{\"lines\":2}", metaJson.c_str());
+        fileManager.deleteFile("spiffs", "__metatest.thr");
+        fileManager.deleteFile("spiffs", "__fileindex__.txt");
+    }
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Arduino.h>
+#include <unity.h>
+#include "PlannerFuzzCase.h"
+#include <ArduinoLog.h>
+
+// Runs the planner invariant checks over a fixed set of pseudo-random inputs (the libFuzzer
+// target in Tests/FuzzPlanner explores further)
+class UnitTestPlannerFuzz
+{
+public:
+    static constexpr int NUM_CASES = 200;
+    static constexpr int CASE_LEN = 128;
+    static constexpr uint32_t RANDOM_SEED = 0x52426f74;
+
+    void runTests()
+    {
+        Serial.println("UnitTestPlannerFuzz");
+        uint32_t randomState = RANDOM_SEED;
+        uint8_t caseData[CASE_LEN];
+        int failCount = 0;
+        for (int caseIdx = 0; caseIdx < NUM_CASES; caseIdx++)
+        {
+            for (int byteIdx = 0; byteIdx < CASE_LEN; byteIdx++)
+            {
+                // xorshift32
+                randomState ^= randomState << 13;
+                randomState ^= randomState >> 17;
+                randomState ^= randomState << 5;
+                caseData[byteIdx] = randomState & 0xff;
+            }
+            PlannerFuzzCase fuzzCase;
+            const char* pFailMsg = fuzzCase.run(caseData, CASE_LEN);
+            if (pFailMsg)
+            {
+                Log.notice("UnitTestPlannerFuzz case %d failed: %s\n", caseIdx, pFailMsg);
+                failCount++;
+            }
+        }
+        TEST_ASSERT_EQUAL(0, failCount);
+    }
+};
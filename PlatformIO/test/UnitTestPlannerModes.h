@@ -0,0 +1,230 @@
+#pragma once
+
+#include <Arduino.h>
+#include <unity.h>
+#include <vector>
+#include "../src/RobotMotion/MotionControl/MotionPlanner.h"
+#include "../src/RobotMotion/MotionControl/CornerBlender.h"
+#include <ArduinoLog.h>
+
+static const char* UnitTestPlannerModes_AxesConfig = R"strDelim(
+    {"axis0":{"maxSpeed":100,"maxAcc":200,"stepsPerRot":200,"unitsPerRot":4},
+     "axis1":{"maxSpeed":100,"maxAcc":200,"stepsPerRot":200,"unitsPerRot":4},
+     "axis2":{"isPrimaryAxis":0},
+     "cornerBlendMM":0.2}
+    )strDelim";
+
+static const char* UnitTestPlannerModes_SlowAxisConfig = R"strDelim(
+    {"axis0":{"maxSpeed":100,"maxAcc":200,"stepsPerRot":200,"unitsPerRot":4},
+     "axis1":{"maxSpeed":20,"maxAcc":50,"stepsPerRot":200,"unitsPerRot":4},
+     "axis2":{"isPrimaryAxis":0}}
+    )strDelim";
+
+// Plans a Sandify style growing, spinning star (sharp vertices with edges subdivided into short
+// segments as in THR files) with each planner mode and with corner blending and compares total path time
+class UnitTestPlannerModes
+{
+public:
+    static constexpr int PIPELINE_LEN = 50;
+    static constexpr int STAR_POINTS = 5;
+    static constexpr int STAR_LOOPS = 10;
+    static constexpr int SEGS_PER_EDGE = 8;
+    static constexpr float JUNCTION_DEVIATION = 0.05f;
+
+    void runTests()
+    {
+        Serial.println("UnitTestPlannerModes");
+        testAxisLimits();
+
+        AxesParams axesParams;
+        String axisJSON;
+        for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
+            axesParams.configureAxis(UnitTestPlannerModes_AxesConfig, axisIdx, axisJSON);
+
+        std::vector<AxisFloats> pathPts;
+        genStarPath(pathPts);
+
+        int violationsJnDev = 0;
+        int violationsCurveLim = 0;
+        float timeJnDev = planPath(MotionPlanner::PLANNER_MODE_JUNCTION_DEVIATION, pathPts, axesParams, violationsJnDev);
+        float timeCurveLim = planPath(MotionPlanner::PLANNER_MODE_CURVATURE_LIMITED, pathPts, axesParams, violationsCurveLim);
+        Log.notice("UnitTestPlannerModes junctionDeviation %Fs curvatureLimited %Fs\n", timeJnDev, timeCurveLim);
+
+        // Every block's profile is achievable with its acceleration
+        TEST_ASSERT_EQUAL(0, violationsJnDev);
+        TEST_ASSERT_EQUAL(0, violationsCurveLim);
+        TEST_ASSERT_TRUE(timeJnDev > 0);
+        TEST_ASSERT_TRUE(timeCurveLim > 0);
+
+        // Corner blending
+        CornerBlender cornerBlender;
+        cornerBlender.configure(UnitTestPlannerModes_AxesConfig);
+        std::vector<AxisFloats> blendedPts;
+        blendPath(cornerBlender, pathPts, blendedPts, axesParams);
+        int violationsBlended = 0;
+        float timeBlended = planPath(MotionPlanner::PLANNER_MODE_JUNCTION_DEVIATION, blendedPts, axesParams, violationsBlended);
+        Log.notice("UnitTestPlannerModes cornerBlend %Fs (%d pts from %d)\n", timeBlended, blendedPts.size(), pathPts.size());
+        TEST_ASSERT_EQUAL(0, violationsBlended);
+        TEST_ASSERT_TRUE(timeBlended < timeJnDev);
+
+        // Blended path stays within tolerance of the original and ends at the same point
+        for (unsigned ptIdx = 0; ptIdx < blendedPts.size(); ptIdx++)
+            TEST_ASSERT_TRUE(distToPath(blendedPts[ptIdx], pathPts) <= cornerBlender.getTolerance() + 0.001f);
+        TEST_ASSERT_TRUE(blendedPts.back().distanceTo(pathPts.back()) < 0.001f);
+    }
+
+    // Each block is limited by every axis's speed and acceleration along its direction
+    void testAxisLimits()
+    {
+        AxesParams axesParams;
+        String axisJSON;
+        for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
+            axesParams.configureAxis(UnitTestPlannerModes_SlowAxisConfig, axisIdx, axisJSON);
+        MotionPipeline motionPipeline;
+        motionPipeline.init(PIPELINE_LEN);
+        MotionPlanner motionPlanner;
+        motionPlanner.configure(JUNCTION_DEVIATION);
+        AxisPosition curAxisPositions;
+        curAxisPositions.clear();
+
+        // Moves along the fast axis, at 45 degrees and along the slow axis
+        static const float moveDirs[][2] = { { 10, 0 }, { 10, 10 }, { 0, 10 } };
+        static const float expFeedrates[] = { 100, 20 * M_SQRT2, 20 };
+        static const float expAccs[] = { 200, 50 * M_SQRT2, 50 };
+        for (int moveIdx = 0; moveIdx < 3; moveIdx++)
+        {
+            RobotCommandArgs args;
+            float ptX = curAxisPositions._axisPositionMM.X() + moveDirs[moveIdx][0];
+            float ptY = curAxisPositions._axisPositionMM.Y() + moveDirs[moveIdx][1];
+            args.setAxisValMM(0, ptX, true);
+            args.setAxisValMM(1, ptY, true);
+            args.setAxisValMM(2, 0, true);
+            AxisFloats destActuatorCoords(ptX * axesParams.getStepsPerUnit(0), ptY * axesParams.getStepsPerUnit(1), 0);
+            TEST_ASSERT_TRUE(motionPlanner.moveTo(args, destActuatorCoords, curAxisPositions, axesParams, motionPipeline));
+            curAxisPositions._axisPositionMM.set(ptX, ptY, 0);
+            MotionBlock *pBlock = motionPipeline.peekNthFromPut(0);
+            TEST_ASSERT_FLOAT_WITHIN(0.01f, expFeedrates[moveIdx], pBlock->_feedrate);
+            TEST_ASSERT_FLOAT_WITHIN(0.01f, expAccs[moveIdx], pBlock->_accMMps2);
+        }
+    }
+
+    void genStarPath(std::vector<AxisFloats> &pathPts)
+    {
+        float lastX = 0, lastY = 0;
+        int numVertices = STAR_POINTS * 2 * STAR_LOOPS;
+        for (int vertexIdx = 0; vertexIdx < numVertices; vertexIdx++)
+        {
+            float x = 0, y = 0;
+            starVertex(vertexIdx, x, y);
+            for (int segIdx = 1; segIdx <= SEGS_PER_EDGE; segIdx++)
+                pathPts.push_back(AxisFloats(lastX + (x - lastX) * segIdx / SEGS_PER_EDGE,
+                                    lastY + (y - lastY) * segIdx / SEGS_PER_EDGE, 0));
+            lastX = x;
+            lastY = y;
+        }
+    }
+
+    void starVertex(int vertexIdx, float &x, float &y)
+    {
+        int vertsPerLoop = STAR_POINTS * 2;
+        float loopFrac = float(vertexIdx) / vertsPerLoop;
+        float radius = (7 + 8 * loopFrac) * ((vertexIdx % 2) ? 0.5f : 1.0f);
+        float angle = 2 * M_PI * vertexIdx / vertsPerLoop + loopFrac * 0.1f;
+        x = radius * cosf(angle);
+        y = radius * sinf(angle);
+    }
+
+    void blendPath(CornerBlender &cornerBlender, std::vector<AxisFloats> &pathPts,
+                std::vector<AxisFloats> &blendedPts, AxesParams &axesParams)
+    {
+        AxisFloats lastPt(0, 0, 0);
+        for (unsigned ptIdx = 0; ptIdx <= pathPts.size(); ptIdx++)
+        {
+            RobotCommandArgs args;
+            if (ptIdx < pathPts.size())
+            {
+                TEST_ASSERT_TRUE(CornerBlender::isBlendable(args, lastPt, pathPts[ptIdx], axesParams));
+                cornerBlender.addMove(lastPt, pathPts[ptIdx], args, axesParams);
+                lastPt = pathPts[ptIdx];
+            }
+            else
+            {
+                cornerBlender.flush();
+            }
+            AxisFloats outPt;
+            while (cornerBlender.getNextOutput(outPt, args))
+                blendedPts.push_back(outPt);
+        }
+        TEST_ASSERT_TRUE(cornerBlender.isEmpty());
+    }
+
+    float distToPath(AxisFloats &pt, std::vector<AxisFloats> &pathPts)
+    {
+        float minDist = 1e8;
+        AxisFloats segStart(0, 0, 0);
+        for (unsigned ptIdx = 0; ptIdx < pathPts.size(); ptIdx++)
+        {
+            AxisFloats segVec = pathPts[ptIdx] - segStart;
+            AxisFloats ptVec = pt - segStart;
+            float segLenSq = segVec.X() * segVec.X() + segVec.Y() * segVec.Y();
+            float proj = (segLenSq > 0) ? (ptVec.X() * segVec.X() + ptVec.Y() * segVec.Y()) / segLenSq : 0;
+            proj = fmaxf(0, fminf(1, proj));
+            AxisFloats nearestPt = segStart + segVec * proj;
+            minDist = fminf(minDist, pt.distanceTo(nearestPt));
+            segStart = pathPts[ptIdx];
+        }
+        return minDist;
+    }
+
+    // Plan the path - the oldest block is treated as executed whenever the pipeline is nearly full
+    float planPath(MotionPlanner::PlannerMode plannerMode, std::vector<AxisFloats> &pathPts,
+                AxesParams &axesParams, int &violations)
+    {
+        MotionPipeline motionPipeline;
+        motionPipeline.init(PIPELINE_LEN);
+        MotionPlanner motionPlanner;
+        motionPlanner.configure(JUNCTION_DEVIATION, plannerMode);
+        AxisPosition curAxisPositions;
+        curAxisPositions.clear();
+
+        float totalTimeSecs = 0;
+        for (unsigned ptIdx = 0; ptIdx < pathPts.size(); ptIdx++)
+        {
+            RobotCommandArgs args;
+            float ptX = pathPts[ptIdx].X();
+            float ptY = pathPts[ptIdx].Y();
+            args.setAxisValMM(0, ptX, true);
+            args.setAxisValMM(1, ptY, true);
+            args.setAxisValMM(2, 0, true);
+            AxisFloats destActuatorCoords(ptX * axesParams.getStepsPerUnit(0), ptY * axesParams.getStepsPerUnit(1), 0);
+            motionPlanner.moveTo(args, destActuatorCoords, curAxisPositions, axesParams, motionPipeline);
+            curAxisPositions._axisPositionMM.set(ptX, ptY, 0);
+            if (motionPipeline.count() >= PIPELINE_LEN - 1)
+                totalTimeSecs += execBlock(motionPipeline, axesParams, violations);
+        }
+        while (motionPipeline.count() > 0)
+            totalTimeSecs += execBlock(motionPipeline, axesParams, violations);
+        return totalTimeSecs;
+    }
+
+    // Remove the oldest block (marking the next as executing) and return its duration
+    float execBlock(MotionPipeline &motionPipeline, AxesParams &axesParams, int &violations)
+    {
+        MotionBlock *pBlock = motionPipeline.peekNthFromGet(0);
+        if (!pBlock)
+            return 0;
+        float acc = MotionPlanner::getBlockAccMMps2(*pBlock, axesParams);
+        float maxSpeedChangeSq = 2 * acc * pBlock->_moveDistPrimaryAxesMM * 1.001f + 0.001f;
+        float entrySq = pBlock->_entrySpeedMMps * pBlock->_entrySpeedMMps;
+        float exitSq = pBlock->_exitSpeedMMps * pBlock->_exitSpeedMMps;
+        if ((fabsf(exitSq - entrySq) > maxSpeedChangeSq) ||
+                (pBlock->_entrySpeedMMps > pBlock->_maxEntrySpeedMMps + 0.001f))
+            violations++;
+        float timeSecs = MotionPlanner::calcBlockTimeSecs(*pBlock, axesParams);
+        motionPipeline.remove();
+        MotionBlockExec *pExec = motionPipeline.peekExecNthFromGet(0);
+        if (pExec)
+            pExec->_isExecuting = true;
+        return timeSecs;
+    }
+};
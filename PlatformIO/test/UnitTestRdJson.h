@@ -0,0 +1,67 @@
+#pragma once
+
+#include <Arduino.h>
+#include <unity.h>
+#include "RdJson.h"
+#include <ArduinoLog.h>
+
+// Escaping and unescaping of JSON string contents (Tests/BenchJsonEscape compares speed with
+// the previous String::replace version)
+class UnitTestRdJson
+{
+public:
+    struct EscTestCase
+    {
+        const char* _raw;
+        const char* _escaped;
+    };
+
+    void runTests()
+    {
+        Serial.println("UnitTestRdJson");
+
+        // Escape and round trip
+        static const EscTestCase escCases[] = {
+            { "", "" },
+            { "no escapes", "no escapes" },
+            { "G28\nG0 X10", "G28\\nG0 X10" },
+            { "say \"hi\"", "say \\\"hi\\\"" },
+            { "C:\\new", "C:\\\\new" },
+            { "\t\r\b\f", "\\t\\r\\b\\f" },
+            { "\x01\x1f", "\\u0001\\u001f" },
+            { "caf\xc3\xa9 /", "caf\xc3\xa9 /" },
+        };
+        for (const EscTestCase& testCase : escCases)
+        {
+            String str = testCase._raw;
+            TEST_ASSERT_EQUAL(strlen(testCase._escaped), RdJson::escapedLen(str.c_str(), str.length()));
+            RdJson::escapeString(str);
+            TEST_ASSERT_EQUAL_STRING(testCase._escaped, str.c_str());
+            RdJson::unescapeString(str);
+            TEST_ASSERT_EQUAL_STRING(testCase._raw, str.c_str());
+        }
+
+        // Unescape only
+        static const EscTestCase unescCases[] = {
+            // Escaped backslash followed by n isn't a newline
+            { "a\\\\nb", "a\\\\\\\\nb" },
+            { "a/b", "a\\/b" },
+            { "A\xc3\xa9\xe2\x82\xac", "\\u0041\\u00e9\\u20AC" },
+            { "\xf0\x9f\x98\x80", "\\ud83d\\ude00" },
+            // Invalid or unsupported sequences are left as they are
+            { "\\q \\u12 \\u0000 \\udc00", "\\q \\u12 \\u0000 \\udc00" },
+            { "end\\", "end\\" },
+        };
+        for (const EscTestCase& testCase : unescCases)
+        {
+            String str = testCase._escaped;
+            RdJson::unescapeString(str);
+            TEST_ASSERT_EQUAL_STRING(testCase._raw, str.c_str());
+        }
+
+        // Caller buffer is truncated at a whole escape sequence
+        char buf[6];
+        TEST_ASSERT_EQUAL(8, RdJson::escapeString(buf, sizeof(buf), "ab\"\"cd", 6));
+        TEST_ASSERT_EQUAL_STRING("ab\\\"", buf);
+    }
+};
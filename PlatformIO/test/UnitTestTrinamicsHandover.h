@@ -0,0 +1,147 @@
+#pragma once
+
+#include <Arduino.h>
+#include <unity.h>
+#include <vector>
+#include "../src/RobotMotion/MotionControl/Trinamics/TrinamicsController.h"
+#include "TrinamicsSimulator.h"
+#include <ArduinoLog.h>
+
+// Handover of short blocks at high junction speeds - a zig-zag where the first axis reverses at
+// every junction while the second carries on, then a run of short blocks in one direction
+static constexpr int UnitTestTrinamicsHandover_ZigzagBlocks = 8;
+static constexpr int32_t UnitTestTrinamicsHandover_ZigzagSteps = 120;
+static constexpr float UnitTestTrinamicsHandover_ZigzagJunctionStepRate = 2000;
+static constexpr int UnitTestTrinamicsHandover_ShortBlocks = 20;
+static constexpr int32_t UnitTestTrinamicsHandover_ShortSteps[] = { 30, 10 };
+static constexpr float UnitTestTrinamicsHandover_ShortJunctionStepRate = 3000;
+
+class UnitTestTrinamicsHandover
+{
+public:
+    static constexpr int NUM_AXES = 2;
+    static constexpr float MAX_STEP_RATE = 4000;
+    static constexpr float STEP_ACC = 20000;
+    static constexpr float TIMER_PERIOD_SECS = 0.0005f;
+    static constexpr int SIM_STEPS_PER_TICK = 5;
+    static constexpr int MAX_TICKS = 40000;
+
+    static uint32_t stepRateToTTicks(float stepsPerSec)
+    {
+        return uint32_t((stepsPerSec * MotionBlock::TTICKS_VALUE) / MotionBlock::TICKS_PER_SEC);
+    }
+
+    // Record the position at which an axis changes direction
+    static void addTurningPoint(std::vector<int32_t>& turningPts, int& dirn, int32_t lastPos, int32_t newPos)
+    {
+        if (newPos == lastPos)
+            return;
+        int newDirn = (newPos > lastPos) ? 1 : -1;
+        if ((dirn != 0) && (newDirn != dirn))
+            turningPts.push_back(lastPos);
+        dirn = newDirn;
+    }
+
+    void runTests()
+    {
+        if (RobotConsts::MAX_AXES < NUM_AXES)
+            return;
+        AxesParams axesParams;
+        MotionPipeline motionPipeline;
+        motionPipeline.init(UnitTestTrinamicsHandover_ZigzagBlocks + UnitTestTrinamicsHandover_ShortBlocks + 1);
+        TrinamicsSimulator simulator;
+        TrinamicsController* pController = new TrinamicsController(axesParams, motionPipeline);
+        pController->setSPIBus(&simulator);
+        for (int axisIdx = 0; axisIdx < NUM_AXES; axisIdx++)
+        {
+            String axisJSON = R"({"chipDriverIdx":)" + String(axisIdx) + "}";
+            pController->configureAxis(axisIdx, axisJSON.c_str());
+        }
+
+        Serial.println("UnitTestTrinamicsHandover");
+
+        // Blocks and the turning points they should produce
+        std::vector<int32_t> blockSteps[NUM_AXES];
+        std::vector<float> junctionStepRates;
+        junctionStepRates.push_back(0);
+        for (int blockIdx = 0; blockIdx < UnitTestTrinamicsHandover_ZigzagBlocks; blockIdx++)
+        {
+            blockSteps[0].push_back((blockIdx % 2 == 0) ? UnitTestTrinamicsHandover_ZigzagSteps : -UnitTestTrinamicsHandover_ZigzagSteps);
+            blockSteps[1].push_back(UnitTestTrinamicsHandover_ZigzagSteps);
+            junctionStepRates.push_back(UnitTestTrinamicsHandover_ZigzagJunctionStepRate);
+        }
+        for (int blockIdx = 0; blockIdx < UnitTestTrinamicsHandover_ShortBlocks; blockIdx++)
+        {
+            blockSteps[0].push_back(UnitTestTrinamicsHandover_ShortSteps[0]);
+            blockSteps[1].push_back(UnitTestTrinamicsHandover_ShortSteps[1]);
+            junctionStepRates.push_back(UnitTestTrinamicsHandover_ShortJunctionStepRate);
+        }
+        junctionStepRates.back() = 0;
+        int numBlocks = blockSteps[0].size();
+        std::vector<int32_t> expectedTurningPts[NUM_AXES];
+        int32_t expectedPos[NUM_AXES] = { 0, 0 };
+        int expectedDirn[NUM_AXES] = { 0, 0 };
+        int expectedXTargetWrites = simulator.getXTargetWrites();
+        for (int blockIdx = 0; blockIdx < numBlocks; blockIdx++)
+        {
+            MotionBlock block;
+            MotionBlockExec blockExec;
+            for (int axisIdx = 0; axisIdx < NUM_AXES; axisIdx++)
+            {
+                int32_t steps = blockSteps[axisIdx][blockIdx];
+                blockExec.setStepsToTarget(axisIdx, steps);
+                addTurningPoint(expectedTurningPts[axisIdx], expectedDirn[axisIdx], expectedPos[axisIdx],
+                            expectedPos[axisIdx] + steps);
+                expectedPos[axisIdx] += steps;
+                if (steps != 0)
+                    expectedXTargetWrites++;
+            }
+            blockExec._initialStepRatePerTTicks = stepRateToTTicks(junctionStepRates[blockIdx]);
+            blockExec._maxStepRatePerTTicks = stepRateToTTicks(MAX_STEP_RATE);
+            blockExec._finalStepRatePerTTicks = stepRateToTTicks(junctionStepRates[blockIdx+1]);
+            blockExec._accStepsPerTTicksPerMS = stepRateToTTicks(STEP_ACC) / 1000;
+            blockExec._canExecute = true;
+            TEST_ASSERT_TRUE(motionPipeline.add(block, blockExec));
+        }
+
+        // Run the controller's timer against the simulator sampling the positions between timer ticks
+        std::vector<int32_t> turningPts[NUM_AXES];
+        int32_t lastPos[NUM_AXES] = { 0, 0 };
+        int dirn[NUM_AXES] = { 0, 0 };
+        int tickIdx = 0;
+        for (tickIdx = 0; (tickIdx < MAX_TICKS) && ((motionPipeline.count() > 0) || simulator.anyMoving()); tickIdx++)
+        {
+            pController->_timerCallback(NULL);
+            for (int simIdx = 0; simIdx < SIM_STEPS_PER_TICK; simIdx++)
+            {
+                simulator.advance(TIMER_PERIOD_SECS / SIM_STEPS_PER_TICK);
+                for (int axisIdx = 0; axisIdx < NUM_AXES; axisIdx++)
+                {
+                    int32_t pos = simulator.getXActual(axisIdx / TrinamicsSimulator::NUM_DRIVERS,
+                                    axisIdx % TrinamicsSimulator::NUM_DRIVERS);
+                    addTurningPoint(turningPts[axisIdx], dirn[axisIdx], lastPos[axisIdx], pos);
+                    lastPos[axisIdx] = pos;
+                }
+            }
+        }
+        Log.notice("UnitTestTrinamicsHandover ticks %d turning points %d expected %d\n", tickIdx,
+                    turningPts[0].size(), expectedTurningPts[0].size());
+
+        // Every block is sent and completes at the expected position
+        TEST_ASSERT_EQUAL(0, motionPipeline.count());
+        TEST_ASSERT_EQUAL(expectedXTargetWrites, simulator.getXTargetWrites());
+        for (int axisIdx = 0; axisIdx < NUM_AXES; axisIdx++)
+        {
+            TEST_ASSERT_EQUAL(expectedPos[axisIdx], lastPos[axisIdx]);
+
+            // Each axis turns exactly at the end of the block before it reverses - turning short
+            // of that would drop part of the segment and turning beyond it is an overshoot
+            TEST_ASSERT_EQUAL(expectedTurningPts[axisIdx].size(), turningPts[axisIdx].size());
+            for (unsigned ptIdx = 0; (ptIdx < turningPts[axisIdx].size()) &&
+                        (ptIdx < expectedTurningPts[axisIdx].size()); ptIdx++)
+                TEST_ASSERT_EQUAL(expectedTurningPts[axisIdx][ptIdx], turningPts[axisIdx][ptIdx]);
+        }
+
+        delete pController;
+    }
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <Arduino.h>
+#include <unity.h>
+#include "../src/RobotMotion/MotionControl/Trinamics/TrinamicsController.h"
+#include "TrinamicsSimulator.h"
+#include <ArduinoLog.h>
+
+// Steps for each axis in each block - only the axes in the build are used (RBOT_MAX_AXES may be 2)
+static constexpr int UnitTestTrinamicsStream_NumAxes = (RobotConsts::MAX_AXES < 3) ? RobotConsts::MAX_AXES : 3;
+static const int32_t UnitTestTrinamicsStream_BlockSteps[][3] = {
+    { 4000, 2000, 0 },
+    { 4000, -1000, 500 },
+    { -2000, 3000, 0 },
+    { 1000, 0, -500 },
+};
+
+// Step rates (of the axis with most steps) at the junctions between blocks
+static const float UnitTestTrinamicsStream_JunctionStepRates[] = { 0, 1500, 500, 800, 0 };
+
+class UnitTestTrinamicsStream
+{
+public:
+    static constexpr float MAX_STEP_RATE = 4000;
+    static constexpr float STEP_ACC = 20000;
+    static constexpr float TIMER_PERIOD_SECS = 0.0005f;
+    static constexpr int MAX_TICKS = 40000;
+    static constexpr int LAST_NUMBERED_CMD_IDX = 7;
+
+    static uint32_t stepRateToTTicks(float stepsPerSec)
+    {
+        return uint32_t((stepsPerSec * MotionBlock::TTICKS_VALUE) / MotionBlock::TICKS_PER_SEC);
+    }
+
+    void runTests()
+    {
+        AxesParams axesParams;
+        MotionPipeline motionPipeline;
+        motionPipeline.init(10);
+        TrinamicsSimulator simulator;
+        TrinamicsController* pController = new TrinamicsController(axesParams, motionPipeline);
+        pController->setSPIBus(&simulator);
+        for (int axisIdx = 0; axisIdx < UnitTestTrinamicsStream_NumAxes; axisIdx++)
+        {
+            String axisJSON = R"({"chipDriverIdx":)" + String(axisIdx) + "}";
+            pController->configureAxis(axisIdx, axisJSON.c_str());
+        }
+
+        Serial.println("UnitTestTrinamicsStream");
+
+        // Add planned blocks to the pipeline
+        int numBlocks = sizeof(UnitTestTrinamicsStream_BlockSteps) / sizeof(UnitTestTrinamicsStream_BlockSteps[0]);
+        int32_t expectedPos[RobotConsts::MAX_AXES];
+        for (int axisIdx = 0; axisIdx < RobotConsts::MAX_AXES; axisIdx++)
+            expectedPos[axisIdx] = 0;
+        int expectedXTargetWrites = simulator.getXTargetWrites();
+        for (int blockIdx = 0; blockIdx < numBlocks; blockIdx++)
+        {
+            MotionBlock block;
+            MotionBlockExec blockExec;
+            for (int axisIdx = 0; axisIdx < UnitTestTrinamicsStream_NumAxes; axisIdx++)
+            {
+                int32_t steps = UnitTestTrinamicsStream_BlockSteps[blockIdx][axisIdx];
+                blockExec.setStepsToTarget(axisIdx, steps);
+                expectedPos[axisIdx] += steps;
+                if (steps != 0)
+                    expectedXTargetWrites++;
+            }
+            blockExec._initialStepRatePerTTicks = stepRateToTTicks(UnitTestTrinamicsStream_JunctionStepRates[blockIdx]);
+            blockExec._maxStepRatePerTTicks = stepRateToTTicks(MAX_STEP_RATE);
+            blockExec._finalStepRatePerTTicks = stepRateToTTicks(UnitTestTrinamicsStream_JunctionStepRates[blockIdx+1]);
+            blockExec._accStepsPerTTicksPerMS = stepRateToTTicks(STEP_ACC) / 1000;
+            if (blockIdx == numBlocks - 1)
+                blockExec.setNumberedCommandIndex(LAST_NUMBERED_CMD_IDX);
+            blockExec._canExecute = true;
+            TEST_ASSERT_TRUE(motionPipeline.add(block, blockExec));
+        }
+
+        // Run the controller's timer against the simulator - count ticks where the motors
+        // are all stopped between the start of the first block and the start of the last
+        // (other than the single tick at a junction where every moving axis reverses, as each
+        // has to come to rest at its target before the next target can be written)
+        int stalledTicks = 0;
+        int tickIdx = 0;
+        bool motionStarted = false;
+        bool lastTickStopped = false;
+        for (tickIdx = 0; (tickIdx < MAX_TICKS) && (motionPipeline.count() > 0); tickIdx++)
+        {
+            pController->_timerCallback(NULL);
+            simulator.advance(TIMER_PERIOD_SECS);
+            bool isStopped = false;
+            if (simulator.anyMoving())
+                motionStarted = true;
+            else if (motionStarted && (motionPipeline.count() > 1))
+                isStopped = true;
+            if (isStopped && lastTickStopped)
+                stalledTicks++;
+            lastTickStopped = isStopped;
+        }
+        Log.notice("UnitTestTrinamicsStream ticks %d stalled %d\n", tickIdx, stalledTicks);
+
+        // All blocks complete at the expected positions
+        TEST_ASSERT_EQUAL(0, motionPipeline.count());
+        for (int axisIdx = 0; axisIdx < UnitTestTrinamicsStream_NumAxes; axisIdx++)
+            TEST_ASSERT_EQUAL(expectedPos[axisIdx], simulator.getXActual(axisIdx / TrinamicsSimulator::NUM_DRIVERS,
+                                    axisIdx % TrinamicsSimulator::NUM_DRIVERS));
+        TEST_ASSERT_EQUAL(LAST_NUMBERED_CMD_IDX, pController->getLastCompletedNumberedCmdIdx());
+
+        // One target write per moving axis per block
+        TEST_ASSERT_EQUAL(expectedXTargetWrites, simulator.getXTargetWrites());
+
+        // Each block is handed over before the previous one reaches its target (or as soon as it
+        // does at a reversal) so the motors never stop mid-sequence
+        TEST_ASSERT_EQUAL(0, stalledTicks);
+
+        // Start and stop speeds of the last block sent are its junction speeds
+        float clockHz = TrinamicsRampRegs::CLOCK_HZ_DEFAULT;
+        TEST_ASSERT_EQUAL(TrinamicsRampRegs::velFromStepRate(UnitTestTrinamicsStream_JunctionStepRates[numBlocks-1], clockHz),
+                    simulator.getReg(0, 0, TMC5072_VSTART));
+        TEST_ASSERT_EQUAL(TrinamicsRampRegs::VSTOP_MIN, simulator.getReg(0, 0, TMC5072_VSTOP));
+
+        delete pController;
+    }
+};
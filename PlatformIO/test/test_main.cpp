@@ -2,6 +2,14 @@
 #include <unity.h>
 #include "UnitTestHomingSeq.h"
 #include "UnitTestMiniHDLC.h"
+#include "UnitTestTrinamicsStream.h"
+#include "UnitTestTrinamicsHandover.h"
+#include "UnitTestPlannerModes.h"
+#include "UnitTestGoldenTraces.h"
+#include "UnitTestPlannerFuzz.h"
+#include "UnitTestRdJson.h"
+#include "UnitTestHeatshrink.h"
+#include "UnitTestPatternIndexer.h"
 
 void setUp(void) {
 // set stuff up here
@@ -21,6 +29,46 @@ void testMiniHDLC(void) {
     unitTestMiniHDLC.runTests();
 }
 
+void testTrinamicsStream(void) {
+    UnitTestTrinamicsStream unitTestTrinamicsStream;
+    unitTestTrinamicsStream.runTests();
+}
+
+void testTrinamicsHandover(void) {
+    UnitTestTrinamicsHandover unitTestTrinamicsHandover;
+    unitTestTrinamicsHandover.runTests();
+}
+
+void testPlannerModes(void) {
+    UnitTestPlannerModes unitTestPlannerModes;
+    unitTestPlannerModes.runTests();
+}
+
+void testGoldenTraces(void) {
+    UnitTestGoldenTraces unitTestGoldenTraces;
+    unitTestGoldenTraces.runTests();
+}
+
+void testPlannerFuzz(void) {
+    UnitTestPlannerFuzz unitTestPlannerFuzz;
+    unitTestPlannerFuzz.runTests();
+}
+
+void testRdJson(void) {
+    UnitTestRdJson unitTestRdJson;
+    unitTestRdJson.runTests();
+}
+
+void testHeatshrink(void) {
+    UnitTestHeatshrink unitTestHeatshrink;
+    unitTestHeatshrink.runTests();
+}
+
+void testPatternIndexer(void) {
+    UnitTestPatternIndexer unitTestPatternIndexer;
+    unitTestPatternIndexer.runTests();
+}
+
 void setup() {
     // NOTE!!! Wait for >2 secs
     // if board doesn't support software reset via Serial.DTR/RTS
@@ -31,6 +79,14 @@ void setup() {
     // Run the tests
     RUN_TEST(testMiniHDLC);
     RUN_TEST(testHomingSeq);
+    RUN_TEST(testTrinamicsStream);
+    RUN_TEST(testTrinamicsHandover);
+    RUN_TEST(testPlannerModes);
+    RUN_TEST(testGoldenTraces);
+    RUN_TEST(testPlannerFuzz);
+    RUN_TEST(testRdJson);
+    RUN_TEST(testHeatshrink);
+    RUN_TEST(testPatternIndexer);
 
     UNITY_END(); // stop unit testing
 
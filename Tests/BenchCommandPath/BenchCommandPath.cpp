@@ -0,0 +1,226 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host throughput benchmark of the full command path - a G-code or THR file is fed through
+// WorkManager (file evaluator, work item queue, G-code interpreter) -> RobotController ->
+// MotionHelper (kinematics, planner) -> RampGenerator with the step ISR called directly (or the
+// Trinamics controller against the TrinamicsSimulator) as fast as possible. Reports points/sec
+// and the per-stage breakdown from CommandPathTiming as a single line of JSON
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include "ConfigBase.h"
+#include "WiFiManager.h"
+#include "MQTTManager.h"
+#include "RdOTAUpdate.h"
+#include "NetLog.h"
+#include "NTPClient.h"
+#include "FileManager.h"
+#include "RestAPIEndpoints.h"
+#include "RestAPISystem.h"
+#include "CommandScheduler.h"
+#include "CommandSerial.h"
+#include "LedStrip.h"
+#include "CommandPathTiming.h"
+#include "RobotConfigurations.h"
+#include "RobotMotion/RobotController.h"
+#include "WorkManager/WorkManager.h"
+#include "TrinamicsSimulator.h"
+
+static constexpr int GEN_THR_POINTS = 20000;
+static constexpr float GEN_THR_TURNS = 100;
+static constexpr uint32_t TICKS_PER_LOOP = 50;
+static constexpr float TRINAMICS_TIMER_PERIOD_SECS = 0.0005f;
+static constexpr uint32_t TRINAMICS_TIMER_INTERVAL_TICKS = uint32_t(TRINAMICS_TIMER_PERIOD_SECS * MotionBlock::TICKS_PER_SEC);
+static constexpr float MAX_SIM_SECS = 24 * 3600;
+// Loop iterations with nothing to do before the run is considered complete
+static constexpr int IDLE_LOOPS_AT_END = 100;
+
+static uint32_t BenchCommandPath_getNs()
+{
+    return uint32_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Spiral in and out (Sandify style) used when no file is given
+static bool BenchCommandPath_genTHR(const char* fileName)
+{
+    FILE* pFile = fopen(fileName, "w");
+    if (!pFile)
+        return false;
+    fprintf(pFile, "# BenchCommandPath spiral\n");
+    for (int ptIdx = 0; ptIdx <= GEN_THR_POINTS; ptIdx++)
+    {
+        float theta = 2 * M_PI * GEN_THR_TURNS * ptIdx / GEN_THR_POINTS;
+        float rho = 1 - fabsf(1 - 2.0f * ptIdx / GEN_THR_POINTS);
+        fprintf(pFile, "%0.5f %0.5f\n", theta, rho);
+    }
+    fclose(pFile);
+    return true;
+}
+
+static int BenchCommandPath_countLines(const char* fileName)
+{
+    FILE* pFile = fopen(fileName, "r");
+    if (!pFile)
+        return -1;
+    int numLines = 0;
+    char lineBuf[200];
+    while (fgets(lineBuf, sizeof(lineBuf), pFile))
+        if ((lineBuf[0] != '#') && (lineBuf[0] != ';') && (strspn(lineBuf, " \t\r\n") != strlen(lineBuf)))
+            numLines++;
+    fclose(pFile);
+    return numLines;
+}
+
+// Set the planner mode in the robotGeom section of a robot config
+static bool BenchCommandPath_setPlannerMode(String& robotConfigStr, const String& plannerMode)
+{
+    int geomPos = robotConfigStr.indexOf("\"robotGeom\"");
+    int bracePos = (geomPos < 0) ? -1 : robotConfigStr.indexOf('{', geomPos);
+    if (bracePos < 0)
+        return false;
+    robotConfigStr = robotConfigStr.substring(0, bracePos + 1) + "\"plannerMode\":\"" + plannerMode + "\"," +
+                robotConfigStr.substring(bracePos + 1);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    // Args: [file.gcode|file.thr] [robotType] [plannerMode]
+    const char* fileName = (argc > 1) ? argv[1] : "BenchCommandPath.thr";
+    String robotType;
+    if (argc > 2)
+        robotType = argv[2];
+    else
+        RobotConfigurations::getNthRobotTypeName(0, robotType);
+    String robotConfigStr = RobotConfigurations::getConfig(robotType.c_str());
+    if (robotConfigStr.equals("{}"))
+    {
+        fprintf(stderr, "BenchCommandPath: unknown robotType %s\n", robotType.c_str());
+        return 1;
+    }
+    if (argc > 3)
+    {
+        String plannerModeStr = argv[3];
+        if (!plannerModeStr.equalsIgnoreCase(MotionPlanner::getPlannerModeStr(
+                    MotionPlanner::getPlannerModeFromStr(plannerModeStr))))
+        {
+            fprintf(stderr, "BenchCommandPath: unknown plannerMode %s\n", argv[3]);
+            return 1;
+        }
+        if (!BenchCommandPath_setPlannerMode(robotConfigStr, plannerModeStr))
+        {
+            fprintf(stderr, "BenchCommandPath: can't set plannerMode %s (no robotGeom in %s config)\n",
+                        argv[3], robotType.c_str());
+            return 1;
+        }
+    }
+    String robotGeom = RdJson::getString("robotGeom", "", robotConfigStr.c_str());
+    MotionPlanner::PlannerMode plannerMode = MotionPlanner::getPlannerModeFromStr(
+                RdJson::getString("plannerMode", "junctionDeviation", robotGeom.c_str()));
+    if ((argc <= 1) && !BenchCommandPath_genTHR(fileName))
+    {
+        fprintf(stderr, "BenchCommandPath: can't write %s\n", fileName);
+        return 1;
+    }
+    int inputLines = BenchCommandPath_countLines(fileName);
+    if (inputLines < 0)
+    {
+        fprintf(stderr, "BenchCommandPath: can't read %s\n", fileName);
+        return 1;
+    }
+
+    // Same objects as the firmware (only the work manager and robot are used)
+    ConfigBase hwConfig("{}");
+    String robotConfigJson = "{\"robotConfig\":" + robotConfigStr + "}";
+    ConfigBase robotConfig(robotConfigJson.c_str());
+    ConfigBase ledStripConfig("{}");
+    WiFiManager wifiManager;
+    NTPClient ntpClient;
+    FileManager fileManager;
+    RestAPIEndpoints restAPIEndpoints;
+    MQTTManager mqttManager(wifiManager, restAPIEndpoints);
+    RdOTAUpdate otaUpdate;
+    CommandScheduler commandScheduler;
+    CommandSerial commandSerial(fileManager);
+    NetLog netLog(Serial, mqttManager, commandSerial);
+    RestAPISystem restAPISystem(wifiManager, mqttManager, otaUpdate, netLog, fileManager, ntpClient,
+                commandScheduler, "BenchCommandPath", "0");
+    LedStrip ledStrip(ledStripConfig);
+    RobotController robotController;
+    WorkManager workManager(hwConfig, robotConfig, robotController, ledStrip, restAPISystem,
+                fileManager, commandScheduler);
+
+    // Robot - steps are generated below rather than from the timers
+    MotionHelper* pMotionHelper = robotController.testGetMotionHelper();
+    TrinamicsSimulator simulator;
+    TrinamicsController* pTrinamicsController = pMotionHelper->testGetTrinamicsController();
+    pTrinamicsController->setSPIBus(&simulator);
+    workManager.reconfigure();
+    RampGenerator* pRampGenerator = pMotionHelper->testGetRampGenerator();
+    pRampGenerator->deinit();
+    pTrinamicsController->testStopTimer();
+    pMotionHelper->pause(false);
+
+    // Start the file
+    String retStr;
+    WorkItem workItem(fileName);
+    workManager.addWorkItem(workItem, retStr);
+
+    // Run as the main loop does
+    CommandPathTiming::setClock(BenchCommandPath_getNs, 1000);
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    uint32_t tickCount = 0;
+    int idleLoops = 0;
+    while (idleLoops < IDLE_LOOPS_AT_END)
+    {
+        workManager.service();
+        robotController.service();
+        CommandPathTiming::start(CommandPathTiming::STAGE_STEP);
+        for (uint32_t tickIdx = 0; tickIdx < TICKS_PER_LOOP; tickIdx++)
+        {
+            if (!pTrinamicsController->isRampGenerator())
+            {
+                pRampGenerator->testTick();
+            }
+            else if (tickCount % TRINAMICS_TIMER_INTERVAL_TICKS == 0)
+            {
+                pTrinamicsController->_timerCallback(NULL);
+                simulator.advance(TRINAMICS_TIMER_PERIOD_SECS);
+            }
+            tickCount++;
+        }
+        CommandPathTiming::end();
+        bool isIdle = workManager.queueIsEmpty() && !workManager.testEvaluatorsBusy() &&
+                    pMotionHelper->isIdle() && pMotionHelper->canAccept();
+        idleLoops = isIdle ? idleLoops + 1 : 0;
+        if (tickCount / MotionBlock::TICKS_PER_SEC > MAX_SIM_SECS)
+        {
+            fprintf(stderr, "BenchCommandPath: not complete after %0.0fs of motion\n", MAX_SIM_SECS);
+            return 1;
+        }
+    }
+    double wallSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    // Results
+    AxisInt32s steps;
+    if (pTrinamicsController->isRampGenerator())
+        pTrinamicsController->getTotalStepPosition(steps);
+    else
+        pRampGenerator->getTotalStepPosition(steps);
+    uint32_t points = CommandPathTiming::getStageCount(CommandPathTiming::STAGE_GCODE);
+    double pathUs = CommandPathTiming::getTotalUs() - CommandPathTiming::getStageUs(CommandPathTiming::STAGE_STEP);
+    String timingJson;
+    CommandPathTiming::getJSON(timingJson);
+    printf("{\"bench\":\"commandPath\",\"robotType\":\"%s\",\"plannerMode\":\"%s\",\"file\":\"%s\",\"inputLines\":%d,"
+                "\"points\":%u,\"blocks\":%u,\"finalSteps\":[%d,%d],\"simSecs\":%0.3f,\"wallSecs\":%0.3f,"
+                "\"pointsPerSec\":%0.1f,\"pointsPerSecExclSteps\":%0.1f,\"usPerPoint\":%0.3f,\"timing\":%s}\n",
+                robotType.c_str(), MotionPlanner::getPlannerModeStr(plannerMode), fileName, inputLines,
+                points, CommandPathTiming::getStageCount(CommandPathTiming::STAGE_PLAN),
+                steps.getVal(0), steps.getVal(1), tickCount / MotionBlock::TICKS_PER_SEC, wallSecs,
+                (wallSecs > 0) ? points / wallSecs : 0, (pathUs > 0) ? points * 1e6 / pathUs : 0,
+                (points > 0) ? pathUs / points : 0, timingJson.c_str());
+    return 0;
+}
@@ -0,0 +1,61 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host benchmark of FileManager on the RAM-backed file system backend - runs the same benchmark
+// as the fsbench REST endpoint (upload write, listing, stat and sequential read) for a range of
+// file counts. The RAM folder can be a mount of a SPIFFS or LittleFS flash image (e.g. with
+// littlefs-fuse) to compare backends on simulated flash. Outputs one line of JSON per file count
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <unistd.h>
+#include "FileManager.h"
+
+static const int DEFAULT_FILE_COUNTS[] = { 10, 50, 100 };
+static const int RESULT_POLL_US = 1000;
+
+int main(int argc, char** argv)
+{
+    // Args: [ramFsRoot] [numFiles ...]
+    String ramFsRoot = (argc > 1) ? argv[1] : "/dev/shm/rbotfs";
+    String configStr = "{\"fileManager\":{\"spiffsEnabled\":1,\"flashFs\":\"ram\",\"ramFsRoot\":\"" + ramFsRoot + "\"}}";
+    ConfigBase config(configStr.c_str());
+
+    // FileManager's worker task runs until the process exits so it isn't destroyed
+    FileManager& fileManager = *new FileManager();
+    fileManager.setup(config);
+    String respStr;
+    if (!fileManager.getFilesJSON("spiffs", "/", respStr))
+    {
+        fprintf(stderr, "BenchFileSys: can't use %s (%s)\n", ramFsRoot.c_str(), respStr.c_str());
+        return 1;
+    }
+
+    std::vector<int> fileCounts;
+    for (int argIdx = 2; argIdx < argc; argIdx++)
+        fileCounts.push_back(atoi(argv[argIdx]));
+    if (fileCounts.empty())
+        fileCounts.assign(DEFAULT_FILE_COUNTS, DEFAULT_FILE_COUNTS + sizeof(DEFAULT_FILE_COUNTS) / sizeof(int));
+    for (int numFiles : fileCounts)
+    {
+        // The benchmark runs on the worker task - wait for its result
+        fileManager.runBenchmark("spiffs", numFiles, respStr);
+        if (respStr.indexOf("\"ok\"") < 0)
+        {
+            fprintf(stderr, "BenchFileSys: can't start (%s)\n", respStr.c_str());
+            return 1;
+        }
+        while (true)
+        {
+            fileManager.getBenchmarkResult(respStr);
+            if (respStr.indexOf("\"busy\"") < 0)
+                break;
+            usleep(RESULT_POLL_US);
+        }
+        printf("%s\n", respStr.c_str());
+        if (respStr.indexOf("\"ok\"") < 0)
+            return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host benchmark of RdJson::escapeString/unescapeString against the previous chained
+// String::replace versions on large config blobs. Results are checked against each other for
+// content the old versions handled correctly and the timings reported as a line of JSON
+
+#include <stdio.h>
+#include <chrono>
+#include "RdJson.h"
+
+static constexpr int DEFAULT_BLOB_KB = 64;
+static constexpr int DEFAULT_REPEATS = 100;
+
+// Previous implementations (three passes each, unescape mis-handles an escaped backslash before n)
+static void BenchJsonEscape_oldEscape(String& strToEsc)
+{
+    strToEsc.replace("\\", "\\\\");
+    strToEsc.replace("\"", "\\\"");
+    strToEsc.replace("\n", "\\n");
+}
+
+static void BenchJsonEscape_oldUnescape(String& strToUnEsc)
+{
+    strToUnEsc.replace("\\\"", "\"");
+    strToUnEsc.replace("\\\\", "\\");
+    strToUnEsc.replace("\\n", "\n");
+}
+
+// Config-like blob with quotes and newlines (startup commands and nested JSON values)
+static void BenchJsonEscape_genBlob(String& blob, int blobKB)
+{
+    static const char* blobParts[] = {
+        "{\"robotType\":\"SandTableScara\",\"cmdsAtStart\":\"\",\n",
+        "\"startup\":\"G28\nG0 X0 Y0\nG0 X10 Y10 F500\",\n",
+        "\"axis0\":{\"maxSpeed\":75,\"maxAcc\":50,\"stepsPerRot\":9600,\"unitsPerRot\":628.318},\n",
+        "\"wifiSSID\":\"home\",\"wifiPW\":\"pass\",\"pattern\":\"x=sin(t)*100\ny=cos(t)*100\",\n",
+    };
+    blob = "";
+    int partIdx = 0;
+    while (blob.length() < (unsigned)blobKB * 1024)
+        blob += blobParts[partIdx++ % (sizeof(blobParts) / sizeof(blobParts[0]))];
+}
+
+template<typename FnType>
+static double BenchJsonEscape_timeUs(const String& src, int repeats, FnType fn, String& result)
+{
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++)
+    {
+        result = src;
+        fn(result);
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime).count() / repeats;
+}
+
+int main(int argc, char** argv)
+{
+    // Args: [blobKB] [repeats]
+    int blobKB = (argc > 1) ? atoi(argv[1]) : DEFAULT_BLOB_KB;
+    int repeats = (argc > 2) ? atoi(argv[2]) : DEFAULT_REPEATS;
+    if ((blobKB <= 0) || (repeats <= 0))
+    {
+        fprintf(stderr, "BenchJsonEscape: [blobKB] [repeats]\n");
+        return 1;
+    }
+    String blob;
+    BenchJsonEscape_genBlob(blob, blobKB);
+
+    // Escape
+    String oldEscaped, newEscaped;
+    double oldEscUs = BenchJsonEscape_timeUs(blob, repeats, BenchJsonEscape_oldEscape, oldEscaped);
+    double newEscUs = BenchJsonEscape_timeUs(blob, repeats,
+                [](String& str) { RdJson::escapeString(str); }, newEscaped);
+
+    // Unescape
+    String oldUnescaped, newUnescaped;
+    double oldUnescUs = BenchJsonEscape_timeUs(newEscaped, repeats, BenchJsonEscape_oldUnescape, oldUnescaped);
+    double newUnescUs = BenchJsonEscape_timeUs(newEscaped, repeats,
+                [](String& str) { RdJson::unescapeString(str); }, newUnescaped);
+
+    bool escMatch = oldEscaped == newEscaped;
+    bool unescMatch = (oldUnescaped == newUnescaped) && (newUnescaped == blob);
+    if (!escMatch || !unescMatch)
+        fprintf(stderr, "BenchJsonEscape: results differ (escape %s unescape %s)\n",
+                    escMatch ? "ok" : "differs", unescMatch ? "ok" : "differs");
+    printf("{\"bench\":\"jsonEscape\",\"blobBytes\":%u,\"escapedBytes\":%u,\"repeats\":%d,"
+                "\"escapeUs\":{\"old\":%0.1f,\"new\":%0.1f},\"unescapeUs\":{\"old\":%0.1f,\"new\":%0.1f},"
+                "\"match\":%s}\n",
+                (unsigned)blob.length(), (unsigned)newEscaped.length(), repeats,
+                oldEscUs, newEscUs, oldUnescUs, newUnescUs, (escMatch && unescMatch) ? "true" : "false");
+    return (escMatch && unescMatch) ? 0 : 1;
+}
@@ -0,0 +1,263 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Compresses THR and G-code pattern files for the firmware's compressed file support - each
+// file is written to the same name with .hs appended in heatshrink format (window 2^11, lookahead
+// 2^4) and checked by decoding it again with the firmware's HeatshrinkDecoder. With no files a
+// self-test of round trips on generated data is run. Reports sizes and decode speed as JSON
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "HeatshrinkDecoder.h"
+
+typedef std::vector<uint8_t> ByteVec;
+
+static const int WINDOW_BITS = HeatshrinkDecoder::WINDOW_BITS;
+static const int LOOKAHEAD_BITS = HeatshrinkDecoder::LOOKAHEAD_BITS;
+static const int MAX_MATCH_LEN = 1 << LOOKAHEAD_BITS;
+static const int MAX_MATCH_DIST = 1 << WINDOW_BITS;
+// A back-reference (1 + 11 + 4 bits) is shorter than two literals (2 x 9 bits)
+static const int MIN_MATCH_LEN = 2;
+static const int HASH_BITS = 12;
+static const int DECODE_REPEATS = 20;
+
+// Bits are written MSB first as in the heatshrink reference encoder
+class BitWriter
+{
+public:
+    BitWriter(ByteVec& out) : _out(out), _curByte(0), _bitCount(0)
+    {
+    }
+    void put(uint32_t bits, int numBits)
+    {
+        for (int bitIdx = numBits - 1; bitIdx >= 0; bitIdx--)
+        {
+            _curByte = (_curByte << 1) | ((bits >> bitIdx) & 1);
+            if (++_bitCount == 8)
+            {
+                _out.push_back(_curByte);
+                _curByte = 0;
+                _bitCount = 0;
+            }
+        }
+    }
+    void flush()
+    {
+        // Pad the last byte with zeros
+        if (_bitCount > 0)
+            _out.push_back(_curByte << (8 - _bitCount));
+        _curByte = 0;
+        _bitCount = 0;
+    }
+private:
+    ByteVec& _out;
+    uint8_t _curByte;
+    int _bitCount;
+};
+
+// Greedy LZSS with hash chains over the window
+static void CompressPatterns_encode(const ByteVec& in, ByteVec& out)
+{
+    out.clear();
+    BitWriter bitWriter(out);
+    std::vector<int> hashHead(1 << HASH_BITS, -1);
+    std::vector<int> hashPrev(in.size(), -1);
+    int inLen = in.size();
+    auto hashAt = [&](int pos) {
+        return ((in[pos] << 5) ^ (in[pos + 1] << 2) ^ in[pos + 2]) & ((1 << HASH_BITS) - 1);
+    };
+    auto insertPos = [&](int pos) {
+        if (pos + 2 >= inLen)
+            return;
+        int hash = hashAt(pos);
+        hashPrev[pos] = hashHead[hash];
+        hashHead[hash] = pos;
+    };
+    int pos = 0;
+    while (pos < inLen)
+    {
+        // Longest match in the window
+        int bestLen = 0;
+        int bestDist = 0;
+        int maxLen = std::min(MAX_MATCH_LEN, inLen - pos);
+        if (pos + 2 < inLen)
+        {
+            for (int candPos = hashHead[hashAt(pos)]; (candPos >= 0) && (pos - candPos <= MAX_MATCH_DIST); candPos = hashPrev[candPos])
+            {
+                int matchLen = 0;
+                while ((matchLen < maxLen) && (in[candPos + matchLen] == in[pos + matchLen]))
+                    matchLen++;
+                if (matchLen > bestLen)
+                {
+                    bestLen = matchLen;
+                    bestDist = pos - candPos;
+                    if (bestLen == maxLen)
+                        break;
+                }
+            }
+        }
+        // Two byte matches aren't hashed so check the previous positions directly
+        if ((bestLen < MIN_MATCH_LEN) && (maxLen >= MIN_MATCH_LEN))
+        {
+            for (int candPos = pos - 1; (candPos >= 0) && (pos - candPos <= MAX_MATCH_DIST) && (bestLen < MIN_MATCH_LEN); candPos--)
+                if ((in[candPos] == in[pos]) && (in[candPos + 1] == in[pos + 1]))
+                {
+                    bestLen = MIN_MATCH_LEN;
+                    bestDist = pos - candPos;
+                }
+        }
+
+        // Output a back-reference or a literal
+        int stepLen = 1;
+        if (bestLen >= MIN_MATCH_LEN)
+        {
+            bitWriter.put(0, 1);
+            bitWriter.put(bestDist - 1, WINDOW_BITS);
+            bitWriter.put(bestLen - 1, LOOKAHEAD_BITS);
+            stepLen = bestLen;
+        }
+        else
+        {
+            bitWriter.put(1, 1);
+            bitWriter.put(in[pos], 8);
+        }
+        for (int i = 0; i < stepLen; i++)
+            insertPos(pos + i);
+        pos += stepLen;
+    }
+    bitWriter.flush();
+}
+
+// Decode with the firmware decoder - input and output are passed in pieces of the given
+// sizes (0 for random sizes) to check streaming
+static void CompressPatterns_decode(const ByteVec& in, ByteVec& out, size_t inPiece, size_t outPiece)
+{
+    HeatshrinkDecoder decoder;
+    out.clear();
+    uint8_t outBuf[512];
+    size_t inPos = 0;
+    while (true)
+    {
+        size_t inLen = inPiece ? inPiece : 1 + rand() % 300;
+        if (inLen > in.size() - inPos)
+            inLen = in.size() - inPos;
+        size_t outMax = outPiece ? outPiece : 1 + rand() % sizeof(outBuf);
+        if (outMax > sizeof(outBuf))
+            outMax = sizeof(outBuf);
+        size_t inUsed = 0;
+        size_t outLen = decoder.decode(in.data() + inPos, inLen, inUsed, outBuf, outMax);
+        inPos += inUsed;
+        out.insert(out.end(), outBuf, outBuf + outLen);
+        if ((outLen == 0) && (inPos >= in.size()))
+            break;
+    }
+}
+
+// Round trip and timing for one input - returns false if the decoded data differs
+static bool CompressPatterns_check(const char* name, const ByteVec& in, ByteVec& compressed, bool printResult)
+{
+    CompressPatterns_encode(in, compressed);
+
+    // Streaming with odd sized pieces
+    ByteVec decoded;
+    CompressPatterns_decode(compressed, decoded, 0, 0);
+    bool ok = decoded == in;
+    CompressPatterns_decode(compressed, decoded, 1, 1);
+    ok = ok && (decoded == in);
+
+    // Speed in the FileManager block sizes
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    for (int rep = 0; rep < DECODE_REPEATS; rep++)
+        CompressPatterns_decode(compressed, decoded, 512, 512);
+    double decodeSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    ok = ok && (decoded == in);
+    if (printResult)
+        printf("{\"file\":\"%s\",\"ok\":%s,\"size\":%u,\"compressedSize\":%u,\"ratio\":%0.3f,\"decodeMBPerSec\":%0.1f}\n",
+                    name, ok ? "true" : "false", (unsigned)in.size(), (unsigned)compressed.size(),
+                    in.size() ? (double)compressed.size() / in.size() : 0,
+                    decodeSecs > 0 ? in.size() * DECODE_REPEATS / decodeSecs / 1e6 : 0);
+    return ok;
+}
+
+static bool CompressPatterns_selfTest()
+{
+    std::vector<std::pair<std::string, ByteVec>> cases;
+    cases.push_back({"empty", ByteVec()});
+    cases.push_back({"oneByte", ByteVec(1, 'x')});
+    cases.push_back({"run", ByteVec(10000, 'a')});
+    ByteVec randomBytes;
+    for (int i = 0; i < 10000; i++)
+        randomBytes.push_back(rand() & 0xff);
+    cases.push_back({"random", randomBytes});
+    ByteVec zeros(5000, 0);
+    cases.push_back({"zeros", zeros});
+    // Spiral as BenchCommandPath generates
+    std::string thr = "# CompressPatterns spiral\n";
+    char lineBuf[100];
+    for (int ptIdx = 0; ptIdx <= 20000; ptIdx++)
+    {
+        float theta = 2 * M_PI * 100 * ptIdx / 20000;
+        float rho = 1 - fabsf(1 - 2.0f * ptIdx / 20000);
+        snprintf(lineBuf, sizeof(lineBuf), "%0.5f %0.5f\n", theta, rho);
+        thr += lineBuf;
+    }
+    cases.push_back({"spiralTHR", ByteVec(thr.begin(), thr.end())});
+    bool allOk = true;
+    for (auto& testCase : cases)
+    {
+        ByteVec compressed;
+        allOk = CompressPatterns_check(testCase.first.c_str(), testCase.second, compressed, true) && allOk;
+    }
+    return allOk;
+}
+
+static bool CompressPatterns_readFile(const char* fileName, ByteVec& data)
+{
+    FILE* pFile = fopen(fileName, "rb");
+    if (!pFile)
+        return false;
+    uint8_t buf[4096];
+    size_t readLen = 0;
+    data.clear();
+    while ((readLen = fread(buf, 1, sizeof(buf), pFile)) > 0)
+        data.insert(data.end(), buf, buf + readLen);
+    fclose(pFile);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    // Args: [file ...]
+    if (argc <= 1)
+        return CompressPatterns_selfTest() ? 0 : 1;
+    bool allOk = true;
+    for (int argIdx = 1; argIdx < argc; argIdx++)
+    {
+        ByteVec in;
+        if (!CompressPatterns_readFile(argv[argIdx], in))
+        {
+            fprintf(stderr, "CompressPatterns: can't read %s\n", argv[argIdx]);
+            return 1;
+        }
+        ByteVec compressed;
+        if (!CompressPatterns_check(argv[argIdx], in, compressed, true))
+        {
+            allOk = false;
+            continue;
+        }
+        std::string outName = std::string(argv[argIdx]) + ".hs";
+        FILE* pFile = fopen(outName.c_str(), "wb");
+        if (!pFile || (fwrite(compressed.data(), 1, compressed.size(), pFile) != compressed.size()))
+        {
+            fprintf(stderr, "CompressPatterns: can't write %s\n", outName.c_str());
+            return 1;
+        }
+        fclose(pFile);
+    }
+    return allOk ? 0 : 1;
+}
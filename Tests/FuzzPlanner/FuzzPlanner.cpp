@@ -0,0 +1,20 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// libFuzzer target for the planner and step generation invariants (see PlannerFuzzCase.h)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "PlannerFuzzCase.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* pData, size_t dataLen)
+{
+    PlannerFuzzCase fuzzCase;
+    const char* pFailMsg = fuzzCase.run(pData, dataLen);
+    if (pFailMsg)
+    {
+        fprintf(stderr, "PlannerFuzzCase failed: %s\n", pFailMsg);
+        abort();
+    }
+    return 0;
+}
@@ -0,0 +1,18 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host runner for UnitTestGoldenTraces (PlatformIO/test) - checks the step traces of every robot
+// configuration against PlatformIO/test/GoldenTraces.h or, when built with GOLDEN_TRACES_RECORD,
+// prints a replacement for GoldenTraces.h
+
+#include "UnitTestGoldenTraces.h"
+
+int main(int argc, char** argv)
+{
+    UnitTestGoldenTraces unitTestGoldenTraces;
+    unitTestGoldenTraces.runTests();
+#ifndef GOLDEN_TRACES_RECORD
+    fprintf(stderr, "GoldenTraces: %d failures\n", unityFailCount);
+#endif
+    return (unityFailCount == 0) ? 0 : 1;
+}
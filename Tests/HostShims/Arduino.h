@@ -0,0 +1,178 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host version of the Arduino core used by the firmware code built in Tests/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+#include <time.h>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <ctype.h>
+
+using std::min;
+using std::max;
+
+#define IRAM_ATTR
+#define INPUT 0
+#define OUTPUT 1
+#define HIGH 1
+#define LOW 0
+#define INPUT_PULLUP 2
+#define INPUT_PULLDOWN 3
+#define HEX 16
+#define DEC 10
+typedef uint8_t byte;
+
+// Pins do nothing
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+inline int digitalRead(int) { return 0; }
+
+// Time is the host's monotonic clock - delays return immediately
+inline unsigned long hostShimsNowUs()
+{
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+inline unsigned long millis() { return hostShimsNowUs() / 1000; }
+inline unsigned long micros() { return hostShimsNowUs(); }
+inline void delay(int) {}
+inline void delayMicroseconds(int) {}
+inline bool getLocalTime(struct tm*, int) { return false; }
+
+// Arduino String (the parts the firmware code uses) based on std::string
+class String : public std::string
+{
+public:
+    String() {}
+    String(const char* s) : std::string(s ? s : "") {}
+    String(const std::string& s) : std::string(s) {}
+    String(char c) : std::string(1, c) {}
+    String(int val) : std::string(std::to_string(val)) {}
+    String(int val, int base) { char buf[40]; snprintf(buf, sizeof(buf), base == 16 ? "%x" : "%d", val); assign(buf); }
+    String(unsigned val) : std::string(std::to_string(val)) {}
+    String(long val) : std::string(std::to_string(val)) {}
+    String(unsigned long val) : std::string(std::to_string(val)) {}
+    String(double val, int decPlaces = 2) { char buf[40]; snprintf(buf, sizeof(buf), "%.*f", decPlaces, val); assign(buf); }
+
+    unsigned length() const { return size(); }
+    bool equals(const String& s) const { return *this == s; }
+    bool equalsIgnoreCase(const String& s) const { return strcasecmp(c_str(), s.c_str()) == 0; }
+    bool startsWith(const String& s) const { return compare(0, s.size(), s) == 0; }
+    bool startsWith(const String& s, unsigned offset) const { return offset <= size() && compare(offset, s.size(), s) == 0; }
+    bool endsWith(const String& s) const { return size() >= s.size() && compare(size() - s.size(), s.size(), s) == 0; }
+    int indexOf(char c, unsigned from = 0) const { size_t pos = find(c, from); return pos == npos ? -1 : int(pos); }
+    int indexOf(const String& s, unsigned from = 0) const { size_t pos = find(s, from); return pos == npos ? -1 : int(pos); }
+    int lastIndexOf(char c) const { size_t pos = rfind(c); return pos == npos ? -1 : int(pos); }
+    char charAt(size_t idx) const { return idx < size() ? (*this)[idx] : 0; }
+    void setCharAt(size_t idx, char c) { if (idx < size()) (*this)[idx] = c; }
+
+    String substring(size_t from) const { return from < size() ? String(substr(from)) : String(); }
+    String substring(size_t from, size_t to) const
+    {
+        if (to > size())
+            to = size();
+        return (from < to) ? String(substr(from, to - from)) : String();
+    }
+    void trim()
+    {
+        size_t first = find_first_not_of(" \t\r\n");
+        if (first == npos)
+        {
+            clear();
+            return;
+        }
+        size_t last = find_last_not_of(" \t\r\n");
+        assign(substr(first, last - first + 1));
+    }
+    void replace(const String& from, const String& to)
+    {
+        if (from.empty())
+            return;
+        size_t pos = 0;
+        while ((pos = find(from, pos)) != npos)
+        {
+            std::string::replace(pos, from.size(), to);
+            pos += to.size();
+        }
+    }
+    void remove(unsigned idx) { if (idx < size()) erase(idx); }
+    void remove(unsigned idx, unsigned count) { if (idx < size()) erase(idx, count); }
+    void toUpperCase() { for (auto& c : *this) c = toupper(c); }
+    void toLowerCase() { for (auto& c : *this) c = tolower(c); }
+
+    long toInt() const { return atol(c_str()); }
+    float toFloat() const { return atof(c_str()); }
+    double toDouble() const { return atof(c_str()); }
+    void toCharArray(char* pBuf, unsigned bufLen) const
+    {
+        if (bufLen == 0)
+            return;
+        strncpy(pBuf, c_str(), bufLen - 1);
+        pBuf[bufLen - 1] = 0;
+    }
+
+    bool concat(const String& s) { append(s); return true; }
+    bool concat(char c) { push_back(c); return true; }
+    bool concat(int val) { append(std::to_string(val)); return true; }
+    String& operator+=(const char* s) { append(s); return *this; }
+    String& operator+=(const std::string& s) { append(s); return *this; }
+    String& operator+=(char c) { push_back(c); return *this; }
+    String& operator+=(int val) { append(std::to_string(val)); return *this; }
+    String& operator+=(unsigned val) { append(std::to_string(val)); return *this; }
+    String& operator+=(long val) { append(std::to_string(val)); return *this; }
+    String& operator+=(unsigned long val) { append(std::to_string(val)); return *this; }
+    String& operator+=(double val) { append(String(val)); return *this; }
+};
+
+inline String operator+(const String& a, const String& b) { String r(a); r.append(b); return r; }
+inline String operator+(const String& a, const char* b) { String r(a); r.append(b); return r; }
+inline String operator+(const char* a, const String& b) { String r(a); r.append(b); return r; }
+inline String operator+(const String& a, char b) { String r(a); r.push_back(b); return r; }
+inline String operator+(const String& a, int b) { return a + String(b); }
+inline String operator+(const String& a, long b) { return a + String(b); }
+inline String operator+(const String& a, unsigned long b) { return a + String(b); }
+inline String operator+(const String& a, double b) { return a + String(b); }
+
+class HardwareSerial
+{
+public:
+    void println(const char* s) { puts(s); }
+    void println(const String& s) { puts(s.c_str()); }
+    void print(const char* s) { fputs(s, stdout); }
+    void print(const String& s) { fputs(s.c_str(), stdout); }
+    template<class... Args> void printf(const char* fmt, Args... args) { ::printf(fmt, args...); }
+};
+extern HardwareSerial Serial;
+
+// Hardware timers never fire - tests call the ISRs directly
+typedef struct { int unused; } hw_timer_t;
+inline hw_timer_t* timerBegin(int, int, bool) { static hw_timer_t timer; return &timer; }
+inline void timerAttachInterrupt(hw_timer_t*, void (*)(), bool) {}
+inline void timerAlarmWrite(hw_timer_t*, int, bool) {}
+inline void timerAlarmEnable(hw_timer_t*) {}
+inline void timerAlarmDisable(hw_timer_t*) {}
+
+class EspClass
+{
+public:
+    uint32_t getCpuFreqMHz() { return 240; }
+    uint32_t getFreeHeap() { return 100000; }
+};
+extern EspClass ESP;
+
+inline void disableCore0WDT() {}
+inline void enableCore0WDT() {}
+
+#include "esp_timer.h"
+#include "ArduinoLog.h"
+#include "HostFreeRTOS.h"
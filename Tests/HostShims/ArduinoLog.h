@@ -0,0 +1,30 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host version of ArduinoLog - output is discarded unless HOST_SHIMS_LOG is defined, in which case
+// notices, warnings and errors are passed to fprintf(stderr) - ArduinoLog formats such as %T are not converted
+
+#pragma once
+
+#include "Arduino.h"
+
+class Logging
+{
+public:
+    template<class... Args> void error(const char* fmt, Args... args) { out(fmt, args...); }
+    template<class... Args> void warning(const char* fmt, Args... args) { out(fmt, args...); }
+    template<class... Args> void notice(const char* fmt, Args... args) { out(fmt, args...); }
+    template<class... Args> void trace(const char*, Args...) {}
+    template<class... Args> void verbose(const char*, Args...) {}
+
+private:
+    template<class... Args> void out(const char* fmt, Args... args)
+    {
+#ifdef HOST_SHIMS_LOG
+        fprintf(stderr, fmt, args...);
+#else
+        (void)fmt;
+#endif
+    }
+};
+extern Logging Log;
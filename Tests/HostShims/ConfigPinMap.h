@@ -0,0 +1,16 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host version of ConfigPinMap - pins are given as numbers in the host configurations
+
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+
+class ConfigPinMap
+{
+public:
+    static int getPinFromName(const char* pinName) { return (pinName && *pinName) ? atoi(pinName) : -1; }
+    static int getInputType(const char* inputType) { return (inputType && strstr(inputType, "PULLUP")) ? 2 : 0; }
+};
@@ -0,0 +1,23 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host version of ESP32Servo - servos do nothing
+
+#pragma once
+
+class Servo
+{
+public:
+    void attach(int, int = 0, int = 0) {}
+    void detach() {}
+    void write(int) {}
+    void writeMicroseconds(int) {}
+    bool attached() { return false; }
+    void setPeriodHertz(int) {}
+};
+
+class ESP32PWM
+{
+public:
+    static void allocateTimer(int) {}
+};
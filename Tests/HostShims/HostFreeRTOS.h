@@ -0,0 +1,87 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host version of the FreeRTOS task and semaphore functions used by the firmware code, implemented
+// with std::thread - only one task (the FileManager worker) is supported
+
+#pragma once
+
+#include <stdint.h>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+
+typedef int BaseType_t;
+typedef uint32_t TickType_t;
+#ifndef portMAX_DELAY
+#define portMAX_DELAY 0xffffffff
+#endif
+#define pdPASS 1
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+// Counting semaphore - mutexes and binary semaphores have a max count of 1
+struct HostSemaphore
+{
+    std::mutex mutex;
+    std::condition_variable cond;
+    int count;
+    int maxCount;
+};
+typedef HostSemaphore* SemaphoreHandle_t;
+typedef std::thread* TaskHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateCounting(int maxCount, int initialCount)
+{
+    HostSemaphore* pSem = new HostSemaphore;
+    pSem->count = initialCount;
+    pSem->maxCount = maxCount;
+    return pSem;
+}
+inline SemaphoreHandle_t xSemaphoreCreateMutex() { return xSemaphoreCreateCounting(1, 1); }
+inline SemaphoreHandle_t xSemaphoreCreateBinary() { return xSemaphoreCreateCounting(1, 0); }
+
+// Ticks are milliseconds
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t pSem, TickType_t ticksToWait)
+{
+    std::unique_lock<std::mutex> lock(pSem->mutex);
+    if (ticksToWait == portMAX_DELAY)
+        pSem->cond.wait(lock, [pSem] { return pSem->count > 0; });
+    else if (!pSem->cond.wait_for(lock, std::chrono::milliseconds(ticksToWait), [pSem] { return pSem->count > 0; }))
+        return pdFALSE;
+    pSem->count--;
+    return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t pSem)
+{
+    std::lock_guard<std::mutex> lock(pSem->mutex);
+    if (pSem->count >= pSem->maxCount)
+        return pdFALSE;
+    pSem->count++;
+    pSem->cond.notify_one();
+    return pdTRUE;
+}
+
+// Defined in HostShims.cpp
+extern std::thread::id hostShimsTaskId;
+extern std::thread* hostShimsTaskHandle;
+
+inline BaseType_t xTaskCreatePinnedToCore(void (*pTaskFn)(void*), const char*, int, void* pParam, int,
+                TaskHandle_t* pHandle, int)
+{
+    hostShimsTaskHandle = new std::thread(pTaskFn, pParam);
+    hostShimsTaskId = hostShimsTaskHandle->get_id();
+    hostShimsTaskHandle->detach();
+    if (pHandle)
+        *pHandle = hostShimsTaskHandle;
+    return pdPASS;
+}
+
+// NULL on any thread other than the created task
+inline TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    return std::this_thread::get_id() == hostShimsTaskId ? hostShimsTaskHandle : NULL;
+}
@@ -0,0 +1,18 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Definitions for the host shims - compile and link this with every host build
+
+#include "Arduino.h"
+#include "soc/gpio_struct.h"
+#include "unity.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+Logging Log;
+gpio_dev_t GPIO;
+
+std::thread::id hostShimsTaskId;
+std::thread* hostShimsTaskHandle = NULL;
+
+int unityFailCount = 0;
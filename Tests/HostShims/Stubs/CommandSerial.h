@@ -0,0 +1,16 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host stand-in for CommandSerial - only constructed, never used by the host tests
+
+#pragma once
+
+#include "FileManager.h"
+
+class CommandSerial
+{
+public:
+    CommandSerial(FileManager& fileManager)
+    {
+    }
+};
@@ -0,0 +1,157 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host stand-in for FileManager (lib/RdFileManager) - files are read directly from the host file
+// system using the file name as a host path, and chunked reads return one line per chunk. Use the
+// real FileManager (with its RAM-backed file system) to test FileManager itself
+
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include "ConfigBase.h"
+
+class FileManager
+{
+public:
+    typedef std::function<bool()> FsBackgroundStepFnType;
+    typedef std::function<void(const String& name, int fileSize, const String& metaJson)> FileListEntryFnType;
+
+    FileManager()
+    {
+        _pFile = NULL;
+    }
+    ~FileManager()
+    {
+        if (_pFile)
+            fclose(_pFile);
+    }
+
+    bool getFilesJSON(const String& fileSystemStr, const String& folderStr, String& respStr)
+    {
+        respStr = "{\"rslt\":\"ok\",\"files\":[]}";
+        return true;
+    }
+    bool setFileMeta(const String& fileSystemStr, const String& filename, int fileLength, const String& metaJson)
+    {
+        return true;
+    }
+    uint32_t getFileListChangeCount()
+    {
+        return 0;
+    }
+
+    bool readFileBlock(const String& fileSystemStr, const String& filename, int filePos,
+                uint8_t* pBuf, int maxLen, int& readLen)
+    {
+        FILE* pFile = fopen(filename.c_str(), "rb");
+        if (!pFile)
+            return false;
+        fseek(pFile, filePos, SEEK_SET);
+        readLen = fread(pBuf, 1, maxLen, pFile);
+        fclose(pFile);
+        return true;
+    }
+    String getFileContents(const String& fileSystemStr, const String& filename, int maxLen=0)
+    {
+        FILE* pFile = fopen(filename.c_str(), "rb");
+        if (!pFile)
+            return "";
+        String contents;
+        int ch;
+        while (((ch = fgetc(pFile)) != EOF) && ((maxLen == 0) || (int(contents.length()) < maxLen)))
+            contents += char(ch);
+        fclose(pFile);
+        return contents;
+    }
+    bool getFileInfo(const String& fileSystemStr, const String& filename, int& fileLength)
+    {
+        FILE* pFile = fopen(filename.c_str(), "rb");
+        if (!pFile)
+            return false;
+        fseek(pFile, 0, SEEK_END);
+        fileLength = ftell(pFile);
+        fclose(pFile);
+        return true;
+    }
+
+    bool chunkedFileStart(const String& fileSystemStr, const String& filename, bool readByLine)
+    {
+        if (_pFile)
+            fclose(_pFile);
+        _pFile = fopen(filename.c_str(), "rb");
+        _chunkFilename = filename;
+        _chunkPos = 0;
+        return _pFile != NULL;
+    }
+    uint8_t* chunkFileNext(String& filename, int& fileLen, int& chunkPos, int& chunkLen, bool& finalChunk)
+    {
+        filename = _chunkFilename;
+        fileLen = 0;
+        chunkPos = _chunkPos;
+        chunkLen = 0;
+        finalChunk = true;
+        if (!_pFile)
+            return NULL;
+        if (!fgets((char*)_chunkBuf, sizeof(_chunkBuf), _pFile))
+        {
+            fclose(_pFile);
+            _pFile = NULL;
+            return NULL;
+        }
+        chunkLen = strlen((char*)_chunkBuf);
+        _chunkPos += chunkLen;
+        int nextCh = fgetc(_pFile);
+        finalChunk = (nextCh == EOF);
+        if (finalChunk)
+        {
+            fclose(_pFile);
+            _pFile = NULL;
+        }
+        else
+        {
+            ungetc(nextCh, _pFile);
+        }
+        return _chunkBuf;
+    }
+    void chunkedFilePrefetch(const String& fileSystemStr, const String& filename)
+    {
+    }
+
+    static String getFileExtension(String& filename)
+    {
+        int dotPos = filename.lastIndexOf('.');
+        return (dotPos < 0) ? String() : filename.substring(dotPos + 1);
+    }
+    static bool isCompressedFile(String& filename)
+    {
+        return false;
+    }
+    static String getUncompressedName(String& filename)
+    {
+        return filename;
+    }
+
+    // No background job is run
+    void setBackgroundJob(const FsBackgroundStepFnType& stepFn)
+    {
+    }
+    void backgroundJobWake()
+    {
+    }
+    bool backgroundFileListStart(const String& fileSystemStr, const String& folderStr, const FileListEntryFnType& entryFn)
+    {
+        return false;
+    }
+    bool backgroundFileListStep(bool& rslt)
+    {
+        rslt = false;
+        return true;
+    }
+
+private:
+    FILE* _pFile;
+    String _chunkFilename;
+    int _chunkPos;
+    uint8_t _chunkBuf[1000];
+};
@@ -0,0 +1,26 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host stand-in for LedStrip - the LED strip is always off
+
+#pragma once
+
+#include "ConfigBase.h"
+
+class LedStrip
+{
+public:
+    LedStrip(ConfigBase& ledStripConfig)
+    {
+    }
+    void setSleepMode(bool sleep)
+    {
+    }
+    const char* getConfigStrPtr()
+    {
+        return "{}";
+    }
+    void updateLedFromConfig(const char* pLedStripJson)
+    {
+    }
+};
@@ -0,0 +1,17 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host stand-in for MQTTManager - only constructed, never used by the host tests
+
+#pragma once
+
+#include "WiFiManager.h"
+#include "RestAPIEndpoints.h"
+
+class MQTTManager
+{
+public:
+    MQTTManager(WiFiManager& wifiManager, RestAPIEndpoints& endpoints)
+    {
+    }
+};
@@ -0,0 +1,17 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host stand-in for NetLog - only constructed, never used by the host tests
+
+#pragma once
+
+#include "MQTTManager.h"
+#include "CommandSerial.h"
+
+class NetLog
+{
+public:
+    NetLog(HardwareSerial& serial, MQTTManager& mqttManager, CommandSerial& commandSerial)
+    {
+    }
+};
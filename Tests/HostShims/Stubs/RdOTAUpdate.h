@@ -0,0 +1,12 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host stand-in for RdOTAUpdate - only constructed, never used by the host tests
+
+#pragma once
+
+#include <Arduino.h>
+
+class RdOTAUpdate
+{
+};
@@ -0,0 +1,28 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host stand-in for RestAPISystem - only constructed, never used by the host tests
+
+#pragma once
+
+#include "WiFiManager.h"
+#include "MQTTManager.h"
+#include "RdOTAUpdate.h"
+#include "NetLog.h"
+#include "FileManager.h"
+#include "NTPClient.h"
+#include "CommandScheduler.h"
+
+class RestAPISystem
+{
+public:
+    RestAPISystem(WiFiManager& wifiManager, MQTTManager& mqttManager, RdOTAUpdate& otaUpdate, NetLog& netLog,
+                FileManager& fileManager, NTPClient& ntpClient, CommandScheduler& commandScheduler,
+                const char* systemType, const char* systemVersion)
+    {
+    }
+    static int reportHealth(int bitPosStart, unsigned long* pOutHash, String* pOutStr)
+    {
+        return 0;
+    }
+};
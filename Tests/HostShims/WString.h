@@ -0,0 +1,8 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// String is defined with the rest of the host Arduino core
+
+#pragma once
+
+#include "Arduino.h"
@@ -0,0 +1,4 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+#pragma once
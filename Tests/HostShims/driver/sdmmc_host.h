@@ -0,0 +1,6 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+#pragma once
+
+#include "esp_vfs_fat.h"
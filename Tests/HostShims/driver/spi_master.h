@@ -0,0 +1,27 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host version of the SPI master driver - the Trinamics controller's SPI bus is replaced in tests
+// (see PlatformIO/test/TrinamicsSimulator.h) so the driver does nothing
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifndef portMAX_DELAY
+#define portMAX_DELAY 0xffffffff
+#endif
+enum { VSPI_HOST = 2 };
+struct spi_transaction_t { uint32_t flags; size_t length; size_t rxlength; void* user; const void* tx_buffer; void* rx_buffer; };
+typedef void (*transaction_cb_t)(spi_transaction_t*);
+struct spi_bus_config_t { int mosi_io_num, miso_io_num, sclk_io_num, quadwp_io_num, quadhd_io_num, max_transfer_sz; };
+struct spi_device_interface_config_t { int mode; int clock_speed_hz; int spics_io_num; int queue_size; transaction_cb_t pre_cb, post_cb; };
+typedef void* spi_device_handle_t;
+inline esp_err_t spi_bus_initialize(int, const spi_bus_config_t*, int) { return ESP_OK; }
+inline esp_err_t spi_bus_add_device(int, const spi_device_interface_config_t*, spi_device_handle_t*) { return ESP_OK; }
+inline esp_err_t spi_bus_remove_device(spi_device_handle_t) { return ESP_OK; }
+inline esp_err_t spi_bus_free(int) { return ESP_OK; }
+inline esp_err_t spi_device_queue_trans(spi_device_handle_t, spi_transaction_t*, uint32_t) { return ESP_OK; }
+inline esp_err_t spi_device_get_trans_result(spi_device_handle_t, spi_transaction_t**, uint32_t) { return ESP_OK; }
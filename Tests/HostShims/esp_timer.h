@@ -0,0 +1,19 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host version of esp_timer - timers never fire, tests call the callbacks directly
+
+#pragma once
+
+typedef void* esp_timer_handle_t;
+enum esp_timer_dispatch_t { ESP_TIMER_TASK };
+struct esp_timer_create_args_t
+{
+    void (*callback)(void*);
+    void* arg;
+    esp_timer_dispatch_t dispatch_method;
+    const char* name;
+};
+inline int esp_timer_create(const esp_timer_create_args_t*, esp_timer_handle_t*) { return 0; }
+inline int esp_timer_start_periodic(esp_timer_handle_t, unsigned long) { return 0; }
+inline int esp_timer_stop(esp_timer_handle_t) { return 0; }
@@ -0,0 +1,24 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host version of the SD card mounting used by FileManager - mounting always fails so only the
+// SPIFFS/LittleFS backend (mapped to a host folder by FileSysBackend) is used
+
+#pragma once
+
+#include "esp_err.h"
+
+typedef int gpio_num_t;
+struct sdmmc_host_t { int unused; };
+struct sdspi_slot_config_t { gpio_num_t gpio_miso, gpio_mosi, gpio_sck, gpio_cs; };
+#define SDSPI_HOST_DEFAULT() sdmmc_host_t{0}
+#define SDSPI_SLOT_CONFIG_DEFAULT() sdspi_slot_config_t{0, 0, 0, 0}
+struct esp_vfs_fat_sdmmc_mount_config_t { bool format_if_mount_failed; int max_files; int allocation_unit_size; };
+struct sdmmc_csd_t { int capacity; int sector_size; };
+struct sdmmc_card_t { sdmmc_csd_t csd; };
+typedef unsigned long DWORD;
+struct FATFS { DWORD csize, n_fatent, free_clst; };
+#define _MAX_SS 512
+inline int f_getfree(const char*, DWORD*, FATFS**) { return 1; }
+inline esp_err_t esp_vfs_fat_sdmmc_mount(const char*, const sdmmc_host_t*, const void*,
+                const esp_vfs_fat_sdmmc_mount_config_t*, sdmmc_card_t**) { return ESP_FAIL; }
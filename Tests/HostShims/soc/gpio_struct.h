@@ -0,0 +1,19 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host version of the GPIO registers accessed directly by the step generation ISR and SPI bus
+
+#pragma once
+
+#include <stdint.h>
+
+struct gpio_dev_t
+{
+    uint32_t out_w1ts;
+    uint32_t out_w1tc;
+    struct { uint32_t val; } out1_w1ts;
+    struct { uint32_t val; } out1_w1tc;
+    uint32_t in;
+    struct { uint32_t val; } in1;
+};
+extern gpio_dev_t GPIO;
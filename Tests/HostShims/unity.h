@@ -0,0 +1,30 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host version of the Unity asserts used by the unit tests in PlatformIO/test - a failure is
+// printed and counted in unityFailCount and the test carries on (unlike Unity which returns)
+
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// Defined in HostShims.cpp
+extern int unityFailCount;
+
+#define TEST_ASSERT_TRUE(cond) do { if (!(cond)) { unityFailCount++; \
+            printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #cond); } } while (0)
+#define TEST_ASSERT_FALSE(cond) TEST_ASSERT_TRUE(!(cond))
+#define TEST_ASSERT_NOT_NULL(ptr) TEST_ASSERT_TRUE((ptr) != NULL)
+#define TEST_ASSERT_EQUAL(expected, actual) do { long exp_ = (long)(expected), act_ = (long)(actual); \
+            if (exp_ != act_) { unityFailCount++; \
+            printf("FAIL %s:%d %s expected %ld was %ld\n", __FILE__, __LINE__, #actual, exp_, act_); } } while (0)
+#define TEST_ASSERT_FLOAT_WITHIN(delta, expected, actual) do { double exp_ = (expected), act_ = (actual); \
+            if (fabs(exp_ - act_) > (delta)) { unityFailCount++; \
+            printf("FAIL %s:%d %s expected %f was %f\n", __FILE__, __LINE__, #actual, exp_, act_); } } while (0)
+#define TEST_ASSERT_EQUAL_FLOAT(expected, actual) TEST_ASSERT_FLOAT_WITHIN(1e-4, expected, actual)
+#define TEST_ASSERT_EQUAL_STRING(expected, actual) TEST_ASSERT_TRUE(strcmp((expected), (actual)) == 0)
+#define TEST_ASSERT_EQUAL_MEMORY(expected, actual, len) TEST_ASSERT_TRUE(memcmp((expected), (actual), (len)) == 0)
+#define TEST_ASSERT_EQUAL_UINT(expected, actual) TEST_ASSERT_EQUAL(expected, actual)
+#define TEST_ASSERT_LESS_OR_EQUAL(threshold, actual) TEST_ASSERT_TRUE((actual) <= (threshold))
@@ -0,0 +1,8 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+#pragma once
+
+#include <unistd.h>
+
+namespace fs {}
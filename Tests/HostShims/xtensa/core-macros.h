@@ -0,0 +1,6 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+#pragma once
+
+#define XTHAL_GET_CCOUNT() 0
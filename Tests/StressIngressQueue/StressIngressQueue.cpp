@@ -0,0 +1,95 @@
+// RBotFirmware
+// Rob Dobson 2016-19
+
+// Host stress test of WorkItemIngressQueue - many producer threads add numbered commands (retrying
+// while the queue is full) and a single consumer checks that every command arrives exactly once
+// and in order for each producer
+
+#include <stdio.h>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include "WorkManager/WorkItemIngressQueue.h"
+
+static constexpr int DEFAULT_PRODUCERS = 8;
+static constexpr int DEFAULT_ITEMS_PER_PRODUCER = 200000;
+
+int main(int argc, char** argv)
+{
+    // Args: [producers] [itemsPerProducer]
+    int numProducers = (argc > 1) ? atoi(argv[1]) : DEFAULT_PRODUCERS;
+    int itemsPerProducer = (argc > 2) ? atoi(argv[2]) : DEFAULT_ITEMS_PER_PRODUCER;
+    if ((numProducers <= 0) || (itemsPerProducer <= 0))
+    {
+        fprintf(stderr, "StressIngressQueue: [producers] [itemsPerProducer]\n");
+        return 1;
+    }
+
+    WorkItemIngressQueue ingressQueue;
+    std::vector<uint64_t> fullRetries(numProducers, 0);
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (int producerIdx = 0; producerIdx < numProducers; producerIdx++)
+    {
+        producers.emplace_back([&ingressQueue, &fullRetries, producerIdx, itemsPerProducer]()
+        {
+            char cmdStr[40];
+            for (int itemIdx = 0; itemIdx < itemsPerProducer; itemIdx++)
+            {
+                snprintf(cmdStr, sizeof(cmdStr), "G0 X%d Y%d", producerIdx, itemIdx);
+                while (!ingressQueue.add(cmdStr))
+                {
+                    fullRetries[producerIdx]++;
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Consume and check
+    std::vector<int> nextItemIdx(numProducers, 0);
+    int64_t totalItems = (int64_t)numProducers * itemsPerProducer;
+    int64_t itemsRxd = 0;
+    int errorCount = 0;
+    while (itemsRxd < totalItems)
+    {
+        char* pStr = ingressQueue.get();
+        if (!pStr)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        int producerIdx = -1, itemIdx = -1;
+        if ((sscanf(pStr, "G0 X%d Y%d", &producerIdx, &itemIdx) != 2) ||
+                    (producerIdx < 0) || (producerIdx >= numProducers) ||
+                    (itemIdx != nextItemIdx[producerIdx]))
+        {
+            if (errorCount++ < 10)
+                fprintf(stderr, "StressIngressQueue: unexpected %s\n", pStr);
+        }
+        else
+        {
+            nextItemIdx[producerIdx]++;
+        }
+        ingressQueue.release(pStr);
+        itemsRxd++;
+    }
+    for (std::thread& producer : producers)
+        producer.join();
+    double wallSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    // Nothing left over
+    if (!ingressQueue.isEmpty())
+    {
+        fprintf(stderr, "StressIngressQueue: queue not empty at end\n");
+        errorCount++;
+    }
+    uint64_t totalRetries = 0;
+    for (uint64_t retries : fullRetries)
+        totalRetries += retries;
+    printf("{\"test\":\"ingressQueue\",\"producers\":%d,\"items\":%lld,\"errors\":%d,\"fullRetries\":%llu,"
+                "\"wallSecs\":%0.3f,\"itemsPerSec\":%0.0f}\n",
+                numProducers, (long long)totalItems, errorCount, (unsigned long long)totalRetries,
+                wallSecs, (wallSecs > 0) ? totalItems / wallSecs : 0);
+    return (errorCount == 0) ? 0 : 1;
+}